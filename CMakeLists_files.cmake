@@ -42,6 +42,7 @@ list(APPEND MAIN_SOURCE_FILES
   opm/grid/cpgrid/NestedRefinementUtilities.cpp
   opm/grid/cpgrid/PartitionTypeIndicator.cpp
   opm/grid/cpgrid/processEclipseFormat.cpp
+  opm/grid/cpgrid/Renumbering.cpp
   opm/grid/common/GeometryHelpers.cpp
   opm/grid/common/GridPartitioning.cpp
   opm/grid/common/MetisPartition.cpp
@@ -68,6 +69,7 @@ list(APPEND MAIN_SOURCE_FILES
   opm/grid/grid_equal.cpp
   opm/grid/utility/compressedToCartesian.cpp
   opm/grid/utility/cartesianToCompressed.cpp
+  opm/grid/utility/SetupProfile.cpp
   opm/grid/utility/StopWatch.cpp
   opm/grid/utility/WachspressCoord.cpp
 )
@@ -92,14 +94,18 @@ list(APPEND TEST_SOURCE_FILES
   tests/test_geom2d.cpp
   tests/test_graphofgrid.cpp
   tests/test_graphofgrid_parallel.cpp
+  tests/test_gridgraph.cpp
   tests/test_gridutilities.cpp
   tests/test_minpvprocessor.cpp
+  tests/test_parallelforeach.cpp
   tests/test_polyhedralgrid.cpp
   tests/test_process_grdecl.cpp
   tests/test_quadratures.cpp
   tests/test_repairzcorn.cpp
+  tests/test_setupprofile.cpp
   tests/test_sparsetable.cpp
   tests/test_subgridpart.cpp
+  tests/test_transtpfa.cpp
   tests/cpgrid/distribution_test.cpp
   tests/cpgrid/entityrep_test.cpp
   tests/cpgrid/entity_test.cpp
@@ -195,20 +201,28 @@ list(APPEND PUBLIC_HEADER_FILES
   opm/grid/common/p2pcommunicator_impl.hh
   opm/grid/common/WellConnections.hpp
   opm/grid/cpgrid/CartesianIndexMapper.hpp
+  opm/grid/cpgrid/CellBlockDataHandle.hpp
+  opm/grid/cpgrid/CommunicationRequest.hpp
   opm/grid/cpgrid/CpGridData.hpp
   opm/grid/cpgrid/CpGridDataTraits.hpp
   opm/grid/cpgrid/CpGridUtilities.hpp
   opm/grid/cpgrid/DataHandleWrappers.hpp
   opm/grid/cpgrid/DefaultGeometryPolicy.hpp
   opm/grid/cpgrid/dgfparser.hh
+  opm/grid/cpgrid/ElementChunks.hpp
   opm/grid/cpgrid/Entity2IndexDataHandle.hpp
   opm/grid/cpgrid/Entity.hpp
   opm/grid/cpgrid/EntityRep.hpp
+  opm/grid/cpgrid/FaceNeighbourTable.hpp
   opm/grid/cpgrid/Geometry.hpp
+  opm/grid/cpgrid/GeometryArrays.hpp
   opm/grid/cpgrid/GlobalIdMapping.hpp
   opm/grid/cpgrid/GridHelpers.hpp
+  opm/grid/cpgrid/IndexPairMap.hpp
+  opm/grid/cpgrid/InteriorCellSets.hpp
   opm/grid/cpgrid/LevelCartesianIndexMapper.hpp
   opm/grid/cpgrid/NestedRefinementUtilities.hpp
+  opm/grid/cpgrid/Renumbering.hpp
   opm/grid/CpGrid.hpp
   opm/grid/cpgrid/Indexsets.hpp
   opm/grid/cpgrid/Intersection.hpp
@@ -221,9 +235,11 @@ list(APPEND PUBLIC_HEADER_FILES
   opm/grid/cpgrid/ParentToChildCellToPointGlobalIdHandle.hpp
   opm/grid/cpgrid/PartitionIteratorRule.hpp
   opm/grid/cpgrid/PartitionTypeIndicator.hpp
+  opm/grid/cpgrid/SingleCellRefinement.hpp
   opm/grid/cpgrid/PersistentContainer.hpp
   opm/grid/common/CartesianIndexMapper.hpp
   opm/grid/common/GridEnums.hpp
+  opm/grid/common/GridGraph.hpp
   opm/grid/common/LevelCartesianIndexMapper.hpp
   opm/grid/common/MetisPartition.hpp
   opm/grid/common/SubGridPart.hpp
@@ -277,7 +293,9 @@ list(APPEND PUBLIC_HEADER_FILES
   opm/grid/utility/IteratorRange.hpp
   opm/grid/utility/OpmLog.hpp
   opm/grid/utility/OpmWellType.hpp
+  opm/grid/utility/ParallelForEach.hpp
   opm/grid/utility/RegionMapping.hpp
+  opm/grid/utility/SetupProfile.hpp
   opm/grid/utility/SparseTable.hpp
   opm/grid/utility/StopWatch.hpp
   opm/grid/utility/VariableSizeCommunicator.hpp
@@ -0,0 +1,371 @@
+/*
+  Copyright 2025 Equinor ASA.
+
+  This file is part of the Open Porous Media project (OPM).
+
+  OPM is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  OPM is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with OPM.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+/// Timing harness for grid construction, load balancing, refinement and
+/// leaf-view iteration of CpGrid on synthetic corner-point models.
+///
+/// Usage:
+///
+///     [mpirun -np P] cpgrid_benchmarks [nx=60] [ny=60] [nz=20]
+///                                      [repeats=3] [output=results.json]
+///
+/// Every benchmark is run \c repeats times on a freshly built grid. The
+/// reported time of one run is the maximum over all processes. Results are
+/// written as JSON to \c output, or to standard output if no file is given.
+
+#include <config.h>
+
+#include <opm/grid/CpGrid.hpp>
+#include <opm/grid/common/GridEnums.hpp>
+#include <opm/grid/cpgpreprocess/preprocess.h>
+#include <opm/grid/utility/StopWatch.hpp>
+
+#include <opm/grid/utility/platform_dependent/disable_warnings.h>
+#include <dune/common/parallel/communication.hh>
+#include <dune/common/parallel/mpihelper.hh>
+#include <opm/grid/utility/platform_dependent/reenable_warnings.h>
+
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
+#include <algorithm>
+#include <array>
+#include <cstdlib>
+#include <fstream>
+#include <functional>
+#include <iostream>
+#include <map>
+#include <string>
+#include <vector>
+
+namespace
+{
+
+/// Corner-point input owning its arrays.
+struct CornerPointModel
+{
+    std::string name;
+    std::array<int,3> dims;
+    std::vector<double> coord;
+    std::vector<double> zcorn;
+
+    grdecl input() const
+    {
+        grdecl g;
+        g.dims[0] = dims[0];
+        g.dims[1] = dims[1];
+        g.dims[2] = dims[2];
+        g.coord = coord.data();
+        g.zcorn = zcorn.data();
+        g.actnum = nullptr;
+        return g;
+    }
+};
+
+/// Build a corner-point model with vertical pillars on a unit spacing.
+///
+/// \param thickness Thickness of layer k at pillar column i.
+/// \param shift     Depth shift of all corners of the cells in column i,
+///                  which creates a fault where it changes between columns.
+CornerPointModel makeModel(const std::string& name,
+                           const std::array<int,3>& dims,
+                           const std::function<double(int,int)>& thickness,
+                           const std::function<double(int)>& shift)
+{
+    const auto [nx, ny, nz] = dims;
+    CornerPointModel model { name, dims, {}, {} };
+
+    double max_depth = 0.0;
+    std::vector<double> top((nx + 1)*(nz + 1), 0.0);
+    for (int i = 0; i <= nx; ++i) {
+        for (int k = 0; k < nz; ++k) {
+            top[i + (nx + 1)*(k + 1)] = top[i + (nx + 1)*k] + thickness(k, i);
+        }
+        max_depth = std::max(max_depth, top[i + (nx + 1)*nz]);
+    }
+    double max_shift = 0.0;
+    for (int i = 0; i < nx; ++i) {
+        max_shift = std::max(max_shift, shift(i));
+    }
+    max_depth += max_shift;
+
+    model.coord.reserve(6*(nx + 1)*(ny + 1));
+    for (int j = 0; j <= ny; ++j) {
+        for (int i = 0; i <= nx; ++i) {
+            model.coord.insert(model.coord.end(), { 1.0*i, 1.0*j, 0.0, 1.0*i, 1.0*j, max_depth + 1.0 });
+        }
+    }
+
+    model.zcorn.resize(8*nx*ny*nz);
+    for (int k = 0; k < nz; ++k) {
+        for (int j = 0; j < ny; ++j) {
+            for (int i = 0; i < nx; ++i) {
+                for (int c = 0; c < 8; ++c) {
+                    const int ci = c % 2;
+                    const int cj = (c / 2) % 2;
+                    const int ck = c / 4;
+                    model.zcorn[(2*i + ci) + 2*nx*((2*j + cj) + 2*ny*(2*k + ck))]
+                        = top[(i + ci) + (nx + 1)*(k + ck)] + shift(i);
+                }
+            }
+        }
+    }
+    return model;
+}
+
+CornerPointModel cartesianModel(const std::array<int,3>& dims)
+{
+    return makeModel("cartesian", dims,
+                     [](int, int) { return 1.0; },
+                     [](int) { return 0.0; });
+}
+
+/// Layers with a vertical fault along the middle i-column.
+CornerPointModel faultedModel(const std::array<int,3>& dims)
+{
+    const int fault_column = dims[0] / 2;
+    return makeModel("faulted", dims,
+                     [](int, int) { return 1.0; },
+                     [fault_column](int i) { return i < fault_column ? 0.0 : 2.5; });
+}
+
+/// Every third layer thins out towards the middle of the model and has
+/// zero thickness beyond it.
+CornerPointModel pinchedModel(const std::array<int,3>& dims)
+{
+    const int nx = dims[0];
+    return makeModel("pinched", dims,
+                     [nx](int k, int i) {
+                         return k % 3 == 1 ? std::max(0.0, 1.0 - 2.0*i/nx) : 1.0;
+                     },
+                     [](int) { return 0.0; });
+}
+
+struct BenchmarkResult
+{
+    std::string name;
+    std::string model;
+    std::array<int,3> dims;
+    int cells = 0;
+    std::vector<double> seconds;
+};
+
+class BenchmarkRunner
+{
+public:
+    BenchmarkRunner(const Dune::MPIHelper::MPICommunicator& comm, int repeats)
+        : comm_(comm), repeats_(repeats)
+    {}
+
+    /// Time \p run \c repeats times. \p setup is called before each run to
+    /// build a fresh grid and is not part of the timing. \p run returns the
+    /// number of cells of the resulting grid.
+    void run(const std::string& name,
+             const std::string& model,
+             const std::array<int,3>& dims,
+             const std::function<void(Dune::CpGrid&)>& setup,
+             const std::function<int(Dune::CpGrid&)>& run)
+    {
+        BenchmarkResult result { name, model, dims, 0, {} };
+        for (int r = 0; r < repeats_; ++r) {
+            Dune::CpGrid grid;
+            setup(grid);
+            comm_.barrier();
+            Opm::time::StopWatch clock;
+            clock.start();
+            result.cells = run(grid);
+            clock.stop();
+            result.seconds.push_back(comm_.max(clock.secsSinceStart()));
+        }
+        if (comm_.rank() == 0) {
+            std::cerr << name << " (" << model << "): "
+                      << *std::min_element(result.seconds.begin(), result.seconds.end())
+                      << " s" << std::endl;
+        }
+        results_.push_back(std::move(result));
+    }
+
+    void writeJson(std::ostream& os) const
+    {
+        int threads = 1;
+#ifdef _OPENMP
+        threads = omp_get_max_threads();
+#endif
+        os << "{\n"
+           << "  \"processes\": " << comm_.size() << ",\n"
+           << "  \"threads\": " << threads << ",\n"
+           << "  \"repeats\": " << repeats_ << ",\n"
+           << "  \"benchmarks\": [";
+        for (std::size_t b = 0; b < results_.size(); ++b) {
+            const auto& res = results_[b];
+            auto sorted = res.seconds;
+            std::sort(sorted.begin(), sorted.end());
+            os << (b == 0 ? "\n" : ",\n")
+               << "    {\n"
+               << "      \"name\": \"" << res.name << "\",\n"
+               << "      \"model\": \"" << res.model << "\",\n"
+               << "      \"dims\": [" << res.dims[0] << ", " << res.dims[1] << ", " << res.dims[2] << "],\n"
+               << "      \"cells\": " << res.cells << ",\n"
+               << "      \"min_seconds\": " << sorted.front() << ",\n"
+               << "      \"median_seconds\": " << sorted[sorted.size() / 2] << ",\n"
+               << "      \"max_seconds\": " << sorted.back() << ",\n"
+               << "      \"seconds\": [";
+            for (std::size_t r = 0; r < res.seconds.size(); ++r) {
+                os << (r == 0 ? "" : ", ") << res.seconds[r];
+            }
+            os << "]\n    }";
+        }
+        os << "\n  ]\n}\n";
+    }
+
+private:
+    Dune::Communication<Dune::MPIHelper::MPICommunicator> comm_;
+    int repeats_;
+    std::vector<BenchmarkResult> results_;
+};
+
+/// Process \p model into the global grid on rank 0.
+///
+/// CpGrid::processEclipseFormat() only accepts corner-point input on rank 0.
+/// The other ranks keep an empty global grid, as createCartesian() leaves
+/// it there, and only receive the logical Cartesian size.
+void processOnRoot(Dune::CpGrid& grid, const CornerPointModel& model)
+{
+    if (grid.comm().rank() == 0) {
+        grid.processEclipseFormat(model.input(), /* remove_ij_boundary = */ false);
+    } else {
+        grid.createCartesian(model.dims, {1.0, 1.0, 1.0});
+    }
+}
+
+/// Visit all leaf elements and their intersections, accumulating face
+/// areas so that the loop cannot be optimised away.
+double iterateLeafView(const Dune::CpGrid& grid)
+{
+    double area = 0.0;
+    const auto& gv = grid.leafGridView();
+    for (const auto& element : elements(gv)) {
+        area += element.geometry().volume();
+        for (const auto& intersection : intersections(gv, element)) {
+            area += intersection.geometry().volume();
+        }
+    }
+    return area;
+}
+
+std::map<std::string, std::string> parseArguments(int argc, char** argv)
+{
+    std::map<std::string, std::string> args { {"nx", "60"}, {"ny", "60"}, {"nz", "20"},
+                                              {"repeats", "3"}, {"output", ""} };
+    for (int a = 1; a < argc; ++a) {
+        const std::string arg = argv[a];
+        const auto eq = arg.find('=');
+        if (eq == std::string::npos || args.count(arg.substr(0, eq)) == 0) {
+            std::cerr << "Unknown argument '" << arg << "'. Expected one of nx=, ny=, nz=, repeats=, output=." << std::endl;
+            std::exit(EXIT_FAILURE);
+        }
+        args[arg.substr(0, eq)] = arg.substr(eq + 1);
+    }
+    return args;
+}
+
+} // anonymous namespace
+
+int main(int argc, char** argv)
+{
+    const auto& mpi = Dune::MPIHelper::instance(argc, argv);
+    const auto args = parseArguments(argc, argv);
+    const std::array<int,3> dims = { std::stoi(args.at("nx")), std::stoi(args.at("ny")), std::stoi(args.at("nz")) };
+    const int repeats = std::max(1, std::stoi(args.at("repeats")));
+
+    BenchmarkRunner runner(mpi.getCommunicator(), repeats);
+    const auto noSetup = [](Dune::CpGrid&) {};
+    const auto cartesian = [&dims](Dune::CpGrid& grid) { grid.createCartesian(dims, {1.0, 1.0, 1.0}); };
+
+    runner.run("createCartesian", "cartesian", dims, noSetup,
+               [&dims](Dune::CpGrid& grid) {
+                   grid.createCartesian(dims, {1.0, 1.0, 1.0});
+                   return grid.size(0);
+               });
+
+    for (const auto& model : { cartesianModel(dims), faultedModel(dims), pinchedModel(dims) }) {
+        runner.run("processEclipseFormat", model.name, dims, noSetup,
+                   [&model](Dune::CpGrid& grid) {
+                       processOnRoot(grid, model);
+                       return grid.size(0);
+                   });
+    }
+
+    const std::vector<std::pair<std::string, Dune::PartitionMethod>> methods {
+        { "simple", Dune::PartitionMethod::simple },
+#if HAVE_MPI && HAVE_ZOLTAN
+        { "zoltan", Dune::PartitionMethod::zoltan },
+        { "zoltanGoG", Dune::PartitionMethod::zoltanGoG },
+#endif
+#if HAVE_MPI && HAVE_METIS
+        { "metis", Dune::PartitionMethod::metis },
+#endif
+    };
+    const auto faulted = faultedModel(dims);
+    for (const auto& [method_name, method] : methods) {
+        runner.run("loadBalance/" + method_name, faulted.name, dims,
+                   [&faulted](Dune::CpGrid& grid) { processOnRoot(grid, faulted); },
+                   [method = method](Dune::CpGrid& grid) {
+                       grid.loadBalance(/* overlapLayers = */ 1, method);
+                       return grid.size(0);
+                   });
+    }
+
+    // One LGR covering the central quarter of the model in i and j.
+    const std::array<int,3> lgr_start = { dims[0]/4, dims[1]/4, 0 };
+    const std::array<int,3> lgr_end = { std::max(dims[0]/4 + 1, 3*dims[0]/4),
+                                        std::max(dims[1]/4 + 1, 3*dims[1]/4),
+                                        dims[2] };
+    runner.run("addLgrsUpdateLeafView", "cartesian", dims, cartesian,
+               [&](Dune::CpGrid& grid) {
+                   grid.addLgrsUpdateLeafView({{2, 2, 2}}, {lgr_start}, {lgr_end}, {"LGR1"});
+                   return grid.size(0);
+               });
+
+    runner.run("globalRefine", "cartesian", dims, cartesian,
+               [](Dune::CpGrid& grid) {
+                   grid.globalRefine(1);
+                   return grid.size(0);
+               });
+
+    runner.run("leafViewIteration", "faulted", dims,
+               [&faulted](Dune::CpGrid& grid) { processOnRoot(grid, faulted); },
+               [](Dune::CpGrid& grid) {
+                   volatile double sum = iterateLeafView(grid);
+                   static_cast<void>(sum);
+                   return grid.size(0);
+               });
+
+    if (mpi.rank() == 0) {
+        const auto& output = args.at("output");
+        if (output.empty()) {
+            runner.writeJson(std::cout);
+        } else {
+            std::ofstream os(output);
+            runner.writeJson(os);
+        }
+    }
+    return EXIT_SUCCESS;
+}
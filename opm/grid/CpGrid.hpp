@@ -48,14 +48,21 @@
 
 #include <opm/grid/common/GridEnums.hpp>
 
+#include <opm/grid/cpgrid/CommunicationRequest.hpp>
 #include <opm/grid/cpgrid/CpGridDataTraits.hpp>
 #include <opm/grid/cpgrid/DefaultGeometryPolicy.hpp>
+#include <opm/grid/cpgrid/FaceNeighbourTable.hpp>
+#include <opm/grid/cpgrid/IndexPairMap.hpp>
+#include <opm/grid/cpgrid/InteriorCellSets.hpp>
 #include <opm/grid/cpgrid/OrientedEntityTable.hpp>
+#include <opm/grid/cpgrid/Renumbering.hpp>
 
 #include <opm/grid/cpgpreprocess/preprocess.h>
 
 #include <opm/grid/utility/OpmWellType.hpp>
+#include <opm/grid/utility/SetupProfile.hpp>
 
+#include <memory>
 #include <set>
 
 namespace Opm
@@ -337,6 +344,42 @@ namespace Dune
                                   bool turn_normals = false,
                                   bool edge_conformal = false);
 
+        /// Build a distributed grid without assembling the global grid
+        /// on any process.
+        ///
+        /// Each process passes the corner-point input of a slab of
+        /// Cartesian rows (constant j) and builds its part of the grid
+        /// directly. The owned rows of all processes must partition
+        /// [0, global_ny). Afterwards the grid behaves as if
+        /// loadBalance() had been called with one layer of overlap,
+        /// except that there is no global grid to gather data to or
+        /// scatter data from. Must be called collectively.
+        ///
+        /// \param[in] slab_input Corner-point input of the rows
+        /// slabInputRows(owned_rows, global_ny) of the global grid.
+        ///
+        /// \param[in] global_ny Number of rows of the global grid.
+        ///
+        /// \param[in] owned_rows First and one past last row owned by
+        /// this process.
+        ///
+        /// \param[in] turn_normals if true, all normals will be turned.
+        ///
+        /// \param[in] edge_conformal Whether or not to construct an
+        /// edge-conformal grid.
+        void processEclipseFormatDistributed(const grdecl& slab_input,
+                                             int global_ny,
+                                             const std::array<int,2>& owned_rows,
+                                             bool turn_normals = false,
+                                             bool edge_conformal = false);
+
+        /// The rows of the corner-point input needed by
+        /// processEclipseFormatDistributed() on a process owning
+        /// \p owned_rows: the owned rows plus two halo rows on each side,
+        /// clipped to the global grid.
+        static std::array<int,2> slabInputRows(const std::array<int,2>& owned_rows,
+                                               int global_ny);
+
         //@}
 
         /// \name Cartesian grid extensions.
@@ -597,7 +640,7 @@ namespace Dune
 
     private:
         void updateCornerHistoryLevels(const std::vector<std::vector<std::array<int,2>>>& cornerInMarkedElemWithEquivRefinedCorner,
-                                       const std::map<std::array<int,2>,std::array<int,2>>& elemLgrAndElemLgrCorner_to_refinedLevelAndRefinedCorner,
+                                       const Dune::cpgrid::IndexPairMap<std::array<int,2>>& elemLgrAndElemLgrCorner_to_refinedLevelAndRefinedCorner,
                                        const std::unordered_map<int,std::array<int,2>>& adaptedCorner_to_elemLgrAndElemLgrCorner,
                                        const int& corner_count,
                                        const std::vector<std::array<int,2>>& preAdaptGrid_corner_history,
@@ -700,6 +743,48 @@ namespace Dune
 
         void setPartitioningParams(const std::map<std::string,std::string>& params);
 
+        /// \brief Choose how communicate() and communicateBegin() exchange data between processes.
+        ///
+        /// With Dune::neighbourhoodCollectives every communication of data with a fixed
+        /// size per entity becomes a collective operation on all processes of the grid,
+        /// which may scale better to large numbers of processes. Has to be called with the
+        /// same method on all processes and not while a communication is pending.
+        void setCommunicationMethod(CommunicationMethod method);
+
+        /// \brief The method used by communicate(), see setCommunicationMethod().
+        CommunicationMethod communicationMethod() const;
+
+        /// \brief Renumbers the cells, faces and points of the current view to improve memory locality.
+        ///
+        /// Neighbouring cells end up close to each other in memory, which reduces the bandwidth
+        /// of matrices assembled over the cells and the cache misses of loops over them. The
+        /// faces and points are numbered in the order in which the renumbered cells reach them.
+        /// Topology, geometry, global cells, ids, partition types, the parallel index set and
+        /// the communication interfaces of the view, including the interfaces used by
+        /// scatterData() and gatherData(), are permuted consistently. Meant to be called
+        /// right after the grid has been created or load balanced, as data and objects of users,
+        /// like mappers or the communication of CpGrid::cellCommunication(), refer to the old
+        /// numbering. Works on each process locally. Grids with refined cells cannot be renumbered,
+        /// and neither can the global view once the grid has been distributed, as the distributed
+        /// view refers to the cells and points of the global view by their indices.
+        /// \param method How the cells are ordered.
+        /// \param ownersFirst Whether the interior cells of a distributed view are put before all
+        ///                    other cells, each group keeping the order of the method.
+        /// \return The permutations applied, to carry over data attached to the old numbering.
+        cpgrid::Renumbering renumber(RenumberingMethod method, bool ownersFirst = false);
+
+        /// \brief Phases of grid setup recorded so far on this process.
+        ///
+        /// Covers corner-point processing, load balancing and refinement.
+        /// Only filled when profiling is enabled, either by
+        /// enableSetupProfile() or by the environment variable
+        /// OPM_GRID_PROFILE. Use Opm::SetupProfile::writeReport() or
+        /// Opm::SetupProfile::writeChromeTrace() to export it.
+        const Opm::SetupProfile& setupProfile() const;
+
+        /// \brief Switch recording of setup phases on or off.
+        void enableSetupProfile(bool enable);
+
         // loadbalance is not part of the grid interface therefore we skip it.
 
         /// \brief Distributes this grid over the available nodes in a distributed machine
@@ -839,6 +924,10 @@ namespace Dune
         /// \param imbalanceTol
         /// \param level Level grid to be distributed. Integer between 0,..., maxLevel().
         ///              Defualt value set to -1, representing the leaf grid view.
+        /// \param cellWeights The computational weights of the cells on rank 0, either one per cell
+        ///            or, for several balancing constraints, dim consecutive ones per cell. Empty means
+        ///            that all cells weigh the same. Only METIS balances several constraints separately,
+        ///            the other partitioners balance their sum.
         /// \warning Throw if level>0. Currently, for CpGrid with LGRs, only distributing level zero grid is supported.
         /// \warning May only be called once.
         /// \return A pair consisting of a boolean indicating whether loadbalancing actually happened and
@@ -851,11 +940,12 @@ namespace Dune
                     bool addCornerCells=false, int overlapLayers=1,
                     int partitionMethod = Dune::PartitionMethod::zoltanGoG,
                     double imbalanceTol = 1.1,
-                    int level = -1)
+                    int level = -1,
+                    const std::vector<double>& cellWeights = {})
         {
             return scatterGrid(method, ownersFirst, wells, possibleFutureConnections,  /* serialPartitioning = */ false,
                                transmissibilities, addCornerCells, overlapLayers, partitionMethod, imbalanceTol,
-                               /* allowDistributeWells = */ false, /* input_cell_part = */ {}, level);
+                               /* allowDistributeWells = */ false, /* input_cell_part = */ {}, level, cellWeights);
         }
 
         /// \brief Distributes this grid and data over the available nodes in a distributed machine.
@@ -932,6 +1022,8 @@ namespace Dune
         /// \param imbalanceTol Set the imbalance tolerance used by the partitioner
         /// \param allowDistributedWells Allow the perforation of a well to be distributed to the
         ///        interior region of multiple processes.
+        /// \param cellWeights The computational weights of the cells on rank 0, one or several per cell.
+        ///            Empty means that all cells weigh the same.
         /// \tparam DataHandle The type implementing DUNE's DataHandle interface.
         /// \warning May only be called once.
         /// \return A pair consisting of a boolean indicating whether loadbalancing actually happened and
@@ -946,11 +1038,12 @@ namespace Dune
                     const double* transmissibilities = nullptr, bool ownersFirst=false,
                     bool addCornerCells=false, int overlapLayers=1, int partitionMethod = Dune::PartitionMethod::zoltanGoG,
                     double imbalanceTol = 1.1,
-                    bool allowDistributedWells = false)
+                    bool allowDistributedWells = false,
+                    const std::vector<double>& cellWeights = {})
         {
             auto ret = scatterGrid(method, ownersFirst, wells, possibleFutureConnections, serialPartitioning, transmissibilities,
                                    addCornerCells, overlapLayers, partitionMethod, imbalanceTol, allowDistributedWells,
-                                   /* input_cell_parts = */ std::vector<int>{}, /* level = */ 0);
+                                   /* input_cell_parts = */ std::vector<int>{}, /* level = */ 0, cellWeights);
             using std::get;
             if (get<0>(ret))
             {
@@ -1076,6 +1169,52 @@ namespace Dune
             return ret;
         }
 
+        /// \brief Rebalances an already distributed grid according to the work per cell.
+        ///
+        /// The current ownership of the cells is the starting point. The processes
+        /// exchange work with their neighbours by diffusion, passing cells across the
+        /// partition boundaries from heavier to lighter processes until the tolerance
+        /// is met, such that only cells that need to change owner do so. The overlap
+        /// is computed anew from the face neighbours and the cells that a process
+        /// gains are sent to it directly by their previous owner. The global view is
+        /// not used, and the distributed view, its interfaces and the interfaces for
+        /// scattering and gathering data are updated in place.
+        /// \param weights The work of each cell of the distributed leaf view, indexed
+        ///                by leaf index. Only the values of interior cells are used.
+        /// \param wells Vector of wells, might be nullptr. Only used on rank 0. Wells may become distributed.
+        /// \param imbalanceTol The tolerated ratio of the maximum to the mean work per process.
+        /// \param ownersFirst Order owner cells before copy/overlap cells.
+        /// \param overlapLayers The number of layers of cells of the overlap region (default: 1).
+        /// \warning Has to be called on all ranks of a grid distributed by loadBalance
+        ///          while the distributed view is the current one. Grids with local
+        ///          refinement cannot be rebalanced yet.
+        /// \return A pair consisting of a boolean indicating whether rebalancing actually happened and
+        ///         a vector containing a pair of name and a boolean, indicating whether this well has
+        ///         perforated cells local to the process, for all wells (sorted by name)
+        std::pair<bool, std::vector<std::pair<std::string,bool> > >
+        rebalance(const std::vector<double>& weights,
+                  const std::vector<cpgrid::OpmWellType> * wells = nullptr,
+                  double imbalanceTol = 1.1,
+                  bool ownersFirst=false,
+                  int overlapLayers=1);
+
+        /// \brief Rebalances an already distributed grid and its data according to the work per cell.
+        ///
+        /// The data is sent from the cells and points of the previous distributed view
+        /// to the ones of the new one, hence the data handle has to be usable for
+        /// scatterData, e.g. by storing the data by global id. Cells may keep the
+        /// data of their copies, which therefore has to be up to date.
+        /// \param data A data handle describing how to distribute attached data.
+        /// \tparam DataHandle The type implementing DUNE's DataHandle interface.
+        /// \see rebalance(const std::vector<double>&, const std::vector<cpgrid::OpmWellType>*, double, bool, int)
+        template<class DataHandle>
+        std::pair<bool, std::vector<std::pair<std::string,bool> > >
+        rebalance(DataHandle& data, const std::vector<double>& weights,
+                  const std::vector<cpgrid::OpmWellType> * wells = nullptr,
+                  double imbalanceTol = 1.1,
+                  bool ownersFirst=false,
+                  int overlapLayers=1);
+
         /// \brief Partitions the grid using Zoltan without decomposing and distributing it among processes.
         /// \param wells The wells of the eclipse.
         /// \param possibleFutureConnections An optional unordered_map<string, set<array<int,3>>>
@@ -1119,6 +1258,27 @@ namespace Dune
         template<class DataHandle>
         void communicate (DataHandle& data, InterfaceType iftype, CommunicationDirection dir) const;
 
+        /// \brief Start communicating objects for all codims, without waiting for the data.
+        ///
+        /// Overlaps communication with computation:
+        /// \code
+        /// auto request = grid.communicateBegin(handle, iftype, dir);
+        /// // work on grid.interiorCellSets().deep_interior
+        /// request.wait();
+        /// // work on grid.interiorCellSets().boundary_adjacent
+        /// \endcode
+        /// A forward and a backward communication over the same interface may be pending
+        /// together, see CpGridData::communicateBegin() for the order of their first use.
+        /// \param data The data handle describing the data. Has to adhere to the
+        /// Dune::DataHandleIF interface and to stay alive until the request is completed.
+        /// \param iftype The interface to use for the communication.
+        /// \param dir The direction of the communication along the interface (forward or backward).
+        /// \return The request completing the communication in its wait() method.
+        /// \see cpgrid::CommunicationRequest
+        template<class DataHandle>
+        cpgrid::CommunicationRequest<DataHandle>
+        communicateBegin(DataHandle& data, InterfaceType iftype, CommunicationDirection dir) const;
+
         /// \brief Get the collective communication object.
         const typename CpGridTraits::Communication& comm () const;
         //@}
@@ -1252,6 +1412,43 @@ namespace Dune
         /// \param cell The index identifying the face.
         const Vector& cellCentroid(int cell) const;
 
+        /// \brief Volumes of all cells, indexed by cell.
+        ///
+        /// Contiguous, unlike the cell geometries. The first call on a
+        /// grid view builds the arrays of volumes, areas and centroids.
+        const std::vector<double>& cellVolumes() const;
+
+        /// \brief Centroids of all cells, indexed by cell.
+        const std::vector<Vector>& cellCentroids() const;
+
+        /// \brief Areas of all faces, indexed by face.
+        const std::vector<double>& faceAreas() const;
+
+        /// \brief Centroids of all faces, indexed by face.
+        const std::vector<Vector>& faceCentroids() const;
+
+        /// \brief Faces of a cell with the cells on their other side.
+        ///
+        /// Entry i describes the i-th intersection of the cell: face index,
+        /// neighbour (or a negative value if there is none on this process),
+        /// face tag and whether the face normal points out of the cell.
+        /// Iterating over it is a linear scan of a flat table, which is built
+        /// for the grid view on the first call.
+        /// \param cell The index identifying the cell.
+        cpgrid::FaceNeighbourTable::row_type faceNeighbours(int cell) const;
+
+        /// \brief Faces and neighbours of all cells, row c belonging to cell c.
+        /// \see faceNeighbours
+        const cpgrid::FaceNeighbourTable& faceNeighbourTable() const;
+
+        /// \brief The interior cells split into those sharing a face with a
+        /// non-interior cell and the others.
+        ///
+        /// Work on the deep interior cells does not need the data of overlap
+        /// cells and can thus be done while it is communicated.
+        /// \see communicateBegin
+        const cpgrid::InteriorCellSets& interiorCellSets() const;
+
         /// \brief An iterator over the centroids of the geometry of the entities.
         /// \tparam codim The co-dimension of the entities.
         template<int codim>
@@ -1451,6 +1648,8 @@ namespace Dune
         ///        interior region of multiple processes.
         /// \param cell_part When using an external loadbalancer the partition number for each cell.
         ///                  If empty or not specified we use internal load balancing.
+        /// \param level Level grid to be distributed, -1 for the leaf grid view.
+        /// \param cellWeights The weights of the cells on rank 0 used by the internal load balancing.
         /// \return A pair consisting of a boolean indicating whether loadbalancing actually happened and
         ///         a vector containing a pair of name and a boolean, indicating whether this well has
         ///         perforated cells local to the process, for all wells (sorted by name)
@@ -1467,7 +1666,37 @@ namespace Dune
                     double imbalanceTol = 1.1,
                     bool allowDistributedWells = true,
                     const std::vector<int>& input_cell_part = {},
-                    int level = -1);
+                    int level = -1,
+                    const std::vector<double>& cellWeights = {});
+
+        /// \brief The previous distributed view after rebalancing together with the
+        /// interfaces from its cells and points to the ones of the new view.
+        ///
+        /// Keeps the previous view registered with the global id set until the
+        /// data has been sent.
+        struct CellMigration
+        {
+            explicit CellMigration(CpGrid& grid_)
+                : grid(grid_)
+            {}
+            ~CellMigration();
+            CellMigration(const CellMigration&) = delete;
+            CellMigration& operator=(const CellMigration&) = delete;
+
+            CpGrid& grid;
+            std::shared_ptr<cpgrid::CpGridData> source;
+            InterfaceMap cells;
+            InterfaceMap points;
+            std::vector<std::pair<std::string,bool>> wells_on_proc;
+        };
+
+        /// \brief Moves the cells of the distributed view to their new owners.
+        /// \return The migration from the previous view, nullptr without MPI.
+        /// \see rebalance
+        std::unique_ptr<CellMigration>
+        migrateCells(const std::vector<double>& weights,
+                     const std::vector<cpgrid::OpmWellType> * wells,
+                     double imbalanceTol, bool ownersFirst, int overlapLayers);
 
         /** @brief The data stored in the grid.
          *
@@ -1503,6 +1732,16 @@ namespace Dune
          */
         std::map<std::string,std::string> partitioningParams;
 
+        /**
+         * @brief How the views exchange data, passed on to the current view on communication.
+         */
+        CommunicationMethod communication_method_ = pointToPoint;
+
+        /**
+         * @brief Timing, memory and entity counts of the setup phases.
+         */
+        std::shared_ptr<Opm::SetupProfile> setup_profile_;
+
     }; // end Class CpGrid
 
 } // end namespace Dune
@@ -1555,9 +1794,18 @@ namespace Dune
     template<class DataHandle>
     void CpGrid::communicate (DataHandle& data, InterfaceType iftype, CommunicationDirection dir) const
     {
+        current_data_->back()->setCommunicationMethod(communication_method_);
         current_data_->back()->communicate(data, iftype, dir);
     }
 
+    template<class DataHandle>
+    cpgrid::CommunicationRequest<DataHandle>
+    CpGrid::communicateBegin(DataHandle& data, InterfaceType iftype, CommunicationDirection dir) const
+    {
+        current_data_->back()->setCommunicationMethod(communication_method_);
+        return current_data_->back()->communicateBegin(data, iftype, dir);
+    }
+
 
     template<class DataHandle>
     void CpGrid::scatterData([[maybe_unused]] DataHandle& handle) const
@@ -1586,6 +1834,27 @@ namespace Dune
 #endif
     }
 
+    template<class DataHandle>
+    std::pair<bool, std::vector<std::pair<std::string,bool> > >
+    CpGrid::rebalance(DataHandle& data, const std::vector<double>& weights,
+                      const std::vector<cpgrid::OpmWellType> * wells,
+                      double imbalanceTol,
+                      bool ownersFirst,
+                      int overlapLayers)
+    {
+        const auto migration = migrateCells(weights, wells, imbalanceTol, ownersFirst, overlapLayers);
+        if (!migration) {
+            return std::make_pair(false, std::vector<std::pair<std::string,bool>>());
+        }
+#if HAVE_MPI
+        distributed_data_[0]->scatterData(data, migration->source.get(), distributed_data_[0].get(),
+                                          migration->cells, migration->points);
+#else
+        static_cast<void>(data);
+#endif
+        return std::make_pair(true, migration->wells_on_proc);
+    }
+
 
     template<class Cell2FacesRowIterator>
     int
@@ -1653,5 +1922,6 @@ namespace Dune
 #include "cpgrid/Intersection.hpp"
 #include "cpgrid/Geometry.hpp"
 #include "cpgrid/Indexsets.hpp"
+#include <opm/grid/cpgrid/ElementChunks.hpp>
 
 #endif // OPM_CPGRID_HEADER
@@ -26,6 +26,9 @@
 #include <config.h>
 #include "GraphOfGrid.hpp"
 
+#include <algorithm>
+#include <cassert>
+#include <iterator>
 #include <numeric>
 
 namespace Opm {
@@ -54,17 +57,29 @@ void GraphOfGrid<Grid>::createGraph (const double* transmissibilities,
         logMinTransm = std::log(logMinTransm);
     }
 
-    const auto& rank = grid.comm().rank();
+    rank = grid.comm().rank();
     // load vertices (grid cells) into graph
-    graph.reserve(grid.size(0));
+    const int numCells = grid.size(0);
+    vertexIDs.reserve(numCells);
     for (auto it=grid.template leafbegin<0>(); it!=grid.template leafend<0>(); ++it)
     {
-        VertexProperties vertex;
-        vertex.nproc = rank;
-        // get vertex's global ID
-        int gID = grid.globalIdSet().id(*it);
+        const int gID = grid.globalIdSet().id(*it);
+        if (gID >= static_cast<int>(slotOfID.size()))
+        {
+            slotOfID.resize(gID+1, -1);
+        }
+        slotOfID[gID] = vertexIDs.size();
+        vertexIDs.push_back(gID);
+    }
+    initVertices();
 
-        // iterate over vertex's faces and store neighbors' IDs
+    // store neighbors' slots in CSR format
+    edgeOffsets.reserve(numCells+1);
+    edgeTargets.reserve(6*numCells);
+    edgeWeights.reserve(6*numCells);
+    for (int gID : vertexIDs)
+    {
+        const auto rowBegin = edgeTargets.size();
         for (int face_lID=0; face_lID<grid.numCellFaces(gID); ++face_lID)
         {
             const int face  = grid.cellFace(gID, face_lID);
@@ -99,12 +114,10 @@ void GraphOfGrid<Grid>::createGraph (const double* transmissibilities,
             } else {
                 weight = 1.;
             }
-            vertex.edges.try_emplace(otherCell, weight);
+            addEdge(rowBegin, slotOf(otherCell), weight);
         }
-
-        graph.try_emplace(gID, vertex);
+        edgeOffsets.push_back(edgeTargets.size());
     }
-
 }
 
 // CpGrid Specialization
@@ -132,34 +145,45 @@ void GraphOfGrid<Dune::CpGrid>::createGraph (const double* transmissibilities,
         logMinTransm = std::log(logMinTransm);
     }
 
-    const auto& rank = grid.comm().rank();
-    // load vertices (grid cells) into graph
-    graph.reserve(grid.numCells(level));
+    rank = grid.comm().rank();
 
     // Select data according to level/leaf grid to be distributed
     bool validLevel = (level>-1) && (level <= grid.maxLevel());
     auto it = validLevel?  grid.template lbegin<0>(level) :  grid.template leafbegin<0>();
     auto itEnd = validLevel? grid.template lend<0>(level) : grid.template leafend<0>();
 
+    // load vertices (grid cells) into graph, the slot of a cell is its index
+    const int numCells = grid.numCells(level);
+    vertexIDs.resize(numCells);
     for (; it!=itEnd; ++it)
     {
-        VertexProperties vertex;
-        vertex.nproc = rank;
-        // get vertex's global ID
-        int gID = validLevel? grid.currentData()[level]->globalIdSet().id(*it) : grid.globalIdSet().id(*it);
-
-        // iterate over vertex's faces and store neighbors' IDs
+        const int gID = validLevel? grid.currentData()[level]->globalIdSet().id(*it) : grid.globalIdSet().id(*it);
+        if (gID >= static_cast<int>(slotOfID.size()))
+        {
+            slotOfID.resize(gID+1, -1);
+        }
+        slotOfID[gID] = it->index();
+        vertexIDs[it->index()] = gID;
+    }
+    initVertices();
 
+    // store neighbors' slots in CSR format
+    edgeOffsets.reserve(numCells+1);
+    edgeTargets.reserve(6*numCells);
+    edgeWeights.reserve(6*numCells);
+    for (int cell = 0; cell < numCells; ++cell)
+    {
+        const auto rowBegin = edgeTargets.size();
         // To access cell_to_face_, face_to_cell_ local ID is needed
-        for (int face_lID=0; face_lID<grid.numCellFaces(it->index(), level); ++face_lID)
+        for (int face_lID=0; face_lID<grid.numCellFaces(cell, level); ++face_lID)
         {
-            const int face  = grid.cellFace(it->index(), face_lID, level);
+            const int face  = grid.cellFace(cell, face_lID, level);
             int otherCell   = grid.faceCell(face, 0, level);
             if (otherCell == -1) // -1 means no cell, face is at boundary
             {
                 continue;
             }
-            if (otherCell == it->index())
+            if (otherCell == cell)
             {
                 otherCell = grid.faceCell(face, 1, level);
             }
@@ -185,87 +209,203 @@ void GraphOfGrid<Dune::CpGrid>::createGraph (const double* transmissibilities,
             } else {
                 weight = 1.;
             }
-            // lookup otherCell gID
-            const auto& otherCellElem = validLevel? Dune::cpgrid::Entity<0>(*(grid.currentData()[level]), otherCell, true) :
-                Dune::cpgrid::Entity<0>(grid.currentLeafData(), otherCell, true);
-            int otherCellgID = validLevel? grid.currentData()[level]->globalIdSet().id(otherCellElem) : grid.globalIdSet().id(otherCellElem);
-            vertex.edges.try_emplace(otherCellgID /*otherCell*/, weight);
+            addEdge(rowBegin, otherCell, weight);
         }
-
-        graph.try_emplace(gID /*it->index()*/, vertex);
+        edgeOffsets.push_back(edgeTargets.size());
     }
+}
 
+template<typename Grid>
+void GraphOfGrid<Grid>::initVertices ()
+{
+    const int numSlots = vertexIDs.size();
+    numVertices = numSlots;
+    parents.resize(numSlots);
+    std::iota(parents.begin(), parents.end(), 0);
+    setSizes.assign(numSlots, 1);
+    vertexWeights.assign(numSlots, 1);
+    edgeOffsets.assign(1, 0);
 }
 
 template<typename Grid>
-int GraphOfGrid<Grid>::contractVertices (int gID1, int gID2)
+void GraphOfGrid<Grid>::addEdge (std::size_t rowBegin, int otherSlot, WeightType weight)
 {
-    // check if the gIDs are in the graph or a well
-    // do nothing if the vertex is not there
-    auto pgID1 = find(gID1);
-    auto pgID2 = find(gID2);
-    if (pgID1==graph.end() || pgID2==graph.end())
+    if (otherSlot == -1)
     {
-        return -1;
+        return;
+    }
+    // cells sharing several faces are connected by the edge of the first face
+    const auto rowEnd = edgeTargets.end();
+    if (std::find(edgeTargets.begin() + rowBegin, rowEnd, otherSlot) == rowEnd)
+    {
+        edgeTargets.push_back(otherSlot);
+        edgeWeights.push_back(weight);
     }
+}
 
-    gID1 = pgID1->first;
-    gID2 = pgID2->first;
-    // ensure that gID1<gID2
-    if (gID1==gID2)
+template<typename Grid>
+int GraphOfGrid<Grid>::findRoot (int gID) const
+{
+    const int slot = slotOf(gID);
+    if (slot == -1)
     {
-        return gID1;
+        return -1;
     }
-    if (gID2<gID1)
+    // vertices contracted into another one are only found through their well
+    const int rootSlot = root(slot);
+    if (vertexIDs[rootSlot] == gID || wellOfRoot.find(rootSlot) != wellOfRoot.end())
     {
-        std::swap(gID1, gID2);
+        return rootSlot;
     }
+    return -1;
+}
 
-    // add up vertex weights
-    graph[gID1].weight += graph[gID2].weight;
+template<typename Grid>
+void GraphOfGrid<Grid>::appendStoredEdges (int rootSlot, std::vector<SlotEdge>& edges) const
+{
+    auto merged = mergedEdges.find(rootSlot);
+    if (merged != mergedEdges.end())
+    {
+        edges.insert(edges.end(), merged->second.begin(), merged->second.end());
+    }
+    else
+    {
+        for (int e = edgeOffsets[rootSlot]; e < edgeOffsets[rootSlot+1]; ++e)
+        {
+            edges.emplace_back(edgeTargets[e], edgeWeights[e]);
+        }
+    }
+}
 
-    // Merge the list of neighbors,
-    // for common neighbors add up edge weights.
-    // Remove the edge between gID1, gID2.
-    auto& v1e = graph[gID1].edges;
-    v1e.erase(gID2);
-    for (const auto& edge : graph[gID2].edges)
+template<typename Grid>
+void GraphOfGrid<Grid>::resolveEdges (int rootSlot, std::vector<SlotEdge>& edges) const
+{
+    for (auto& edge : edges)
     {
-        if (v1e.find(edge.first)==v1e.end())
-        { // new edge
-            if (edge.first != gID1)
-            {
-                v1e.insert(edge);
-                // remap neighbor's edge
-                graph[edge.first].edges.erase(gID2);
-                graph[edge.first].edges.emplace(gID1, edge.second);
-            }
+        edge.first = root(edge.first);
+    }
+    std::erase_if(edges, [rootSlot](const auto& edge) { return edge.first == rootSlot; });
+    std::ranges::sort(edges, {}, &SlotEdge::first);
+    // common neighbors, add up edge weights
+    auto last = edges.begin();
+    for (const auto& edge : edges)
+    {
+        if (last != edges.begin() && std::prev(last)->first == edge.first)
+        {
+            std::prev(last)->second += edge.second;
         }
         else
-        { // common neighbor, add edge weight
-            v1e[edge.first] += edge.second;
-            graph[edge.first].edges.erase(gID2);
-            graph[edge.first].edges[gID1] += edge.second;
+        {
+            *last++ = edge;
         }
     }
+    edges.erase(last, edges.end());
+}
+
+template<typename Grid>
+int GraphOfGrid<Grid>::getEdges (int gID, std::vector<Edge>& edges) const
+{
+    const int rootSlot = findRoot(gID);
+    edges.clear();
+    if (rootSlot == -1)
+    {
+        return -1;
+    }
+    appendStoredEdges(rootSlot, edges);
+    resolveEdges(rootSlot, edges);
+    for (auto& edge : edges)
+    {
+        edge.first = vertexIDs[edge.first];
+    }
+    return edges.size();
+}
 
-    // erase the second vertex to conclude contraction
-    graph.erase(gID2);
-    return gID1;
+template<typename Grid>
+typename GraphOfGrid<Grid>::VertexProperties
+GraphOfGrid<Grid>::vertexProperties (int rootSlot) const
+{
+    VertexProperties vertex;
+    vertex.nproc = rank;
+    vertex.weight = vertexWeights[rootSlot];
+    std::vector<Edge> edges;
+    getEdges(vertexIDs[rootSlot], edges);
+    vertex.edges.insert(edges.begin(), edges.end());
+    return vertex;
 }
 
 template<typename Grid>
-int GraphOfGrid<Grid>::wellID (int gID) const
+int GraphOfGrid<Grid>::contractSlots (const std::vector<int>& slots)
 {
-    for (const auto& w : wells)
+    std::vector<int> roots;
+    roots.reserve(slots.size());
+    for (int slot : slots)
+    {
+        roots.push_back(root(slot));
+    }
+    std::ranges::sort(roots);
+    roots.erase(std::unique(roots.begin(), roots.end()), roots.end());
+    if (roots.size() < 2)
     {
-        auto pgID = w.find(gID);
-        if (pgID!=w.end())
+        return roots.empty() ? -1 : roots.front();
+    }
+
+    // attach the smaller sets to the largest one to keep the trees shallow
+    const int newRoot = *std::ranges::max_element(roots, [this](int a, int b)
+    {
+        return setSizes[a] < setSizes[b]
+            || (setSizes[a] == setSizes[b] && vertexIDs[a] > vertexIDs[b]);
+    });
+
+    std::vector<SlotEdge> edges;
+    WeightType weight = 0;
+    int size = 0;
+    int gID = vertexIDs[newRoot];
+    for (int r : roots)
+    {
+        appendStoredEdges(r, edges);
+        weight += vertexWeights[r];
+        size += setSizes[r];
+        gID = std::min(gID, vertexIDs[r]);
+    }
+    for (int r : roots)
+    {
+        if (r == newRoot)
+        {
+            continue;
+        }
+        parents[r] = newRoot;
+        mergedEdges.erase(r);
+        auto well = wellOfRoot.find(r);
+        if (well != wellOfRoot.end())
         {
-            return *(w.begin()); // well entries are ordered
+            wellOfRoot.try_emplace(newRoot, well->second);
+            wellOfRoot.erase(well);
         }
     }
-    return -1;
+    vertexWeights[newRoot] = weight;
+    setSizes[newRoot] = size;
+    vertexIDs[newRoot] = gID;
+    numVertices -= roots.size() - 1;
+
+    // Merge the lists of neighbors, for common neighbors add up edge
+    // weights, and remove the edges within the contracted set.
+    resolveEdges(newRoot, edges);
+    mergedEdges[newRoot] = std::move(edges);
+    return newRoot;
+}
+
+template<typename Grid>
+int GraphOfGrid<Grid>::contractVertices (int gID1, int gID2)
+{
+    // check if the gIDs are in the graph or a well
+    // do nothing if the vertex is not there
+    const int root1 = findRoot(gID1);
+    const int root2 = findRoot(gID2);
+    if (root1==-1 || root2==-1)
+    {
+        return -1;
+    }
+    return vertexIDs[contractSlots({root1, root2})];
 }
 
 template<typename Grid>
@@ -274,47 +414,51 @@ void GraphOfGrid<Grid>::mergeWellIndices(const std::set<int>& well)
     if (well.empty())
         return;
 
-    int wellIdx = *(well.begin());
     std::set<int> newWell;
+    std::vector<int> slots;
+    slots.reserve(well.size());
     for (int idx : well)
     {
-        // check if the cell is already in some well
-        if (newWell.find(idx) != newWell.end()) {
+        const int slot = slotOf(idx);
+        assert( slot!=-1 && "Added well vertex was not found in the grid (or its wells).");
+        if (slot == -1) {
             continue;
         }
-        for (auto w = wells.begin(); w != wells.end();) {
-            if (w->find(idx) != w->end()) {
-                // idx is in another well => remap it and join wells
-                if ( wellIdx == idx ) {
-                    wellIdx = *(w->begin());
-                }
-                idx = *(w->begin());
-                newWell.insert(w->begin(), w->end());
-                wells.erase(w);
-                break; // GraphOfGrid::wells are constructed to be disjoint, each idx has max 1 match
-            }
-            else {
-                ++w;
-            }
+        // check if the cell is already in some well
+        auto w = wellOfRoot.find(root(slot));
+        if (w != wellOfRoot.end()) {
+            // idx is in another well => join wells
+            newWell.insert(w->second->begin(), w->second->end());
+            wells.erase(w->second);
+            wellOfRoot.erase(w);
         }
-        wellIdx = contractVertices(wellIdx, idx);
-        assert( wellIdx!=-1 && "Added well vertex was not found in the grid (or its wells).");
+        slots.push_back(slot);
     }
     newWell.insert(well.begin(), well.end());
-    wells.push_front(newWell);
+    const int wellRoot = contractSlots(slots);
+    wells.push_front(std::move(newWell));
+    wellOfRoot[wellRoot] = wells.begin();
 }
 
 template<typename Grid>
 void GraphOfGrid<Grid>::contractWellAndAdd(const std::set<int>& well)
 {
-    if (well.empty())
+    std::vector<int> slots;
+    slots.reserve(well.size());
+    for (int gID : well)
+    {
+        const int slot = slotOf(gID);
+        if (slot != -1)
+        {
+            slots.push_back(slot);
+        }
+    }
+    if (slots.empty())
         return;
 
-    int wID = *(well.begin());
-    std::accumulate(well.begin(), well.end(), wID,
-                    [this](const auto wId, const auto gID)
-                    { return contractVertices(wId, gID); });
+    const int wellRoot = contractSlots(slots);
     wells.emplace_front(well);
+    wellOfRoot[wellRoot] = wells.begin();
 }
 
 
@@ -332,17 +476,33 @@ void GraphOfGrid<Grid>::addWell (const std::set<int>& well, bool checkIntersecti
     }
 }
 
+template<typename Grid>
+void GraphOfGrid<Grid>::setCellWeights (const std::vector<WeightType>& cellWeights)
+{
+    if (cellWeights.size() != parents.size())
+    {
+        OPM_THROW(std::invalid_argument, "GraphOfGrid::setCellWeights: need one weight per cell.");
+    }
+    std::fill(vertexWeights.begin(), vertexWeights.end(), 0);
+    for (std::size_t slot = 0; slot < parents.size(); ++slot)
+    {
+        vertexWeights[root(slot)] += cellWeights[slot];
+    }
+}
+
 template<typename Grid>
 void GraphOfGrid<Grid>::addNeighboringCellsToWells ()
 {
     // mark all cells that will be added to wells (addding them one
     // by one would require recursive checks for neighboring wells)
     std::vector<std::set<int>> buffer(wells.size());
+    std::vector<Edge> edges;
     int i=0;
     for (auto& w : wells)
     {
         buffer[i].insert(*w.begin()); // intersects with its well
-        for (const auto& v : edgeList(*w.begin()))
+        getEdges(*w.begin(), edges);
+        for (const auto& v : edges)
         {
             buffer[i].insert(v.first);
         }
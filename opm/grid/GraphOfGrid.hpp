@@ -28,6 +28,14 @@
 
 #include <opm/grid/CpGrid.hpp>
 
+#include <cstddef>
+#include <list>
+#include <map>
+#include <set>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
 namespace Opm {
 
 /// \brief A class storing a graph representation of the grid
@@ -39,6 +47,13 @@ namespace Opm {
 /// Features edge contractions, which adds weights of merged vertices
 /// and of edges to every shared neighbor. Intended use is for loadbalancing
 /// to ensure that no well is split between processes.
+///
+/// The vertices are stored in contiguous arrays indexed by their position
+/// in the grid ("slot") and the edges of the grid in compressed sparse row
+/// format. Contracted vertices form the sets of a union-find structure:
+/// the root of a set carries the summed weight and the merged edge list
+/// of the set, and is reported under the smallest global ID of the set.
+/// Edges are resolved to the roots of their targets when they are read.
 template<typename Grid>
 class GraphOfGrid{
     using WeightType = float;
@@ -52,6 +67,74 @@ class GraphOfGrid{
     };
 
 public:
+    /// \brief An edge given by the neighbor's global ID and the edge weight
+    using Edge = std::pair<int,WeightType>;
+
+    /// \brief Iterator over the vertices, dereferencing to
+    /// a pair of global ID and VertexProperties.
+    ///
+    /// The properties are assembled on dereferencing. Use forEachVertex
+    /// and getEdges when only IDs, weights or edges are needed.
+    class VertexIterator
+    {
+    public:
+        using value_type = std::pair<int,VertexProperties>;
+
+        VertexIterator(const GraphOfGrid* graph, int slot)
+            : graph_(graph), slot_(slot)
+        {
+            skipContracted();
+        }
+
+        value_type operator*() const
+        {
+            return {graph_->vertexIDs[slot_], graph_->vertexProperties(slot_)};
+        }
+
+        struct ArrowProxy
+        {
+            value_type value;
+            const value_type* operator->() const
+            {
+                return &value;
+            }
+        };
+
+        ArrowProxy operator->() const
+        {
+            return {**this};
+        }
+
+        VertexIterator& operator++()
+        {
+            ++slot_;
+            skipContracted();
+            return *this;
+        }
+
+        bool operator==(const VertexIterator& other) const
+        {
+            return slot_ == other.slot_;
+        }
+
+        bool operator!=(const VertexIterator& other) const
+        {
+            return slot_ != other.slot_;
+        }
+
+    private:
+        void skipContracted()
+        {
+            const int numSlots = graph_->parents.size();
+            while (slot_ < numSlots && graph_->parents[slot_] != slot_) {
+                ++slot_;
+            }
+        }
+
+        const GraphOfGrid* graph_;
+        int slot_;
+    };
+
     explicit GraphOfGrid (const Grid& grid_,
                           const double* transmissibilities=nullptr,
                           const Dune::EdgeWeightMethod edgeWeightMethod=Dune::EdgeWeightMethod::defaultTransEdgeWgt,
@@ -69,49 +152,55 @@ public:
     /// \brief Number of graph vertices
     int size () const
     {
-        return graph.size();
+        return numVertices;
     }
 
-    auto begin() const
+    VertexIterator begin() const
     {
-        return graph.begin();
+        return VertexIterator(this, 0);
     }
-    auto end() const
+    VertexIterator end() const
     {
-        return graph.end();
+        return VertexIterator(this, parents.size());
     }
 
     /// \brief Get iterator to the vertex with this global ID
     /// or ID of the well containing it
-    auto find(int gID) const
+    VertexIterator find(int gID) const
     {
-        // search the graph first, and then wells
-        auto pgID = graph.find(gID);
-        if (pgID == graph.end())
-        {
-            gID = wellID(gID);
-            if (gID == -1)
-            {
-                return graph.end();
+        const int root = findRoot(gID);
+        return root == -1 ? end() : VertexIterator(this, root);
+    }
+
+    /// \brief Call f(gID, weight) for each vertex
+    template<class Func>
+    void forEachVertex(Func&& f) const
+    {
+        for (std::size_t slot = 0; slot < parents.size(); ++slot) {
+            if (parents[slot] == static_cast<int>(slot)) {
+                f(vertexIDs[slot], vertexWeights[slot]);
             }
-            pgID = graph.find(gID);
         }
-        return pgID;
     }
 
     /// \brief Return properties of vertex of given ID.
     ///
-    /// If no such vertex exists, returns vertex with
-    /// process -1, weight 0, and empty edgeList.
     /// If the vertex is in a well, return the well's vertex.
-    const VertexProperties& getVertex (int gID) const
+    /// Throws std::logic_error if no such vertex exists.
+    VertexProperties getVertex (int gID) const
     {
-        auto pgID = find(gID);
-        if (pgID == graph.end())
+        const int root = findRoot(gID);
+        if (root == -1)
         {
             OPM_THROW(std::logic_error, "GraphOfGrid::getVertex: gID is not in the graph!");
         }
-        return pgID->second;
+        return vertexProperties(root);
+    }
+
+    /// \brief Rank of the process owning the vertices
+    int getRank () const
+    {
+        return rank;
     }
 
     /// \brief Number of vertices for given vertex
@@ -119,29 +208,28 @@ public:
     // returns -1 if vertex with such global ID is not in the graph (or wells)
     int numEdges (int gID) const
     {
-        auto pgID = find(gID);
-        if (pgID == graph.end())
-        {
-            return -1;
-        }
-        else
-        {
-            return pgID->second.edges.size();
-        }
+        std::vector<Edge> edges;
+        return getEdges(gID, edges);
     }
 
     /// \brief List of neighbors for given vertex
-    const EdgeList& edgeList(int gID) const
+    EdgeList edgeList(int gID) const
     {
-        // get iterator to the vertex or the well containing it
-        auto pgID = find(gID);
-        if (pgID==graph.end())
+        std::vector<Edge> edges;
+        if (getEdges(gID, edges) == -1)
         {
             OPM_THROW(std::logic_error, "GraphOfGrid::edgeList: gID is not in the graph!");
         }
-        return pgID->second.edges;
+        return EdgeList(edges.begin(), edges.end());
     }
 
+    /// \brief Store the edges of given vertex
+    ///
+    /// The buffer is overwritten, so that it can be reused across calls.
+    /// Returns the number of edges or -1 if vertex with such global ID
+    /// is not in the graph (or wells).
+    int getEdges (int gID, std::vector<Edge>& edges) const;
+
     /// \brief Contract two vertices
     ///
     /// Vertex weights are added, and edges are merged. Edge weights
@@ -165,6 +253,12 @@ public:
         return wells;
     }
 
+    /// \brief Set the weights of the grid cells
+    ///
+    /// cellWeights[i] is the weight of the cell with index i. The weight
+    /// of a contracted vertex (e.g. a well) is the sum of its cells' weights.
+    void setCellWeights (const std::vector<WeightType>& cellWeights);
+
     /// \brief Contract a layer of verices around each well into it
     ///
     /// Representing a well by one node guarantees that the well won't
@@ -180,6 +274,9 @@ public:
     }
 
 private:
+    using WellIterator = typename std::list<std::set<int>>::iterator;
+    using SlotEdge = std::pair<int,WeightType>; // <slot, edge weight>
+
     /// \brief Create a graph representation of the grid
     ///
     /// If transmissibilities are not supplied, edge weight=1
@@ -189,11 +286,50 @@ private:
                       const Dune::EdgeWeightMethod edgeWeightMethod=Dune::EdgeWeightMethod::defaultTransEdgeWgt,
                       int level = -1);
 
-    /// \brief Identify the well containing the cell with this global ID
+    /// \brief Initialize the vertex arrays once vertexIDs are filled
+    void initVertices ();
+
+    /// \brief Add an edge to the CSR row starting at rowBegin
+    ///
+    /// Edges to slot -1 and repeated edges are skipped.
+    void addEdge (std::size_t rowBegin, int otherSlot, WeightType weight);
+
+    /// \brief Slot of the vertex with this global ID, or -1
+    int slotOf (int gID) const
+    {
+        return (gID >= 0 && gID < static_cast<int>(slotOfID.size())) ? slotOfID[gID] : -1;
+    }
+
+    /// \brief Root of the set containing the slot
+    int root (int slot) const
+    {
+        while (parents[slot] != slot)
+        {
+            slot = parents[slot];
+        }
+        return slot;
+    }
+
+    /// \brief Root of the vertex with this global ID.
+    ///
+    /// Returns -1 if gID is not in the graph, or if it was contracted into
+    /// another vertex outside of a well.
+    int findRoot (int gID) const;
+
+    /// \brief Append the stored edges of the root, whose targets may
+    /// have been contracted since
+    void appendStoredEdges (int rootSlot, std::vector<SlotEdge>& edges) const;
+
+    /// \brief Replace edge targets by their roots, drop edges to rootSlot,
+    /// and add up weights of edges to the same root
+    void resolveEdges (int rootSlot, std::vector<SlotEdge>& edges) const;
+
+    VertexProperties vertexProperties (int rootSlot) const;
+
+    /// \brief Contract the sets of the given slots into one
     ///
-    /// returns the smallest cell-ID in the well or
-    /// returns -1 if no well contains given gID
-    int wellID (int gID) const;
+    /// Returns the root of the contracted set.
+    int contractSlots (const std::vector<int>& slots);
 
     /// \brief Merge the given well with any overlapping existing wells and contract all vertices.
     ///
@@ -211,8 +347,22 @@ private:
     void contractWellAndAdd(const std::set<int>& well);
 
     const Grid& grid;
-    std::unordered_map<int, VertexProperties> graph; // <gID, VertexProperties>
+    int rank = 0;
+    int numVertices = 0;
+    // per slot; for a root vertexIDs holds the smallest gID of its set
+    std::vector<int> vertexIDs;
+    std::vector<int> slotOfID; // <gID, slot>, -1 for IDs not in the graph
+    std::vector<int> parents;
+    std::vector<int> setSizes;
+    std::vector<WeightType> vertexWeights;
+    // edges of the grid in CSR format, targets are slots
+    std::vector<int> edgeOffsets;
+    std::vector<int> edgeTargets;
+    std::vector<WeightType> edgeWeights;
+    // merged edges of contracted roots, replacing their CSR rows
+    std::unordered_map<int, std::vector<SlotEdge>> mergedEdges;
     std::list<std::set<int>> wells;
+    std::unordered_map<int, WellIterator> wellOfRoot; // <root slot, well>
 };
 
 } // namespace Opm
@@ -26,6 +26,7 @@
 #include <config.h>
 #include "GraphOfGridWrappers.hpp"
 #include <opm/grid/common/CommunicationUtils.hpp>
+#include <opm/grid/common/GridPartitioning.hpp> // cell weights
 #include <opm/grid/common/ZoltanPartition.hpp> // function scatterExportInformation
 #include <opm/grid/common/ZoltanGraphFunctions.hpp> // makeImportAndExportLists when allowDistributedWells==true
 
@@ -53,13 +54,13 @@ void getGraphOfGridVerticesList(void* pGraph,
     assert(weightDim==1); // vertex weight is a single float
     const GraphOfGrid<Dune::CpGrid>& gog = *static_cast<const GraphOfGrid<Dune::CpGrid>*>(pGraph);
     int i=0;
-    for (const auto& v : gog)
+    gog.forEachVertex([&i, gIDs, objWeights](int gID, float weight)
     {
-        gIDs[i] = v.first;
+        gIDs[i] = gID;
         // lIDs are left unused
-        objWeights[i] = v.second.weight;
+        objWeights[i] = weight;
         ++i;
-    }
+    });
     *err = ZOLTAN_OK;
 }
 
@@ -74,9 +75,10 @@ void getGraphOfGridNumEdges(void *pGraph,
 {
     assert(dimGlobalID==1); // ID is a single int
     const GraphOfGrid<Dune::CpGrid>& gog = *static_cast<const GraphOfGrid<Dune::CpGrid>*>(pGraph);
+    std::vector<std::pair<int,float>> eList;
     for (int i=0; i<numCells; ++i)
     {
-        int nE = gog.numEdges(gIDs[i]);
+        int nE = gog.getEdges(gIDs[i], eList);
         if (nE== -1)
         {
             std::ostringstream ostr;
@@ -106,10 +108,12 @@ void getGraphOfGridEdgeList(void *pGraph,
     assert(dimGlobalID==1); // ID is a single int
     assert(weightDim==1); // edge weight is a single float
     const GraphOfGrid<Dune::CpGrid>&  gog = *static_cast<const GraphOfGrid<Dune::CpGrid>*>(pGraph);
+    const int rank = gog.getRank();
+    std::vector<std::pair<int,float>> eList;
     int id=0;
     for (int i=0; i<numCells; ++i)
     {
-        const auto& eList = gog.edgeList(gIDs[i]);
+        gog.getEdges(gIDs[i], eList);
         if ((int)eList.size()!=numEdges[i])
         {
             std::ostringstream ostr;
@@ -123,7 +127,7 @@ void getGraphOfGridEdgeList(void *pGraph,
         for (const auto& e : eList)
         {
             nborGIDs[id]= e.first;
-            nborProc[id]= gog.getVertex(e.first).nproc;
+            nborProc[id]= rank;
             edgeWeights[id]= e.second;
             ++id;
         }
@@ -334,6 +338,108 @@ std::vector<int> communicateExportedCells(const std::vector<std::vector<int>>& e
     return result;
 }
 
+GraphOfGridPiece distributeGraphOfGrid(const GraphOfGrid<Dune::CpGrid>& gog,
+                                       const Dune::cpgrid::CpGridDataTraits::Communication& cc,
+                                       int root)
+{
+    // for each rank: numbers of vertices and edges, vertex IDs, numbers of
+    // edges of each vertex, neighbors' IDs and neighbors' ranks
+    std::vector<std::vector<int>> intData;
+    // for each rank: vertex weights and edge weights
+    std::vector<std::vector<float>> floatData;
+    if (cc.rank()==root)
+    {
+        const int numRanks = cc.size();
+        std::vector<int> vertexIDs;
+        std::vector<float> vertexWeights;
+        vertexIDs.reserve(gog.size());
+        vertexWeights.reserve(gog.size());
+        double totalWeight = 0;
+        int maxID = -1;
+        gog.forEachVertex([&](int gID, float weight)
+        {
+            vertexIDs.push_back(gID);
+            vertexWeights.push_back(weight);
+            totalWeight += weight;
+            maxID = std::max(maxID, gID);
+        });
+
+        // cut the vertices into slabs of equal weight
+        std::vector<int> vertexRank(maxID+1, -1); // indexed by vertex ID
+        std::vector<std::vector<int>> verticesOnRank(numRanks);
+        double weightBefore = 0;
+        for (std::size_t i=0; i<vertexIDs.size(); ++i)
+        {
+            const double middle = weightBefore + 0.5*vertexWeights[i];
+            const int rank = std::min(numRanks-1, static_cast<int>(numRanks*middle/totalWeight));
+            vertexRank[vertexIDs[i]] = rank;
+            verticesOnRank[rank].push_back(i);
+            weightBefore += vertexWeights[i];
+        }
+
+        intData.resize(numRanks);
+        floatData.resize(numRanks);
+        std::vector<std::pair<int,float>> edges;
+        for (int rank=0; rank<numRanks; ++rank)
+        {
+            const auto& vertices = verticesOnRank[rank];
+            std::vector<int> numEdges, nborGIDs, nborProcs;
+            std::vector<float> edgeWeights;
+            numEdges.reserve(vertices.size());
+            for (int i : vertices)
+            {
+                gog.getEdges(vertexIDs[i], edges);
+                numEdges.push_back(edges.size());
+                for (const auto& [nborGID, weight] : edges)
+                {
+                    nborGIDs.push_back(nborGID);
+                    nborProcs.push_back(vertexRank[nborGID]);
+                    edgeWeights.push_back(weight);
+                }
+            }
+            auto& ints = intData[rank];
+            ints.reserve(2 + 2*vertices.size() + 2*nborGIDs.size());
+            ints.push_back(vertices.size());
+            ints.push_back(nborGIDs.size());
+            for (int i : vertices)
+            {
+                ints.push_back(vertexIDs[i]);
+            }
+            ints.insert(ints.end(), numEdges.begin(), numEdges.end());
+            ints.insert(ints.end(), nborGIDs.begin(), nborGIDs.end());
+            ints.insert(ints.end(), nborProcs.begin(), nborProcs.end());
+            auto& floats = floatData[rank];
+            floats.reserve(vertices.size() + edgeWeights.size());
+            for (int i : vertices)
+            {
+                floats.push_back(vertexWeights[i]);
+            }
+            floats.insert(floats.end(), edgeWeights.begin(), edgeWeights.end());
+        }
+    }
+
+    const auto ints = Opm::scatterv(intData, cc, root);
+    const auto floats = Opm::scatterv(floatData, cc, root);
+    intData.clear();
+    floatData.clear();
+
+    GraphOfGridPiece piece;
+    const int numVertices = ints[0];
+    const int numEdges = ints[1];
+    auto pInt = ints.begin() + 2;
+    piece.gIDs.assign(pInt, pInt + numVertices);
+    pInt += numVertices;
+    piece.edgeOffsets.resize(numVertices+1);
+    std::partial_sum(pInt, pInt + numVertices, piece.edgeOffsets.begin()+1);
+    pInt += numVertices;
+    piece.nborGIDs.assign(pInt, pInt + numEdges);
+    pInt += numEdges;
+    piece.nborProcs.assign(pInt, pInt + numEdges);
+    piece.weights.assign(floats.begin(), floats.begin() + numVertices);
+    piece.edgeWeights.assign(floats.begin() + numVertices, floats.end());
+    return piece;
+}
+
 void extendAndSortImportList(std::vector<std::tuple<int,int,char,int>>& importList,
                              const std::vector<int>& extraCells)
 {
@@ -510,6 +616,151 @@ void setDefaultZoltanParameters(Zoltan_Struct* zz)
 #endif
 }
 
+int getGraphOfGridPieceNumVertices(void* pPiece, int *err)
+{
+    const auto& piece = *static_cast<const Impl::GraphOfGridPiece*>(pPiece);
+    *err = ZOLTAN_OK;
+    return piece.gIDs.size();
+}
+
+void getGraphOfGridPieceVerticesList(void* pPiece,
+                    [[maybe_unused]] int dimGlobalID,
+                    [[maybe_unused]] int dimLocalID,
+                                     ZOLTAN_ID_PTR gIDs,
+                                     ZOLTAN_ID_PTR lIDs,
+                    [[maybe_unused]] int weightDim,
+                                     float *objWeights,
+                                     int *err)
+{
+    assert(dimGlobalID==1 && dimLocalID==1);
+    assert(weightDim==1);
+    const auto& piece = *static_cast<const Impl::GraphOfGridPiece*>(pPiece);
+    for (std::size_t i=0; i<piece.gIDs.size(); ++i)
+    {
+        gIDs[i] = piece.gIDs[i];
+        lIDs[i] = i;
+        objWeights[i] = piece.weights[i];
+    }
+    *err = ZOLTAN_OK;
+}
+
+void getGraphOfGridPieceNumEdges(void *pPiece,
+                [[maybe_unused]] int dimGlobalID,
+                [[maybe_unused]] int dimLocalID,
+                                 int numCells,
+                [[maybe_unused]] ZOLTAN_ID_PTR gIDs,
+                                 ZOLTAN_ID_PTR lIDs,
+                                 int *numEdges,
+                                 int *err)
+{
+    const auto& piece = *static_cast<const Impl::GraphOfGridPiece*>(pPiece);
+    for (int i=0; i<numCells; ++i)
+    {
+        numEdges[i] = piece.edgeOffsets[lIDs[i]+1] - piece.edgeOffsets[lIDs[i]];
+    }
+    *err = ZOLTAN_OK;
+}
+
+void getGraphOfGridPieceEdgeList(void *pPiece,
+                [[maybe_unused]] int dimGlobalID,
+                [[maybe_unused]] int dimLocalID,
+                                 int numCells,
+                [[maybe_unused]] ZOLTAN_ID_PTR gIDs,
+                                 ZOLTAN_ID_PTR lIDs,
+                [[maybe_unused]] int *numEdges,
+                                 ZOLTAN_ID_PTR nborGIDs,
+                                 int *nborProc,
+                [[maybe_unused]] int weightDim,
+                                 float *edgeWeights,
+                                 int *err)
+{
+    assert(weightDim==1);
+    const auto& piece = *static_cast<const Impl::GraphOfGridPiece*>(pPiece);
+    int id=0;
+    for (int i=0; i<numCells; ++i)
+    {
+        for (int e=piece.edgeOffsets[lIDs[i]]; e<piece.edgeOffsets[lIDs[i]+1]; ++e)
+        {
+            nborGIDs[id] = piece.nborGIDs[e];
+            nborProc[id] = piece.nborProcs[e];
+            edgeWeights[id] = piece.edgeWeights[e];
+            ++id;
+        }
+    }
+    *err = ZOLTAN_OK;
+}
+
+/// \brief Partition the graph on root with its vertices spread over all ranks
+///
+/// \return On root the vertices that leave root and the ranks they go to,
+///         on other ranks the vertices they receive from root,
+///         i.e. what Zoltan returns when partitioning a graph held by root.
+std::tuple<std::vector<int>, std::vector<int>, std::vector<int>>
+partitionDistributedGraph(Zoltan_Struct* zz,
+                          const GraphOfGrid<Dune::CpGrid>& gog,
+                          const Dune::cpgrid::CpGridDataTraits::Communication& cc,
+                          int root)
+{
+    auto piece = Impl::distributeGraphOfGrid(gog, cc, root);
+
+    Zoltan_Set_Param(zz, "NUM_LID_ENTRIES", "1");
+    Zoltan_Set_Num_Obj_Fn(zz, getGraphOfGridPieceNumVertices, &piece);
+    Zoltan_Set_Obj_List_Fn(zz, getGraphOfGridPieceVerticesList, &piece);
+    Zoltan_Set_Num_Edges_Multi_Fn(zz, getGraphOfGridPieceNumEdges, &piece);
+    Zoltan_Set_Edge_List_Multi_Fn(zz, getGraphOfGridPieceEdgeList, &piece);
+
+    int changes, numGidEntries, numLidEntries, numImport, numExport;
+    ZOLTAN_ID_PTR importGlobalGids, importLocalGids, exportGlobalGids, exportLocalGids;
+    int *importProcs, *importToPart, *exportProcs, *exportToPart;
+    int rc = Zoltan_LB_Partition(zz, &changes, &numGidEntries, &numLidEntries,
+                                 &numImport, &importGlobalGids, &importLocalGids, &importProcs, &importToPart,
+                                 &numExport, &exportGlobalGids, &exportLocalGids, &exportProcs, &exportToPart);
+    if (rc == ZOLTAN_WARN) {
+        OpmLog::warning("Zoltan_LB_Partition returned with warning");
+    } else if (rc == ZOLTAN_MEMERR) {
+        OPM_THROW(std::runtime_error, "Memory allocation failure in Zoltan_LB_Partition");
+    } else if (rc == ZOLTAN_FATAL) {
+        OPM_THROW(std::runtime_error, "Error returned from Zoltan_LB_Partition");
+    }
+
+    // the new rank of each vertex held here, as pairs <gID, rank>
+    std::vector<int> vertexRanks(2*piece.gIDs.size());
+    for (std::size_t i=0; i<piece.gIDs.size(); ++i)
+    {
+        vertexRanks[2*i] = piece.gIDs[i];
+        vertexRanks[2*i+1] = cc.rank();
+    }
+    for (int i=0; i<numExport; ++i)
+    {
+        vertexRanks[2*exportLocalGids[i]+1] = exportToPart[i];
+    }
+    Zoltan_LB_Free_Part(&exportGlobalGids, &exportLocalGids, &exportProcs, &exportToPart);
+    Zoltan_LB_Free_Part(&importGlobalGids, &importLocalGids, &importProcs, &importToPart);
+    piece = Impl::GraphOfGridPiece();
+
+    // collect the partition on root and express it as moves from root
+    std::vector<int> exportGids, exportToRank;
+    std::vector<std::vector<int>> exportedVertices;
+    const auto allVertexRanks = Opm::gatherv(vertexRanks, cc, root).first;
+    if (cc.rank()==root)
+    {
+        exportedVertices.resize(cc.size());
+        for (std::size_t i=0; i<allVertexRanks.size(); i+=2)
+        {
+            const int gID = allVertexRanks[i];
+            const int rank = allVertexRanks[i+1];
+            if (rank!=root)
+            {
+                exportGids.push_back(gID);
+                exportToRank.push_back(rank);
+                exportedVertices[rank].push_back(gID);
+            }
+        }
+    }
+    auto importGids = Impl::communicateExportedCells(exportedVertices, cc, root);
+    return std::make_tuple(std::move(exportGids), std::move(exportToRank), std::move(importGids));
+}
+
 } // anon namespace
 
 std::tuple<std::vector<int>,
@@ -527,7 +778,8 @@ zoltanPartitioningWithGraphOfGrid(const Dune::CpGrid& grid,
                                   const double zoltanImbalanceTol,
                                   bool allowDistributedWells,
                                   const std::map<std::string, std::string>& params,
-                                  int level)
+                                  int level,
+                                  const std::vector<double>& cellWeights)
 {
     float ver = 0;
     struct Zoltan_Struct *zz;
@@ -547,21 +799,29 @@ zoltanPartitioningWithGraphOfGrid(const Dune::CpGrid& grid,
     setDefaultZoltanParameters(zz);
     Zoltan_Set_Param(zz, "IMBALANCE_TOL", std::to_string(zoltanImbalanceTol).c_str());
     int layers = 0; // extra layers of cells attached to wells to distance them from boundary
+    bool distributeGraph = false; // spread the graph over all ranks before partitioning
     for (const auto& [key, value] : params)
     {
         if (key=="EnvelopeWellLayers")
             layers = std::stoi(value);
+        else if (key=="DistributeGraph")
+            distributeGraph = (value=="true" || value=="1");
         else
             Zoltan_Set_Param(zz, key.c_str(), value.c_str());
     }
 
     // root process has the whole grid, other ranks nothing
     bool partitionIsEmpty = cc.rank()!=root;
+    const int weightDim = Dune::cpgrid::cellWeightDimension(grid, cellWeights, cc, root, level);
 
     // prepare graph and contract well cells
     // non-root processes have empty grid and no wells
     GraphOfGrid gog(grid, transmissibilities, edgeWeightMethod, level);
     assert(gog.size()==0 || !partitionIsEmpty);
+    if (weightDim > 0 && !partitionIsEmpty) {
+        const auto combined = Dune::cpgrid::combinedCellWeights(cellWeights, weightDim);
+        gog.setCellWeights(std::vector<float>(combined.begin(), combined.end()));
+    }
     auto wellConnections = partitionIsEmpty || !wells ? Dune::cpgrid::WellConnections()
                                                       : Dune::cpgrid::WellConnections(*wells, possibleFutureConnections, grid);
     if (!allowDistributedWells){
@@ -570,32 +830,10 @@ zoltanPartitioningWithGraphOfGrid(const Dune::CpGrid& grid,
         gog.addNeighboringCellsToWells(layers);
     }
 
-    // call partitioner
-    setGraphOfGridZoltanGraphFunctions(zz, gog, partitionIsEmpty);
-    rc = Zoltan_LB_Partition(zz, /* input (all remaining fields are output) */
-                             &changes,        /* 1 if partitioning was changed, 0 otherwise */
-                             &numGidEntries,  /* Number of integers used for a global ID */
-                             &numLidEntries,  /* Number of integers used for a local ID */
-                             &numImport,      /* Number of vertices to be sent to me */
-                             &importGlobalGids,  /* Global IDs of vertices to be sent to me */
-                             &importLocalGids,   /* Local IDs of vertices to be sent to me */
-                             &importProcs,    /* Process rank for source of each incoming vertex */
-                             &importToPart,   /* New partition for each incoming vertex */
-                             &numExport,      /* Number of vertices I must send to other processes*/
-                             &exportGlobalGids,  /* Global IDs of the vertices I must send */
-                             &exportLocalGids,   /* Local IDs of the vertices I must send */
-                             &exportProcs,    /* Process to which I send each of the vertices */
-                             &exportToPart);  /* Partition to which each vertex will belong */
-    if (rc == ZOLTAN_WARN) {
-        OpmLog::warning("Zoltan_LB_Partition returned with warning");
-    } else if (rc == ZOLTAN_MEMERR) {
-        OPM_THROW(std::runtime_error, "Memory allocation failure in Zoltan_LB_Partition");
-    } else if (rc == ZOLTAN_FATAL) {
-        OPM_THROW(std::runtime_error, "Error returned from Zoltan_LB_Partition");
-    }
-
     // arrange output into tuples and add well cells
-    auto prepareIELists = [&]() {
+    auto prepareIELists = [&](int numExport, int numImport,
+                              const auto* exportLocalGids, const auto* exportGlobalGids,
+                              const int* exportProcs, const auto* importGlobalGids) {
         if (allowDistributedWells) {
             // wells can be split among several processes
             using CombinedGridWellGraph = Dune::cpgrid::CombinedGridWellGraph;
@@ -645,7 +883,42 @@ zoltanPartitioningWithGraphOfGrid(const Dune::CpGrid& grid,
                               std::move(wellConnections));
         }
     };
-    auto importExportLists = prepareIELists();
+    if (distributeGraph)
+    {
+        const auto [exportGids, exportToRank, importGids] = partitionDistributedGraph(zz, gog, cc, root);
+        auto importExportLists = prepareIELists(exportGids.size(), importGids.size(),
+                                                exportGids.data(), exportGids.data(),
+                                                exportToRank.data(), importGids.data());
+        Zoltan_Destroy(&zz);
+        return importExportLists;
+    }
+
+    // call partitioner
+    setGraphOfGridZoltanGraphFunctions(zz, gog, partitionIsEmpty);
+    rc = Zoltan_LB_Partition(zz, /* input (all remaining fields are output) */
+                             &changes,        /* 1 if partitioning was changed, 0 otherwise */
+                             &numGidEntries,  /* Number of integers used for a global ID */
+                             &numLidEntries,  /* Number of integers used for a local ID */
+                             &numImport,      /* Number of vertices to be sent to me */
+                             &importGlobalGids,  /* Global IDs of vertices to be sent to me */
+                             &importLocalGids,   /* Local IDs of vertices to be sent to me */
+                             &importProcs,    /* Process rank for source of each incoming vertex */
+                             &importToPart,   /* New partition for each incoming vertex */
+                             &numExport,      /* Number of vertices I must send to other processes*/
+                             &exportGlobalGids,  /* Global IDs of the vertices I must send */
+                             &exportLocalGids,   /* Local IDs of the vertices I must send */
+                             &exportProcs,    /* Process to which I send each of the vertices */
+                             &exportToPart);  /* Partition to which each vertex will belong */
+    if (rc == ZOLTAN_WARN) {
+        OpmLog::warning("Zoltan_LB_Partition returned with warning");
+    } else if (rc == ZOLTAN_MEMERR) {
+        OPM_THROW(std::runtime_error, "Memory allocation failure in Zoltan_LB_Partition");
+    } else if (rc == ZOLTAN_FATAL) {
+        OPM_THROW(std::runtime_error, "Error returned from Zoltan_LB_Partition");
+    }
+
+    auto importExportLists = prepareIELists(numExport, numImport, exportLocalGids, exportGlobalGids,
+                                            exportProcs, importGlobalGids);
 
     Zoltan_LB_Free_Part(&exportGlobalGids, &exportLocalGids, &exportProcs, &exportToPart);
     Zoltan_LB_Free_Part(&importGlobalGids, &importLocalGids, &importProcs, &importToPart);
@@ -679,7 +952,8 @@ applySerialZoltan (const Dune::CpGrid& grid,
                    int root,
                    const double zoltanImbalanceTol,
                    bool allowDistributedWells,
-                   const std::map<std::string, std::string>& params)
+                   const std::map<std::string, std::string>& params,
+                   const std::vector<float>& cellWeights)
 {
     int rc = ZOLTAN_OK;
     ZOLTAN_ID_PTR importGlobalGids, importLocalGids, exportGlobalGids, exportLocalGids;
@@ -712,6 +986,9 @@ applySerialZoltan (const Dune::CpGrid& grid,
 
     // prepare graph and contract well cells
     GraphOfGrid gog(grid, transmissibilities, edgeWeightMethod);
+    if (!cellWeights.empty()) {
+        gog.setCellWeights(cellWeights);
+    }
     if (!allowDistributedWells){
         // skip cell contraction if wells can be distributed over multiple processes
         addWellConnections(gog, wellConnections);
@@ -766,10 +1043,12 @@ zoltanSerialPartitioningWithGraphOfGrid(const Dune::CpGrid& grid,
                                         int root,
                                         const double zoltanImbalanceTol,
                                         bool allowDistributedWells,
-                                        const std::map<std::string, std::string>& params)
+                                        const std::map<std::string, std::string>& params,
+                                        const std::vector<double>& cellWeights)
 {
     // root process has the whole grid, other ranks nothing
     bool partitionIsEmpty = cc.rank() != root;
+    const int weightDim = Dune::cpgrid::cellWeightDimension(grid, cellWeights, cc, root);
     int rc = ZOLTAN_OK;
     std::vector<int> gIDtoRank;
     using AttributeSet = Dune::cpgrid::CpGridData::AttributeSet;
@@ -780,6 +1059,8 @@ zoltanSerialPartitioningWithGraphOfGrid(const Dune::CpGrid& grid,
                                                       : Dune::cpgrid::WellConnections(*wells, possibleFutureConnections, grid);
 
     if (cc.rank() == root) {
+        const auto combined = weightDim > 0 ? Dune::cpgrid::combinedCellWeights(cellWeights, weightDim)
+                                            : std::vector<double>();
         std::tie(rc, gIDtoRank) = applySerialZoltan(grid,
                                                     wellConnections,
                                                     transmissibilities,
@@ -788,7 +1069,8 @@ zoltanSerialPartitioningWithGraphOfGrid(const Dune::CpGrid& grid,
                                                     root,
                                                     zoltanImbalanceTol,
                                                     allowDistributedWells,
-                                                    params);
+                                                    params,
+                                                    std::vector<float>(combined.begin(), combined.end()));
     }
 
     cc.broadcast(&rc, 1, root);
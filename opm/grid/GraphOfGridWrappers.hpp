@@ -172,6 +172,32 @@ extendRootExportList(const GraphOfGrid<Dune::CpGrid>& gog,
 std::vector<int> communicateExportedCells(const std::vector<std::vector<int>>& exportedCells,
                                           const Dune::cpgrid::CpGridDataTraits::Communication& cc,
                                           int root);
+
+/// \brief The vertices of a GraphOfGrid held by one process
+///
+/// Edges of vertex i are stored in [edgeOffsets[i], edgeOffsets[i+1])
+/// and may point to vertices held by any process, whose rank is in nborProcs.
+struct GraphOfGridPiece
+{
+    std::vector<int> gIDs;
+    std::vector<float> weights;
+    std::vector<int> edgeOffsets{0};
+    std::vector<int> nborGIDs;
+    std::vector<int> nborProcs;
+    std::vector<float> edgeWeights;
+};
+
+/// \brief Spread the vertices of the graph on root over all ranks
+///
+/// This is the initial split for partitioning a distributed graph.
+/// The vertices are cut in the order of their cells into slabs of about
+/// equal total vertex weight, which for Cartesian ordering are layers of
+/// the grid. Contracted wells are single vertices and stay whole.
+/// \param gog The graph, empty on non-root ranks
+/// \return The vertices held by this rank
+GraphOfGridPiece distributeGraphOfGrid(const GraphOfGrid<Dune::CpGrid>& gog,
+                                       const Dune::cpgrid::CpGridDataTraits::Communication& cc,
+                                       int root);
 } // end namespace Impl
 
 /// \brief Add well cells' global IDs to the root's export and others' import list
@@ -258,6 +284,12 @@ makeImportAndExportLists(const GraphOfGrid<Dune::CpGrid>& gog,
 ///
 /// GraphOfGrid represents a well by one vertex, so wells can not be
 /// spread over several processes.
+/// The graph is built on root. With the parameter "DistributeGraph" set
+/// to "true", its vertices are first spread over all ranks by
+/// Impl::distributeGraphOfGrid and Zoltan partitions the distributed
+/// graph in parallel. Otherwise Zoltan partitions the graph held by root.
+/// The optional cellWeights on root (see Dune::cpgrid::cellWeightDimension)
+/// are summed per cell and become the vertex weights.
 std::tuple<std::vector<int>, std::vector<std::pair<std::string, bool>>,
            std::vector<std::tuple<int,int,char> >,
            std::vector<std::tuple<int,int,char,int> >,
@@ -272,7 +304,8 @@ zoltanPartitioningWithGraphOfGrid(const Dune::CpGrid& grid,
                                   const double zoltanImbalanceTol,
                                   bool allowDistributedWells,
                                   const std::map<std::string,std::string>& params,
-                                  int level);
+                                  int level,
+                                  const std::vector<double>& cellWeights = {});
 
 /// \brief Make complete export lists from a vector holding destination rank for each global ID
 ///
@@ -288,6 +321,8 @@ makeExportListsFromGIDtoRank(const std::vector<int>& gIDtoRank, int ccsize);
 ///
 /// GraphOfGrid represents a well by one vertex, so wells can not be
 /// spread over several processes.
+/// The optional cellWeights on root are summed per cell and become the
+/// vertex weights.
 std::tuple<std::vector<int>, std::vector<std::pair<std::string, bool>>,
            std::vector<std::tuple<int,int,char> >,
            std::vector<std::tuple<int,int,char,int> >,
@@ -301,7 +336,8 @@ zoltanSerialPartitioningWithGraphOfGrid(const Dune::CpGrid& grid,
                                         int root,
                                         const double zoltanImbalanceTol,
                                         bool allowDistributedWells,
-                                        const std::map<std::string,std::string>& params);
+                                        const std::map<std::string,std::string>& params,
+                                        const std::vector<double>& cellWeights = {});
 #endif // HAVE_MPI
 
 } // end namespace Opm
@@ -25,6 +25,10 @@
 #include <cassert>
 #include <stdexcept>
 
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
 namespace Opm {
 
 
@@ -39,7 +43,16 @@ void MinpvProcessor::Result::add_nnc(int cell1, int cell2)
 MinpvProcessor::MinpvProcessor(const int nx, const int ny, const int nz) :
     dims_( {{nx,ny,nz}} ),
     delta_( {{1 , 2*nx , 4*nx*ny}} )
-{ }
+{
+#ifdef _OPENMP
+    num_threads_ = omp_get_max_threads();
+#endif
+}
+
+void MinpvProcessor::setNumThreads(const int num_threads)
+{
+    num_threads_ = std::max(num_threads, 1);
+}
 
 double MinpvProcessor::computeGap(const std::array<double,8>& coord_above,
                                   const std::array<double,8>& coord_below) const
@@ -98,8 +111,6 @@ MinpvProcessor::process(const std::vector<double>& thickness,
     //    to infinity.
 
 
-    Result result;
-
     // Check for sane input sizes.
     const size_t log_size = dims_[0] * dims_[1] * dims_[2];
     if (pv.size() != log_size) {
@@ -113,224 +124,261 @@ MinpvProcessor::process(const std::vector<double>& thickness,
                   "If option 4 of PINCH keyword is ALL, then the deck needs to specify PERMZ or PERMX");
         }
 
-    // Main loop.
-    for (int jj = 0; jj < dims_[1]; ++jj) {
-        for (int ii = 0; ii < dims_[0]; ++ii) {
-            for (int kk = 0; kk < dims_[2]; ++kk) {
-                // For a corner case for option ALL
-                // where one of the cells in-between has 0 transmissibility
-                // we will omit the nnc
-                bool option4ALLZero = false;
-                const int c = ii + dims_[0] * (jj + dims_[1] * kk);
-                bool c_active = actnum.empty() || actnum[c];
-                bool c_thin = (thickness[c] <= z_tolerance);
-                bool c_thin_inactive = !c_active && c_thin;
-                bool c_low_pv_active = pv[c] < minpvv[c] && c_active;
-
-                if (c_low_pv_active || c_thin_inactive) {
-                    std::array<double, 8> cz = getCellZcorn(ii, jj, kk, zcorn);
-                    // Cell is either inactive or made inactive due to MINPV
-
-                    // Move deeper (higher k) coordinates to lower k coordinates.
-                    // i.e remove the cell
-                    for (int count = 0; count < 4; ++count) {
-                        cz[count + 4] = cz[count];
-                    }
-                    setCellZcorn(ii, jj, kk, cz, zcorn);
+    // Columns of cells with the same (i, j) touch disjoint parts of zcorn
+    // and are processed independently; only the result is shared.
+    auto processColumn = [&](const int ii, const int jj, Result& result)
+    {
+        for (int kk = 0; kk < dims_[2]; ++kk) {
+            // For a corner case for option ALL
+            // where one of the cells in-between has 0 transmissibility
+            // we will omit the nnc
+            bool option4ALLZero = false;
+            const int c = ii + dims_[0] * (jj + dims_[1] * kk);
+            bool c_active = actnum.empty() || actnum[c];
+            bool c_thin = (thickness[c] <= z_tolerance);
+            bool c_thin_inactive = !c_active && c_thin;
+            bool c_low_pv_active = pv[c] < minpvv[c] && c_active;
+
+            if (c_low_pv_active || c_thin_inactive) {
+                std::array<double, 8> cz = getCellZcorn(ii, jj, kk, zcorn);
+                // Cell is either inactive or made inactive due to MINPV
+
+                // Move deeper (higher k) coordinates to lower k coordinates.
+                // i.e remove the cell
+                for (int count = 0; count < 4; ++count) {
+                    cz[count + 4] = cz[count];
+                }
+                setCellZcorn(ii, jj, kk, cz, zcorn);
 
-                    if (c_low_pv_active) {
-                        // Inactive due to MINPV mark it as removed
-                        result.removed_cells.push_back(c);
-                    }
+                if (c_low_pv_active) {
+                    // Inactive due to MINPV mark it as removed
+                    result.removed_cells.push_back(c);
+                }
 
-                    if (kk == dims_[2] - 1) {
-                        // this is cell at the bottom of the grid
-                        // no neighbor below for an NNC.
-                        continue;
-                    }
+                if (kk == dims_[2] - 1) {
+                    // this is cell at the bottom of the grid
+                    // no neighbor below for an NNC.
+                    continue;
+                }
 
-                    // In the case of PinchNOGAP this cell must be thin to allow NNCs, if it was deactivated
-                    // via PINCH, too.
-                    // In addition skip NNC if PINCH option 4 is ALL and we know that Z transmissibilty will
-                    // be zero because of multz or permz
-                    bool nnc_allowed = (!c_low_pv_active || (!pinchNOGAP || thickness[c] <= z_tolerance))
-                        && (!pinchOption4ALL || (permz[c] != 0.0 && multz(c) != 0.0) );
+                // In the case of PinchNOGAP this cell must be thin to allow NNCs, if it was deactivated
+                // via PINCH, too.
+                // In addition skip NNC if PINCH option 4 is ALL and we know that Z transmissibilty will
+                // be zero because of multz or permz
+                bool nnc_allowed = (!c_low_pv_active || (!pinchNOGAP || thickness[c] <= z_tolerance))
+                    && (!pinchOption4ALL || (permz[c] != 0.0 && multz(c) != 0.0) );
 
-                    if (pinchOption4ALL)
-                    {
-                        option4ALLZero = option4ALLZero || (!permz.empty() && permz[c] == 0) || multz(c) == 0;
-                    }
+                if (pinchOption4ALL)
+                {
+                    option4ALLZero = option4ALLZero || (!permz.empty() && permz[c] == 0) || multz(c) == 0;
+                }
 
-                    // Find the next cell below
-                    int kk_iter = kk + 1;
+                // Find the next cell below
+                int kk_iter = kk + 1;
 
-                    int c_below = ii + dims_[0] * (jj + dims_[1] * (kk_iter));
-                    bool active = actnum.empty() || actnum[c_below];
-                    bool thin = (thickness[c_below] <= z_tolerance);
-                    bool thin_inactive = !active && thin;
-                    bool low_pv_active = pv[c_below] < minpvv[c_below] && active;
+                int c_below = ii + dims_[0] * (jj + dims_[1] * (kk_iter));
+                bool active = actnum.empty() || actnum[c_below];
+                bool thin = (thickness[c_below] <= z_tolerance);
+                bool thin_inactive = !active && thin;
+                bool low_pv_active = pv[c_below] < minpvv[c_below] && active;
 
 
-                    while ( (thin_inactive || low_pv_active) && kk_iter < dims_[2] )
+                while ( (thin_inactive || low_pv_active) && kk_iter < dims_[2] )
+                {
+                    // bypass inactive cells with thickness less then the tolerance
+                    if (thin_inactive)
                     {
-                        // bypass inactive cells with thickness less then the tolerance
-                        if (thin_inactive)
+                        // move these cell to the position of the first cell to make the
+                        // coordinates strictly sorted
+                        setCellZcorn(ii, jj, kk_iter, cz, zcorn);
+                    }
+                    if (low_pv_active)
+                    {
+                        // In the case of PichNOGAP this cell must be thin to allow NNCs, too.
+                        nnc_allowed = nnc_allowed && (!pinchNOGAP || thin);
+                        // Cell is made inactive due to MINPV
+                        // It might make sense to always proceed as in the else branch,
+                        // but we try to keep changes due to refactoring smalle here and
+                        // mimic the old approach
+                        if (mergeMinPVCells)
                         {
-                            // move these cell to the position of the first cell to make the
-                            // coordinates strictly sorted
+                            // original algorithm would have extended this cells before
+                            // the collapsing. Doing the same.
                             setCellZcorn(ii, jj, kk_iter, cz, zcorn);
                         }
-                        if (low_pv_active)
+                        else
                         {
-                            // In the case of PichNOGAP this cell must be thin to allow NNCs, too.
-                            nnc_allowed = nnc_allowed && (!pinchNOGAP || thin);
-                            // Cell is made inactive due to MINPV
-                            // It might make sense to always proceed as in the else branch,
-                            // but we try to keep changes due to refactoring smalle here and
-                            // mimic the old approach
-                            if (mergeMinPVCells)
-                            {
-                                // original algorithm would have extended this cells before
-                                // the collapsing. Doing the same.
-                                setCellZcorn(ii, jj, kk_iter, cz, zcorn);
-                            }
-                            else
-                            {
-                                // original algorithm collapses the unextended cell
-                                cz = getCellZcorn(ii, jj, kk_iter, zcorn);
-                                for (int count = 0; count < 4; ++count) {
-                                    cz[count + 4] = cz[count];
-                                }
-                                setCellZcorn(ii, jj, kk_iter, cz, zcorn);
+                            // original algorithm collapses the unextended cell
+                            cz = getCellZcorn(ii, jj, kk_iter, zcorn);
+                            for (int count = 0; count < 4; ++count) {
+                                cz[count + 4] = cz[count];
                             }
-                            result.removed_cells.push_back(c_below);
+                            setCellZcorn(ii, jj, kk_iter, cz, zcorn);
                         }
-                        // Skip NNC if PINCH option 4 is ALL and we know that Z transmissibilty will
-                        // be zero because of multz or permz
-                        nnc_allowed = nnc_allowed &&
-                            (!pinchOption4ALL || (permz[c_below] != 0.0 && multz(c_below) != 0.0));
+                        result.removed_cells.push_back(c_below);
+                    }
+                    // Skip NNC if PINCH option 4 is ALL and we know that Z transmissibilty will
+                    // be zero because of multz or permz
+                    nnc_allowed = nnc_allowed &&
+                        (!pinchOption4ALL || (permz[c_below] != 0.0 && multz(c_below) != 0.0));
 
-                        if (pinchOption4ALL) {
-                            option4ALLZero = option4ALLZero || (!permz.empty() && permz[c_below] == 0) || multz(c_below) == 0;
-                        }
+                    if (pinchOption4ALL) {
+                        option4ALLZero = option4ALLZero || (!permz.empty() && permz[c_below] == 0) || multz(c_below) == 0;
+                    }
 
-                        // move to next lower cell
-                        kk_iter = kk_iter + 1;
-                        if (kk_iter == dims_[2])
-                        {
-                            break;
-                        }
+                    // move to next lower cell
+                    kk_iter = kk_iter + 1;
+                    if (kk_iter == dims_[2])
+                    {
+                        break;
+                    }
+
+                    c_below = ii + dims_[0] * (jj + dims_[1] * (kk_iter));
+                    active = actnum.empty() || actnum[c_below];
+                    thin = (thickness[c_below] <= z_tolerance);
+                    thin_inactive = (!actnum.empty() && !actnum[c_below]) && thin;
+                    low_pv_active = pv[c_below] < minpvv[c_below] && active;
+                }
 
-                        c_below = ii + dims_[0] * (jj + dims_[1] * (kk_iter));
-                        active = actnum.empty() || actnum[c_below];
-                        thin = (thickness[c_below] <= z_tolerance);
-                        thin_inactive = (!actnum.empty() && !actnum[c_below]) && thin;
-                        low_pv_active = pv[c_below] < minpvv[c_below] && active;
+                // create nnc if false or merge the cells if true
+                if (mergeMinPVCells && c_low_pv_active) {
+                    // Set lower k coordinates of cell below to upper cells's coordinates.
+                    // i.e fill the void using the cell below
+                    std::array<double, 8> cz_below = getCellZcorn(ii, jj, kk_iter, zcorn);
+                    for (int count = 0; count < 4; ++count) {
+                        cz_below[count] = cz[count];
                     }
 
-                    // create nnc if false or merge the cells if true
-                    if (mergeMinPVCells && c_low_pv_active) {
-                        // Set lower k coordinates of cell below to upper cells's coordinates.
-                        // i.e fill the void using the cell below
-                        std::array<double, 8> cz_below = getCellZcorn(ii, jj, kk_iter, zcorn);
-                        for (int count = 0; count < 4; ++count) {
-                            cz_below[count] = cz[count];
-                        }
+                    setCellZcorn(ii, jj, kk_iter, cz_below, zcorn);
+                }
+                else
+                {
 
-                        setCellZcorn(ii, jj, kk_iter, cz_below, zcorn);
+                    // No top or bottom cell, so no nnc is created.
+                    if (kk == 0 || kk_iter == dims_[2]) {
+                        kk = kk_iter;
+                        continue;
+                    }
+                    // bottom cell not active, hence no nnc is created
+                    if (!actnum.empty() && !actnum[c_below]) {
+                        kk = kk_iter;
+                        continue;
                     }
-                    else
-                    {
 
-                        // No top or bottom cell, so no nnc is created.
-                        if (kk == 0 || kk_iter == dims_[2]) {
-                            kk = kk_iter;
-                            continue;
-                        }
-                        // bottom cell not active, hence no nnc is created
-                        if (!actnum.empty() && !actnum[c_below]) {
-                            kk = kk_iter;
-                            continue;
-                        }
+                    // Bypass inactive cells with thickness below tolerance and
+                    // active cells with volume below minpv
+                    int k_above = kk-1;
+                    int c_above = ii + dims_[0] * (jj + dims_[1] * (kk-1));
+                    auto above_active = actnum.empty() || actnum[c_above];
+                    auto above_inactive = !actnum.empty() && !actnum[c_above];
+                    auto above_thin = thickness[c_above] < z_tolerance;
+                    auto above_small_pv = pv[c_above] < minpvv[c_above];
+
+                    if ((above_inactive && above_thin) || (above_active && above_small_pv
+                                                           && (!pinchNOGAP || above_thin) ) ) {
+                        for (k_above = kk - 2; k_above > 0; --k_above) {
+                            c_above = ii + dims_[0] * (jj + dims_[1] * (k_above));
+                            above_active = actnum.empty() || actnum[c_above];
+                            above_inactive = !actnum.empty() && !actnum[c_above];
+                            auto above_significant_pv = pv[c_above] > minpvv[c_above];
+                            auto above_broad = thickness[c_above] > z_tolerance;
+
+                            // \todo if condition seems wrong and should be the negation of above?
+                            if ( (above_active && (above_significant_pv || (pinchNOGAP && above_broad) ) ) || (above_inactive && above_broad)) {
+                                break;
+                            }
 
-                        // Bypass inactive cells with thickness below tolerance and
-                        // active cells with volume below minpv
-                        int k_above = kk-1;
-                        int c_above = ii + dims_[0] * (jj + dims_[1] * (kk-1));
-                        auto above_active = actnum.empty() || actnum[c_above];
-                        auto above_inactive = !actnum.empty() && !actnum[c_above];
-                        auto above_thin = thickness[c_above] < z_tolerance;
-                        auto above_small_pv = pv[c_above] < minpvv[c_above];
-
-                        if ((above_inactive && above_thin) || (above_active && above_small_pv
-                                                               && (!pinchNOGAP || above_thin) ) ) {
-                            for (k_above = kk - 2; k_above > 0; --k_above) {
-                                c_above = ii + dims_[0] * (jj + dims_[1] * (k_above));
-                                above_active = actnum.empty() || actnum[c_above];
-                                above_inactive = !actnum.empty() && !actnum[c_above];
-                                auto above_significant_pv = pv[c_above] > minpvv[c_above];
-                                auto above_broad = thickness[c_above] > z_tolerance;
-
-                                // \todo if condition seems wrong and should be the negation of above?
-                                if ( (above_active && (above_significant_pv || (pinchNOGAP && above_broad) ) ) || (above_inactive && above_broad)) {
-                                    break;
-                                }
-
-                                nnc_allowed = nnc_allowed &&
-                                    (!pinchOption4ALL || (permz[c_above] != 0.0 && multz(c_above) != 0.0) );
-
-                                if (pinchOption4ALL) {
-                                    option4ALLZero =  option4ALLZero || (!permz.empty() && permz[c_above] == 0.0) || multz(c_above) == 0.0;
-                                }
+                            nnc_allowed = nnc_allowed &&
+                                (!pinchOption4ALL || (permz[c_above] != 0.0 && multz(c_above) != 0.0) );
+
+                            if (pinchOption4ALL) {
+                                option4ALLZero =  option4ALLZero || (!permz.empty() && permz[c_above] == 0.0) || multz(c_above) == 0.0;
                             }
                         }
+                    }
 
-                        // Allow nnc only of total thickness of pinched out cells is below threshold.
-                        // and sum of gaps is below threshold
-                        const std::array<double, 8> cz_below = getCellZcorn(ii, jj, kk_iter, zcorn);
-                        const std::array<double, 8> cz_above = getCellZcorn(ii, jj, k_above, zcorn);
-                        // top cell might not have been inspected for option 4 ALL before
-                        option4ALLZero = option4ALLZero || (!permz.empty() && permz[c_above] == 0.0) || multz(c_above) == 0.0;
-                        nnc_allowed = nnc_allowed && (computeGap(cz_above, cz_below) < max_gap) && (!pinchOption4ALL || !option4ALLZero) ;
-
-                        if ( nnc_allowed &&
-                             (actnum.empty() || (actnum[c_above] && actnum[c_below])) &&
-                             pv[c_above] > minpvv[c_above] && pv[c_below] > minpvv[c_below]) {
-                            result.add_nnc(c_above, c_below);
-                        }
-                        kk = kk_iter;
+                    // Allow nnc only of total thickness of pinched out cells is below threshold.
+                    // and sum of gaps is below threshold
+                    const std::array<double, 8> cz_below = getCellZcorn(ii, jj, kk_iter, zcorn);
+                    const std::array<double, 8> cz_above = getCellZcorn(ii, jj, k_above, zcorn);
+                    // top cell might not have been inspected for option 4 ALL before
+                    option4ALLZero = option4ALLZero || (!permz.empty() && permz[c_above] == 0.0) || multz(c_above) == 0.0;
+                    nnc_allowed = nnc_allowed && (computeGap(cz_above, cz_below) < max_gap) && (!pinchOption4ALL || !option4ALLZero) ;
+
+                    if ( nnc_allowed &&
+                         (actnum.empty() || (actnum[c_above] && actnum[c_below])) &&
+                         pv[c_above] > minpvv[c_above] && pv[c_below] > minpvv[c_below]) {
+                        result.add_nnc(c_above, c_below);
                     }
+                    kk = kk_iter;
                 }
-                else
+            }
+            else
+            {
+                if (kk < dims_[2] - 1 && (actnum.empty() || actnum[c]) && pv[c] > minpvv[c] &&
+                    multz(c) != 0.0)
                 {
-                    if (kk < dims_[2] - 1 && (actnum.empty() || actnum[c]) && pv[c] > minpvv[c] &&
-                        multz(c) != 0.0)
-                    {
-                        // Check whether there is a gap to the neighbor below whose thickness is less
-                        // than MAX_GAP. In that case we need to create an NNC if there is a gap between the two cells.
-                        int kk_below = kk + 1;
-                        int c_below = ii + dims_[0] * (jj + dims_[1] * kk_below);
+                    // Check whether there is a gap to the neighbor below whose thickness is less
+                    // than MAX_GAP. In that case we need to create an NNC if there is a gap between the two cells.
+                    int kk_below = kk + 1;
+                    int c_below = ii + dims_[0] * (jj + dims_[1] * kk_below);
 
-                        if ((actnum.empty() || actnum[c_below]) && pv[c_below] > minpvv[c_below])
-                        {
-                            // Check MAX_GAP threshold
-                            std::array<double, 8> cz = getCellZcorn(ii, jj, kk, zcorn);
-                            std::array<double, 8> cz_below = getCellZcorn(ii, jj, kk_below, zcorn);
-                            bool vertically_connected = true; // If true a connection will be there anyway -> Skip NNC
-
-                            for(int i = 0; i < 4; ++i) {
-                                vertically_connected = vertically_connected && std::abs(cz_below[i] - cz[4+i])
-                                    <= tolerance_unique_points;
-                            }
+                    if ((actnum.empty() || actnum[c_below]) && pv[c_below] > minpvv[c_below])
+                    {
+                        // Check MAX_GAP threshold
+                        std::array<double, 8> cz = getCellZcorn(ii, jj, kk, zcorn);
+                        std::array<double, 8> cz_below = getCellZcorn(ii, jj, kk_below, zcorn);
+                        bool vertically_connected = true; // If true a connection will be there anyway -> Skip NNC
+
+                        for(int i = 0; i < 4; ++i) {
+                            vertically_connected = vertically_connected && std::abs(cz_below[i] - cz[4+i])
+                                <= tolerance_unique_points;
+                        }
 
-                            if (!vertically_connected && computeGap(cz, cz_below) < max_gap) {
-                                result.add_nnc(c, c_below);
-                            }
+                        if (!vertically_connected && computeGap(cz, cz_below) < max_gap) {
+                            result.add_nnc(c, c_below);
                         }
                     }
                 }
             }
         }
+    };
+
+    Result result;
+    const int num_columns = dims_[0] * dims_[1];
+    const int num_blocks = std::min(num_columns, num_threads_ > 1 ? 8 * num_threads_ : 1);
+    if (num_blocks <= 1) {
+        for (int column = 0; column < num_columns; ++column) {
+            processColumn(column % dims_[0], column / dims_[0], result);
+        }
+        return result;
+    }
+
+    // Each block of consecutive columns collects its removed cells and NNCs
+    // in its own result. Concatenating the blocks in order reproduces the
+    // serial result exactly, independently of the thread count.
+    std::vector<Result> block_results(num_blocks);
+#ifdef _OPENMP
+#pragma omp parallel for schedule(dynamic) num_threads(num_threads_)
+#endif
+    for (int block = 0; block < num_blocks; ++block) {
+        const int first = static_cast<long long>(num_columns) * block / num_blocks;
+        const int last = static_cast<long long>(num_columns) * (block + 1) / num_blocks;
+        for (int column = first; column < last; ++column) {
+            processColumn(column % dims_[0], column / dims_[0], block_results[block]);
+        }
+    }
+
+    std::size_t num_removed = 0;
+    for (const auto& block_result : block_results) {
+        num_removed += block_result.removed_cells.size();
+    }
+    result.removed_cells.reserve(num_removed);
+    for (auto& block_result : block_results) {
+        result.removed_cells.insert(result.removed_cells.end(),
+                                    block_result.removed_cells.begin(),
+                                    block_result.removed_cells.end());
+        result.nnc.merge(block_result.nnc);
     }
 
     return result;
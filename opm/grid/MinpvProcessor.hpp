@@ -48,6 +48,12 @@ namespace Opm
         /// \param[in]   ny   logical cartesian number of cells in J-direction
         /// \param[in]   nz   logical cartesian number of cells in K-direction
         MinpvProcessor(const int nx, const int ny, const int nz);
+        /// \brief Set the number of threads used by process().
+        ///
+        /// Defaults to the maximum number of OpenMP threads, or one without
+        /// OpenMP. The result does not depend on the number of threads. With
+        /// more than one thread, multZ passed to process() is called concurrently.
+        void setNumThreads(const int num_threads);
         /// Change zcorn so that it respects the minpv property.
         /// \param[in]       thickness thickness of the cell
         /// \param[in]       z_tolerance cells with thickness below z_tolerance will be bypassed in the minpv process.
@@ -93,6 +99,7 @@ namespace Opm
         void setCellZcorn(const int i, const int j, const int k, const std::array<double, 8>& cellz, double* z) const;
         std::array<int, 3> dims_;
         std::array<int, 3> delta_;
+        int num_threads_ = 1;
     };
 
 } // namespace Opm
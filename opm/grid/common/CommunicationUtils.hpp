@@ -97,5 +97,48 @@ gatherv(const std::vector<T,A>& input, const C& comm, int root)
     comm.gatherv(input.data(), input.size(), output.data(), sizes.data(), displ.data(), root);
     return {output, displ};
 }
+
+/// \brief Scatters vectors from a root process to all processes.
+///
+/// In parallel this will call MPI_Scatterv. Has to be called on all
+/// ranks.
+///
+/// \param input On the root rank a vector with one vector per process,
+///              holding the values to send there. Unused on other ranks.
+/// \param comm The Dune::Communication object.
+/// \param root The rank of the processes to scatter the values from.
+/// \return The values sent to this rank.
+template<class T, class A, class C>
+std::vector<T, A>
+scatterv(const std::vector<std::vector<T,A>>& input, const C& comm, int root)
+{
+    bool isRoot = (comm.rank() == root);
+    std::vector<int> sizes;
+    std::vector<int> displ;
+    std::vector<T,A> flat;
+
+    if (isRoot)
+    {
+        sizes.resize(comm.size());
+        displ.resize(comm.size() + 1);
+        for (int i = 0; i < comm.size(); ++i)
+        {
+            sizes[i] = input[i].size();
+        }
+        std::partial_sum(sizes.begin(), sizes.end(),
+                         displ.begin()+1);
+        flat.reserve(displ.back());
+        for (const auto& values : input)
+        {
+            flat.insert(flat.end(), values.begin(), values.end());
+        }
+    }
+    int mySize = 0;
+    comm.scatter(sizes.data(), &mySize, 1, root);
+
+    std::vector<T,A> output(mySize);
+    comm.scatterv(flat.data(), sizes.data(), displ.data(), output.data(), mySize, root);
+    return output;
+}
 }
 #endif
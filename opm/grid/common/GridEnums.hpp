@@ -51,6 +51,27 @@ namespace Dune {
         /// \brief use Zoltan on GraphOfGrid for partitioning
         zoltanGoG=3
     };
+
+    /// \brief enum for choosing how data is exchanged between processes by CpGrid::communicate.
+    ///
+    /// Neighbourhood collectives only apply to data with a fixed size per entity.
+    /// Data of variable size is always exchanged with point-to-point messages.
+    enum CommunicationMethod {
+        /// \brief One point-to-point message per neighbouring process
+        pointToPoint=0,
+        /// \brief One MPI-3 neighbourhood collective (MPI_Ineighbor_alltoallv) per communication
+        neighbourhoodCollectives=1
+    };
+
+    /// \brief enum for choosing how CpGrid::renumber orders the cells of a grid view.
+    ///
+    /// Faces and points are numbered in the order in which the renumbered cells reach them.
+    enum RenumberingMethod {
+        /// \brief Reverse Cuthill-McKee ordering of the face graph of the cells, reduces the bandwidth
+        reverseCuthillMcKee=0,
+        /// \brief Ordering of the cell centroids along a Hilbert space-filling curve
+        hilbertCurve=1
+    };
 }
 
 #endif
@@ -0,0 +1,256 @@
+/*
+  Copyright 2025 Equinor ASA.
+
+  This file is part of The Open Porous Media project  (OPM).
+
+  OPM is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  OPM is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with OPM.  If not, see <http://www.gnu.org/licenses/>.
+*/
+#ifndef DUNE_CPGRID_GRID_GRAPH_HEADER
+#define DUNE_CPGRID_GRID_GRAPH_HEADER
+
+#include <opm/grid/CpGrid.hpp>
+#include <opm/grid/common/ZoltanGraphFunctions.hpp>
+
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+#include <cstddef>
+#include <limits>
+#include <numeric>
+#include <type_traits>
+#include <vector>
+
+namespace Dune
+{
+namespace cpgrid
+{
+/// \brief The graph of a grid in compressed sparse row format.
+///
+/// The vertices are the cells of the grid, numbered by their local index,
+/// and there is an edge between two cells for each face they share. When
+/// created from a CombinedGridWellGraph, cells perforated by the same well
+/// are connected, too, and the edges carry weights: the maximum weight for
+/// well connections and CombinedGridWellGraph::edgeWeight() for faces. The
+/// well connections of a cell come first, in increasing order, followed by
+/// the neighbours across its faces that are not already connected by a well.
+///
+/// The graph is assembled once, threaded with OpenMP, and its arrays are
+/// passed directly to partitioners that accept the CSR format (xadj,
+/// adjncy, adjwgt in METIS' terms), or copied from by the Zoltan
+/// callbacks. The index and weight types are those of the partitioner.
+/// Weights of the cells, possibly several per cell, can be attached to the
+/// vertices with setVertexWeights.
+template<class Index, class Weight>
+class GridGraph
+{
+public:
+    using IndexType = Index;
+    using WeightType = Weight;
+
+    /// \brief Create the graph of the faces of a grid, without edge weights.
+    explicit GridGraph(const CpGrid& grid)
+        : grid_(grid)
+    {
+        build([&grid](int cell, auto&& addEdge)
+        {
+            for (int local_face = 0; local_face < grid.numCellFaces(cell); ++local_face) {
+                const int face = grid.cellFace(cell, local_face);
+                const int other = otherCell(grid, face, cell);
+                if (other != -1) {
+                    addEdge(other, Weight(1));
+                }
+            }
+        }, false);
+    }
+
+    /// \brief Create the graph of the faces of a grid and of the wells.
+    explicit GridGraph(const CombinedGridWellGraph& graph)
+        : grid_(graph.getGrid())
+    {
+        const auto& grid = grid_;
+        build([&grid, &graph](int cell, auto&& addEdge)
+        {
+            // First the strong edges of the well completions.
+            const auto& wellEdges = graph.getWellsGraph()[cell];
+            for (const int edge : wellEdges) {
+                addEdge(edge, std::numeric_limits<Weight>::max());
+            }
+            // Now the ones of the grid that are not handled by the well completions
+            for (int local_face = 0; local_face < grid.numCellFaces(cell); ++local_face) {
+                const int face = grid.cellFace(cell, local_face);
+                const int other = otherCell(grid, face, cell);
+                if (other != -1 && wellEdges.find(other) == wellEdges.end()) {
+                    addEdge(other, static_cast<Weight>(graph.edgeWeight(face)));
+                }
+            }
+        }, true);
+    }
+
+    /// \brief The grid of the graph.
+    const CpGrid& grid() const
+    {
+        return grid_;
+    }
+
+    /// \brief Number of vertices, i.e. cells.
+    Index numVertices() const
+    {
+        return xadj_.size() - 1;
+    }
+
+    /// \brief Number of directed edges, i.e. twice the number of edges.
+    Index numEdges() const
+    {
+        return adjncy_.size();
+    }
+
+    /// \brief Number of edges of a vertex.
+    Index numEdges(int cell) const
+    {
+        return xadj_[cell + 1] - xadj_[cell];
+    }
+
+    /// \brief Offsets of the edges of each vertex into adjncy(); of size numVertices()+1.
+    const std::vector<Index>& xadj() const
+    {
+        return xadj_;
+    }
+
+    /// \brief Target vertices of the edges.
+    const std::vector<Index>& adjncy() const
+    {
+        return adjncy_;
+    }
+
+    /// \brief Weights of the edges, empty if the graph has no edge weights.
+    const std::vector<Weight>& edgeWeights() const
+    {
+        return edge_weights_;
+    }
+
+    bool hasEdgeWeights() const
+    {
+        return !edge_weights_.empty();
+    }
+
+    /// \brief Attach weights to the vertices.
+    ///
+    /// \param weights The weights of the cells, dim consecutive ones per cell
+    ///                (vwgt in METIS' terms).
+    /// \param dim The number of weights per cell, i.e. of balancing constraints.
+    /// For integral weight types each constraint is scaled such that its largest
+    /// weight becomes maxIntegralVertexWeight, and positive weights stay positive.
+    void setVertexWeights(const std::vector<double>& weights, int dim)
+    {
+        assert(weights.size() == static_cast<std::size_t>(numVertices()) * dim);
+        vertex_weight_dim_ = dim;
+        vertex_weights_.resize(weights.size());
+        if constexpr (std::is_integral_v<Weight>) {
+            for (int j = 0; j < dim; ++j) {
+                double max_weight = 0.0;
+                for (std::size_t i = j; i < weights.size(); i += dim) {
+                    max_weight = std::max(max_weight, weights[i]);
+                }
+                const double scale = max_weight > 0.0 ? maxIntegralVertexWeight / max_weight : 0.0;
+                for (std::size_t i = j; i < weights.size(); i += dim) {
+                    const auto weight = static_cast<Weight>(std::lround(weights[i] * scale));
+                    vertex_weights_[i] = (weights[i] > 0.0) ? std::max(weight, Weight(1)) : Weight(0);
+                }
+            }
+        }
+        else {
+            std::copy(weights.begin(), weights.end(), vertex_weights_.begin());
+        }
+    }
+
+    /// \brief Weights of the vertices, empty if the graph has no vertex weights.
+    const std::vector<Weight>& vertexWeights() const
+    {
+        return vertex_weights_;
+    }
+
+    /// \brief Number of weights per vertex, 0 without vertex weights.
+    int numVertexWeights() const
+    {
+        return vertex_weight_dim_;
+    }
+
+    /// \brief The largest vertex weight for integral weight types.
+    ///
+    /// Small enough for the sum over millions of cells to fit into 32 bits.
+    static constexpr double maxIntegralVertexWeight = 100.0;
+
+private:
+    /// \brief The cell on the other side of a face, or -1 if there is none.
+    static int otherCell(const CpGrid& grid, int face, int cell)
+    {
+        int other = grid.faceCell(face, 0);
+        if (other == cell || other == -1) {
+            other = grid.faceCell(face, 1);
+            if (other == cell || other == -1) {
+                return -1;
+            }
+        }
+        return other;
+    }
+
+    /// \brief Counts the edges of all cells, then fills them in.
+    /// \param forEachEdge Calls addEdge(neighbour, weight) for each edge of a cell.
+    template<class ForEachEdge>
+    void build(const ForEachEdge& forEachEdge, bool withWeights)
+    {
+        const int numCells = grid_.numCells();
+        xadj_.assign(numCells + 1, 0);
+#ifdef _OPENMP
+#pragma omp parallel for schedule(static)
+#endif
+        for (int cell = 0; cell < numCells; ++cell) {
+            Index count = 0;
+            forEachEdge(cell, [&count](int, Weight) { ++count; });
+            xadj_[cell + 1] = count;
+        }
+        std::partial_sum(xadj_.begin(), xadj_.end(), xadj_.begin());
+
+        adjncy_.resize(xadj_[numCells]);
+        if (withWeights) {
+            edge_weights_.resize(xadj_[numCells]);
+        }
+#ifdef _OPENMP
+#pragma omp parallel for schedule(static)
+#endif
+        for (int cell = 0; cell < numCells; ++cell) {
+            std::size_t pos = xadj_[cell];
+            forEachEdge(cell, [this, &pos, withWeights](int other, Weight weight)
+            {
+                adjncy_[pos] = other;
+                if (withWeights) {
+                    edge_weights_[pos] = weight;
+                }
+                ++pos;
+            });
+        }
+    }
+
+    const CpGrid& grid_;
+    std::vector<Index> xadj_;
+    std::vector<Index> adjncy_;
+    std::vector<Weight> edge_weights_;
+    std::vector<Weight> vertex_weights_;
+    int vertex_weight_dim_ = 0;
+};
+
+} // end namespace cpgrid
+} // end namespace Dune
+
+#endif // DUNE_CPGRID_GRID_GRAPH_HEADER
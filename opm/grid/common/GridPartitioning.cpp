@@ -44,7 +44,10 @@
 #include <opm/grid/cpgrid/CpGridDataTraits.hpp>
 #include <opm/grid/common/ZoltanPartition.hpp>
 
+#include <algorithm>
+#include <cassert>
 #include <memory>
+#include <numeric>
 #include <stack>
 #include <variant>
 
@@ -251,137 +254,283 @@ namespace Dune
         }
     }
 
-/// \brief Adds cells to the overlap that just share a point with an owner cell.
-void addOverlapCornerCell(const CpGrid& grid,
-                          int owner,
-                          const CpGrid::Codim<0>::Entity& from,
-                          const CpGrid::Codim<0>::Entity& neighbor,
-                          const std::vector<int>& cell_part,
-                          std::vector<std::set<int> >& cell_overlap,
-                          int level)
+namespace
 {
-    bool validLevel = (level>-1) && (level <= grid.maxLevel());
-    const auto& ix = validLevel? grid.levelIndexSet(level) : grid.leafIndexSet();
-    int my_index = ix.index(from);
-    int nb_index = ix.index(neighbor);
-    const int num_from_subs = from.subEntities(CpGrid::dimension);
-    for ( int i = 0; i < num_from_subs ; i++ )
+
+/// \brief Cell adjacency of a grid view in compressed sparse row format.
+///
+/// The neighbours of a cell are stored in intersection order together
+/// with the face between them, and the corners of each cell alongside.
+struct OverlapAdjacency
+{
+    std::vector<int> neighbour_offsets;
+    std::vector<int> neighbours;
+    std::vector<int> faces;
+    std::vector<int> corner_offsets;
+    std::vector<int> corners;
+
+    OverlapAdjacency(const CpGrid& grid, std::size_t num_cells, bool with_corners, int level)
     {
-        int mypoint = ix.index(from.subEntity<CpGrid::dimension>(i));
-        const int num_nb_subs = neighbor.subEntities(CpGrid::dimension);
-        for ( int j = 0; j < num_nb_subs; j++)
-        {
-            int otherpoint = ix.index(neighbor.subEntity<CpGrid::dimension>(j));
-            if ( mypoint == otherpoint )
-            {
-                cell_overlap[nb_index].insert(owner);
-                cell_overlap[my_index].insert(cell_part[nb_index]);
-                return;
+        bool validLevel = (level>-1) && (level <= grid.maxLevel());
+        const auto& ix = validLevel? grid.levelIndexSet(level) : grid.leafIndexSet();
+
+        neighbour_offsets.reserve(num_cells + 1);
+        neighbours.reserve(6 * num_cells);
+        faces.reserve(6 * num_cells);
+        neighbour_offsets.push_back(0);
+        if (with_corners) {
+            corner_offsets.reserve(num_cells + 1);
+            corners.reserve(8 * num_cells);
+            corner_offsets.push_back(0);
+        }
+
+        auto it = validLevel?  grid.template lbegin<0>(level) : grid.template leafbegin<0>();
+        const auto& endIt = validLevel?  grid.template lend<0>(level) : grid.template leafend<0>();
+
+        for (; it != endIt; ++it) {
+            // Cells are visited in index order.
+            assert(ix.index(*it) + 1 == static_cast<int>(neighbour_offsets.size()));
+            auto iit = validLevel? it->ilevelbegin() : it->ileafbegin();
+            const auto& endIit = validLevel? it->ilevelend() :  it->ileafend();
+            for (; iit != endIit; ++iit) {
+                if ( iit->neighbor() ) {
+                    neighbours.push_back(ix.index(iit->outside()));
+                    faces.push_back(iit->id());
+                }
+            }
+            neighbour_offsets.push_back(neighbours.size());
+
+            if (with_corners) {
+                const int num_subs = it->subEntities(CpGrid::dimension);
+                for ( int i = 0; i < num_subs ; i++ ) {
+                    corners.push_back(ix.index(it->template subEntity<CpGrid::dimension>(i)));
+                }
+                corner_offsets.push_back(corners.size());
             }
         }
     }
-}
 
-/// \brief Adds cells to the overlap that just share a point with an owner cell.
-void addOverlapCornerCell(const CpGrid& grid,
-                          int owner,
-                          const CpGrid::Codim<0>::Entity& from,
-                          const CpGrid::Codim<0>::Entity& neighbor,
-                          const std::vector<int>& cell_part,
-                          std::vector<std::tuple<int,int,char>>& exportList,
-                          int level)
-{
-    // Add corner cells to the overlap layer. Example of a subdomain of a 4x4 grid
-    // with and without corner cells in the overlap is given below. Note that the
-    // corner cell is not needed for cell centered finite volume schemes.
-    // I = interior cells, O = overlap cells and E = exterior cells.
-    //
-    //  With corner     Without corner
-    //  I I O E         I I O E
-    //  I I O E         I I O E
-    //  O O O E         O O E E
-    //  E E E E         E E E E
-    using AttributeSet = Dune::cpgrid::CpGridDataTraits::AttributeSet;
-    bool validLevel = (level>-1) && (level <= grid.maxLevel());
-    const auto& ix = validLevel? grid.levelIndexSet(level) : grid.leafIndexSet();
-    int my_index = ix.index(from);
-    int nb_index = ix.index(neighbor);
-    const int num_from_subs = from.subEntities(CpGrid::dimension);
-    for ( int i = 0; i < num_from_subs ; i++ )
+    /// \brief Whether two cells share at least one corner.
+    bool shareCorner(int cell1, int cell2) const
     {
-        int mypoint = ix.index(from.subEntity<CpGrid::dimension>(i));
-        const int num_nb_subs = neighbor.subEntities(CpGrid::dimension);
-        for ( int j = 0; j < num_nb_subs; j++)
-        {
-            int otherpoint = ix.index(neighbor.subEntity<CpGrid::dimension>(j));
-            if ( mypoint == otherpoint )
-            {
-                // Note: multiple adds for same process are possible
-                exportList.emplace_back(nb_index, owner, AttributeSet::copy);
-                exportList.emplace_back(my_index, cell_part[nb_index],  AttributeSet::copy);
-                return;
+        for (int i = corner_offsets[cell1]; i < corner_offsets[cell1 + 1]; ++i) {
+            for (int j = corner_offsets[cell2]; j < corner_offsets[cell2 + 1]; ++j) {
+                if (corners[i] == corners[j]) {
+                    return true;
+                }
             }
         }
+        return false;
     }
-}
+};
 
-void addOverlapLayer(const CpGrid& grid,
-                     int index,
-                     const CpGrid::Codim<0>::Entity& e,
-                     const int owner,
-                     const std::vector<int>& cell_part,
-                     std::vector<std::set<int> >& cell_overlap,
-                     int recursion_deps,
-                     int level)
+/// \brief Sends a list of ranks per cell from the owner to the copies.
+struct CellRanksHandle
 {
-    bool validLevel = (level>-1) && (level <= grid.maxLevel());
-    const auto& ix = validLevel? grid.levelIndexSet(level) : grid.leafIndexSet();
+    using DataType = int;
 
-    auto iit = validLevel? e.ilevelbegin() : e.ileafbegin();
-    const auto& endIit = validLevel? e.ilevelend() :  e.ileafend();
+    explicit CellRanksHandle(std::vector<std::vector<int>>& ranks)
+        : ranks_(ranks)
+    {}
 
-    for (; iit != endIit; ++iit) {
-        if ( iit->neighbor() ) {
-            int nb_index = ix.index(iit->outside());
-            if ( cell_part[nb_index]!=owner )
-            {
-                cell_overlap[nb_index].insert(owner);
-                cell_overlap[index].insert(cell_part[nb_index]);
-                if ( recursion_deps>0 ) {
-                    // Add another layer
-                    addOverlapLayer(grid,
-                                    nb_index,
-                                    iit->outside(),
-                                    owner,
-                                    cell_part,
-                                    cell_overlap,
-                                    recursion_deps-1,
-                                    level);
-                }
-                else { // Add cells to the overlap that just share a corner with e.
-                    auto iit2 = validLevel? iit->outside().ilevelbegin() : iit->outside().ileafbegin();
-                    const auto& endIit2 = validLevel?  iit->outside().ilevelend() :  iit->outside().ileafend();
-
-                    for (; iit2 != endIit2; ++iit2) {
-                        if ( iit2->neighbor() )
-                        {
-                            int nb_index2 = ix.index(iit2->outside( ));
-                            if( cell_part[nb_index2]==owner ) continue;
-                            addOverlapCornerCell(grid,
-                                                 owner,
-                                                 e,
-                                                 iit2->outside(),
-                                                 cell_part,
-                                                 cell_overlap,
-                                                 level);
+    bool fixedSize(int, int)
+    {
+        return false;
+    }
+
+    bool contains(int, int codim)
+    {
+        return codim == 0;
+    }
+
+    template<class T>
+    std::size_t size(const T& element)
+    {
+        return ranks_[element.index()].size();
+    }
+
+    template<class B, class T>
+    void gather(B& buffer, const T& element)
+    {
+        for (const int rank : ranks_[element.index()]) {
+            buffer.write(rank);
+        }
+    }
+
+    template<class B, class T>
+    void scatter(B& buffer, const T& element, std::size_t size)
+    {
+        auto& ranks = ranks_[element.index()];
+        ranks.resize(size);
+        for (auto& rank : ranks) {
+            buffer.read(rank);
+        }
+    }
+
+private:
+    std::vector<std::vector<int>>& ranks_;
+};
+
+/// \brief Computes the overlap of partitions layer by layer.
+///
+/// Layer 0 consists of the cells of the owner, and layer k+1 of the cells
+/// of other partitions neighbouring a cell of layer k. For each cell c of
+/// the layers 0 to layers-1 and each of its neighbours n not belonging to
+/// owner, n becomes an overlap cell of owner and c one of the partition of
+/// n. Optionally, cells of other partitions that share just a corner with
+/// a cell of the last layer are added as well. Each layer is stored once,
+/// hence neighbours are not revisited as in a depth-first traversal.
+///
+/// When trans is given, neighbours across faces with zero
+/// transmissibility are skipped.
+class OverlapLayerBuilder
+{
+public:
+    OverlapLayerBuilder(const OverlapAdjacency& adjacency,
+                        const std::vector<int>& cell_part,
+                        bool addCornerCells,
+                        const double* trans,
+                        int layers)
+        : adjacency_(adjacency), cell_part_(cell_part), addCornerCells_(addCornerCells),
+          trans_(trans), layers_(std::max(layers, 1)),
+          exported_to_(cell_part.size(), -1), in_layer_(cell_part.size(), -1)
+    {}
+
+    /// \brief Appends the pairs (cell, partition) of the overlap of owner.
+    /// \param cells The cells of owner.
+    void addOwner(int owner, const std::vector<int>& cells, std::vector<std::pair<int,int>>& entries)
+    {
+        layer_ = cells;
+        for (int layer = 0; layer < layers_ && !layer_.empty(); ++layer) {
+            const bool last_layer = layer + 1 == layers_;
+            ++layer_stamp_;
+            next_layer_.clear();
+            for (const int cell : layer_) {
+                for (int k = adjacency_.neighbour_offsets[cell]; k < adjacency_.neighbour_offsets[cell + 1]; ++k) {
+                    // If the transmissibility on a cell interface is zero we do not add the neighbor cell
+                    // to the overlap layer. The reason for this is that
+                    // zero transmissibility -> no flux over the face -> zero offdiagonal.
+                    // This is a reservoir simulation spesific thing that reduce parallel overhead.
+                    if ( trans_ && trans_[adjacency_.faces[k]] == 0.0 ) {
+                        continue;
+                    }
+                    const int nb = adjacency_.neighbours[k];
+                    if ( cell_part_[nb] == owner ) {
+                        continue;
+                    }
+                    addEntry(nb, owner, entries);
+                    entries.emplace_back(cell, cell_part_[nb]);
+                    if ( !last_layer ) {
+                        if ( in_layer_[nb] != layer_stamp_ ) {
+                            in_layer_[nb] = layer_stamp_;
+                            next_layer_.push_back(nb);
                         }
                     }
+                    else if ( addCornerCells_ ) {
+                        addCornerCells(owner, cell, nb, entries);
+                    }
                 }
             }
+            layer_.swap(next_layer_);
+        }
+    }
+
+private:
+    void addEntry(int cell, int owner, std::vector<std::pair<int,int>>& entries)
+    {
+        if ( exported_to_[cell] != owner ) {
+            exported_to_[cell] = owner;
+            entries.emplace_back(cell, owner);
+        }
+    }
+
+    /// \brief Adds the cells of other partitions that neighbour nb and share a corner with cell.
+    void addCornerCells(int owner, int cell, int nb, std::vector<std::pair<int,int>>& entries)
+    {
+        // Add corner cells to the overlap layer. Example of a subdomain of a 4x4 grid
+        // with and without corner cells in the overlap is given below. Note that the
+        // corner cell is not needed for cell centered finite volume schemes.
+        // I = interior cells, O = overlap cells and E = exterior cells.
+        //
+        //  With corner     Without corner
+        //  I I O E         I I O E
+        //  I I O E         I I O E
+        //  O O O E         O O E E
+        //  E E E E         E E E E
+        for (int k = adjacency_.neighbour_offsets[nb]; k < adjacency_.neighbour_offsets[nb + 1]; ++k) {
+            const int nb2 = adjacency_.neighbours[k];
+            if ( cell_part_[nb2] != owner && adjacency_.shareCorner(cell, nb2) ) {
+                addEntry(nb2, owner, entries);
+                entries.emplace_back(cell, cell_part_[nb2]);
+            }
         }
     }
+
+    const OverlapAdjacency& adjacency_;
+    const std::vector<int>& cell_part_;
+    bool addCornerCells_;
+    const double* trans_;
+    int layers_;
+    /// The last owner that a cell was added to the overlap of.
+    std::vector<int> exported_to_;
+    /// Stamp of the last layer that a cell was added to.
+    std::vector<int> in_layer_;
+    int layer_stamp_ = -1;
+    std::vector<int> layer_;
+    std::vector<int> next_layer_;
+};
+
+/// \brief Computes the overlap of the given owners as pairs (cell, partition).
+///
+/// With OpenMP the owners are processed concurrently. The pairs may
+/// contain duplicates.
+std::vector<std::pair<int,int>> computeOverlap(const CpGrid& grid,
+                                               const std::vector<int>& cell_part,
+                                               const std::vector<int>& owners,
+                                               bool addCornerCells,
+                                               const double* trans,
+                                               int layers,
+                                               int level)
+{
+    const OverlapAdjacency adjacency(grid, cell_part.size(), addCornerCells, level);
+
+    // Cells grouped by partition.
+    const int num_parts = cell_part.empty() ? 0 : *std::max_element(cell_part.begin(), cell_part.end()) + 1;
+    std::vector<std::vector<int>> cells_of_part(num_parts);
+    for (std::size_t cell = 0; cell < cell_part.size(); ++cell) {
+        cells_of_part[cell_part[cell]].push_back(cell);
+    }
+
+    std::vector<std::vector<std::pair<int,int>>> owner_entries(owners.size());
+#ifdef _OPENMP
+#pragma omp parallel if(owners.size() > 1)
+#endif
+    {
+        OverlapLayerBuilder builder(adjacency, cell_part, addCornerCells, trans, layers);
+#ifdef _OPENMP
+#pragma omp for schedule(dynamic)
+#endif
+        for (int i = 0; i < static_cast<int>(owners.size()); ++i) {
+            if ( owners[i] < num_parts ) {
+                builder.addOwner(owners[i], cells_of_part[owners[i]], owner_entries[i]);
+            }
+        }
+    }
+
+    std::size_t num_entries = 0;
+    for (const auto& entries : owner_entries) {
+        num_entries += entries.size();
+    }
+    std::vector<std::pair<int,int>> overlap;
+    overlap.reserve(num_entries);
+    for (const auto& entries : owner_entries) {
+        overlap.insert(overlap.end(), entries.begin(), entries.end());
+    }
+    return overlap;
 }
 
+} // anon namespace
+
 void addOverlapLayer(const CpGrid& grid,
                      const std::vector<int>& cell_part,
                      std::vector<std::set<int> >& cell_overlap,
@@ -391,164 +540,209 @@ void addOverlapLayer(const CpGrid& grid,
                      int level)
 {
     cell_overlap.resize(cell_part.size());
-    bool validLevel = (level>-1) && (level <= grid.maxLevel());
-    const auto& ix = validLevel?  grid.levelIndexSet(level) :  grid.leafIndexSet();
-
-    auto it = validLevel?  grid.template lbegin<0>(level) : grid.template leafbegin<0>();
-    const auto& endIt = validLevel?  grid.template lend<0>(level) : grid.template leafend<0>();
-
-    for (; it != endIt; ++it) {
-        int index = ix.index(*it);
-        int owner;
-        if(cell_part[index]==mypart)
-            owner = mypart;
-        else
-        {
-            if(all)
-                owner=cell_part[index];
-            else
+    std::vector<int> owners;
+    if ( all ) {
+        std::set<int> parts(cell_part.begin(), cell_part.end());
+        owners.assign(parts.begin(), parts.end());
+    }
+    else {
+        owners.push_back(mypart);
+    }
+    for (const auto& [cell, part] : computeOverlap(grid, cell_part, owners, true, nullptr, layers, level)) {
+        cell_overlap[cell].insert(part);
+    }
+}
+
+void rebalancePartition(const CpGrid& grid,
+                        std::vector<int>& cell_part,
+                        const std::vector<double>& cell_weights,
+                        int num_part,
+                        double imbalance_tol,
+                        int max_sweeps)
+{
+    assert(cell_part.size() == cell_weights.size());
+    std::vector<double> load(num_part, 0.0);
+    std::vector<int> num_cells(num_part, 0);
+    for (std::size_t cell = 0; cell < cell_part.size(); ++cell) {
+        load[cell_part[cell]] += cell_weights[cell];
+        ++num_cells[cell_part[cell]];
+    }
+    const double mean_load = std::accumulate(load.begin(), load.end(), 0.0) / num_part;
+    const double max_load = imbalance_tol * mean_load;
+    const OverlapAdjacency adjacency(grid, cell_part.size(), false, -1);
+
+    // Each move strictly decreases the sum of the squared loads, hence
+    // the sweeps terminate even without the limit.
+    for (int sweep = 0; sweep < max_sweeps; ++sweep) {
+        if (*std::max_element(load.begin(), load.end()) <= max_load) {
+            break;
+        }
+        bool moved = false;
+        for (std::size_t cell = 0; cell < cell_part.size(); ++cell) {
+            const int part = cell_part[cell];
+            // Partitions above the mean pass cells on, such that the
+            // excess of a partition can travel through its neighbours.
+            if (load[part] <= mean_load || num_cells[part] == 1) {
                 continue;
+            }
+            int target = -1;
+            for (int i = adjacency.neighbour_offsets[cell]; i < adjacency.neighbour_offsets[cell + 1]; ++i) {
+                const int other = cell_part[adjacency.neighbours[i]];
+                if (other != part && (target == -1 || load[other] < load[target])) {
+                    target = other;
+                }
+            }
+            if (target != -1 && load[target] + cell_weights[cell] < load[part]) {
+                load[part] -= cell_weights[cell];
+                load[target] += cell_weights[cell];
+                --num_cells[part];
+                ++num_cells[target];
+                cell_part[cell] = target;
+                moved = true;
+            }
+        }
+        if (!moved) {
+            break;
         }
-        addOverlapLayer(grid, index, *it, owner, cell_part, cell_overlap, layers-1, level);
     }
 }
 
-void addOverlapLayer(const CpGrid& grid,
-                     int index,
-                     const CpGrid::Codim<0>::Entity& e,
-                     const int owner,
-                     const std::vector<int>& cell_part,
-                     std::vector<std::tuple<int,int,char>>& exportList,
-                     bool addCornerCells,
-                     int recursion_deps,
-                     int level)
+void rebalanceDistributedPartition(const CpGrid& grid,
+                                   std::vector<int>& cell_owner,
+                                   const std::vector<double>& cell_weights,
+                                   double imbalance_tol,
+                                   int max_sweeps)
 {
-    using AttributeSet = Dune::cpgrid::CpGridDataTraits::AttributeSet;
-
-    bool validLevel = (level>-1) && (level <= grid.maxLevel());
-    const auto& ix = validLevel? grid.levelIndexSet(level) : grid.leafIndexSet();
-
-    auto iit = validLevel? e.ilevelbegin() : e.ileafbegin();
-    const auto& endIit = validLevel? e.ilevelend() :  e.ileafend();
-
-    for (; iit != endIit; ++iit) {
-        if ( iit->neighbor() ) {
-            int nb_index = ix.index(iit->outside());
-            if ( cell_part[nb_index]!=owner ) {
-                // Note: multiple adds for same process are possible
-                exportList.emplace_back(nb_index, owner, AttributeSet::copy);
-                exportList.emplace_back(index, cell_part[nb_index],  AttributeSet::copy);
-                if ( recursion_deps>0 ) {
-                    // Add another layer
-                    addOverlapLayer(grid,
-                                    nb_index,
-                                    iit->outside(),
-                                    owner,
-                                    cell_part,
-                                    exportList,
-                                    addCornerCells,
-                                    recursion_deps-1,
-                                    level);
+    assert(cell_owner.size() == cell_weights.size());
+    const auto& cc = grid.comm();
+    const int rank = cc.rank();
+    const int num_procs = cc.size();
+
+    std::vector<int> owned;
+    double my_load = 0.0;
+    for (std::size_t cell = 0; cell < cell_owner.size(); ++cell) {
+        if (cell_owner[cell] == rank) {
+            owned.push_back(cell);
+            my_load += cell_weights[cell];
+        }
+    }
+    std::vector<double> load(num_procs);
+    cc.allgather(&my_load, 1, load.data());
+    const double mean_load = std::accumulate(load.begin(), load.end(), 0.0) / num_procs;
+    const double max_load = imbalance_tol * mean_load;
+    const OverlapAdjacency adjacency(grid, cell_owner.size(), false, -1);
+    auto num_owned = owned.size();
+    // Marks the cells already queued in the search for cells to pass on.
+    std::vector<int> queued(cell_owner.size(), -1);
+    int search = 0;
+
+    for (int sweep = 0; sweep < max_sweeps; ++sweep) {
+        if (*std::max_element(load.begin(), load.end()) <= max_load) {
+            break;
+        }
+        // The processes owning a neighbour of one of our cells.
+        std::set<int> neighbour_procs;
+        for (const int cell : owned) {
+            if (cell_owner[cell] != rank) {
+                continue;
+            }
+            for (int i = adjacency.neighbour_offsets[cell]; i < adjacency.neighbour_offsets[cell + 1]; ++i) {
+                const int other = cell_owner[adjacency.neighbours[i]];
+                if (other != rank) {
+                    neighbour_procs.insert(other);
                 }
-                else if (addCornerCells) {
-                    // Add cells to the overlap that just share a corner with e.
-                    auto iit2 = validLevel? iit->outside().ilevelbegin() : iit->outside().ileafbegin();
-                    const auto& endIit2 = validLevel?  iit->outside().ilevelend() :  iit->outside().ileafend();
-
-                    for (; iit2 != endIit2; ++iit2) {
-                        if ( iit2->neighbor() )
-                        {
-                            int nb_index2 = ix.index(iit2->outside());
-                            if( cell_part[nb_index2]!=owner ) {
-                                addOverlapCornerCell(grid,
-                                                     owner,
-                                                     e,
-                                                     iit2->outside(),
-                                                     cell_part,
-                                                     exportList,
-                                                     level);
-                            }
-                        }
+            }
+        }
+        const int my_degree = neighbour_procs.size();
+        std::vector<int> degree(num_procs);
+        cc.allgather(&my_degree, 1, degree.data());
+
+        // Each process passes a share of the load difference to its less loaded
+        // neighbours. Scaling it by the degree keeps a process from receiving
+        // more than it can take when several neighbours pass on cells at once.
+        std::vector<double> delta(num_procs, 0.0);
+        for (const int other : neighbour_procs) {
+            if (load[other] >= load[rank]) {
+                continue;
+            }
+            const double flow = (load[rank] - load[other]) / (1 + std::max(degree[rank], degree[other]));
+            // Breadth-first search starting at our cells next to the ones of other.
+            std::vector<int> front;
+            for (const int cell : owned) {
+                if (cell_owner[cell] != rank) {
+                    continue;
+                }
+                for (int i = adjacency.neighbour_offsets[cell]; i < adjacency.neighbour_offsets[cell + 1]; ++i) {
+                    if (cell_owner[adjacency.neighbours[i]] == other) {
+                        queued[cell] = search;
+                        front.push_back(cell);
+                        break;
                     }
                 }
             }
+            double moved = 0.0;
+            for (std::size_t next = 0; next < front.size() && moved < flow && num_owned > 1; ++next) {
+                const int cell = front[next];
+                if (moved + 0.5 * cell_weights[cell] > flow) {
+                    continue;
+                }
+                cell_owner[cell] = other;
+                moved += cell_weights[cell];
+                --num_owned;
+                for (int i = adjacency.neighbour_offsets[cell]; i < adjacency.neighbour_offsets[cell + 1]; ++i) {
+                    const int neighbour = adjacency.neighbours[i];
+                    if (cell_owner[neighbour] == rank && queued[neighbour] != search) {
+                        queued[neighbour] = search;
+                        front.push_back(neighbour);
+                    }
+                }
+            }
+            ++search;
+            delta[rank] -= moved;
+            delta[other] += moved;
+        }
+        cc.sum(delta.data(), num_procs);
+        if (std::all_of(delta.begin(), delta.end(), [](double d) { return d == 0.0; })) {
+            break;
+        }
+        for (int proc = 0; proc < num_procs; ++proc) {
+            load[proc] += delta[proc];
         }
     }
 }
 
-void addOverlapLayerNoZeroTrans(const CpGrid& grid,
-                                int index,
-                                const CpGrid::Codim<0>::Entity& e,
-                                const int owner,
-                                const std::vector<int>& cell_part,
-                                std::vector<std::tuple<int,int,char>>& exportList,
-                                bool addCornerCells,
-                                int recursion_deps,
-                                const double* trans,
-                                int level)
+std::vector<std::vector<int>> distributedOverlap(const CpGrid& grid,
+                                                 std::vector<int>& cell_owner,
+                                                 int layers)
 {
-    using AttributeSet = Dune::OwnerOverlapCopyAttributeSet::AttributeSet;
-    bool validLevel = (level>-1) && (level <= grid.maxLevel());
-    const auto& ix = validLevel? grid.levelIndexSet(level) : grid.leafIndexSet();
-
-    auto iit = validLevel? e.ilevelbegin() : e.ileafbegin();
-    const auto& endIit = validLevel? e.ilevelend() :  e.ileafend();
-
-    for (; iit != endIit; ++iit) {
-        if ( iit->neighbor() ) {
-            int faceId = iit->id();
-
-            // If the transmissibility on a cell interface is zero we do not add the neighbor cell
-            // to the overlap layer. The reason for this is that
-            // zero transmissibility -> no flux over the face -> zero offdiagonal.
-            // This is a reservoir simulation spesific thing that reduce parallel overhead.
-            if ( trans[faceId] != 0.0 ) {
-                int nb_index = ix.index(iit->outside());
-                if ( cell_part[nb_index]!=owner )
-                {
-                    // Note: multiple adds for same process are possible
-                    exportList.emplace_back(nb_index, owner, AttributeSet::copy);
-                    exportList.emplace_back(index, cell_part[nb_index],  AttributeSet::copy);
-                    if ( recursion_deps>0 )
-                    {
-                        // Add another layer
-                        addOverlapLayerNoZeroTrans(grid,
-                                                   nb_index,
-                                                   e,
-                                                   owner,
-                                                   cell_part,
-                                                   exportList,
-                                                   addCornerCells,
-                                                   recursion_deps-1,
-                                                   trans,
-                                                   level);
-                    }
-                    else if (addCornerCells)
-                    {
-                        // Add cells to the overlap that just share a corner with e.
-                        auto iit2 = validLevel? iit->outside().ilevelbegin() : iit->outside().ileafbegin();
-                        const auto& endIit2 = validLevel?  iit->outside().ilevelend() :  iit->outside().ileafend();
-
-                        for (; iit2 != endIit2; ++iit2) {
-                            if ( iit2->neighbor() )
-                            {
-                                int nb_index2 = ix.index(iit2->outside());
-                                if( cell_part[nb_index2]!=owner ) {
-                                    addOverlapCornerCell(grid,
-                                                         owner,
-                                                         e,
-                                                         iit2->outside(),
-                                                         cell_part,
-                                                         exportList,
-                                                         level);
-                                }
-                            }
-                        }
-                    }
-                }
+    std::vector<std::vector<int>> ranks(cell_owner.size());
+    for (std::size_t cell = 0; cell < cell_owner.size(); ++cell) {
+        ranks[cell].push_back(cell_owner[cell]);
+    }
+    CellRanksHandle handle(ranks);
+    grid.communicate(handle, InteriorBorder_All_Interface, ForwardCommunication);
+    for (std::size_t cell = 0; cell < cell_owner.size(); ++cell) {
+        cell_owner[cell] = ranks[cell].front();
+    }
+
+    // Layer k+1 of a partition consists of the neighbours of its layer k. The
+    // owner of a cell sees all its neighbours and sends the result to the copies.
+    const OverlapAdjacency adjacency(grid, cell_owner.size(), false, -1);
+    for (int layer = 0; layer < layers; ++layer) {
+        auto extended = ranks;
+        for (std::size_t cell = 0; cell < cell_owner.size(); ++cell) {
+            auto& cell_ranks = extended[cell];
+            for (int i = adjacency.neighbour_offsets[cell]; i < adjacency.neighbour_offsets[cell + 1]; ++i) {
+                const auto& other = ranks[adjacency.neighbours[i]];
+                cell_ranks.insert(cell_ranks.end(), other.begin(), other.end());
             }
+            std::sort(cell_ranks.begin(), cell_ranks.end());
+            cell_ranks.erase(std::unique(cell_ranks.begin(), cell_ranks.end()), cell_ranks.end());
         }
+        ranks.swap(extended);
+        grid.communicate(handle, InteriorBorder_All_Interface, ForwardCommunication);
     }
+    return ranks;
 }
 
 int addOverlapLayer([[maybe_unused]] const CpGrid& grid,
@@ -565,23 +759,20 @@ int addOverlapLayer([[maybe_unused]] const CpGrid& grid,
     using AttributeSet = Dune::cpgrid::CpGridData::AttributeSet;
     auto ownerSize = exportList.size();
 
-    bool validLevel = (level>-1) && (level <= grid.maxLevel());
-    const auto& ix = validLevel? grid.levelIndexSet(level) : grid.leafIndexSet();
     std::map<int,int> exportProcs, importProcs;
-
-    auto it = validLevel?  grid.template lbegin<0>(level) : grid.template leafbegin<0>();
-    const auto& endIt = validLevel?  grid.template lend<0>(level) : grid.template leafend<0>();
-
-    for (; it != endIt; ++it) {
-        int index = ix.index(*it);
-        auto owner = cell_part[index];
+    for (const int owner : cell_part) {
         exportProcs.insert(std::make_pair(owner, 0));
-        if ( trans ) {
-            addOverlapLayerNoZeroTrans(grid, index, *it, owner, cell_part, exportList, addCornerCells, layers-1, trans, level);
-        }
-        else {
-            addOverlapLayer(grid, index, *it, owner, cell_part, exportList, addCornerCells, layers-1, level);
-        }
+    }
+    std::vector<int> owners;
+    owners.reserve(exportProcs.size());
+    for (const auto& proc : exportProcs) {
+        owners.push_back(proc.first);
+    }
+
+    const auto overlap = computeOverlap(grid, cell_part, owners, addCornerCells, trans, layers, level);
+    exportList.reserve(ownerSize + overlap.size());
+    for (const auto& [cell, part] : overlap) {
+        exportList.emplace_back(cell, part, AttributeSet::copy);
     }
     // remove multiple entries
     auto compare = [](const std::tuple<int,int,char>& t1, const std::tuple<int,int,char>& t2)
@@ -763,11 +954,13 @@ namespace cpgrid
                WellConnections>
     vanillaPartitionGridOnRoot(const CpGrid& grid, const std::vector<cpgrid::OpmWellType> * wells,
                                const std::unordered_map<std::string, std::set<int>>& possibleFutureConnections,
-                               const double* transmissibilities, bool allowDistributedWells = false)
+                               const double* transmissibilities, bool allowDistributedWells,
+                               double imbalanceTol, const std::vector<double>& cellWeights)
     {
         int root = 0;
         const auto& cc = grid.comm();
         std::vector<int> parts;
+        const int weightDim = cellWeightDimension(grid, cellWeights, cc, root);
 
         if (cc.rank() == root)
         {
@@ -778,9 +971,58 @@ namespace cpgrid
             initialSplit[1]=initialSplit[2]=std::pow(cc.size(), 1.0/3.0);
             initialSplit[0]=cc.size()/(initialSplit[1]*initialSplit[2]);
             partition(grid, initialSplit, numParts, parts, false, false);
+            if (weightDim > 0)
+            {
+                rebalancePartition(grid, parts, combinedCellWeights(cellWeights, weightDim),
+                                   numParts, imbalanceTol);
+            }
         }
         return createListsFromParts(grid, wells, possibleFutureConnections, transmissibilities, parts, allowDistributedWells);
     }
+
+    int cellWeightDimension(const CpGrid& grid,
+                            const std::vector<double>& cellWeights,
+                            const Communication<Dune::MPIHelper::MPICommunicator>& cc,
+                            int root, int level)
+    {
+        int dim = 0;
+        if (cc.rank() == root && !cellWeights.empty())
+        {
+            const std::size_t numCells = grid.numCells(level);
+            dim = (numCells > 0 && cellWeights.size() % numCells == 0) ? cellWeights.size() / numCells : -1;
+        }
+        cc.broadcast(&dim, 1, root);
+        if (dim < 0)
+        {
+            const std::string msg = "The number of cell weights has to be a multiple of the number of cells.";
+            if (cc.rank() == root)
+            {
+                OPM_THROW(std::invalid_argument, msg);
+            }
+            else
+            {
+                OPM_THROW_NOLOG(std::invalid_argument, msg);
+            }
+        }
+        return dim;
+    }
 #endif
+
+    std::vector<double> combinedCellWeights(const std::vector<double>& cellWeights, int dim)
+    {
+        if (dim <= 1)
+        {
+            return cellWeights;
+        }
+        std::vector<double> combined(cellWeights.size() / dim, 0.0);
+        for (std::size_t cell = 0; cell < combined.size(); ++cell)
+        {
+            for (int j = 0; j < dim; ++j)
+            {
+                combined[cell] += cellWeights[cell*dim + j];
+            }
+        }
+        return combined;
+    }
 } // namespace cpgrid
 } // namespace Dune
@@ -79,6 +79,61 @@ namespace Dune
                    bool recursive = false,
                    bool ensureConnectivity = true);
 
+    /// \brief Improves the balance of a partitioning by moving cells to neighbouring partitions.
+    ///
+    /// Starting from the given partitioning, cells of partitions whose load exceeds
+    /// the mean load are moved across the partition boundary to the least loaded
+    /// neighbouring partition, as long as this reduces the larger of the two loads.
+    /// The sweeps over the cells stop once no partition exceeds imbalance_tol times
+    /// the mean load. Cells that need not move keep their partition, which makes this
+    /// suitable for rebalancing a grid that is already distributed.
+    /// @param[in] grid the grid that is partitioned (its leaf view)
+    /// @param[inout] cell_part a vector containing, for each cell, its partition number
+    /// @param[in] cell_weights the load of each cell
+    /// @param[in] num_part the number of partitions
+    /// @param[in] imbalance_tol the tolerated ratio of the maximum to the mean load
+    /// @param[in] max_sweeps the maximum number of sweeps over all cells
+    void rebalancePartition(const CpGrid& grid,
+                            std::vector<int>& cell_part,
+                            const std::vector<double>& cell_weights,
+                            int num_part,
+                            double imbalance_tol,
+                            int max_sweeps = 100);
+
+    /// \brief Improves the balance of a distributed grid by moving cells between neighbouring processes.
+    ///
+    /// The processes exchange load by first order diffusion: in each sweep every
+    /// process passes a share of the load difference to each less loaded process
+    /// owning a neighbour of one of its cells. The cells passed on are taken from
+    /// the boundary to that process inwards. Only the loads are communicated,
+    /// the cells themselves are not moved.
+    /// @param[in] grid the distributed grid (its leaf view)
+    /// @param[inout] cell_owner for each cell the rank owning it. The entries of the
+    ///               cells owned by this rank are changed to the rank of their new owner.
+    /// @param[in] cell_weights the load of each cell, only used for the owned ones
+    /// @param[in] imbalance_tol the tolerated ratio of the maximum to the mean load
+    /// @param[in] max_sweeps the maximum number of sweeps
+    void rebalanceDistributedPartition(const CpGrid& grid,
+                                       std::vector<int>& cell_owner,
+                                       const std::vector<double>& cell_weights,
+                                       double imbalance_tol,
+                                       int max_sweeps = 100);
+
+    /// \brief Computes which processes hold the cells of a distributed grid after they changed owners.
+    ///
+    /// Besides its owner, a cell is held by every process owning a cell at most
+    /// layers face neighbours away. The owner of each cell, which sees all its
+    /// neighbours, computes this layer by layer and sends it to the copies.
+    /// @param[in] grid the distributed grid (its leaf view)
+    /// @param[inout] cell_owner for each cell the rank owning it. On input only the
+    ///               entries of the cells owned by this rank are used, on output
+    ///               the entries of the copies are set too.
+    /// @param[in] layers the number of overlap layers
+    /// @return for each cell the sorted ranks holding it, including its owner.
+    std::vector<std::vector<int>> distributedOverlap(const CpGrid& grid,
+                                                     std::vector<int>& cell_owner,
+                                                     int layers);
+
     /// \brief Adds a layer of overlap cells to a partitioning.
     /// \param[in] grid The grid that is partitioned.
     /// \param[in] cell_part a vector containing each cells partition number.
@@ -170,6 +225,11 @@ namespace cpgrid
     ///                                  The grid will then be partitioned such that these connections are on the same
     ///                                  partition. If NULL, they will be neglected.
     /// \param transmissibilities C-array with transmissibilities or nullptr.
+    /// \param allowDistributedWells
+    /// \param imbalanceTol The tolerated ratio of the maximum to the mean weight per partition.
+    ///                     Only used with cell weights.
+    /// \param cellWeights The weights of the cells on the root, see cellWeightDimension. If given,
+    ///                    the Cartesian partitioning is rebalanced with rebalancePartition.
     /// \return  A tuple consisting of a vector that contains for each local cell of the original grid the
     ///         the number of the process that owns it after repartitioning,
     ///         a vector containing a pair of name  and a boolean indicating whether this well has
@@ -188,8 +248,33 @@ namespace cpgrid
                                const std::vector<cpgrid::OpmWellType> * wells,
                                const std::unordered_map<std::string, std::set<int>>& possibleFutureConnections,
                                const double* transmissibilities,
-                               bool allowDistributedWells);
+                               bool allowDistributedWells,
+                               double imbalanceTol = 1.1,
+                               const std::vector<double>& cellWeights = {});
+
+    /// \brief Get the number of weights per cell of the cell weights given on the root.
+    ///
+    /// The weights of a cell are stored consecutively, i.e. cellWeights[cell*dim + j] is
+    /// the j-th weight (constraint) of cell. Throws on all ranks if the size of the
+    /// weights is not a multiple of the number of cells.
+    /// \param grid The grid to be partitioned, whose cells are on the root.
+    /// \param cellWeights The weights of the cells, only used on the root.
+    /// \param cc The communication object.
+    /// \param root The rank holding the grid.
+    /// \param level The level grid to be partitioned, -1 for the leaf grid view.
+    /// \return The number of weights per cell on all ranks, 0 if no weights are given.
+    int cellWeightDimension(const CpGrid& grid,
+                            const std::vector<double>& cellWeights,
+                            const Communication<Dune::MPIHelper::MPICommunicator>& cc,
+                            int root, int level = -1);
 #endif
+
+    /// \brief Sum up the weights of each cell.
+    ///
+    /// For partitioners that balance only one weight per cell.
+    /// \param cellWeights The weights, dim consecutive ones per cell.
+    /// \param dim The number of weights per cell.
+    std::vector<double> combinedCellWeights(const std::vector<double>& cellWeights, int dim);
 } // namespace cpgrid
 } // namespace Dune
 
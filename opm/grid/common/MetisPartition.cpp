@@ -25,6 +25,7 @@
 #include <opm/grid/utility/OpmLog.hpp>
 
 #include <opm/grid/common/ZoltanGraphFunctions.hpp>
+#include <opm/grid/common/GridGraph.hpp>
 #include <opm/grid/common/MetisPartition.hpp>
 #include <opm/grid/utility/OpmWellType.hpp>
 #include <opm/grid/cpgrid/CpGridData.hpp>
@@ -156,7 +157,8 @@ metisSerialGraphPartitionGridOnRoot(const CpGrid& cpgrid,
                                     int root,
                                     real_t imbalanceTol,
                                     bool allowDistributedWells,
-                                    [[maybe_unused]] const std::map<std::string,std::string>& params)
+                                    [[maybe_unused]] const std::map<std::string,std::string>& params,
+                                    const std::vector<double>& cellWeights)
 {
 #if defined(IDXTYPEWIDTH) // IDXTYPEWIDTH might be an expression, e.g. sizeof(::idx_t) * 8
     if ( IDXTYPEWIDTH != 64 && edgeWeightsMethod == Dune::EdgeWeightMethod::defaultTransEdgeWgt )
@@ -176,6 +178,7 @@ metisSerialGraphPartitionGridOnRoot(const CpGrid& cpgrid,
                                                        edgeWeightsMethod));
     }
 
+    const int weightDim = cellWeightDimension(cpgrid, cellWeights, cc, root);
     std::vector<int> partitionVector;
     int rc = METIS_OK;
 
@@ -199,26 +202,26 @@ metisSerialGraphPartitionGridOnRoot(const CpGrid& cpgrid,
         // The number of partitions to split the graph into, we want to distribtue over all processes, so cc.size()
         idx_t nparts = cc.size();
 
-        auto& globalIdSet         =  cpgrid.globalIdSet();
-        auto& localIdSet          =  cpgrid.localIdSet();
-
-        idx_t* gids = new idx_t[n];
-        idx_t* lids = new idx_t[n];
-
-        int idx = 0;
-        for (auto cell = cpgrid.leafbegin<0>(), cellEnd = cpgrid.leafend<0>(); cell != cellEnd; ++cell)
-        {
-            gids[idx]   = globalIdSet.id(*cell);
-            lids[idx++] = localIdSet.id(*cell);
-        }
-
         //The number of balancing constraints, should be at least 1.
-        idx_t ncon = 1;
-
-        // The adjacency structure of a graph with n vertices and m edges is represented using two arrays xadj and adjncy.
-        // An array of size n+1 that specifies the adjacency structure of the graph. The adjacency list of vertex i is stored in adjncy[xadj[i]] to adjncy[xadj[i+1]-1].
-        idx_t* xadj = new idx_t[n+1];
-        xadj[0] = 0;
+        // With cell weights this is the number of weights per cell.
+        idx_t ncon = weightDim > 0 ? weightDim : 1;
+
+        // The adjacency structure of the graph in CSR format: the adjacency list of vertex i is
+        // stored in adjncy[xadj[i]] to adjncy[xadj[i+1]-1], and the weight of edge adjncy[j] in
+        // adjwgt[j]. Every cell is a vertex, and for each edge between vertices v and u both (v, u)
+        // and (u, v) are stored. With wells, the cells perforated by the same well are connected
+        // by edges of maximum weight; without wells, all edges have the same weight.
+        // The vertex weights are stored in vwgt[i*ncon+j]; without cell weights all vertices weigh the same.
+        auto graph = wells
+            ? GridGraph<idx_t, idx_t>(*gridAndWells)
+            : GridGraph<idx_t, idx_t>(cpgrid);
+        if (weightDim > 0) {
+            graph.setVertexWeights(cellWeights, weightDim);
+        }
+        idx_t* xadj = const_cast<idx_t*>(graph.xadj().data());
+        idx_t* adjncy = const_cast<idx_t*>(graph.adjncy().data());
+        idx_t* adjwgt = graph.hasEdgeWeights() ? const_cast<idx_t*>(graph.edgeWeights().data()) : nullptr;
+        idx_t* vwgt = weightDim > 0 ? const_cast<idx_t*>(graph.vertexWeights().data()) : nullptr;
 
         int manuallySelectedMethod = 0; // 0: choose according to number of partitions, 1: recursive, 2: kway
 #if IS_SCOTCH_METIS_HEADER
@@ -237,58 +240,12 @@ metisSerialGraphPartitionGridOnRoot(const CpGrid& cpgrid,
         Dune::cpgrid::setMetisOptions(params, manuallySelectedMethod, options);
 #endif
 
-        // This is an array of size ncon (in our case, of size 1) that specifies the allowed load imbalance tolerance for each constraint.
+        // This is an array of size ncon that specifies the allowed load imbalance tolerance for each constraint.
         // For the ith partition and jth constraint the allowed weight is the ubvec[j]*tpwgts[i*ncon+j] fraction
         // of the jth’s constraint total weight. The load imbalances must be greater than 1.0.
         // A NULL value can be passed indicating that the load imbalance tolerance for each constraint should
-        // be 1.001 (for ncon=1) or 1.01 (for ncon>1).
-        real_t ubvec = imbalanceTol;
-
-        //////// Now, we define all variables that *do depend* on whether there are wells or not
-
-        if( wells )
-        {
-            for (int i = 0; i < n;  i++) {
-                xadj[i+1] = xadj[i] + Dune::cpgrid::getNumberOfEdgesForSpecificCellForGridWithWells(*gridAndWells, lids[i]);
-            }
-        }
-        else
-        {
-            for (int i = 0; i < n;  i++) {
-                xadj[i+1] = xadj[i] + Dune::cpgrid::getNumberOfEdgesForSpecificCell(cpgrid, lids[i]);
-            }
-        }
-
-        // The number of edges depends on whether there are wells or not, twoM = 2*m, where m = number of edges.
-        idx_t twoM = xadj[n];
-
-        // An array that contains the adjacency list of the graph.
-        // The xadj array is of size n + 1 whereas the adjncy array is of size 2m (because for each edge between vertices v and u we actually store both (v, u) and (u, v)).
-        // The adjacency list of vertex i is stored in array adjncy starting at index xadj[i] and ending at (but not
-        // including) index xadj[i + 1] (i.e., adjncy[xadj[i]] through and including adjncy[xadj[i + 1]-1])
-        // So: xadj contains the indices where we start for the respective component
-        idx_t* adjncy = new idx_t[twoM];
-
-        // An array that contains the weights of the edges. If all edges have the same weight, this can be set to NULL.
-        // The weights of the edges (if any) are stored in an additional array called adjwgt. This array contains 2m elements, and the weight of edge adjncy[j] is stored at location adjwgt[j]
-        idx_t* adjwgt = new idx_t[twoM];
-
-        if( wells )
-        {
-            int neighborCounter = 0;
-            for( int cell = 0; cell < n;  cell++ )
-            {
-                fillNBORGIDAndWeightsForSpecificCellAndIncrementNeighborCounterForGridWithWells(*gridAndWells, lids[cell], gids, neighborCounter, adjncy, adjwgt);
-            }
-        }
-        else
-        {
-            int neighborCounter = 0;
-            for( int cell = 0; cell < n;  cell++ )
-            {
-                fillNBORGIDForSpecificCellAndIncrementNeighborCounter(cpgrid, lids[cell], gids, neighborCounter, adjncy);
-            }
-        }
+        // be 1.001 (for ncon=1) or 1.01 (for ncon>1). We use the same tolerance for all constraints.
+        std::vector<real_t> ubvec(ncon, imbalanceTol);
 
         // Decide which partition method to use, both methods create k partitions, where
         // METIS_PartGraphRecursive uses multilevel recursive bisection and
@@ -304,12 +261,12 @@ metisSerialGraphPartitionGridOnRoot(const CpGrid& cpgrid,
                                           &ncon,
                                           xadj,
                                           adjncy,
-                                          nullptr, // vwgt
+                                          vwgt,
                                           nullptr, // vsize,
-                                          wells ? adjwgt : nullptr,
+                                          adjwgt,
                                           &nparts,
                                           nullptr, // tpwgts,
-                                          &ubvec,
+                                          ubvec.data(),
                                           options,
                                           &objval,
                                           gpart);
@@ -319,12 +276,12 @@ metisSerialGraphPartitionGridOnRoot(const CpGrid& cpgrid,
                                      &ncon,
                                      xadj,
                                      adjncy,
-                                     nullptr, // vwgt
+                                     vwgt,
                                      nullptr, // vsize,
-                                     wells ? adjwgt : nullptr,
+                                     adjwgt,
                                      &nparts,
                                      nullptr, // tpwgts,
-                                     &ubvec,
+                                     ubvec.data(),
                                      options,
                                      &objval,
                                      gpart);
@@ -332,11 +289,6 @@ metisSerialGraphPartitionGridOnRoot(const CpGrid& cpgrid,
 
         partitionVector.assign(gpart, gpart + n);
 
-        delete[] gids;
-        delete[] lids;
-        delete[] xadj;
-        delete[] adjncy;
-        delete[] adjwgt;
         delete[] options;
         delete[] gpart;
     }
@@ -95,6 +95,9 @@ namespace cpgrid
 /// @param imbalanceTol Set the imbalance tolerance used by METIS, i.e. the entries of the parameter ubvec
 /// @param allowDistributedWells Allow the perforation of a well to be distributed to the
 ///        interior region of multiple processes.
+/// @param params Options passed on to METIS.
+/// @param cellWeights The weights of the cells on the root, see cellWeightDimension.
+///        With several weights per cell METIS balances each of them separately.
 /// @return A tuple consisting of a vector that contains for each local cell of the original grid the
 ///         the number of the process that owns it after repartitioning,
 ///         a vector containing a pair of name  and a boolean indicating whether this well has
@@ -120,7 +123,8 @@ metisSerialGraphPartitionGridOnRoot(const CpGrid& grid,
                                     int root,
                                     real_t imbalanceTol,
                                     bool allowDistributedWells,
-                                    const std::map<std::string,std::string>& params);
+                                    const std::map<std::string,std::string>& params,
+                                    const std::vector<double>& cellWeights = {});
 }
 }
 
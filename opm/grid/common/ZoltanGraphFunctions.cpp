@@ -21,6 +21,7 @@
 #ifdef HAVE_CONFIG_H
 #include <config.h>
 #endif
+#include <algorithm>
 #include <limits>
 
 
@@ -28,6 +29,7 @@
 #include <opm/grid/utility/OpmWellType.hpp>
 
 #include <opm/grid/common/ZoltanGraphFunctions.hpp>
+#include <opm/grid/common/GridGraph.hpp>
 #include <dune/common/parallel/indexset.hh>
 
 namespace Dune
@@ -74,6 +76,27 @@ void getCpGridVertexList(void* cpGridPointer, int numGlobalIdEntries,
     *err = ZOLTAN_OK;
 }
 
+void getGridGraphVertexList(void* gridGraphPointer, int numGlobalIdEntries,
+                            int numLocalIdEntries, ZOLTAN_ID_PTR gids,
+                            ZOLTAN_ID_PTR lids, int wgtDim,
+                            float *objWgts, int *err)
+{
+    const ZoltanGridGraph& graph = *static_cast<const ZoltanGridGraph*>(gridGraphPointer);
+    if ( wgtDim != 0 && wgtDim != graph.numVertexWeights() )
+    {
+        *err = ZOLTAN_FATAL;
+        return;
+    }
+    getCpGridVertexList(const_cast<CpGrid*>(&graph.grid()), numGlobalIdEntries, numLocalIdEntries,
+                        gids, lids, wgtDim, objWgts, err);
+    if ( *err == ZOLTAN_OK && wgtDim > 0 )
+    {
+        // The vertices are listed in the order of the cells, like the weights.
+        const auto& weights = graph.vertexWeights();
+        std::copy(weights.begin(), weights.end(), objWgts);
+    }
+}
+
 void getNullNumEdgesList(void *cpGridPointer, int sizeGID, int sizeLID,
                            int numCells,
                            ZOLTAN_ID_PTR globalID, ZOLTAN_ID_PTR localID,
@@ -340,6 +363,62 @@ void getCpGridWellsEdgeList(void *graphPointer, int sizeGID, int sizeLID,
 #endif
 }
 
+void getGridGraphNumEdgesList(void *gridGraphPointer, int sizeGID, int sizeLID,
+                              int numCells,
+                              ZOLTAN_ID_PTR globalID, ZOLTAN_ID_PTR localID,
+                              int *numEdges, int *err)
+{
+    (void) globalID;
+    const ZoltanGridGraph& graph = *static_cast<const ZoltanGridGraph*>(gridGraphPointer);
+    if ( sizeGID != 1 || sizeLID != 1 || numCells != graph.numVertices() )
+    {
+        *err = ZOLTAN_FATAL;
+        return;
+    }
+    for( int i = 0; i < numCells;  i++ )
+    {
+        numEdges[i] = graph.numEdges(localID[i]);
+    }
+    *err = ZOLTAN_OK;
+}
+
+void getGridGraphEdgeList(void *gridGraphPointer, int sizeGID, int sizeLID,
+                          int numCells, ZOLTAN_ID_PTR globalID, ZOLTAN_ID_PTR localID,
+                          int *numEdges,
+                          ZOLTAN_ID_PTR nborGID, int *nborProc,
+                          int wgtDim, float *ewgts, int *err)
+{
+    (void) numEdges;
+    const ZoltanGridGraph& graph = *static_cast<const ZoltanGridGraph*>(gridGraphPointer);
+    if ( sizeGID != 1 || sizeLID != 1 || numCells != graph.numVertices() )
+    {
+        *err = ZOLTAN_FATAL;
+        return;
+    }
+    const auto& xadj = graph.xadj();
+    const auto& adjncy = graph.adjncy();
+    const auto& weights = graph.edgeWeights();
+    const bool copyWeights = wgtDim == 1 && graph.hasEdgeWeights();
+    const int myrank = graph.grid().comm().rank();
+    int neighborCounter = 0;
+
+    for( int cell = 0; cell < numCells;  cell++ )
+    {
+        const int lid = localID[cell];
+        assert(numEdges[cell] == xadj[lid + 1] - xadj[lid]);
+        for ( int edge = xadj[lid]; edge < xadj[lid + 1]; ++edge, ++neighborCounter )
+        {
+            nborGID[neighborCounter] = globalID[adjncy[edge]];
+            nborProc[neighborCounter] = myrank;
+            if ( copyWeights )
+            {
+                ewgts[neighborCounter] = weights[edge];
+            }
+        }
+    }
+    *err = ZOLTAN_OK;
+}
+
 CombinedGridWellGraph::CombinedGridWellGraph(const CpGrid& grid,
                                              const std::vector<OpmWellType> * wells,
                                              const std::unordered_map<std::string, std::set<int>>& possibleFutureConnections,
@@ -411,6 +490,17 @@ void setCpGridZoltanGraphFunctions(Zoltan_Struct *zz,
         Zoltan_Set_Edge_List_Multi_Fn(zz, getCpGridWellsEdgeList, graphPointer);
     }
 }
+void setCpGridZoltanGraphFunctions(Zoltan_Struct *zz,
+                                   const ZoltanGridGraph& graph)
+{
+    Dune::CpGrid *gridPointer = const_cast<Dune::CpGrid*>(&graph.grid());
+    ZoltanGridGraph* graphPointer = const_cast<ZoltanGridGraph*>(&graph);
+    Zoltan_Set_Num_Obj_Fn(zz, getCpGridNumCells, gridPointer);
+    Zoltan_Set_Obj_List_Fn(zz, getGridGraphVertexList, graphPointer);
+    Zoltan_Set_Num_Edges_Multi_Fn(zz, getGridGraphNumEdgesList, graphPointer);
+    Zoltan_Set_Edge_List_Multi_Fn(zz, getGridGraphEdgeList, graphPointer);
+}
+
 // Explicit template instantiation for METIS
 #if HAVE_METIS
 template
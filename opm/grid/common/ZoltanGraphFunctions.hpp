@@ -41,6 +41,12 @@ namespace Dune
 {
 namespace cpgrid
 {
+template<class Index, class Weight>
+class GridGraph;
+
+/// \brief The graph of a grid with the index and weight types used for Zoltan.
+using ZoltanGridGraph = GridGraph<int, float>;
+
 /// \brief Get the number of cells of the grid.
 ///
 /// The cells are the vertices of the graph.
@@ -119,6 +125,25 @@ void getCpGridWellsEdgeList(void *cpGridWellsPointer, int sizeGID, int sizeLID,
                        int *num_edges,
                        ZOLTAN_ID_PTR nborGID, int *nborProc,
                        int wgt_dim, float *ewgts, int *err);
+
+/// \brief Get the list of vertices, and their weights if any, of a precomputed ZoltanGridGraph.
+void getGridGraphVertexList(void* gridGraphPointer, int numGlobalIds,
+                            int numLocalIds, ZOLTAN_ID_PTR gids,
+                            ZOLTAN_ID_PTR lids, int wgtDim,
+                            float *objWgts, int *err);
+
+/// \brief Get the number of edges of a precomputed ZoltanGridGraph.
+void getGridGraphNumEdgesList(void *gridGraphPointer, int sizeGID, int sizeLID,
+                              int numCells,
+                              ZOLTAN_ID_PTR globalID, ZOLTAN_ID_PTR localID,
+                              int *numEdges, int *err);
+
+/// \brief Get the list of edges, and their weights if any, of a precomputed ZoltanGridGraph.
+void getGridGraphEdgeList(void *gridGraphPointer, int sizeGID, int sizeLID,
+                          int numCells, ZOLTAN_ID_PTR globalID, ZOLTAN_ID_PTR localID,
+                          int *num_edges,
+                          ZOLTAN_ID_PTR nborGID, int *nborProc,
+                          int wgt_dim, float *ewgts, int *err);
 } // end namespace cpgrid
 } // end namespace Dune
 
@@ -259,6 +284,15 @@ void setCpGridZoltanGraphFunctions(Zoltan_Struct *zz, const Dune::CpGrid& grid,
 void setCpGridZoltanGraphFunctions(Zoltan_Struct *zz,
                                    const CombinedGridWellGraph& graph,
                                    bool pretendNull);
+
+/// \brief Sets up the call-back functions for ZOLTAN's graph partitioning
+///        from a precomputed graph.
+///
+/// The graph must outlive the partitioning.
+/// \param zz The struct with the information for ZOLTAN.
+/// \param graph The graph of the grid, and possibly the wells, to partition.
+void setCpGridZoltanGraphFunctions(Zoltan_Struct *zz,
+                                   const ZoltanGridGraph& graph);
 #endif // HAVE_ZOLTAN
 } // end namespace cpgrid
 } // end namespace Dune
@@ -22,12 +22,15 @@
 #endif
 #if HAVE_MPI // no code in this file without MPI. Skip includes-
 #include <opm/grid/common/ZoltanPartition.hpp>
+#include <opm/grid/common/GridGraph.hpp>
+#include <opm/grid/common/GridPartitioning.hpp>
 #include <opm/grid/cpgrid/CpGridData.hpp>
 #include <opm/grid/cpgrid/Entity.hpp>
 #include <opm/grid/utility/OpmLog.hpp>
 #include <opm/grid/utility/OpmWellType.hpp>
 
 #include <algorithm>
+#include <memory>
 #include <type_traits>
 #endif
 
@@ -307,7 +310,8 @@ zoltanGraphPartitionGridOnRoot(const CpGrid& cpgrid,
                                int root,
                                const double zoltanImbalanceTol,
                                bool allowDistributedWells,
-                               const std::map<std::string,std::string>& params)
+                               const std::map<std::string,std::string>& params,
+                               const std::vector<double>& cellWeights)
 {
     float ver = 0;
     struct Zoltan_Struct *zz;
@@ -328,6 +332,9 @@ zoltanGraphPartitionGridOnRoot(const CpGrid& cpgrid,
     Zoltan_Set_Param(zz, "IMBALANCE_TOL", std::to_string(zoltanImbalanceTol).c_str());
     for (const auto& [key, value] : params)
         Zoltan_Set_Param(zz, key.c_str(), value.c_str());
+    const int weightDim = cellWeightDimension(cpgrid, cellWeights, cc, root);
+    if (weightDim > 0)
+        Zoltan_Set_Param(zz, "OBJ_WEIGHT_DIM", "1");
 
     // For the load balancer one process has the whole grid and
     // all others an empty partition before loadbalancing.
@@ -344,13 +351,22 @@ zoltanGraphPartitionGridOnRoot(const CpGrid& cpgrid,
                                                        transmissibilities,
                                                        partitionIsEmpty,
                                                        edgeWeightsMethod));
-        Dune::cpgrid::setCpGridZoltanGraphFunctions(zz, *gridAndWells,
-                                                    partitionIsEmpty);
     }
-    else
+
+    std::unique_ptr<ZoltanGridGraph> graph;
+    if ( partitionIsEmpty )
     {
         Dune::cpgrid::setCpGridZoltanGraphFunctions(zz, cpgrid, partitionIsEmpty);
     }
+    else
+    {
+        graph = wells
+            ? std::make_unique<ZoltanGridGraph>(*gridAndWells)
+            : std::make_unique<ZoltanGridGraph>(cpgrid);
+        if (weightDim > 0)
+            graph->setVertexWeights(combinedCellWeights(cellWeights, weightDim), 1);
+        Dune::cpgrid::setCpGridZoltanGraphFunctions(zz, *graph);
+    }
 
     rc = Zoltan_LB_Partition(zz, /* input (all remaining fields are output) */
                              &changes,        /* 1 if partitioning was changed, 0 otherwise */
@@ -412,7 +428,8 @@ public:
                             const double _zoltanImbalanceTol,
                             bool _allowDistributedWells,
                             int _numParts,
-                            const std::map<std::string,std::string>& param)
+                            const std::map<std::string,std::string>& param,
+                            const std::vector<double>& _cellWeights)
         : cpgrid(_cpgrid)
         , wells(_wells)
         , possibleFutureConnections(_possibleFutureConnections)
@@ -424,6 +441,7 @@ public:
         , allowDistributedWells(_allowDistributedWells)
         , numParts(_numParts)
         , params(param)
+        , cellWeights(_cellWeights)
     {
         if (wells) {
             const bool partitionIsEmpty = cc.rank() != root;
@@ -454,6 +472,9 @@ public:
                WellConnections>
     partition()
     {
+        // Collective, hence only here and not in partitionForInfo(), which
+        // may run on some ranks only and never gets cell weights.
+        weightDim = cellWeightDimension(cpgrid, cellWeights, cc, root);
         MPI_Barrier(cc);
 
         // Initialize Zoltan and perform partitioning.
@@ -525,6 +546,8 @@ private:
 
         for (const auto& [key, value] : params)
             Zoltan_Set_Param(zz, key.c_str(), value.c_str());
+        if (weightDim > 0)
+            Zoltan_Set_Param(zz, "OBJ_WEIGHT_DIM", "1");
 
         // For the load balancer one process has the whole grid and
         // all others an empty partition before loadbalancing.
@@ -532,9 +555,18 @@ private:
 
         if (wells) {
             Zoltan_Set_Param(zz, "EDGE_WEIGHT_DIM", "1");
-            Dune::cpgrid::setCpGridZoltanGraphFunctions(zz, *gridAndWells, partitionIsEmpty);
-        } else {
+        }
+        if (partitionIsEmpty) {
             Dune::cpgrid::setCpGridZoltanGraphFunctions(zz, cpgrid, partitionIsEmpty);
+        } else {
+            if (!graph) {
+                graph = wells
+                    ? std::make_unique<ZoltanGridGraph>(*gridAndWells)
+                    : std::make_unique<ZoltanGridGraph>(cpgrid);
+                if (weightDim > 0)
+                    graph->setVertexWeights(combinedCellWeights(cellWeights, weightDim), 1);
+            }
+            Dune::cpgrid::setCpGridZoltanGraphFunctions(zz, *graph);
         }
 
         rc = Zoltan_LB_Partition(zz, /* input (all remaining fields are output) */
@@ -582,11 +614,14 @@ private:
     ZOLTAN_ID_PTR exportLocalGids = nullptr;
     int *importProcs, *importToPart, *exportProcs, *exportToPart;
     std::unique_ptr<CombinedGridWellGraph> gridAndWells;
+    std::unique_ptr<ZoltanGridGraph> graph;
     using ZoltanId = typename std::remove_pointer<ZOLTAN_ID_PTR>::type;
     std::vector<ZoltanId> importGlobalGidsVector;
     bool allowDistributedWells;
     int numParts;
     const std::map<std::string,std::string>& params;
+    const std::vector<double>& cellWeights;
+    int weightDim = 0;
 };
 
 
@@ -604,10 +639,11 @@ zoltanSerialGraphPartitionGridOnRoot(const CpGrid& cpgrid,
                                      int root,
                                      const double zoltanImbalanceTol,
                                      bool allowDistributedWells,
-                                     const std::map<std::string,std::string>& params)
+                                     const std::map<std::string,std::string>& params,
+                                     const std::vector<double>& cellWeights)
 {
     ZoltanSerialPartitioner partitioner(cpgrid, wells, possibleFutureConnections, transmissibilities, cc, edgeWeightsMethod,
-                                        root, zoltanImbalanceTol, allowDistributedWells, 0, params);
+                                        root, zoltanImbalanceTol, allowDistributedWells, 0, params, cellWeights);
     return partitioner.partition();
 }
 
@@ -620,13 +656,14 @@ zoltanGraphPartitionGridForJac(const CpGrid& cpgrid,
                                EdgeWeightMethod edgeWeightsMethod, int root,
                                int numParts, const double zoltanImbalanceTol)
 {
-    // Parameters are empty, but must still have scope here since it
-    // (or rather a const reference to it) is queried in
-    // partitionForInfo() further down.
+    // Parameters and cell weights are empty, but must still have scope
+    // here since they (or rather const references to them) are queried
+    // in partitionForInfo() further down.
     std::map<std::string,std::string> params;
+    std::vector<double> cellWeights;
 
     ZoltanSerialPartitioner partitioner(cpgrid, wells, possibleFutureConnections, transmissibilities, cc, edgeWeightsMethod,
-                                        root, zoltanImbalanceTol, false, numParts, params);
+                                        root, zoltanImbalanceTol, false, numParts, params, cellWeights);
     return partitioner.partitionForInfo();
 }
 
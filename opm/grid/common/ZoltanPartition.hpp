@@ -118,6 +118,9 @@ namespace cpgrid
 /// @param zoltanImbalanceTol Set the imbalance tolerance used by Zoltan
 /// \param allowDistributedWells Allow the perforation of a well to be distributed to the
 ///        interior region of multiple processes.
+/// @param params Parameters passed on to Zoltan.
+/// @param cellWeights The weights of the cells on the root, see cellWeightDimension.
+///        Zoltan balances their sum per cell.
 /// @return A tuple consisting of a vector that contains for each local cell of the original grid the
 ///         the number of the process that owns it after repartitioning,
 ///         a vector containing a pair of name  and a boolean indicating whether this well has
@@ -141,7 +144,8 @@ zoltanGraphPartitionGridOnRoot(const CpGrid& grid,
                                EdgeWeightMethod edgeWeightsMethod, int root,
                                const double zoltanImbalanceTol,
                                bool allowDistributedWells,
-                               const std::map<std::string,std::string>& params);
+                               const std::map<std::string,std::string>& params,
+                               const std::vector<double>& cellWeights = {});
 
 /// \brief Partition a CpGrid using Zoltan serially only on rank 0
 ///
@@ -165,6 +169,9 @@ zoltanGraphPartitionGridOnRoot(const CpGrid& grid,
 /// @param zoltanImbalanceTol Set the imbalance tolerance used by Zoltan
 /// @param allowDistributedWells Allow the perforation of a well to be distributed to the
 ///        interior region of multiple processes.
+/// @param params Parameters passed on to Zoltan.
+/// @param cellWeights The weights of the cells on the root, see cellWeightDimension.
+///        Zoltan balances their sum per cell.
 /// @return A tuple consisting of a vector that contains for each local cell of the original grid the
 ///         the number of the process that owns it after repartitioning,
 ///         a set of names of wells that should be defunct in a parallel
@@ -188,7 +195,8 @@ zoltanSerialGraphPartitionGridOnRoot(const CpGrid& grid,
                                EdgeWeightMethod edgeWeightsMethod, int root,
                                const double zoltanImbalanceTol,
                                bool allowDistributedWells,
-                               const std::map<std::string,std::string>& params);
+                               const std::map<std::string,std::string>& params,
+                               const std::vector<double>& cellWeights = {});
 
 /// \brief Partition a CpGrid using Zoltan
 ///
@@ -70,12 +70,14 @@ checkmemory(size_t nz,
 static void
 process_vertical_faces(bool edge_conformal,
                        int direction,
+                       int jbegin, int jend,
                        int **intersections,
                        int *plist, int *work,
                        struct processed_grid *out);
 
 static void
 process_horizontal_faces(bool pinchActive,
+                         int jbegin, int jend,
                          int **intersections,
                          int *plist,
                          const int *is_aquifer_cell,
@@ -229,10 +231,13 @@ checkmemory(size_t nz,
 
   direction == 0 : constant-i faces (parallel to J-K plane).
   direction == 1 : constant-j faces (parallel to I-K plane).
+
+  Only pillar rows jbegin <= j < jend are processed.
 */
 static void
 process_vertical_faces(bool edge_conformal,
                        int direction,
+                       int jbegin, int jend,
                        int **intersections,
                        int *plist, int *work,
                        struct processed_grid *out)
@@ -257,7 +262,9 @@ process_vertical_faces(bool edge_conformal,
     d[1] = 2 * (ny + 0);
     d[2] = 2 * (nz + 1);
 
-    for (j = 0; j < ny + direction; ++j) {
+    assert ((0 <= jbegin) && (jend <= ny + direction));
+
+    for (j = jbegin; j < jend; ++j) {
         for (i = 0; i < nx + (1 - direction); ++i) {
 
             if (! checkmemory(nz, out, intersections)) {
@@ -327,9 +334,11 @@ process_vertical_faces(bool edge_conformal,
   cells that are have collapsed coordinates. (This includes cells with
   ACTNUM==0)
 
+  Only cell rows jbegin <= j < jend are processed.
 */
 static void
 process_horizontal_faces(bool pinchActive,
+                         int jbegin, int jend,
                          int **intersections,
                          int *plist,
                          const int *is_aquifer_cell,
@@ -354,7 +363,9 @@ process_horizontal_faces(bool pinchActive,
     d[2] = 2+2*nz;
 
 
-    for (j=0; j<ny; ++j) {
+    assert ((0 <= jbegin) && (jend <= ny));
+
+    for (j=jbegin; j<jend; ++j) {
         for (i=0; i<nx; ++i) {
 
             if (! checkmemory(nz, out, intersections)) {
@@ -1099,6 +1110,354 @@ reverse_face_nodes(struct processed_grid *out)
 }
 
 
+/* ----------------------------------------------------------------------
+ * Threaded face processing.
+ *
+ * The pillar rows of each face sweep are split into contiguous tiles.
+ * Every tile is processed into a private, growable processed_grid using
+ * the serial routines above.  Intersection nodes are numbered from
+ * 'number_of_nodes_on_pillars' within each tile and shifted into their
+ * global position when the tiles are stitched, in row order, into the
+ * final result.  The resulting topology is therefore identical to that
+ * of the serial sweep.
+ * ---------------------------------------------------------------------- */
+
+struct face_tile {
+    int jbegin;                 /* First row (inclusive) */
+    int jend;                   /* Last row (exclusive) */
+    int *intersections;         /* Tile-local intersection records */
+    int *work;                  /* findconnections() work array */
+    struct processed_grid g;    /* Tile-local faces */
+};
+
+
+/* ---------------------------------------------------------------------- */
+static int
+init_face_tile(const struct processed_grid *out, struct face_tile *tile)
+/* ---------------------------------------------------------------------- */
+{
+    const size_t BIGNUM = 64;
+    const size_t nwork  = 2 * ((size_t) (2*out->dimensions[2] + 2));
+    size_t       i;
+
+    memset(tile, 0, sizeof *tile);
+
+    tile->g.m = (int) (BIGNUM / 3);
+    tile->g.n = (int) BIGNUM;
+
+    tile->g.face_neighbors = malloc( BIGNUM         * sizeof *tile->g.face_neighbors);
+    tile->g.face_nodes     = malloc( tile->g.n      * sizeof *tile->g.face_nodes);
+    tile->g.face_node_ptr  = malloc((tile->g.m + 1) * sizeof *tile->g.face_node_ptr);
+    tile->g.face_tag       = malloc( tile->g.m      * sizeof *tile->g.face_tag);
+    tile->intersections    = malloc( BIGNUM         * sizeof *tile->intersections);
+    tile->work             = malloc( nwork          * sizeof *tile->work);
+
+    if ((tile->g.face_neighbors == NULL) ||
+        (tile->g.face_nodes     == NULL) ||
+        (tile->g.face_node_ptr  == NULL) ||
+        (tile->g.face_tag       == NULL) ||
+        (tile->intersections    == NULL) ||
+        (tile->work             == NULL))
+    {
+        return 0;
+    }
+
+    /* findconnections() leaves the work array in its initial state. */
+    for (i = 0; i < nwork; ++i) { tile->work[i] = -1; }
+
+    tile->g.dimensions[0] = out->dimensions[0];
+    tile->g.dimensions[1] = out->dimensions[1];
+    tile->g.dimensions[2] = out->dimensions[2];
+
+    /* Shared with the final result.  Each tile writes distinct cells. */
+    tile->g.local_cell_index = out->local_cell_index;
+
+    return 1;
+}
+
+
+/* ---------------------------------------------------------------------- */
+static void
+reset_face_tile(const struct processed_grid *out,
+                int jbegin, int jend,
+                struct face_tile *tile)
+/* ---------------------------------------------------------------------- */
+{
+    tile->jbegin = jbegin;
+    tile->jend   = jend;
+
+    tile->g.number_of_faces            = 0;
+    tile->g.face_node_ptr[0]           = 0;
+    tile->g.number_of_cells            = 0;
+    tile->g.number_of_nodes            = out->number_of_nodes_on_pillars;
+    tile->g.number_of_nodes_on_pillars = out->number_of_nodes_on_pillars;
+}
+
+
+/* ---------------------------------------------------------------------- */
+static void
+free_face_tile(struct face_tile *tile)
+/* ---------------------------------------------------------------------- */
+{
+    free(tile->g.face_neighbors);
+    free(tile->g.face_nodes);
+    free(tile->g.face_node_ptr);
+    free(tile->g.face_tag);
+    free(tile->intersections);
+    free(tile->work);
+}
+
+
+/* ---------------------------------------------------------------------- */
+/* Grow result arrays to hold at least 'nf' faces with a total of 'nfn'
+ * face nodes, and 'ni' intersection records. */
+/* ---------------------------------------------------------------------- */
+static int
+reserve_faces(size_t nf, size_t nfn, size_t ni,
+              size_t *intersection_capacity,
+              int **intersections,
+              struct processed_grid *out)
+/* ---------------------------------------------------------------------- */
+{
+    size_t m = out->m;
+    size_t n = out->n;
+    bool   ok = true;
+
+    if (nf > m) {
+        void *p1, *p2, *p3;
+
+        m += MAX(m / 2, nf - m);
+
+        p1 = realloc(out->face_neighbors, 2*m   * sizeof *out->face_neighbors);
+        p2 = realloc(out->face_node_ptr , (m+1) * sizeof *out->face_node_ptr);
+        p3 = realloc(out->face_tag      , 1*m   * sizeof *out->face_tag);
+
+        if (p1 != NULL) { out->face_neighbors = p1; }
+        if (p2 != NULL) { out->face_node_ptr  = p2; }
+        if (p3 != NULL) { out->face_tag       = p3; }
+
+        ok = (p1 != NULL) && (p2 != NULL) && (p3 != NULL);
+
+        if (ok) { out->m = m; }
+    }
+
+    if (ok && (nfn > n)) {
+        void *p1;
+
+        n += MAX(n / 2, nfn - n);
+
+        p1 = realloc(out->face_nodes, n * sizeof *out->face_nodes);
+
+        ok = p1 != NULL;
+
+        if (ok) {
+            out->face_nodes = p1;
+            out->n          = n;
+        }
+    }
+
+    if (ok && (ni > *intersection_capacity)) {
+        void  *p1;
+        size_t cap = *intersection_capacity;
+
+        cap += MAX(cap / 2, ni - cap);
+
+        p1 = realloc(*intersections, 4 * cap * sizeof **intersections);
+
+        ok = p1 != NULL;
+
+        if (ok) {
+            *intersections         = p1;
+            *intersection_capacity = cap;
+        }
+    }
+
+    return ok;
+}
+
+
+/* ---------------------------------------------------------------------- */
+/* Append tiles, in order, to result structure. */
+/* ---------------------------------------------------------------------- */
+static int
+stitch_face_tiles(int ntiles, const struct face_tile *tiles,
+                  int num_threads,
+                  size_t *intersection_capacity,
+                  int **intersections,
+                  struct processed_grid *out)
+/* ---------------------------------------------------------------------- */
+{
+    const int np = out->number_of_nodes_on_pillars;
+
+    size_t *face_off, *fnode_off, *node_off;
+    size_t  nf, nfn, ni;
+    int     t;
+
+    face_off  = malloc(3 * ((size_t) ntiles + 1) * sizeof *face_off);
+    if (face_off == NULL) {
+        return 0;
+    }
+    fnode_off = face_off  + (ntiles + 1);
+    node_off  = fnode_off + (ntiles + 1);
+
+    face_off [0] = out->number_of_faces;
+    fnode_off[0] = out->face_node_ptr[out->number_of_faces];
+    node_off [0] = out->number_of_nodes - np;
+
+    for (t = 0; t < ntiles; ++t) {
+        const struct processed_grid *g = &tiles[t].g;
+
+        face_off [t + 1] = face_off [t] + g->number_of_faces;
+        fnode_off[t + 1] = fnode_off[t] + g->face_node_ptr[g->number_of_faces];
+        node_off [t + 1] = node_off [t] + (g->number_of_nodes - np);
+    }
+
+    nf  = face_off [ntiles];
+    nfn = fnode_off[ntiles];
+    ni  = node_off [ntiles];
+
+    if (! reserve_faces(nf, nfn, ni, intersection_capacity,
+                        intersections, out)) {
+        free(face_off);
+        return 0;
+    }
+
+#if !defined(_OPENMP)
+    (void) num_threads;
+#else
+#pragma omp parallel for schedule(static) num_threads(num_threads)
+#endif
+    for (t = 0; t < ntiles; ++t) {
+        const struct processed_grid *g = &tiles[t].g;
+        const int shift = (int) node_off[t];
+
+        int          *fn  = out->face_nodes + fnode_off[t];
+        unsigned int *ptr = out->face_node_ptr + face_off[t];
+        size_t        k;
+        unsigned      f;
+
+        for (k = 0; k < g->face_node_ptr[g->number_of_faces]; ++k) {
+            const int node = g->face_nodes[k];
+
+            fn[k] = (node < np) ? node : node + shift;
+        }
+
+        for (f = 0; f < g->number_of_faces; ++f) {
+            ptr[f + 1] = (unsigned int) (fnode_off[t] + g->face_node_ptr[f + 1]);
+        }
+
+        memcpy(out->face_neighbors + 2*face_off[t], g->face_neighbors,
+               2 * ((size_t) g->number_of_faces) * sizeof *g->face_neighbors);
+
+        memcpy(out->face_tag + face_off[t], g->face_tag,
+               ((size_t) g->number_of_faces) * sizeof *g->face_tag);
+
+        memcpy(*intersections + 4*node_off[t], tiles[t].intersections,
+               4 * (node_off[t + 1] - node_off[t]) * sizeof **intersections);
+    }
+
+    out->number_of_faces  = (unsigned) nf;
+    out->number_of_nodes  = (int) (np + ni);
+
+    free(face_off);
+
+    return 1;
+}
+
+
+/* ---------------------------------------------------------------------- */
+/* Threaded counterpart of the three face sweeps
+ *
+ *   process_vertical_faces(direction = 0)
+ *   process_vertical_faces(direction = 1)
+ *   process_horizontal_faces()
+ */
+/* ---------------------------------------------------------------------- */
+static int
+process_faces_threaded(bool pinchActive,
+                       bool edge_conformal,
+                       int num_threads,
+                       int **intersections,
+                       int *plist,
+                       const int *is_aquifer_cell,
+                       struct processed_grid *out)
+/* ---------------------------------------------------------------------- */
+{
+    const int ny = out->dimensions[1];
+
+    struct face_tile *tiles;
+    size_t intersection_capacity;
+    int    ntiles, maxtiles, sweep, nrows, t, ok;
+
+    /* Use a few tiles per thread to balance rows of differing cost. */
+    maxtiles = MIN(4 * num_threads, ny + 1);
+    maxtiles = MAX(maxtiles, 1);
+
+    tiles = calloc(maxtiles, sizeof *tiles);
+    if (tiles == NULL) {
+        return 0;
+    }
+
+    ok = 1;
+    for (t = 0; ok && (t < maxtiles); ++t) {
+        ok = init_face_tile(out, &tiles[t]);
+    }
+
+    /* Intersection records are (re)allocated when stitching. */
+    intersection_capacity = 0;
+
+    out->number_of_cells = 0;
+
+    for (sweep = 0; ok && (sweep < 3); ++sweep) {
+        nrows  = (sweep == 1) ? ny + 1 : ny;
+        ntiles = MIN(maxtiles, nrows);
+
+        for (t = 0; t < ntiles; ++t) {
+            reset_face_tile(out,
+                            (int) ((((size_t) nrows) * (t + 0)) / ntiles),
+                            (int) ((((size_t) nrows) * (t + 1)) / ntiles),
+                            &tiles[t]);
+        }
+
+#ifdef _OPENMP
+#pragma omp parallel for schedule(dynamic, 1) num_threads(num_threads)
+#endif
+        for (t = 0; t < ntiles; ++t) {
+            struct face_tile *tile = &tiles[t];
+
+            if (sweep < 2) {
+                process_vertical_faces(edge_conformal, sweep,
+                                       tile->jbegin, tile->jend,
+                                       &tile->intersections,
+                                       plist, tile->work, &tile->g);
+            }
+            else {
+                process_horizontal_faces(pinchActive,
+                                         tile->jbegin, tile->jend,
+                                         &tile->intersections,
+                                         plist, is_aquifer_cell, &tile->g);
+            }
+        }
+
+        ok = stitch_face_tiles(ntiles, tiles, num_threads,
+                               &intersection_capacity, intersections, out);
+
+        if (sweep == 2) {
+            for (t = 0; t < ntiles; ++t) {
+                out->number_of_cells += tiles[t].g.number_of_cells;
+            }
+        }
+    }
+
+    for (t = 0; t < maxtiles; ++t) {
+        free_face_tile(&tiles[t]);
+    }
+    free(tiles);
+
+    return ok;
+}
+
+
 /* ----------------------------------------------------------------------
  * Public interface
  * ---------------------------------------------------------------------- */
@@ -1108,6 +1467,21 @@ int process_grdecl(int                    pinchActive,
                    const struct grdecl   *in,
                    const int             *is_aquifer_cell,
                    struct processed_grid *out)
+{
+    return process_grdecl_threaded(pinchActive, edge_conformal, tolerance,
+                                   in, is_aquifer_cell,
+                                   /* num_threads = */ 1, out);
+}
+
+/* ---------------------------------------------------------------------- */
+int process_grdecl_threaded(int                    pinchActive,
+                            int                    edge_conformal,
+                            double                 tolerance,
+                            const struct grdecl   *in,
+                            const int             *is_aquifer_cell,
+                            int                    num_threads,
+                            struct processed_grid *out)
+/* ---------------------------------------------------------------------- */
 {
     struct grdecl g = {0};
 
@@ -1218,7 +1592,7 @@ int process_grdecl(int                    pinchActive,
         return 0;
     }
 
-    finduniquepoints(&g, plist, tolerance, out);
+    finduniquepoints_threaded(&g, plist, tolerance, MAX(num_threads, 1), out);
 
     free(zcorn);  zcorn  = NULL;
     free(actnum); actnum = NULL;
@@ -1253,12 +1627,29 @@ int process_grdecl(int                    pinchActive,
         return 0;
     }
 
-    process_vertical_faces(edge_conformal != 0, 0, &intersections, plist, work, out);
-    process_vertical_faces(edge_conformal != 0, 1, &intersections, plist, work, out);
-
-    /* Memory allocation procedure depends on edge conformal flag */
-    process_horizontal_faces(pinchActive != 0, &intersections,
-                             plist, is_aquifer_cell, out);
+    if (num_threads > 1) {
+        if (! process_faces_threaded(pinchActive != 0, edge_conformal != 0,
+                                     num_threads, &intersections,
+                                     plist, is_aquifer_cell, out)) {
+            fprintf(stderr,
+                    "Could not allocate enough space in "
+                    "process_faces_threaded()\n");
+            free(intersections);
+            free(plist);
+            free(work);
+            return 0;
+        }
+    }
+    else {
+        process_vertical_faces(edge_conformal != 0, 0, 0, ny,
+                               &intersections, plist, work, out);
+        process_vertical_faces(edge_conformal != 0, 1, 0, ny + 1,
+                               &intersections, plist, work, out);
+
+        /* Memory allocation procedure depends on edge conformal flag */
+        process_horizontal_faces(pinchActive != 0, 0, ny, &intersections,
+                                 plist, is_aquifer_cell, out);
+    }
 
     free(work);   work  = NULL;
     free(plist);  plist = NULL;
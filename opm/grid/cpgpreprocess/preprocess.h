@@ -167,6 +167,31 @@ extern "C" {
                        const int             *is_aquifer_cell,
                        struct processed_grid *out);
 
+    /**
+     * Construct a prototypical grid representation from a corner-point
+     * specification using multiple threads.
+     *
+     * The pillar sweeps of process_grdecl() are split into independent
+     * tiles of pillar rows that are processed concurrently and then
+     * stitched together in row order.  The resulting grid is identical
+     * to the one produced by process_grdecl().  Threading requires
+     * OpenMP support; the tiles are otherwise processed sequentially.
+     *
+     * @param[in] num_threads Number of threads.  Values less than two
+     *                        select the serial algorithm of
+     *                        process_grdecl().
+     *
+     * All other parameters and the return value are as for
+     * process_grdecl().
+     */
+    int process_grdecl_threaded(int                    pinchActive,
+                                int                    edge_conformal,
+                                double                 tol,
+                                const struct grdecl   *g,
+                                const int             *is_aquifer_cell,
+                                int                    num_threads,
+                                struct processed_grid *out);
+
     /**
      * Release memory resources acquired in previous grid processing using
      * function process_grdecl().
@@ -272,6 +272,25 @@ int finduniquepoints(const struct grdecl *g,
                      double tolerance,
                      struct processed_grid *out)
 
+{
+    return finduniquepoints_threaded(g, plist, tolerance, 1, out);
+}
+
+
+/*-----------------------------------------------------------------
+  Threaded version of finduniquepoints().  Every pillar is sorted and
+  uniquified into its own fixed-size slot of the z-list, after which
+  the slots are compacted in pillar order.  Point numbers are
+  therefore independent of the number of threads. */
+int finduniquepoints_threaded(const struct grdecl *g,
+                              /* return values: */
+                              int           *plist, /* list of point
+                                                     * numbers on each
+                                                     * pillar*/
+                              double tolerance,
+                              int    num_threads,
+                              struct processed_grid *out)
+
 {
 
     const int nx = out->dimensions[0];
@@ -281,30 +300,27 @@ int finduniquepoints(const struct grdecl *g,
 
 
     /* zlist may need extra space temporarily due to simple boundary
-     * treatement  */
-    int            npillarpoints = 8*(nx+1)*(ny+1)*nz;
+     * treatement.  Each pillar owns a slot of 'slot' z-values. */
+    int            slot          = 8*nz;
     int            npillars      = (nx+1)*(ny+1);
+    size_t         npillarpoints = ((size_t) slot) * ((size_t) npillars);
 
     double *zlist = malloc(npillarpoints*sizeof *zlist);
     int     *zptr = malloc((npillars+1)*sizeof *zptr);
 
+    int     pix, j;
+    int     ok;
+    int     d1[3];
 
+    if ((zlist == NULL) || (zptr == NULL)) {
+        free(zptr);
+        free(zlist);
+        return 0;
+    }
 
-
-    int     i,j,k;
-
-    int     d1[3];
-    int     len;
-    double  *zout  = zlist;
-    int     pos    = 0;
-    double *pt;
-    const double *z[4];
-    const int *a[4];
-    int *p;
-    int pix, cix;
-    int zix;
-
-    const double *coord = g->coord;
+#if !defined(_OPENMP)
+    (void) num_threads;
+#endif
 
     d1[0] = 2*g->dims[0];
     d1[1] = 2*g->dims[1];
@@ -312,47 +328,81 @@ int finduniquepoints(const struct grdecl *g,
 
     out->node_coordinates = malloc (3*8*nc*sizeof(*out->node_coordinates));
 
-    zptr[pos++] = zout - zlist;
+    /* Loop over pillars, find unique points on each pillar.  zptr[pix+1]
+     * temporarily holds the number of unique points on pillar pix. */
+    zptr[0] = 0;
 
-    pt    = out->node_coordinates;
+#ifdef _OPENMP
+#pragma omp parallel for schedule(static) num_threads(MAX(num_threads, 1))
+#endif
+    for (pix = 0; pix < npillars; ++pix) {
+        const double *z[4];
+        const int    *a[4];
+        double       *zout = zlist + ((size_t) slot)*pix;
+        int           len;
 
-    /* Loop over pillars, find unique points on each pillar */
-    for (j=0; j < g->dims[1]+1; ++j){
-        for (i=0; i < g->dims[0]+1; ++i){
+        const int pi = pix % (g->dims[0] + 1);
+        const int pj = pix / (g->dims[0] + 1);
 
-            /* Get positioned pointers for actnum and zcorn data */
-            igetvectors(g->dims,   i,   j, g->actnum, a);
-            dgetvectors(d1,      2*i, 2*j, g->zcorn,  z);
+        /* Get positioned pointers for actnum and zcorn data */
+        igetvectors(g->dims,   pi,   pj, g->actnum, a);
+        dgetvectors(d1,      2*pi, 2*pj, g->zcorn,  z);
 
-            len = createSortedList(     zout, d1[2], 4, z, a);
-            len = uniquify        (len, zout, tolerance);
+        len = createSortedList(     zout, d1[2], 4, z, a);
+        len = uniquify        (len, zout, tolerance);
 
-            /* Assign unique points */
-            for (k=0; k<len; ++k){
-                pt[2] = zout[k];
-                interpolate_pillar(coord, pt);
-                pt += 3;
-            }
+        zptr[pix + 1] = len;
+    }
+
+    /* Convert counts to start pointers of sparse table of unique zcorn
+     * values, and compact the per-pillar slots in pillar order. */
+    for (pix = 0; pix < npillars; ++pix) {
+        const int len = zptr[pix + 1];
+
+        zptr[pix + 1] = zptr[pix] + len;
+
+        if ((size_t) zptr[pix] != ((size_t) slot)*pix) {
+            memmove(zlist + zptr[pix],
+                    zlist + ((size_t) slot)*pix,
+                    len * sizeof *zlist);
+        }
+    }
 
-            /* Increment pointer to sparse table of unique zcorn
-             * values */
-            zout        = zout + len;
-            zptr[pos++] = zout - zlist;
+    out->number_of_nodes_on_pillars = zptr[npillars];
+    out->number_of_nodes            = zptr[npillars];
 
-            coord += 6;
+    /* Assign unique points */
+#ifdef _OPENMP
+#pragma omp parallel for schedule(static) num_threads(MAX(num_threads, 1))
+#endif
+    for (pix = 0; pix < npillars; ++pix) {
+        const double *coord = g->coord + 6*((size_t) pix);
+        double       *pt    = out->node_coordinates + 3*((size_t) zptr[pix]);
+        int           k;
+
+        for (k = zptr[pix]; k < zptr[pix + 1]; ++k) {
+            pt[2] = zlist[k];
+            interpolate_pillar(coord, pt);
+            pt += 3;
         }
     }
-    out->number_of_nodes_on_pillars = zptr[pos-1];
-    out->number_of_nodes            = zptr[pos-1];
 
     /* Loop over all vertical sets of zcorn values, assign point
      * numbers */
-    p = plist;
-    for (j=0; j < 2*g->dims[1]; ++j){
-        for (i=0; i < 2*g->dims[0]; ++i){
+    ok = 1;
+
+#ifdef _OPENMP
+#pragma omp parallel for schedule(static) num_threads(MAX(num_threads, 1)) \
+    reduction(&&:ok)
+#endif
+    for (j = 0; j < 2*g->dims[1]; ++j) {
+        int *p = plist + ((size_t) j)*(2*g->dims[0])*(2 + 2*g->dims[2]);
+        int  i, cix, zix, colpix;
+
+        for (i = 0; i < 2*g->dims[0]; ++i) {
 
             /* pillar index */
-            pix = (i+1)/2 + (g->dims[0]+1)*((j+1)/2);
+            colpix = (i+1)/2 + (g->dims[0]+1)*((j+1)/2);
 
             /* cell column position */
             cix = g->dims[2]*((i/2) + (j/2)*g->dims[0]);
@@ -360,12 +410,12 @@ int finduniquepoints(const struct grdecl *g,
             /* zcorn column position */
             zix = 2*g->dims[2]*(i+2*g->dims[0]*j);
 
-            if (!assignPointNumbers(zptr[pix], zptr[pix+1], zlist,
-                                    2*g->dims[2],
-                                    g->zcorn  + zix, g->actnum + cix,
-                                    p, tolerance)){
+            if (ok && !assignPointNumbers(zptr[colpix], zptr[colpix+1], zlist,
+                                          2*g->dims[2],
+                                          g->zcorn  + zix, g->actnum + cix,
+                                          p, tolerance)){
                 fprintf(stderr, "Something went wrong in assignPointNumbers");
-                return 0;
+                ok = 0;
             }
 
             p += 2 + 2*g->dims[2];
@@ -375,7 +425,7 @@ int finduniquepoints(const struct grdecl *g,
     free(zptr);
     free(zlist);
 
-    return 1;
+    return ok;
 }
 
 /* Local Variables:    */
@@ -0,0 +1,142 @@
+/*
+  Copyright 2025 Equinor ASA.
+
+  This file is part of the Open Porous Media project (OPM).
+
+  OPM is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  OPM is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with OPM.  If not, see <http://www.gnu.org/licenses/>.
+*/
+#ifndef OPM_CELLBLOCKDATAHANDLE_HEADER
+#define OPM_CELLBLOCKDATAHANDLE_HEADER
+
+#include <cassert>
+#include <cstddef>
+#include <type_traits>
+#include <vector>
+
+namespace Dune
+{
+namespace cpgrid
+{
+
+/// \brief A data handle for cell data stored in a vector, with a fixed number
+/// of values per cell.
+///
+/// The values of the cell with index c are the blockSize entries starting at
+/// c*blockSize. It can be used like any other data handle, e.g. with
+/// CpGrid::communicate(), scatterData() and gatherData(). These recognise it
+/// and move the values without calling gather and scatter per cell. Between
+/// processes the vectors are described by MPI derived datatypes, so the
+/// values are neither packed nor unpacked by us.
+///
+/// The vectors are referenced, not copied, and must not be resized while a
+/// communication is pending. The block size has to be the same on all
+/// processes.
+/// \tparam T The type of the values, has to be supported by Dune::MPITraits.
+template<class T>
+class CellBlockDataHandle
+{
+public:
+    using DataType = T;
+
+    /// \brief Constructor for moving data from one grid view to another.
+    /// \param source The values gathered, indexed by the cells of the sending view.
+    /// \param target The values scattered, indexed by the cells of the receiving view.
+    /// \param blockSize The number of values per cell.
+    CellBlockDataHandle(const std::vector<T>& source, std::vector<T>& target, std::size_t blockSize)
+        : source_(source), target_(target), blockSize_(blockSize)
+    {}
+
+    /// \brief Constructor for communicating within a grid view.
+    ///
+    /// If the interface sends and receives the same cell, as e.g.
+    /// All_All_Interface does, the values received are buffered and only
+    /// copied to the vector when the communication completes. Hence the
+    /// values sent are always the ones before the communication.
+    /// \param values The values sent and overwritten by the ones received.
+    /// \param blockSize The number of values per cell.
+    CellBlockDataHandle(std::vector<T>& values, std::size_t blockSize)
+        : source_(values), target_(values), blockSize_(blockSize)
+    {}
+
+    bool contains(int dim, int codim) const
+    {
+        return dim == 3 && codim == 0;
+    }
+
+    bool fixedSize(int /* dim */, int /* codim */) const
+    {
+        return true;
+    }
+
+    template<class E>
+    std::size_t size(const E& /* entity */) const
+    {
+        return blockSize_;
+    }
+
+    template<class B, class E>
+    void gather(B& buffer, const E& entity) const
+    {
+        const T* values = sourceData() + entity.index() * blockSize_;
+        for (std::size_t i = 0; i < blockSize_; ++i) {
+            buffer.write(values[i]);
+        }
+    }
+
+    template<class B, class E>
+    void scatter(B& buffer, const E& entity, std::size_t size)
+    {
+        assert(size == blockSize_);
+        T* values = targetData() + entity.index() * size;
+        for (std::size_t i = 0; i < size; ++i) {
+            buffer.read(values[i]);
+        }
+    }
+
+    /// \brief The first value gathered.
+    const T* sourceData() const
+    {
+        return source_.data();
+    }
+
+    /// \brief The first value scattered.
+    T* targetData()
+    {
+        return target_.data();
+    }
+
+    /// \brief The number of values per cell.
+    std::size_t blockSize() const
+    {
+        return blockSize_;
+    }
+
+private:
+    const std::vector<T>& source_;
+    std::vector<T>& target_;
+    std::size_t blockSize_;
+};
+
+/// \brief Whether a data handle is a CellBlockDataHandle.
+template<class DataHandle>
+struct IsCellBlockDataHandle : std::false_type
+{};
+
+template<class T>
+struct IsCellBlockDataHandle<CellBlockDataHandle<T>> : std::true_type
+{};
+
+} // end namespace cpgrid
+} // end namespace Dune
+#endif
@@ -0,0 +1,137 @@
+/*
+  Copyright 2025 Equinor ASA.
+
+  This file is part of the Open Porous Media project (OPM).
+
+  OPM is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  OPM is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with OPM.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#ifndef OPM_COMMUNICATIONREQUEST_HEADER
+#define OPM_COMMUNICATIONREQUEST_HEADER
+
+#include <dune/grid/common/gridenums.hh>
+
+#include "CpGridDataTraits.hpp"
+#include "Entity2IndexDataHandle.hpp"
+
+#include <optional>
+#include <utility>
+
+namespace Dune
+{
+namespace cpgrid
+{
+class CpGridData;
+
+/// \brief A communication started by CpGridData::communicateBegin().
+///
+/// The data of the handle has been gathered and sent, and the receives have
+/// been posted. wait() scatters the received data into the handle, which has
+/// to stay alive until then. Meanwhile the entities whose data is sent or
+/// received must not be touched, but everything else, e.g. the deep interior
+/// cells, can be worked on. The destructor waits if wait() has not been called.
+/// The request has to be completed before the grid is changed, e.g. by
+/// load balancing or refinement.
+///
+/// Only data with a fixed size per entity is actually in flight between
+/// communicateBegin() and wait(). Data of variable size is communicated
+/// completely by communicateBegin().
+///
+/// \tparam DataHandle The type of the data handle communicated.
+template<class DataHandle>
+class CommunicationRequest
+{
+public:
+    CommunicationRequest() = default;
+
+    CommunicationRequest(CommunicationRequest&& other) noexcept
+#if HAVE_MPI
+        : cells_(std::move(other.cells_)), points_(std::move(other.points_)),
+          cell_comm_(other.cell_comm_), point_comm_(other.point_comm_),
+          forward_(other.forward_)
+#endif
+    {
+#if HAVE_MPI
+        other.cell_comm_ = nullptr;
+        other.point_comm_ = nullptr;
+#else
+        static_cast<void>(other);
+#endif
+    }
+
+    CommunicationRequest(const CommunicationRequest&) = delete;
+    CommunicationRequest& operator=(const CommunicationRequest&) = delete;
+    CommunicationRequest& operator=(CommunicationRequest&&) = delete;
+
+    ~CommunicationRequest()
+    {
+        wait();
+    }
+
+    /// \brief Whether the communication still has to be completed by wait().
+    bool pending() const
+    {
+#if HAVE_MPI
+        return cell_comm_ || point_comm_;
+#else
+        return false;
+#endif
+    }
+
+    /// \brief Complete the communication.
+    ///
+    /// Waits for the messages of the neighbours and scatters them into the
+    /// data handle. Does nothing if the communication is already complete.
+    void wait()
+    {
+#if HAVE_MPI
+        if (cell_comm_) {
+            end(*cell_comm_, *cells_);
+            cell_comm_ = nullptr;
+        }
+        if (point_comm_) {
+            end(*point_comm_, *points_);
+            point_comm_ = nullptr;
+        }
+#endif
+    }
+
+private:
+    friend class CpGridData;
+
+#if HAVE_MPI
+    using PersistentCommunicator = CpGridDataTraits::PersistentCommunicator;
+
+    template<class Wrapper>
+    void end(PersistentCommunicator& comm, Wrapper& wrapper)
+    {
+        if (forward_)
+            comm.forwardPersistentEnd(wrapper);
+        else
+            comm.backwardPersistentEnd(wrapper);
+    }
+
+    std::optional<Entity2IndexDataHandle<DataHandle, 0>> cells_;
+    std::optional<Entity2IndexDataHandle<DataHandle, 3>> points_;
+    /// \brief The communicators with a pending communication, or nullptr.
+    PersistentCommunicator* cell_comm_ = nullptr;
+    PersistentCommunicator* point_comm_ = nullptr;
+    bool forward_ = true;
+#endif
+};
+
+} // end namespace cpgrid
+} // end namespace Dune
+
+#endif // OPM_COMMUNICATIONREQUEST_HEADER
@@ -64,8 +64,11 @@
 //#include <iostream>
 #include <algorithm>
 #include <iomanip>
+#include <map>
 #include <numeric>
 #include <tuple>
+#include <unordered_map>
+#include <utility>
 
 namespace
 {
@@ -121,6 +124,163 @@ void setupRecvInterface(const std::vector<std::tuple<int, int, char, int> >& lis
         interface[std::get<1>(entry)].second.add(index);
     }
 }
+
+/// Sets up an interface from the indices to send to and to receive from each process.
+void setupInterface(const std::map<int, std::pair<std::vector<int>, std::vector<int>>>& lists,
+                    Dune::CpGrid::InterfaceMap& interface)
+{
+    for (const auto& [proc, indices] : lists)
+    {
+        auto& [send, recv] = interface[proc];
+        send.reserve(indices.first.size());
+        for (const int index : indices.first)
+            send.add(index);
+        recv.reserve(indices.second.size());
+        for (const int index : indices.second)
+            recv.add(index);
+    }
+}
+
+using InterfaceInformation = Dune::CpGrid::InterfaceMap::mapped_type::first_type;
+
+void replaceIndices(InterfaceInformation& information, const std::vector<int>& indices)
+{
+    InterfaceInformation replacement;
+    replacement.reserve(indices.size());
+    for (const int index : indices)
+        replacement.add(index);
+    information.free();
+    information = replacement;
+}
+
+/// Patches an interface for scattering data from the global view on the root
+/// after entities moved between the processes of the distributed view.
+///
+/// The position of an index within an interface is its match on the other
+/// process. Entries of entities that left a process are removed and the ones
+/// of entities that arrived are appended, ordered by global id.
+/// \param new_index_of_old For each entity of the previous distributed view its
+///                         index in the new one, -1 if it left.
+/// \param added Global id and index of the entities that arrived, sorted by global id.
+/// \param global_index Maps a global id to the index in the global view, used on the root.
+template<class GlobalIndex>
+void patchScatterGatherInterface(Dune::CpGrid::InterfaceMap& interfaces,
+                                 const std::vector<int>& new_index_of_old,
+                                 const std::vector<std::pair<int,int>>& added,
+                                 const GlobalIndex& global_index,
+                                 const Dune::cpgrid::CpGridData::Communication& cc)
+{
+    auto& recv = interfaces[0].second;
+    std::vector<int> removed;
+    std::vector<int> indices;
+    indices.reserve(recv.size() + added.size());
+    for (std::size_t i = 0; i < recv.size(); ++i)
+    {
+        const int index = new_index_of_old[recv[i]];
+        if (index < 0)
+            removed.push_back(i);
+        else
+            indices.push_back(index);
+    }
+    std::vector<int> added_ids;
+    added_ids.reserve(added.size());
+    for (const auto& [id, index] : added)
+    {
+        added_ids.push_back(id);
+        indices.push_back(index);
+    }
+    replaceIndices(recv, indices);
+
+    const auto [all_removed, removed_offsets] = Opm::gatherv(removed, cc, 0);
+    const auto [all_added, added_offsets] = Opm::gatherv(added_ids, cc, 0);
+    if (cc.rank() != 0)
+        return;
+
+    for (int proc = 0; proc < cc.size(); ++proc)
+    {
+        auto& send = interfaces[proc].first;
+        indices.clear();
+        auto next_removed = all_removed.begin() + removed_offsets[proc];
+        const auto end_removed = all_removed.begin() + removed_offsets[proc + 1];
+        for (std::size_t i = 0; i < send.size(); ++i)
+        {
+            if (next_removed != end_removed && *next_removed == static_cast<int>(i))
+            {
+                ++next_removed;
+                continue;
+            }
+            indices.push_back(send[i]);
+        }
+        for (int i = added_offsets[proc]; i < added_offsets[proc + 1]; ++i)
+            indices.push_back(global_index(all_added[i]));
+        replaceIndices(send, indices);
+    }
+}
+
+/// Computes for all wells whether they perforate cells owned by this process.
+///
+/// The root sends the Cartesian indices of the perforated cells of all wells to
+/// all processes, each of which checks them against its interior cells.
+/// \param wells The wells, only used on the root.
+std::vector<std::pair<std::string,bool>>
+computeWellsOnProc(const Dune::cpgrid::CpGridData& global_view,
+                   const Dune::cpgrid::CpGridData& distributed_view,
+                   const std::vector<Dune::cpgrid::OpmWellType>* wells,
+                   const Dune::cpgrid::CpGridData::Communication& cc)
+{
+    std::vector<int> offsets;
+    std::vector<int> perforations;
+    if (cc.rank() == 0 && wells)
+    {
+        const auto& cartesianSize = global_view.logicalCartesianSize();
+        const auto& globalCell = global_view.globalCell();
+        std::vector<int> cartesianToCompressed(cartesianSize[0] * cartesianSize[1] * cartesianSize[2], -1);
+        for (std::size_t cell = 0; cell < globalCell.size(); ++cell)
+            cartesianToCompressed[globalCell[cell]] = cell;
+        const Dune::cpgrid::WellConnections connections(*wells, {}, cartesianSize, cartesianToCompressed);
+        offsets.push_back(0);
+        for (std::size_t well = 0; well < connections.size(); ++well)
+        {
+            for (const int cell : connections[well])
+                perforations.push_back(globalCell[cell]);
+            offsets.push_back(perforations.size());
+        }
+    }
+    std::size_t sizes[2] = { offsets.size(), perforations.size() };
+    cc.broadcast(sizes, 2, 0);
+    offsets.resize(sizes[0]);
+    perforations.resize(sizes[1]);
+    cc.broadcast(offsets.data(), offsets.size(), 0);
+    cc.broadcast(perforations.data(), perforations.size(), 0);
+
+    std::vector<int> interiorCells;
+    for (const auto& index : distributed_view.cellIndexSet())
+    {
+        if (index.local().attribute() == AttributeSet::owner)
+            interiorCells.push_back(distributed_view.globalCell()[index.local()]);
+    }
+    std::ranges::sort(interiorCells);
+    std::vector<int> myWells;
+    for (std::size_t well = 0; well + 1 < offsets.size(); ++well)
+    {
+        if (std::any_of(perforations.begin() + offsets[well], perforations.begin() + offsets[well + 1],
+                        [&interiorCells](int cell)
+                        { return std::ranges::binary_search(interiorCells, cell); }))
+            myWells.push_back(well);
+    }
+
+    const auto [allWells, wellOffsets] = Opm::gatherv(myWells, cc, 0);
+    std::vector<std::vector<int>> wells_on_proc;
+    if (cc.rank() == 0)
+    {
+        wells_on_proc.resize(cc.size());
+        for (int proc = 0; proc < cc.size(); ++proc)
+            wells_on_proc[proc].assign(allWells.begin() + wellOffsets[proc],
+                                       allWells.begin() + wellOffsets[proc + 1]);
+    }
+    const std::vector<Dune::cpgrid::OpmWellType> noWells;
+    return Dune::cpgrid::computeParallelWells(wells_on_proc, wells ? *wells : noWells, cc, 0);
+}
 #endif // HAVE_MPI
 
 /// Release memory resources from CpGrid::InterfaceMap.  Used as custom
@@ -167,7 +327,8 @@ CpGrid::CpGrid()
     : distributed_data_(),
       cell_scatter_gather_interfaces_(new InterfaceMap, FreeInterfaces{}),
       point_scatter_gather_interfaces_(new InterfaceMap, FreeInterfaces{}),
-      global_id_set_ptr_()
+      global_id_set_ptr_(),
+      setup_profile_(std::make_shared<Opm::SetupProfile>())
 {
     data_.push_back(std::make_shared<cpgrid::CpGridData>(data_));
     current_data_ = &data_;
@@ -178,7 +339,8 @@ CpGrid::CpGrid(MPIHelper::MPICommunicator comm)
     : distributed_data_(),
       cell_scatter_gather_interfaces_(new InterfaceMap, FreeInterfaces{}),
       point_scatter_gather_interfaces_(new InterfaceMap, FreeInterfaces{}),
-      global_id_set_ptr_()
+      global_id_set_ptr_(),
+      setup_profile_(std::make_shared<Opm::SetupProfile>())
 {
     data_.push_back(std::make_shared<cpgrid::CpGridData>(comm, data_));
     current_data_ = &data_;
@@ -217,7 +379,8 @@ CpGrid::scatterGrid(EdgeWeightMethod method,
                     double imbalanceTol,
                     [[maybe_unused]] bool allowDistributedWells,
                     [[maybe_unused]] const std::vector<int>& input_cell_part,
-                    int level)
+                    int level,
+                    [[maybe_unused]] const std::vector<double>& cellWeights)
 {
     // Silence any unused argument warnings that could occur with various configurations.
     static_cast<void>(wells);
@@ -271,6 +434,8 @@ CpGrid::scatterGrid(EdgeWeightMethod method,
 
     if (cc.size() > 1)
     {
+        Opm::SetupProfile::Scope profile_scope(setup_profile_.get(), "loadBalance");
+        Opm::SetupProfile::Scope partitioning_scope(setup_profile_.get(), "partitioning");
         std::vector<int> computedCellPart;
         std::vector<std::pair<std::string,bool>> wells_on_proc;
         std::vector<std::tuple<int,int,char>> exportList;
@@ -353,8 +518,8 @@ CpGrid::scatterGrid(EdgeWeightMethod method,
 #ifdef HAVE_ZOLTAN
                 std::tie(computedCellPart, wells_on_proc, exportList, importList, wellConnections)
                     = serialPartitioning
-                    ? cpgrid::zoltanSerialGraphPartitionGridOnRoot(*this, wells, possibleFutureConnections, transmissibilities, cc, method, 0, imbalanceTol, allowDistributedWells, partitioningParams)
-                    : cpgrid::zoltanGraphPartitionGridOnRoot(*this, wells, possibleFutureConnections, transmissibilities, cc, method, 0, imbalanceTol, allowDistributedWells, partitioningParams);
+                    ? cpgrid::zoltanSerialGraphPartitionGridOnRoot(*this, wells, possibleFutureConnections, transmissibilities, cc, method, 0, imbalanceTol, allowDistributedWells, partitioningParams, cellWeights)
+                    : cpgrid::zoltanGraphPartitionGridOnRoot(*this, wells, possibleFutureConnections, transmissibilities, cc, method, 0, imbalanceTol, allowDistributedWells, partitioningParams, cellWeights);
 #else
                 OPM_THROW(std::runtime_error, "Parallel runs depend on ZOLTAN if useZoltan is true. Please install!");
 #endif // HAVE_ZOLTAN
@@ -364,7 +529,7 @@ CpGrid::scatterGrid(EdgeWeightMethod method,
 #ifdef HAVE_METIS
                 if (!serialPartitioning)
                     OPM_MESSAGE("Warning: Serial partitioning is set to false and METIS was selected to partition the grid, but METIS is a serial partitioner. Continuing with serial partitioning...");
-                std::tie(computedCellPart, wells_on_proc, exportList, importList, wellConnections) = cpgrid::metisSerialGraphPartitionGridOnRoot(*this, wells, possibleFutureConnections, transmissibilities, cc, method, 0, imbalanceTol, allowDistributedWells, partitioningParams);
+                std::tie(computedCellPart, wells_on_proc, exportList, importList, wellConnections) = cpgrid::metisSerialGraphPartitionGridOnRoot(*this, wells, possibleFutureConnections, transmissibilities, cc, method, 0, imbalanceTol, allowDistributedWells, partitioningParams, cellWeights);
 #else
                 OPM_THROW(std::runtime_error, "Parallel runs depend on METIS if useMetis is true. Please install!");
 #endif // HAVE_METIS
@@ -375,8 +540,8 @@ CpGrid::scatterGrid(EdgeWeightMethod method,
 #ifdef HAVE_ZOLTAN
                 std::tie(computedCellPart, wells_on_proc, exportList, importList, wellConnections)
                     = serialPartitioning
-                    ? Opm::zoltanSerialPartitioningWithGraphOfGrid(*this, wells, possibleFutureConnections, transmissibilities, cc, method, 0, imbalanceTol, allowDistributedWells, partitioningParams)
-                    : Opm::zoltanPartitioningWithGraphOfGrid(*this, wells, possibleFutureConnections, transmissibilities, cc, method, 0, imbalanceTol, allowDistributedWells, partitioningParams, level);
+                    ? Opm::zoltanSerialPartitioningWithGraphOfGrid(*this, wells, possibleFutureConnections, transmissibilities, cc, method, 0, imbalanceTol, allowDistributedWells, partitioningParams, cellWeights)
+                    : Opm::zoltanPartitioningWithGraphOfGrid(*this, wells, possibleFutureConnections, transmissibilities, cc, method, 0, imbalanceTol, allowDistributedWells, partitioningParams, level, cellWeights);
 #else
                 OPM_THROW(std::runtime_error, "Parallel runs depend on ZOLTAN if useZoltan is true. Please install!");
 #endif // HAVE_ZOLTAN
@@ -384,12 +549,16 @@ CpGrid::scatterGrid(EdgeWeightMethod method,
             else
             {
                 std::tie(computedCellPart, wells_on_proc, exportList, importList, wellConnections) =
-                    cpgrid::vanillaPartitionGridOnRoot(*this, wells, possibleFutureConnections, transmissibilities, allowDistributedWells);
+                    cpgrid::vanillaPartitionGridOnRoot(*this, wells, possibleFutureConnections, transmissibilities, allowDistributedWells,
+                                                       imbalanceTol, cellWeights);
             }
         }
         comm().barrier();
+        partitioning_scope.count("exported_cells", exportList.size());
+        partitioning_scope.close();
 
         // first create the overlap
+        Opm::SetupProfile::Scope overlap_scope(setup_profile_.get(), "overlap");
         auto noImportedOwner = addOverlapLayer(*this,
                                                computedCellPart,
                                                exportList,
@@ -423,6 +592,9 @@ CpGrid::scatterGrid(EdgeWeightMethod method,
             std::inplace_merge(importList.begin(), importList.begin()+noImportedOwner,
                                importList.end(), compareImport);
         }
+        overlap_scope.count("owned_cells", noImportedOwner);
+        overlap_scope.count("overlap_cells", importList.size() - noImportedOwner);
+        overlap_scope.close();
 
         int procsWithZeroCells{};
 
@@ -465,6 +637,43 @@ CpGrid::scatterGrid(EdgeWeightMethod method,
             auto sumOverlap = std::accumulate(overlapCells.begin(), overlapCells.end(), 0);
             ostr << std::setw(16) << sumOverlap;
             ostr << std::setw(14) << (sumOwned + sumOverlap) << "\n";
+
+            // With cell weights also report the weight owned by each rank and
+            // the resulting imbalance (ratio of maximum to mean weight).
+            const std::size_t numCells = computedCellPart.size();
+            if (numCells > 0 && !cellWeights.empty() && cellWeights.size() % numCells == 0)
+            {
+                const std::size_t dim = cellWeights.size() / numCells;
+                std::vector<double> ownedWeights(cc.size() * dim, 0.0);
+                for (std::size_t cell = 0; cell < numCells; ++cell)
+                {
+                    for (std::size_t j = 0; j < dim; ++j)
+                    {
+                        ownedWeights[computedCellPart[cell] * dim + j] += cellWeights[cell * dim + j];
+                    }
+                }
+                ostr << "  rank   owned weight(s)\n";
+                ostr << "--------------------------------------------------\n";
+                for (int i = 0; i < cc.size(); ++i) {
+                    ostr << std::setw(6) << i;
+                    for (std::size_t j = 0; j < dim; ++j) {
+                        ostr << std::setw(14) << ownedWeights[i * dim + j];
+                    }
+                    ostr << "\n";
+                }
+                ostr << "--------------------------------------------------\n";
+                ostr << " weighted imbalance (max/mean):";
+                for (std::size_t j = 0; j < dim; ++j) {
+                    double maxWeight = 0.0;
+                    double sumWeight = 0.0;
+                    for (int i = 0; i < cc.size(); ++i) {
+                        maxWeight = std::max(maxWeight, ownedWeights[i * dim + j]);
+                        sumWeight += ownedWeights[i * dim + j];
+                    }
+                    ostr << " " << (sumWeight > 0.0 ? maxWeight * cc.size() / sumWeight : 1.0);
+                }
+                ostr << "\n";
+            }
             Opm::OpmLog::info(ostr.str());
         }
 
@@ -536,6 +745,7 @@ CpGrid::scatterGrid(EdgeWeightMethod method,
 
 
         // distributed_data should be empty at this point.
+        Opm::SetupProfile::Scope distribution_scope(setup_profile_.get(), "distribution");
         distributed_data_.push_back(std::make_shared<cpgrid::CpGridData>(cc, distributed_data_));
         distributed_data_[0]->setUniqueBoundaryIds(data_[selectedLevel]->uniqueBoundaryIds());
 
@@ -561,6 +771,9 @@ CpGrid::scatterGrid(EdgeWeightMethod method,
         (*global_id_set_ptr_).insertIdSet(*distributed_data_[0]);
         distributed_data_[0]-> index_set_.reset(new cpgrid::IndexSet(distributed_data_[0]->cell_to_face_.size(),
                                                                      distributed_data_[0]-> geomVector<3>().size()));
+        distribution_scope.count("cells", distributed_data_[0]->size(0));
+        distribution_scope.count("faces", distributed_data_[0]->face_to_cell_.size());
+        distribution_scope.count("points", distributed_data_[0]->size(3));
 
         current_data_ = &distributed_data_;
         return std::make_pair(true, wells_on_proc);
@@ -580,10 +793,269 @@ CpGrid::scatterGrid(EdgeWeightMethod method,
 }
 
 
+std::pair<bool, std::vector<std::pair<std::string,bool> > >
+CpGrid::rebalance(const std::vector<double>& weights,
+                  const std::vector<cpgrid::OpmWellType> * wells,
+                  double imbalanceTol,
+                  bool ownersFirst,
+                  int overlapLayers)
+{
+    const auto migration = migrateCells(weights, wells, imbalanceTol, ownersFirst, overlapLayers);
+    if (!migration) {
+        return std::make_pair(false, std::vector<std::pair<std::string,bool>>());
+    }
+    return std::make_pair(true, migration->wells_on_proc);
+}
+
+CpGrid::CellMigration::~CellMigration()
+{
+    FreeInterfaces{}(&cells);
+    FreeInterfaces{}(&points);
+    if (source) {
+        grid.global_id_set_ptr_->removeIdSet(*source);
+    }
+}
+
+std::unique_ptr<CpGrid::CellMigration>
+CpGrid::migrateCells([[maybe_unused]] const std::vector<double>& weights,
+                     [[maybe_unused]] const std::vector<cpgrid::OpmWellType> * wells,
+                     [[maybe_unused]] double imbalanceTol,
+                     [[maybe_unused]] bool ownersFirst,
+                     [[maybe_unused]] int overlapLayers)
+{
+#if HAVE_MPI
+    if (distributed_data_.empty()) {
+        OPM_THROW(std::logic_error, "Only a load balanced grid can be rebalanced.");
+    }
+    if (distributed_data_.size() > 1) {
+        OPM_THROW(std::logic_error, "Rebalancing a grid with local refinement is not supported, yet.");
+    }
+
+    const auto& view = *distributed_data_[0];
+    const auto& cc = view.ccobj_;
+    // The partitioning works on the leaf view of this grid.
+    if (cc.max(static_cast<int>(current_data_ != &distributed_data_))) {
+        const std::string msg = "Rebalancing needs the distributed view to be the current one.";
+        if (cc.rank() == 0) {
+            OPM_THROW(std::logic_error, msg);
+        }
+        else {
+            OPM_THROW_NOLOG(std::logic_error, msg);
+        }
+    }
+    if (cc.max(static_cast<int>(weights.size() != static_cast<std::size_t>(view.size(0))))) {
+        const std::string msg = "Rebalancing needs a weight for each cell of the distributed grid.";
+        if (cc.rank() == 0) {
+            OPM_THROW(std::invalid_argument, msg);
+        }
+        else {
+            OPM_THROW_NOLOG(std::invalid_argument, msg);
+        }
+    }
+
+    const int rank = cc.rank();
+    const int numCells = view.size(0);
+    std::vector<int> gid(numCells);
+    for (const auto& index : view.cellIndexSet()) {
+        gid[index.local()] = index.global();
+    }
+    // The current owner and the other processes holding each cell.
+    std::vector<int> cellOwner(numCells, rank);
+    std::vector<std::vector<int>> oldHolders(numCells);
+    for (const auto& [proc, lists] : view.cellRemoteIndices()) {
+        for (const auto& remote : *lists.first) {
+            const int cell = remote.localIndexPair().local();
+            oldHolders[cell].push_back(proc);
+            if (remote.attribute() == AttributeSet::owner) {
+                cellOwner[cell] = proc;
+            }
+        }
+    }
+    std::vector<char> oldOwned(numCells);
+    std::ranges::transform(cellOwner, oldOwned.begin(), [rank](int owner) { return owner == rank; });
+
+    rebalanceDistributedPartition(*this, cellOwner, weights, imbalanceTol);
+    const auto holders = distributedOverlap(*this, cellOwner, std::max(overlapLayers, 1));
+
+    // The previous owner of a cell sends it to the processes gaining it. A message
+    // holds for each cell its global id, new owner, and the processes holding it.
+    std::map<int, std::vector<int>> sendCells;
+    std::map<int, std::vector<int>> sendBuffers;
+    for (int cell = 0; cell < numCells; ++cell) {
+        if (!oldOwned[cell]) {
+            continue;
+        }
+        for (const int proc : holders[cell]) {
+            if (proc == rank || std::ranges::find(oldHolders[cell], proc) != oldHolders[cell].end()) {
+                continue;
+            }
+            sendCells[proc].push_back(cell);
+            auto& buffer = sendBuffers[proc];
+            buffer.push_back(gid[cell]);
+            buffer.push_back(cellOwner[cell]);
+            buffer.push_back(holders[cell].size());
+            buffer.insert(buffer.end(), holders[cell].begin(), holders[cell].end());
+        }
+    }
+
+    std::vector<int> sendSizes(cc.size(), 0);
+    std::vector<int> recvSizes(cc.size(), 0);
+    for (const auto& [proc, buffer] : sendBuffers) {
+        sendSizes[proc] = buffer.size();
+    }
+    MPI_Alltoall(sendSizes.data(), 1, MPI_INT, recvSizes.data(), 1, MPI_INT, cc);
+
+    const int tag = 4711;
+    std::map<int, std::vector<int>> recvBuffers;
+    std::vector<MPI_Request> requests;
+    requests.reserve(cc.size());
+    for (int proc = 0; proc < cc.size(); ++proc) {
+        if (recvSizes[proc] > 0) {
+            auto& buffer = recvBuffers[proc];
+            buffer.resize(recvSizes[proc]);
+            requests.emplace_back();
+            MPI_Irecv(buffer.data(), buffer.size(), MPI_INT, proc, tag, cc, &requests.back());
+        }
+    }
+    for (auto& [proc, buffer] : sendBuffers) {
+        MPI_Send(buffer.data(), buffer.size(), MPI_INT, proc, tag, cc);
+    }
+    std::vector<MPI_Status> statuses(requests.size());
+    MPI_Waitall(requests.size(), requests.data(), statuses.data());
+
+    // The cells of the new view are numbered like the ones of loadBalance.
+    struct NewCell
+    {
+        int gid;
+        bool owner;
+        int oldIndex; // -1 for cells that arrived
+    };
+    std::vector<NewCell> newCells;
+    std::set<int> neighbours;
+    const auto addNeighbours = [&neighbours, rank](auto begin, auto end)
+    {
+        for (; begin != end; ++begin) {
+            if (*begin != rank) {
+                neighbours.insert(*begin);
+            }
+        }
+    };
+    for (int cell = 0; cell < numCells; ++cell) {
+        if (std::ranges::binary_search(holders[cell], rank)) {
+            newCells.push_back({gid[cell], cellOwner[cell] == rank, cell});
+            addNeighbours(holders[cell].begin(), holders[cell].end());
+        }
+    }
+    for (const auto& [proc, buffer] : recvBuffers) {
+        for (std::size_t i = 0; i < buffer.size(); i += 3 + buffer[i + 2]) {
+            newCells.push_back({buffer[i], buffer[i + 1] == rank, -1});
+            addNeighbours(buffer.begin() + i + 3, buffer.begin() + i + 3 + buffer[i + 2]);
+        }
+    }
+    std::ranges::sort(newCells, [ownersFirst](const NewCell& c1, const NewCell& c2)
+                                {
+                                    if (ownersFirst && c1.owner != c2.owner) {
+                                        return c1.owner;
+                                    }
+                                    return c1.gid < c2.gid;
+                                });
+
+    auto newView = std::make_shared<cpgrid::CpGridData>(cc, distributed_data_);
+    newView->setUniqueBoundaryIds(view.uniqueBoundaryIds());
+    std::vector<int> newIndexOfOld(numCells, -1);
+    std::vector<std::pair<int,int>> addedCells;
+    auto& indexSet = newView->cellIndexSet();
+    indexSet.beginResize();
+    for (std::size_t i = 0; i < newCells.size(); ++i) {
+        const auto& cell = newCells[i];
+        indexSet.add(cell.gid,
+                     ParallelIndexSet::LocalIndex(i, cell.owner ? AttributeSet::owner : AttributeSet::copy, true));
+        if (cell.oldIndex < 0) {
+            addedCells.emplace_back(cell.gid, i);
+        }
+        else {
+            newIndexOfOld[cell.oldIndex] = i;
+        }
+    }
+    indexSet.endResize();
+    std::ranges::sort(addedCells);
+
+    // Processes only share cells with the ones holding them, too. An empty
+    // set of neighbours would mean all processes, hence it is used on all
+    // ranks or on none.
+    if (cc.min(static_cast<int>(!neighbours.empty()))) {
+        newView->cellRemoteIndices().setNeighbours(neighbours);
+    }
+
+    // The interface from the cells of the previous view to the new one: kept
+    // cells are copied locally, the others are sent in the order of the messages.
+    auto migration = std::make_unique<CellMigration>(*this);
+    std::map<int, std::pair<std::vector<int>, std::vector<int>>> migrationLists;
+    auto& kept = migrationLists[rank];
+    for (int cell = 0; cell < numCells; ++cell) {
+        if (newIndexOfOld[cell] >= 0) {
+            kept.first.push_back(cell);
+            kept.second.push_back(newIndexOfOld[cell]);
+        }
+    }
+    for (const auto& [proc, cells] : sendCells) {
+        migrationLists[proc].first = cells;
+    }
+    for (const auto& [proc, buffer] : recvBuffers) {
+        auto& recv = migrationLists[proc].second;
+        for (std::size_t i = 0; i < buffer.size(); i += 3 + buffer[i + 2]) {
+            recv.push_back(std::ranges::lower_bound(addedCells, std::make_pair(buffer[i], 0))->second);
+        }
+    }
+    setupInterface(migrationLists, migration->cells);
+
+    newView->distributeCells(view, migration->cells, migration->points);
+    newView->index_set_.reset(new cpgrid::IndexSet(newView->cell_to_face_.size(),
+                                                   newView->geomVector<3>().size()));
+
+    // Patch the interfaces for scattering and gathering data from the global view.
+    patchScatterGatherInterface(*cell_scatter_gather_interfaces_, newIndexOfOld, addedCells,
+                                [](int id) { return id; }, cc);
+
+    const auto& oldPointIds = view.global_id_set_->getMapping<3>();
+    const auto& newPointIds = newView->global_id_set_->getMapping<3>();
+    std::unordered_map<int,int> newPointOfId;
+    newPointOfId.reserve(newPointIds.size());
+    for (std::size_t point = 0; point < newPointIds.size(); ++point) {
+        newPointOfId.emplace(newPointIds[point], point);
+    }
+    std::vector<int> newIndexOfOldPoint(oldPointIds.size(), -1);
+    for (std::size_t point = 0; point < oldPointIds.size(); ++point) {
+        const auto candidate = newPointOfId.find(oldPointIds[point]);
+        if (candidate != newPointOfId.end()) {
+            newIndexOfOldPoint[point] = candidate->second;
+            newPointOfId.erase(candidate);
+        }
+    }
+    // The remaining points arrived, the mapping is sorted by id.
+    std::vector<std::pair<int,int>> addedPoints(newPointOfId.begin(), newPointOfId.end());
+    std::ranges::sort(addedPoints);
+    const cpgrid::ReversePointGlobalIdSet globalPointIndex(*data_[0]->global_id_set_);
+    patchScatterGatherInterface(*point_scatter_gather_interfaces_, newIndexOfOldPoint, addedPoints,
+                                [&globalPointIndex](int id) { return globalPointIndex[id]; }, cc);
+
+    global_id_set_ptr_->insertIdSet(*newView);
+    migration->source = std::exchange(distributed_data_[0], newView);
+    migration->wells_on_proc = computeWellsOnProc(*data_[0], *distributed_data_[0], wells, cc);
+    return migration;
+#else // #if HAVE_MPI
+    std::cerr << "CpGrid::rebalance() is non-trivial only with "
+              << "MPI support and if the target Dune platform is "
+              << "sufficiently recent.\n";
+    return nullptr;
+#endif
+}
+
 void CpGrid::createCartesian(const std::array<int, 3>& dims,
                              const std::array<double, 3>& cellsize,
                              const std::array<int, 3>& shift)
 {
+    Opm::SetupProfile::Scope profile_scope(setup_profile_.get(), "createCartesian");
     if ( current_data_->back()->ccobj_.rank() != 0 )
     {
         // global grid only on rank 0
@@ -635,6 +1107,7 @@ void CpGrid::createCartesian(const std::array<int, 3>& dims,
 
     // Note: This is a Cartesian, matching grid which is edge-conforming
     // regardless of the edge_conformal flag.
+    current_data_->back()->setup_profile_ = setup_profile_.get();
     current_data_->back()->processEclipseFormat(g,
 #if HAVE_OPM_COMMON
                                                 /* ecl_state = */ nullptr,
@@ -1129,11 +1602,65 @@ unsigned int CpGrid::numBoundarySegments() const
     }
 }
 
+const Opm::SetupProfile& CpGrid::setupProfile() const
+{
+    return *setup_profile_;
+}
+
+void CpGrid::enableSetupProfile(bool enable)
+{
+    setup_profile_->setEnabled(enable);
+}
+
 void CpGrid::setPartitioningParams(const std::map<std::string,std::string>& params)
 {
     partitioningParams = params;
 }
 
+void CpGrid::setCommunicationMethod(CommunicationMethod method)
+{
+    communication_method_ = method;
+}
+
+CommunicationMethod CpGrid::communicationMethod() const
+{
+    return communication_method_;
+}
+
+cpgrid::Renumbering CpGrid::renumber(RenumberingMethod method, bool ownersFirst)
+{
+    if (current_data_->size() > 1) {
+        OPM_THROW(std::logic_error, "Grids with refined cells cannot be renumbered");
+    }
+    // The ids of the global view are its indices, and the distributed view refers to
+    // them when gathering data or rebalancing.
+    if (!distributed_data_.empty() && current_data_ == &data_) {
+        OPM_THROW(std::logic_error, "The global view cannot be renumbered once the grid is distributed");
+    }
+    auto renumbering = current_data_->back()->renumber(method, ownersFirst);
+#if HAVE_MPI
+    // The scatter/gather interfaces receive into indices of the distributed view.
+    if (!distributed_data_.empty()) {
+        const auto renumberInterface = [](InterfaceMap& interfaces, const std::vector<int>& order)
+        {
+            std::vector<int> new_index(order.size());
+            for (std::size_t i = 0; i < order.size(); ++i) {
+                new_index[order[i]] = i;
+            }
+            for (auto& entry : interfaces) {
+                auto& indices = entry.second.second;
+                for (std::size_t i = 0; i < indices.size(); ++i) {
+                    indices[i] = new_index[indices[i]];
+                }
+            }
+        };
+        renumberInterface(*cell_scatter_gather_interfaces_, renumbering.cells);
+        renumberInterface(*point_scatter_gather_interfaces_, renumbering.points);
+    }
+#endif
+    return renumbering;
+}
+
 const typename CpGridTraits::Communication& Dune::CpGrid::comm () const
 {
     return current_data_->back()->ccobj_;
@@ -1568,12 +2095,12 @@ const Dune::FieldVector<double,3>& CpGrid::vertexPosition(int vertex) const
 
 double CpGrid::faceArea(int face) const
 {
-    return current_data_->back()->geomVector<1>()[cpgrid::EntityRep<1>(face, true)].volume();
+    return current_data_->back()->geometryArrays().face_areas[face];
 }
 
 const Dune::FieldVector<double,3>& CpGrid::faceCentroid(int face) const
 {
-    return current_data_->back()->geomVector<1>()[cpgrid::EntityRep<1>(face, true)].center();
+    return current_data_->back()->geometryArrays().face_centroids[face];
 }
 
 const Dune::FieldVector<double,3>& CpGrid::faceNormal(int face) const
@@ -1583,12 +2110,47 @@ const Dune::FieldVector<double,3>& CpGrid::faceNormal(int face) const
 
 double CpGrid::cellVolume(int cell) const
 {
-    return current_data_->back()->geomVector<0>()[cpgrid::EntityRep<0>(cell, true)].volume();
+    return current_data_->back()->geometryArrays().cell_volumes[cell];
 }
 
 const Dune::FieldVector<double,3>& CpGrid::cellCentroid(int cell) const
 {
-    return current_data_->back()->geomVector<0>()[cpgrid::EntityRep<0>(cell, true)].center();
+    return current_data_->back()->geometryArrays().cell_centroids[cell];
+}
+
+const std::vector<double>& CpGrid::cellVolumes() const
+{
+    return current_data_->back()->geometryArrays().cell_volumes;
+}
+
+const std::vector<Dune::FieldVector<double,3>>& CpGrid::cellCentroids() const
+{
+    return current_data_->back()->geometryArrays().cell_centroids;
+}
+
+const std::vector<double>& CpGrid::faceAreas() const
+{
+    return current_data_->back()->geometryArrays().face_areas;
+}
+
+const std::vector<Dune::FieldVector<double,3>>& CpGrid::faceCentroids() const
+{
+    return current_data_->back()->geometryArrays().face_centroids;
+}
+
+cpgrid::FaceNeighbourTable::row_type CpGrid::faceNeighbours(int cell) const
+{
+    return current_data_->back()->faceNeighbourTable()[cell];
+}
+
+const cpgrid::FaceNeighbourTable& CpGrid::faceNeighbourTable() const
+{
+    return current_data_->back()->faceNeighbourTable();
+}
+
+const cpgrid::InteriorCellSets& CpGrid::interiorCellSets() const
+{
+    return current_data_->back()->interiorCellSets();
 }
 
 CpGrid::CentroidIterator<0> CpGrid::beginCellCentroids() const
@@ -1710,6 +2272,8 @@ CpGrid::processEclipseFormat(const Opm::EclipseGrid* ecl_grid,
                              const bool pinchActive,
                              const bool edge_conformal)
 {
+    Opm::SetupProfile::Scope profile_scope(setup_profile_.get(), "processEclipseFormat");
+    current_data_->back()->setup_profile_ = setup_profile_.get();
     auto removed_cells = current_data_->back()->
         processEclipseFormat(ecl_grid, ecl_state,
                              periodic_extension,
@@ -1743,9 +2307,11 @@ void CpGrid::processEclipseFormat(const grdecl& input_data,
                                   const bool turn_normals,
                                   const bool edge_conformal)
 {
+    Opm::SetupProfile::Scope profile_scope(setup_profile_.get(), "processEclipseFormat");
     using NNCMap = std::set<std::pair<int, int>>;
     using NNCMaps = std::array<NNCMap, 2>;
     NNCMaps nnc;
+    current_data_->back()->setup_profile_ = setup_profile_.get();
     current_data_->back()->processEclipseFormat(input_data,
 #if HAVE_OPM_COMMON
                                                 nullptr,
@@ -1762,6 +2328,50 @@ void CpGrid::processEclipseFormat(const grdecl& input_data,
                                             0);
 }
 
+void CpGrid::processEclipseFormatDistributed(const grdecl& slab_input,
+                                             const int global_ny,
+                                             const std::array<int,2>& owned_rows,
+                                             const bool turn_normals,
+                                             const bool edge_conformal)
+{
+    if (!distributed_data_.empty()) {
+        OPM_THROW(std::logic_error, "There is already a distributed version of the grid.");
+    }
+
+    Opm::SetupProfile::Scope profile_scope(setup_profile_.get(), "processEclipseFormatDistributed");
+    auto& cc = data_[0]->ccobj_;
+
+    if (cc.size() == 1) {
+        // Nothing to distribute, the slab is the whole grid.
+        data_[0]->setup_profile_ = setup_profile_.get();
+        data_[0]->processEclipseFormatDistributed(slab_input, global_ny, owned_rows,
+                                                  turn_normals,
+                                                  /* pinchActive = */ false,
+                                                  /* tolerance_unique_points = */ 0.0,
+                                                  edge_conformal);
+        return;
+    }
+
+    distributed_data_.push_back(std::make_shared<cpgrid::CpGridData>(cc, distributed_data_));
+    distributed_data_[0]->setup_profile_ = setup_profile_.get();
+    distributed_data_[0]->processEclipseFormatDistributed(slab_input, global_ny, owned_rows,
+                                                          turn_normals,
+                                                          /* pinchActive = */ false,
+                                                          /* tolerance_unique_points = */ 0.0,
+                                                          edge_conformal);
+    (*global_id_set_ptr_).insertIdSet(*distributed_data_[0]);
+    current_data_ = &distributed_data_;
+}
+
+std::array<int,2> CpGrid::slabInputRows(const std::array<int,2>& owned_rows,
+                                        const int global_ny)
+{
+    // One halo row becomes the overlap layer. The second one is only
+    // processed to get the faces and points between the overlap layer
+    // and the rest of the grid right, and is dropped afterwards.
+    return { std::max(owned_rows[0] - 2, 0), std::min(owned_rows[1] + 2, global_ny) };
+}
+
 template<int dim>
 cpgrid::Entity<dim> createEntity(const CpGrid& grid,int index,bool orientation)
 {
@@ -1859,6 +2469,7 @@ bool CpGrid::refineAndUpdateGrid(const std::vector<std::array<int,3>>& cells_per
 {
     // To do: support coarsening.
     assert( static_cast<int>(assignRefinedLevel.size()) == currentLeafData().size(0));
+    Opm::SetupProfile::Scope profile_scope(setup_profile_.get(), "refinement");
     assert(cells_per_dim_vec.size() == lgr_name_vec.size());
 
     auto& data = currentData(); // data pointed by current_data_ (data_ or distributed_data_[if loadBalance() has been invoked before adapt()]).
@@ -1951,7 +2562,8 @@ bool CpGrid::refineAndUpdateGrid(const std::vector<std::array<int,3>>& cells_per
     // -- markedElem_to_itsLgr :
     // Each marked element gets refined and we store this "auxiliary markedElementLGR", to later
     // build a unique level containing all the refined entities from all the marked elements.
-    std::vector<std::shared_ptr<Dune::cpgrid::CpGridData> > markedElem_to_itsLgr;
+    // Only geometries and topology are kept (no CpGridData per marked element).
+    std::vector<std::shared_ptr<Dune::cpgrid::SingleCellRefinement>> markedElem_to_itsLgr;
     markedElem_to_itsLgr.resize(current_data_->back()->size(0));
     // -- markedElem_count: Total amount of marked elements to be refined. It will be used to print grid info.
     int markedElem_count = 0;
@@ -1970,7 +2582,7 @@ bool CpGrid::refineAndUpdateGrid(const std::vector<std::array<int,3>>& cells_per
     // Following the example above,
     // markedElemAndEquivRefinedCorner_to_corner[{0, 8}] = 5;
     // markedElemAndEquivRefinedCorner_to_corner[{1, 2}] = 5;
-    std::map< std::array<int,2>, int > markedElemAndEquivRefinedCorn_to_corner;
+    Dune::cpgrid::IndexPairMap<int> markedElemAndEquivRefinedCorn_to_corner;
     // -- faceInMarkedElemAndRefinedFaces :
     // For each face from level zero, we store the marked elements where the face appears (maximum 2 cells)
     // and its new-born refined faces from each auxiliary marked-element-lgr. Example: face with index 9
@@ -1982,8 +2594,8 @@ bool CpGrid::refineAndUpdateGrid(const std::vector<std::array<int,3>>& cells_per
     faceInMarkedElemAndRefinedFaces.resize(current_data_->back()->face_to_cell_.size());
     // ------------------------ Refined cells parameters
     // --- Refined cells and PreAdapt cells relations ---
-    std::map<std::array<int,2>,std::array<int,2>> elemLgrAndElemLgrCell_to_refinedLevelAndRefinedCell;
-    std::map<std::array<int,2>,std::array<int,2>> refinedLevelAndRefinedCell_to_elemLgrAndElemLgrCell;
+    Dune::cpgrid::IndexPairMap<std::array<int,2>> elemLgrAndElemLgrCell_to_refinedLevelAndRefinedCell;
+    Dune::cpgrid::IndexPairMap<std::array<int,2>> refinedLevelAndRefinedCell_to_elemLgrAndElemLgrCell;
     // Integer to count only REFINED cells (new-born refined cells from ANY marked element).
     std::vector<int> refined_cell_count_vec(levels, 0);
     // -- Parent-child relations --
@@ -1991,7 +2603,7 @@ bool CpGrid::refineAndUpdateGrid(const std::vector<std::array<int,3>>& cells_per
     std::vector<std::vector<std::tuple<int,std::vector<int>>>> preAdapt_parent_to_children_cells_vec(preAdaptMaxLevel +1);
     // ------------------------ Adapted cells parameters
     // --- Adapted cells and PreAdapt cells relations ---
-    std::map<std::array<int,2>,int>           elemLgrAndElemLgrCell_to_adaptedCell;
+    Dune::cpgrid::IndexPairMap<int>           elemLgrAndElemLgrCell_to_adaptedCell;
     std::unordered_map<int,std::array<int,2>> adaptedCell_to_elemLgrAndElemLgrCell;
     // Integer to count adapted cells (mixed between cells from level0 (not involved in LGRs), and (new-born) refined cells).
     int cell_count = 0;
@@ -2011,6 +2623,7 @@ bool CpGrid::refineAndUpdateGrid(const std::vector<std::array<int,3>>& cells_per
         preAdapt_level_to_leaf_cells_vec[preAdaptLevel].resize(data[preAdaptLevel]->size(0), -1);
     }
     //
+    Opm::SetupProfile::Scope marked_scope(setup_profile_.get(), "refineMarkedCells");
     Opm::Lgr::refineAndProvideMarkedRefinedRelations( *this,
                                                       /* Marked elements parameters */
                                                       markedElem_to_itsLgr,
@@ -2031,6 +2644,9 @@ bool CpGrid::refineAndUpdateGrid(const std::vector<std::array<int,3>>& cells_per
                                                       preAdapt_level_to_leaf_cells_vec,
                                                       /* Additional parameters */
                                                       cells_per_dim_vec);
+    marked_scope.count("marked_cells", markedElem_count);
+    marked_scope.count("leaf_cells", cell_count);
+    marked_scope.close();
 
 #if HAVE_MPI
     auto global_markedElem_count = comm().sum(markedElem_count);
@@ -2083,9 +2699,9 @@ bool CpGrid::refineAndUpdateGrid(const std::vector<std::array<int,3>>& cells_per
     // Stablish relationships between PreAdapt corners and refined or adapted ones ---
     //
     // --- Refined corners and PreAdapt corners relations ---
-    std::map<std::array<int,2>,std::array<int,2>> elemLgrAndElemLgrCorner_to_refinedLevelAndRefinedCorner;
-    std::map<std::array<int,2>,std::array<int,2>> refinedLevelAndRefinedCorner_to_elemLgrAndElemLgrCorner;
-    std::map<std::array<int,2>,std::array<int,2>> vanishedRefinedCorner_to_itsLastAppearance;
+    Dune::cpgrid::IndexPairMap<std::array<int,2>> elemLgrAndElemLgrCorner_to_refinedLevelAndRefinedCorner;
+    Dune::cpgrid::IndexPairMap<std::array<int,2>> refinedLevelAndRefinedCorner_to_elemLgrAndElemLgrCorner;
+    Dune::cpgrid::IndexPairMap<std::array<int,2>> vanishedRefinedCorner_to_itsLastAppearance;
     // Integer to count only refined corners.
     std::vector<int> refined_corner_count_vec(levels, 0);
     Opm::Lgr::identifyRefinedCornersPerLevel(currentLeafData(),
@@ -2103,7 +2719,7 @@ bool CpGrid::refineAndUpdateGrid(const std::vector<std::array<int,3>>& cells_per
                                              cells_per_dim_vec);
 
     // --- Adapted corners and PreAdapt corners relations ---
-    std::map<std::array<int,2>,int>           elemLgrAndElemLgrCorner_to_adaptedCorner;
+    Dune::cpgrid::IndexPairMap<int>           elemLgrAndElemLgrCorner_to_adaptedCorner;
     std::unordered_map<int,std::array<int,2>> adaptedCorner_to_elemLgrAndElemLgrCorner;
     // Integer to count adapted corners (mixed between corners from pre-refined-leaf corners not involved in LGRs, and new-born refined corners).
     int corner_count = 0;
@@ -2124,8 +2740,8 @@ bool CpGrid::refineAndUpdateGrid(const std::vector<std::array<int,3>>& cells_per
     // FACES
     // Stablish relationships between PreAdapt faces and refined or adapted ones ---
     // --- Refined faces and PreAdapt faces relations ---
-    std::map<std::array<int,2>,std::array<int,2>> elemLgrAndElemLgrFace_to_refinedLevelAndRefinedFace;
-    std::map<std::array<int,2>,std::array<int,2>> refinedLevelAndRefinedFace_to_elemLgrAndElemLgrFace;
+    Dune::cpgrid::IndexPairMap<std::array<int,2>> elemLgrAndElemLgrFace_to_refinedLevelAndRefinedFace;
+    Dune::cpgrid::IndexPairMap<std::array<int,2>> refinedLevelAndRefinedFace_to_elemLgrAndElemLgrFace;
     // Integer to count adapted faces (mixed between faces from level0 (not involved in LGRs), and (new-born) refined faces).
     std::vector<int> refined_face_count_vec(levels, 0);
     Opm::Lgr::identifyRefinedFacesPerLevel(currentLeafData(),
@@ -2139,7 +2755,7 @@ bool CpGrid::refineAndUpdateGrid(const std::vector<std::array<int,3>>& cells_per
                                            cells_per_dim_vec);
 
     // --- Adapted faces and PreAdapt faces relations ---
-    std::map< std::array<int,2>, int >           elemLgrAndElemLgrFace_to_adaptedFace;
+    Dune::cpgrid::IndexPairMap<int>           elemLgrAndElemLgrFace_to_adaptedFace;
     std::unordered_map< int, std::array<int,2> > adaptedFace_to_elemLgrAndElemLgrFace;
     // Integer to count adapted faces (mixed between faces from pre-refined-leaf faces not involved in LGRs and new-born refined faces).
     int face_count = 0;
@@ -2781,7 +3397,7 @@ std::array<double,3> CpGrid::getEclCentroid(const cpgrid::Entity<0>& elem) const
 }
 
 void CpGrid::updateCornerHistoryLevels(const std::vector<std::vector<std::array<int,2>>>& cornerInMarkedElemWithEquivRefinedCorner,
-                                       const std::map<std::array<int,2>,std::array<int,2>>& elemLgrAndElemLgrCorner_to_refinedLevelAndRefinedCorner,
+                                       const Dune::cpgrid::IndexPairMap<std::array<int,2>>& elemLgrAndElemLgrCorner_to_refinedLevelAndRefinedCorner,
                                        const std::unordered_map<int,std::array<int,2>>& adaptedCorner_to_elemLgrAndElemLgrCorner,
                                        const int& corner_count,
                                        const std::vector<std::array<int,2>>& preAdaptGrid_corner_history,
@@ -1,8 +1,13 @@
 #include"config.h"
 #include <algorithm>
 #include <array>
+#include <cassert>
+#include <limits>
 #include <map>
 #include <set>
+#include <string>
+#include <tuple>
+#include <type_traits>
 #include <vector>
 #include <utility>
 #include"CpGridData.hpp"
@@ -122,6 +127,121 @@ void CpGridData::populateGlobalCellIndexSet()
 #endif
 }
 
+const GeometryArrays& CpGridData::geometryArrays() const
+{
+    std::call_once(geometry_arrays_flag_, [this]() { geometry_arrays_ = buildGeometryArrays(); });
+    return *geometry_arrays_;
+}
+
+std::unique_ptr<GeometryArrays> CpGridData::buildGeometryArrays() const
+{
+    const auto& cells = geomVector<0>();
+    const auto& faces = geomVector<1>();
+    const int num_cells = cells.size();
+    const int num_faces = faces.size();
+
+    auto arrays = std::make_unique<GeometryArrays>();
+    arrays->cell_volumes.resize(num_cells);
+    arrays->cell_centroids.resize(num_cells);
+    arrays->face_areas.resize(num_faces);
+    arrays->face_centroids.resize(num_faces);
+
+#ifdef _OPENMP
+#pragma omp parallel for schedule(static)
+#endif
+    for (int cell = 0; cell < num_cells; ++cell) {
+        const auto& geom = cells.get(cell);
+        arrays->cell_volumes[cell] = geom.volume();
+        arrays->cell_centroids[cell] = geom.center();
+    }
+#ifdef _OPENMP
+#pragma omp parallel for schedule(static)
+#endif
+    for (int face = 0; face < num_faces; ++face) {
+        const auto& geom = faces.get(face);
+        arrays->face_areas[face] = geom.volume();
+        arrays->face_centroids[face] = geom.center();
+    }
+    return arrays;
+}
+
+const FaceNeighbourTable& CpGridData::faceNeighbourTable() const
+{
+    std::call_once(face_neighbour_table_flag_, [this]() { face_neighbour_table_ = buildFaceNeighbourTable(); });
+    return *face_neighbour_table_;
+}
+
+std::unique_ptr<FaceNeighbourTable> CpGridData::buildFaceNeighbourTable() const
+{
+    const int num_cells = cell_to_face_.size();
+    std::vector<int> row_sizes(num_cells);
+    for (int cell = 0; cell < num_cells; ++cell) {
+        row_sizes[cell] = cell_to_face_.rowSize(EntityRep<0>(cell, true));
+    }
+    auto table = std::make_unique<FaceNeighbourTable>();
+    table->allocate(row_sizes.begin(), row_sizes.end());
+
+    // Same neighbour rules as Intersection::update().
+#ifdef _OPENMP
+#pragma omp parallel for schedule(static)
+#endif
+    for (int cell = 0; cell < num_cells; ++cell) {
+        auto row = (*table)[cell];
+        int i = 0;
+        for (const auto& face : cell_to_face_[EntityRep<0>(cell, true)]) {
+            auto& entry = row[i++];
+            entry.face = face.index();
+            entry.tag = face_tag_[face];
+            entry.normal_is_outward = face.orientation();
+            const auto cells_of_face = face_to_cell_[face];
+            if (cells_of_face.size() == 1) {
+                entry.neighbour = FaceNeighbour::Boundary;
+            }
+            else if (cells_of_face[0].index() == std::numeric_limits<int>::max() ||
+                     cells_of_face[1].index() == std::numeric_limits<int>::max()) {
+                entry.neighbour = FaceNeighbour::ProcessBoundary;
+            }
+            else {
+                entry.neighbour = cells_of_face[0].index() == cell
+                    ? cells_of_face[1].index()
+                    : cells_of_face[0].index();
+            }
+        }
+    }
+    return table;
+}
+
+const InteriorCellSets& CpGridData::interiorCellSets() const
+{
+    std::call_once(interior_cell_sets_flag_, [this]() { interior_cell_sets_ = buildInteriorCellSets(); });
+    return *interior_cell_sets_;
+}
+
+std::unique_ptr<InteriorCellSets> CpGridData::buildInteriorCellSets() const
+{
+    const auto& table = faceNeighbourTable();
+    const int num_cells = table.size();
+    std::vector<char> interior(num_cells);
+    for (int cell = 0; cell < num_cells; ++cell) {
+        interior[cell] = partition_type_indicator_->getPartitionType(Entity<0>(*this, cell, true))
+            == InteriorEntity;
+    }
+    auto sets = std::make_unique<InteriorCellSets>();
+    for (int cell = 0; cell < num_cells; ++cell) {
+        if (!interior[cell]) {
+            continue;
+        }
+        const auto row = table[cell];
+        const bool deep = std::all_of(row.begin(), row.end(), [&interior](const FaceNeighbour& entry)
+        {
+            return entry.neighbour == FaceNeighbour::Boundary
+                || (entry.hasNeighbour() && interior[entry.neighbour]);
+        });
+        (deep ? sets->deep_interior : sets->boundary_adjacent).push_back(cell);
+    }
+    return sets;
+}
+
 void CpGridData::computeUniqueBoundaryIds()
 {
     // Perhaps we should make available a more comprehensive interface
@@ -857,6 +977,9 @@ struct IndexSet2IdSet
     template<int dim>
     int idLevelZero(const EntityRep<dim>& t) const
     {
+        // Cells of other processes stay marked as such.
+        if (t.index() == std::numeric_limits<int>::max())
+            return std::numeric_limits<int>::max();
         return map_[t.index()];
     }
 
@@ -1206,7 +1329,8 @@ void createInterfaces(std::vector<std::map<int,char> >& attributes,
 
 }
 
-void CpGridData::computeGeometry(const CpGrid& grid,
+template<class Scatter>
+void CpGridData::computeGeometry(const Scatter& scatter,
                                  const DefaultGeometryPolicy&  globalGeometry,
                                  const std::vector<int>& globalAquiferCells,
                                  const OrientedEntityTable<0, 1>& globalCell2Faces,
@@ -1219,21 +1343,22 @@ void CpGridData::computeGeometry(const CpGrid& grid,
                                       *geometry.geomVector(std::integral_constant<int,1>()));
     FaceViaCellHandleWrapper<FaceGeometryHandle>
         wrappedFaceGeomHandle(faceGeomHandle, globalCell2Faces, cell2Faces);
-    grid.scatterData(wrappedFaceGeomHandle);
+    scatter(wrappedFaceGeomHandle);
 
     PointGeometryHandle pointGeomHandle(*globalGeometry.geomVector(std::integral_constant<int,3>()),
                                         *geometry.geomVector(std::integral_constant<int,3>()));
-    grid.scatterData(pointGeomHandle);
+    scatter(pointGeomHandle);
 
     CellGeometryHandle cellGeomHandle(*globalGeometry.geomVector(std::integral_constant<int,0>()),
                                       *geometry.geomVector(std::integral_constant<int,0>()),
                                       globalAquiferCells, aquiferCells,
                                       geometry.geomVector(std::integral_constant<int,3>()),
                                       cell2Points);
-    grid.scatterData(cellGeomHandle);
+    scatter(cellGeomHandle);
 }
 
-void computeFace2Point(const CpGrid& grid,
+template<class Scatter>
+void computeFace2Point(const Scatter& scatter,
                        const OrientedEntityTable<0, 1>& globalCell2Faces,
                        const LevelGlobalIdSet& globalIds,
                        const OrientedEntityTable<0, 1>& cell2Faces,
@@ -1249,7 +1374,7 @@ void computeFace2Point(const CpGrid& grid,
     RowSizeDataHandle rowSizeHandle(wrappedGlobal, rowSizes);
     FaceViaCellHandleWrapper<RowSizeDataHandle>
         wrappedSizeHandle(rowSizeHandle, globalCell2Faces, cell2Faces);
-    grid.scatterData(wrappedSizeHandle);
+    scatter(wrappedSizeHandle);
     face2Points.allocate(rowSizes.begin(), rowSizes.end());
     // Use entity with index INT_MAX to mark unprocessed row entries
     for (int row = 0, size = face2Points.size(); row < size; ++row)
@@ -1262,11 +1387,11 @@ void computeFace2Point(const CpGrid& grid,
     SparseTableDataHandle handle(globalFace2Points, globalIds, face2Points, global2local);
     FaceViaCellHandleWrapper<SparseTableDataHandle>
         wrappedHandle(handle, globalCell2Faces, cell2Faces);
-    grid.scatterData(wrappedHandle);
+    scatter(wrappedHandle);
 }
 
-template<class IndexSet>
-void computeFace2Cell(CpGrid& grid,
+template<class Scatter, class IndexSet>
+void computeFace2Cell(const Scatter& scatter,
                       const OrientedEntityTable<0, 1>& globalCell2Faces,
                       const OrientedEntityTable<0, 1>& cell2Faces,
                       const OrientedEntityTable<1, 0>& globalFace2Cells,
@@ -1280,7 +1405,7 @@ void computeFace2Cell(CpGrid& grid,
     RowSizeDataHandle<Table,1> rowSizeHandle(globalFace2Cells, rowSizes);
     FaceViaCellHandleWrapper<RowSizeDataHandle<Table,1> > wrappedSizeHandle(rowSizeHandle,
                                                                             globalCell2Faces, cell2Faces);
-    grid.scatterData(wrappedSizeHandle);
+    scatter(wrappedSizeHandle);
     face2Cells.allocate(rowSizes.begin(), rowSizes.end());
     // Use entity with index INT_MAX to mark unprocessed row entries
     for (int row = 0, size = face2Cells.size(); row < size; ++row)
@@ -1294,7 +1419,7 @@ void computeFace2Cell(CpGrid& grid,
     F2CDataHandle<IndexSet> entryHandle(globalFace2Cells, face2Cells, local2Global, global2local);
     FaceViaCellHandleWrapper<F2CDataHandle<IndexSet> > wrappedEntryHandle(entryHandle,
                                                                           globalCell2Faces, cell2Faces);
-    grid.scatterData(wrappedEntryHandle);
+    scatter(wrappedEntryHandle);
 #ifndef NDEBUG
     for (int row = 0, size = face2Cells.size(); row < size; ++row)
     {
@@ -1309,7 +1434,8 @@ void computeFace2Cell(CpGrid& grid,
 }
 
 
-std::map<int,int> computeCell2Face(const CpGrid& grid,
+template<class Scatter>
+std::map<int,int> computeCell2Face(const Scatter& scatter,
                                    const OrientedEntityTable<0, 1>& globalCell2Faces,
                                    const LevelGlobalIdSet& globalIds,
                                    OrientedEntityTable<0, 1>& cell2Faces,
@@ -1319,12 +1445,12 @@ std::map<int,int> computeCell2Face(const CpGrid& grid,
     std::vector<int> rowSizes(noCells);
     using Table = OrientedEntityTable<0,1>;
     RowSizeDataHandle<Table,0> rowSizeHandle(globalCell2Faces, rowSizes);
-    grid.scatterData(rowSizeHandle);
+    scatter(rowSizeHandle);
     cell2Faces.allocate(rowSizes.begin(), rowSizes.end());
     map2Global.reserve((noCells*6)*1.1);
     C2FDataHandle handle(globalCell2Faces, globalIds, cell2Faces,
                          map2Global);
-    grid.scatterData(handle);
+    scatter(handle);
     // make map2Global a map from local index to global id
     std::ranges::sort(map2Global);
     auto newEnd = std::unique(map2Global.begin(),map2Global.end());
@@ -1423,7 +1549,8 @@ void createInterfaceList(const typename CpGridData::InterfaceMap::value_type& pr
         pointList.add(point);
 }
 
-std::map<int,int> computeCell2Point(const CpGrid& grid,
+template<class Scatter>
+std::map<int,int> computeCell2Point(const Scatter& scatter,
                                     const std::vector<std::array<int,8> >& globalCell2Points,
                                     const LevelGlobalIdSet& globalIds,
                                     const OrientedEntityTable<0, 1>& globalCell2Faces,
@@ -1446,7 +1573,7 @@ std::map<int,int> computeCell2Point(const CpGrid& grid,
                                  cell2Points,
                                  map2Global,
                                  additionalPoints);
-    grid.scatterData(handle);
+    scatter(handle);
     // make map2Global a map from local index to global id
     std::ranges::sort(map2Global);
     auto newEnd = std::unique(map2Global.begin(),map2Global.end());
@@ -1468,11 +1595,11 @@ std::map<int,int> computeCell2Point(const CpGrid& grid,
     }
 
     // Create interfaces for point communication
+    ReversePointGlobalIdSet globalMap2Local(globalIds);
 
     for ( const auto& procCellLists: cellInterfaces)
     {
         // The send list
-        ReversePointGlobalIdSet globalMap2Local(globalIds);
         createInterfaceList<true>(procCellLists, globalCell2Points,
                                   globalAdditionalPoints,
                                   [&globalIds](int i){
@@ -1480,7 +1607,6 @@ std::map<int,int> computeCell2Point(const CpGrid& grid,
                                   },
                                   globalMap2Local,
                                   pointInterfaces[procCellLists.first]);
-        globalMap2Local.release();
         // The receive list
         createInterfaceList<false>(procCellLists, cell2Points,
                                    additionalPoints,
@@ -1491,6 +1617,7 @@ std::map<int,int> computeCell2Point(const CpGrid& grid,
                                    map2Local,
                                    pointInterfaces[procCellLists.first]);
     }
+    globalMap2Local.release();
     return map2Local;
 }
 
@@ -1501,11 +1628,30 @@ void CpGridData::distributeGlobalGrid(CpGrid& grid,
                                       const std::vector<int>& /* cell_part */)
 {
 #if HAVE_MPI
+    distributeCells(view_data, *grid.cell_scatter_gather_interfaces_,
+                    *grid.point_scatter_gather_interfaces_);
+#else // #if HAVE_MPI
+    static_cast<void>(grid);
+    static_cast<void>(view_data);
+#endif
+}
+
+#if HAVE_MPI
+void CpGridData::distributeCells(const CpGridData& view_data,
+                                 const InterfaceMap& cell_inf,
+                                 InterfaceMap& point_inf)
+{
     auto& cell_indexset = cellIndexSet();
     auto& cell_remote_indices = cellRemoteIndices();
     // setup the remote indices.
     cell_remote_indices.template rebuild<false>(); // We could probably also compute this on our own, like before?
 
+    // All data is sent from the cells and points of view_data to the ones of this view.
+    const auto scatter = [this, &view_data, &cell_inf, &point_inf](auto& handle)
+    {
+        this->scatterData(handle, &view_data, this, cell_inf, point_inf);
+    };
+
     // We can identify existing cells with the help of the index set.
     // Now we need to compute the existing faces and points. Either exist
     // if they are reachable from an existing cell.
@@ -1513,11 +1659,10 @@ void CpGridData::distributeGlobalGrid(CpGrid& grid,
     std::vector<int> map2GlobalFaceId;
     std::vector<int> map2GlobalPointId;
     std::map<int,int> point_indicator =
-        computeCell2Point(grid, view_data.cell_to_point_, *view_data.global_id_set_, view_data.cell_to_face_,
+        computeCell2Point(scatter, view_data.cell_to_point_, *view_data.global_id_set_, view_data.cell_to_face_,
                           view_data.face_to_point_, cell_to_point_,
                           map2GlobalPointId, cell_indexset.size(),
-                          *grid.cell_scatter_gather_interfaces_,
-                          *grid.point_scatter_gather_interfaces_);
+                          cell_inf, point_inf);
 
     // create global ids array for cells. The parallel index set uses the global id
     // as the global index.
@@ -1528,7 +1673,7 @@ void CpGridData::distributeGlobalGrid(CpGrid& grid,
     }
 
     [[maybe_unused]] std::map<int,int> face_indicator =
-        computeCell2Face(grid, view_data.cell_to_face_, *view_data.global_id_set_, cell_to_face_,
+        computeCell2Face(scatter, view_data.cell_to_face_, *view_data.global_id_set_, cell_to_face_,
                          map2GlobalFaceId, cell_indexset.size());
 
     auto noExistingPoints = map2GlobalPointId.size();
@@ -1536,9 +1681,9 @@ void CpGridData::distributeGlobalGrid(CpGrid& grid,
 
     global_id_set_->swap(map2GlobalCellId, map2GlobalFaceId, map2GlobalPointId);
 
-    computeFace2Cell(grid, view_data.cell_to_face_, cell_to_face_,
+    computeFace2Cell(scatter, view_data.cell_to_face_, cell_to_face_,
                      view_data.face_to_cell_, face_to_cell_, cell_indexset, view_data.cellIndexSet(), noExistingFaces);
-    computeFace2Point(grid,  view_data.cell_to_face_, *view_data.global_id_set_, cell_to_face_,
+    computeFace2Point(scatter,  view_data.cell_to_face_, *view_data.global_id_set_, cell_to_face_,
                       view_data.face_to_point_, face_to_point_, point_indicator,
                       noExistingFaces);
 
@@ -1550,14 +1695,14 @@ void CpGridData::distributeGlobalGrid(CpGrid& grid,
     geometry_.geomVector(std::integral_constant<int,0>()) -> resize(cell_to_face_.size());
     geometry_.geomVector(std::integral_constant<int,3>()) -> resize(noExistingPoints);
 
-    computeGeometry(grid, view_data.geometry_, view_data.aquifer_cells_, view_data.cell_to_face_,
+    computeGeometry(scatter, view_data.geometry_, view_data.aquifer_cells_, view_data.cell_to_face_,
                     geometry_, aquifer_cells_, cell_to_face_, cell_to_point_);
 
     global_cell_.resize(cell_indexset.size());
 
     // communicate global cell
     DefaultContainerHandle<std::vector<int> > indexHandle(view_data.global_cell_, global_cell_);
-    grid.scatterData(indexHandle);
+    scatter(indexHandle);
 
     // Scatter face tags, normals, and boundary ids.
     auto noBids = view_data.unique_boundary_ids_.size();
@@ -1572,7 +1717,7 @@ void CpGridData::distributeGlobalGrid(CpGrid& grid,
                                           face_tag_, face_normals_, unique_boundary_ids_);
         FaceViaCellHandleWrapper<FaceTagNormalBIdHandle>
             wrappedFaceHandle(faceHandle, view_data.cell_to_face_, cell_to_face_);
-        grid.scatterData(wrappedFaceHandle);
+        scatter(wrappedFaceHandle);
     }
     else
     {
@@ -1580,7 +1725,7 @@ void CpGridData::distributeGlobalGrid(CpGrid& grid,
                                        face_tag_, face_normals_);
         FaceViaCellHandleWrapper<FaceTagNormalHandle>
             wrappedFaceHandle(faceHandle, view_data.cell_to_face_, cell_to_face_);
-        grid.scatterData(wrappedFaceHandle);
+        scatter(wrappedFaceHandle);
     }
 
     // Compute the partition type for cell
@@ -1590,11 +1735,8 @@ void CpGridData::distributeGlobalGrid(CpGrid& grid,
     computePointPartitionType();
 
     computeCommunicationInterfaces(noExistingPoints);
-#else // #if HAVE_MPI
-    static_cast<void>(grid);
-    static_cast<void>(view_data);
-#endif
 }
+#endif // #if HAVE_MPI
 
 void CpGridData::computeCellPartitionType()
 {
@@ -1608,9 +1750,28 @@ void CpGridData::computeCellPartitionType()
             i.local().attribute()==AttributeSet::owner?
             InteriorEntity:OverlapEntity;
     }
+    computeInteriorCellsEnd();
 #endif
 }
 
+void CpGridData::computeInteriorCellsEnd()
+{
+    const auto& indicator = partition_type_indicator_->cell_indicator_;
+    const auto first_other = std::ranges::find_if(indicator, [](char type) { return type != InteriorEntity; });
+    const bool interior_first = std::find(first_other, indicator.end(), char(InteriorEntity)) == indicator.end();
+    interior_cells_end_ = interior_first ? first_other - indicator.begin() : -1;
+}
+
+int CpGridData::interiorCellsEnd() const
+{
+    if (partition_type_indicator_->cell_indicator_.empty()) {
+        // Same rules as PartitionTypeIndicator::getPartitionType(): Cells of refined
+        // levels take the type of their parent cells, all others are interior.
+        return level_ > 0 ? -1 : size(0);
+    }
+    return interior_cells_end_;
+}
+
 void CpGridData::computePointPartitionType()
 {
 #if HAVE_MPI
@@ -1661,6 +1822,9 @@ void CpGridData::computePointPartitionType()
 void CpGridData::computeCommunicationInterfaces([[maybe_unused]] int noExistingPoints)
 {
 #if HAVE_MPI
+    // The persistent plans refer to the old interfaces.
+    persistent_communicators_.clear();
+
     // Compute the interface information for cells
     std::get<InteriorBorder_All_Interface>(cell_interfaces_)
         .build(cellRemoteIndices(), EnumItem<AttributeSet, AttributeSet::owner>(),
@@ -1711,6 +1875,300 @@ void CpGridData::computeCommunicationInterfaces([[maybe_unused]] int noExistingP
 #endif
 }
 
+#if HAVE_MPI
+CpGridData::PersistentCommunicator& CpGridData::persistentCommunicator(const InterfaceMap& interface)
+{
+    auto& comm = persistent_communicators_[&interface];
+    if (!comm) {
+        comm = std::make_unique<PersistentCommunicator>(ccobj_, interface);
+        comm->setNeighbourhoodCollectives(communication_method_ == neighbourhoodCollectives);
+    }
+    return *comm;
+}
+#endif
+
+void CpGridData::setCommunicationMethod(CommunicationMethod method)
+{
+    if (method == communication_method_) {
+        return;
+    }
+#if HAVE_MPI
+    for (auto& entry : persistent_communicators_) {
+        auto& comm = entry.second;
+        if (comm->persistentPending(true) || comm->persistentPending(false)) {
+            OPM_THROW(std::logic_error, "The communication method cannot be changed while a "
+                      "communication is pending");
+        }
+        comm->setNeighbourhoodCollectives(method == neighbourhoodCollectives);
+    }
+#endif
+    communication_method_ = method;
+}
+
+namespace
+{
+/// Reorders values with one entry per entity, new entry i being old entry order[i].
+/// The container itself is kept, as others may refer to it. Empty containers stay empty.
+template<class Container>
+void permuteEntities(Container& values, const std::vector<int>& order)
+{
+    if (values.empty()) {
+        return;
+    }
+    assert(values.size() == order.size());
+    std::vector<std::decay_t<decltype(*values.data())>> permuted;
+    permuted.reserve(order.size());
+    for (const int old_index : order) {
+        permuted.push_back(values.data()[old_index]);
+    }
+    std::ranges::copy(permuted, values.begin());
+}
+
+/// Numbers the entities not reached so far after all others, in their old order.
+void appendUnreached(std::vector<int>& new_index, std::vector<int>& order)
+{
+    for (std::size_t i = 0; i < new_index.size(); ++i) {
+        if (new_index[i] < 0) {
+            new_index[i] = order.size();
+            order.push_back(i);
+        }
+    }
+}
+
+#if HAVE_MPI
+/// Replaces the local indices of both directions of an interface by new ones. The
+/// position of an index within an interface is its match on the other process,
+/// hence it is kept.
+template<class Map>
+void renumberInterfaces(Map& interfaces, const std::vector<int>& new_index)
+{
+    for (auto& entry : interfaces) {
+        for (auto* information : {&entry.second.first, &entry.second.second}) {
+            for (std::size_t i = 0; i < information->size(); ++i) {
+                (*information)[i] = new_index[(*information)[i]];
+            }
+        }
+    }
+}
+#endif
+} // anonymous namespace
+
+std::vector<int> CpGridData::renumberedCellOrder(RenumberingMethod method, bool ownersFirst) const
+{
+    const int num_cells = size(0);
+    std::vector<int> order;
+    switch (method) {
+    case reverseCuthillMcKee: {
+        const auto& table = faceNeighbourTable();
+        std::vector<int> xadj(num_cells + 1, 0);
+        std::vector<int> adjncy;
+        adjncy.reserve(table.dataSize());
+        for (int cell = 0; cell < num_cells; ++cell) {
+            for (const auto& entry : table[cell]) {
+                if (entry.hasNeighbour()) {
+                    adjncy.push_back(entry.neighbour);
+                }
+            }
+            xadj[cell + 1] = adjncy.size();
+        }
+        order = reverseCuthillMcKeeOrder(xadj, adjncy);
+        break;
+    }
+    case hilbertCurve: {
+        const auto& cells = geomVector<0>();
+        std::vector<FieldVector<double, 3>> centroids(num_cells);
+        for (int cell = 0; cell < num_cells; ++cell) {
+            centroids[cell] = cells.get(cell).center();
+        }
+        order = hilbertCurveOrder(centroids);
+        break;
+    }
+    default:
+        OPM_THROW(std::invalid_argument, "Unknown renumbering method " + std::to_string(method));
+    }
+    if (ownersFirst) {
+        std::ranges::stable_partition(order, [this](int cell)
+        {
+            return partition_type_indicator_->getPartitionType(Entity<0>(*this, cell, true))
+                == InteriorEntity;
+        });
+    }
+    return order;
+}
+
+Renumbering CpGridData::renumber(RenumberingMethod method, bool ownersFirst)
+{
+    if (!level_to_leaf_cells_.empty() || !leaf_to_level_cells_.empty() || !child_to_parent_cells_.empty()) {
+        OPM_THROW(std::logic_error, "Grid views with refined cells cannot be renumbered");
+    }
+#if HAVE_MPI
+    for (auto& entry : persistent_communicators_) {
+        if (entry.second->persistentPending(true) || entry.second->persistentPending(false)) {
+            OPM_THROW(std::logic_error, "The grid cannot be renumbered while a communication is pending");
+        }
+    }
+#endif
+    const int num_cells = size(0);
+    const int num_faces = face_to_cell_.size();
+    const int num_points = geomVector<3>().size();
+
+    Renumbering renumbering;
+    auto& cells = renumbering.cells;
+    auto& faces = renumbering.faces;
+    auto& points = renumbering.points;
+    cells = renumberedCellOrder(method, ownersFirst);
+    std::vector<int> new_cell(num_cells);
+    for (int cell = 0; cell < num_cells; ++cell) {
+        new_cell[cells[cell]] = cell;
+    }
+
+    // Faces and points are numbered in the order the renumbered cells reach them.
+    std::vector<int> new_face(num_faces, -1);
+    faces.reserve(num_faces);
+    for (const int cell : cells) {
+        for (const auto& face : cell_to_face_[EntityRep<0>(cell, true)]) {
+            if (new_face[face.index()] < 0) {
+                new_face[face.index()] = faces.size();
+                faces.push_back(face.index());
+            }
+        }
+    }
+    appendUnreached(new_face, faces);
+
+    std::vector<int> new_point(num_points, -1);
+    points.reserve(num_points);
+    const auto reachPoint = [&new_point, &points](int point)
+    {
+        if (new_point[point] < 0) {
+            new_point[point] = points.size();
+            points.push_back(point);
+        }
+    };
+    if (!cell_to_point_.empty()) {
+        for (const int cell : cells) {
+            for (const int point : cell_to_point_[cell]) {
+                reachPoint(point);
+            }
+        }
+    }
+    if (face_to_point_.size() == num_faces) {
+        for (const int face : faces) {
+            for (const int point : face_to_point_[face]) {
+                reachPoint(point);
+            }
+        }
+    }
+    appendUnreached(new_point, points);
+
+    // Topology. Faces of other processes are marked by an invalid cell index, which is kept.
+    {
+        std::vector<EntityRep<1>> data;
+        data.reserve(cell_to_face_.dataSize());
+        std::vector<int> row_sizes(num_cells);
+        for (int cell = 0; cell < num_cells; ++cell) {
+            const auto row = cell_to_face_[EntityRep<0>(cells[cell], true)];
+            row_sizes[cell] = row.size();
+            for (const auto& face : row) {
+                data.emplace_back(new_face[face.index()], face.orientation());
+            }
+        }
+        OrientedEntityTable<0, 1> table(data.begin(), data.end(), row_sizes.begin(), row_sizes.end());
+        cell_to_face_.swap(table);
+    }
+    {
+        std::vector<EntityRep<0>> data;
+        data.reserve(face_to_cell_.dataSize());
+        std::vector<int> row_sizes(num_faces);
+        for (int face = 0; face < num_faces; ++face) {
+            const auto row = face_to_cell_[EntityRep<1>(faces[face], true)];
+            row_sizes[face] = row.size();
+            for (const auto& cell : row) {
+                data.push_back(cell.index() == std::numeric_limits<int>::max()
+                               ? cell : EntityRep<0>(new_cell[cell.index()], cell.orientation()));
+            }
+        }
+        OrientedEntityTable<1, 0> table(data.begin(), data.end(), row_sizes.begin(), row_sizes.end());
+        face_to_cell_.swap(table);
+    }
+    if (face_to_point_.size() == num_faces) {
+        std::vector<int> data;
+        data.reserve(face_to_point_.dataSize());
+        std::vector<int> row_sizes(num_faces);
+        for (int face = 0; face < num_faces; ++face) {
+            const auto row = face_to_point_[faces[face]];
+            row_sizes[face] = row.size();
+            for (const int point : row) {
+                data.push_back(new_point[point]);
+            }
+        }
+        Opm::SparseTable<int> table(data.begin(), data.end(), row_sizes.begin(), row_sizes.end());
+        face_to_point_.swap(table);
+    }
+    permuteEntities(cell_to_point_, cells);
+    for (auto& corners : cell_to_point_) {
+        for (auto& point : corners) {
+            point = new_point[point];
+        }
+    }
+
+    // Geometry. The cells refer to their corners through cell_to_point_.
+    permuteEntities(*geometry_.geomVector(std::integral_constant<int, 3>()), points);
+    permuteEntities(*geometry_.geomVector(std::integral_constant<int, 1>()), faces);
+    auto& cell_geometries = *geometry_.geomVector(std::integral_constant<int, 0>());
+    permuteEntities(cell_geometries, cells);
+    const std::shared_ptr<const EntityVariable<Geometry<0, 3>, 3>> corners =
+        geometry_.geomVector(std::integral_constant<int, 3>());
+    for (int cell = 0; cell < num_cells; ++cell) {
+        const auto& geometry = cell_geometries.get(cell);
+        cell_geometries.get(cell) = Geometry<3, 3>(geometry.center(), geometry.volume(),
+                                                   corners, cell_to_point_[cell].data());
+    }
+    permuteEntities(face_normals_, faces);
+
+    // Data attached to the entities.
+    permuteEntities(global_cell_, cells);
+    permuteEntities(face_tag_, faces);
+    permuteEntities(unique_boundary_ids_, faces);
+    permuteEntities(mark_, cells);
+    permuteEntities(partition_type_indicator_->cell_indicator_, cells);
+    permuteEntities(partition_type_indicator_->point_indicator_, points);
+    computeInteriorCellsEnd();
+    permuteEntities(global_id_set_->getMapping<0>(), cells);
+    permuteEntities(global_id_set_->getMapping<1>(), faces);
+    permuteEntities(global_id_set_->getMapping<3>(), points);
+    for (auto& cell : aquifer_cells_) {
+        cell = new_cell[cell];
+    }
+    std::ranges::sort(aquifer_cells_);
+
+#if HAVE_MPI
+    // The remote indices refer to the entries of the index set, so changing the local
+    // indices in place keeps them valid.
+    for (auto& pair : cellIndexSet()) {
+        pair.local() = new_cell[pair.local()];
+    }
+    renumberInterfaces(std::get<InteriorBorder_All_Interface>(cell_interfaces_).interfaces(), new_cell);
+    renumberInterfaces(std::get<Overlap_OverlapFront_Interface>(cell_interfaces_).interfaces(), new_cell);
+    renumberInterfaces(std::get<Overlap_All_Interface>(cell_interfaces_).interfaces(), new_cell);
+    renumberInterfaces(std::get<All_All_Interface>(cell_interfaces_).interfaces(), new_cell);
+    std::apply([&new_point](auto&... interfaces) { (renumberInterfaces(interfaces, new_point), ...); },
+               point_interfaces_);
+    persistent_communicators_.clear();
+#endif
+
+    // Caches built so far are rebuilt, later ones are built from the renumbered view.
+    if (geometry_arrays_) {
+        geometry_arrays_ = buildGeometryArrays();
+    }
+    if (face_neighbour_table_) {
+        face_neighbour_table_ = buildFaceNeighbourTable();
+    }
+    if (interior_cell_sets_) {
+        interior_cell_sets_ = buildInteriorCellSets();
+    }
+    return renumbering;
+}
+
 std::array<Dune::FieldVector<double,3>,8> CpGridData::getReferenceRefinedCorners(int idx_in_parent_cell, const std::array<int,3>& cells_per_dim) const
 {
     // Refined cells in parent cell: k*cells_per_dim[0]*cells_per_dim[1] + j*cells_per_dim[0] + i
@@ -1789,17 +2247,48 @@ std::tuple< const std::shared_ptr<CpGridData>,
             const std::vector<std::array<int,2>>>                // child_to_parent_cells
 CpGridData::refineSingleCell(const std::array<int,3>& cells_per_dim, const int& parent_idx) const
 {
+    auto [refined_cell_ptr,
+          parent_to_refined_corners,
+          parent_to_children_faces,
+          parent_to_children_cells,
+          child_to_parent_faces,
+          child_to_parent_cell] = refineSingleCellCompact(cells_per_dim, parent_idx);
+    auto& refined_cell = *refined_cell_ptr;
     // To store the LGR/refined-grid.
     std::vector<std::shared_ptr<CpGridData>> refined_data;
     std::shared_ptr<CpGridData> refined_grid_ptr = std::make_shared<CpGridData>(refined_data); // ccobj_
     auto& refined_grid = *refined_grid_ptr;
-    DefaultGeometryPolicy& refined_geometries = refined_grid.geometry_;
-    std::vector<std::array<int,8>>& refined_cell_to_point = refined_grid.cell_to_point_;
-    cpgrid::OrientedEntityTable<0,1>& refined_cell_to_face = refined_grid.cell_to_face_;
-    Opm::SparseTable<int>& refined_face_to_point = refined_grid.face_to_point_;
-    cpgrid::OrientedEntityTable<1,0>& refined_face_to_cell = refined_grid.face_to_cell_;
-    cpgrid::EntityVariable<enum face_tag,1>& refined_face_tags = refined_grid.face_tag_;
-    cpgrid::SignedEntityVariable<Dune::FieldVector<double,3>,1>& refined_face_normals = refined_grid.face_normals_;
+    // The cell geometries point into cell_to_point_ and the corner geometries. Sharing the geometry
+    // containers and swapping the vectors keeps those pointers valid.
+    refined_grid.geometry_ = refined_cell.geometry_;
+    refined_grid.cell_to_point_.swap(refined_cell.cell_to_point_);
+    refined_grid.cell_to_face_.swap(refined_cell.cell_to_face_);
+    refined_grid.face_to_point_.swap(refined_cell.face_to_point_);
+    refined_grid.face_to_cell_.swap(refined_cell.face_to_cell_);
+    static_cast<EntityVariableBase<enum face_tag>&>(refined_grid.face_tag_).swap(refined_cell.face_tag_);
+    static_cast<EntityVariableBase<Dune::FieldVector<double,3>>&>(refined_grid.face_normals_).swap(refined_cell.face_normals_);
+    return {refined_grid_ptr, parent_to_refined_corners, parent_to_children_faces, parent_to_children_cells,
+            child_to_parent_faces, child_to_parent_cell};
+}
+
+std::tuple< const std::shared_ptr<SingleCellRefinement>,
+            const std::vector<std::array<int,2>>,                // parent_to_refined_corners(~boundary_old_to_new_corners)
+            const std::vector<std::tuple<int,std::vector<int>>>, // parent_to_children_faces (~boundary_old_to_new_faces)
+            const std::tuple<int, std::vector<int>>,             // parent_to_children_cells
+            const std::vector<std::array<int,2>>,                // child_to_parent_faces
+            const std::vector<std::array<int,2>>>                // child_to_parent_cells
+CpGridData::refineSingleCellCompact(const std::array<int,3>& cells_per_dim, const int& parent_idx) const
+{
+    // To store the refined cell.
+    auto refined_cell_ptr = std::make_shared<SingleCellRefinement>();
+    auto& refined_cell = *refined_cell_ptr;
+    DefaultGeometryPolicy& refined_geometries = refined_cell.geometry_;
+    std::vector<std::array<int,8>>& refined_cell_to_point = refined_cell.cell_to_point_;
+    cpgrid::OrientedEntityTable<0,1>& refined_cell_to_face = refined_cell.cell_to_face_;
+    Opm::SparseTable<int>& refined_face_to_point = refined_cell.face_to_point_;
+    cpgrid::OrientedEntityTable<1,0>& refined_face_to_cell = refined_cell.face_to_cell_;
+    cpgrid::EntityVariable<enum face_tag,1>& refined_face_tags = refined_cell.face_tag_;
+    cpgrid::SignedEntityVariable<Dune::FieldVector<double,3>,1>& refined_face_normals = refined_cell.face_normals_;
     // Get parent cell
     const cpgrid::Geometry<3,3>& parent_cell = (*(geometry_.geomVector(std::integral_constant<int,0>())))[EntityRep<0>(parent_idx, true)];
     // Get parent cell corners.
@@ -1904,7 +2393,7 @@ CpGridData::refineSingleCell(const std::array<int,3>& cells_per_dim, const int&
         children_cells.push_back(cell);
         child_to_parent_cell.push_back({cell, parent_idx});
     }
-    return {refined_grid_ptr, parent_to_refined_corners, parent_to_children_faces, parent_to_children_cells,
+    return {refined_cell_ptr, parent_to_refined_corners, parent_to_children_faces, parent_to_children_cells,
             child_to_parent_faces, child_to_parent_cell};
 }
 
@@ -63,16 +63,28 @@
 #include <opm/input/eclipse/EclipseState/Grid/NNC.hpp>
 #endif
 
+#include <opm/grid/common/GridEnums.hpp>
 #include <opm/grid/cpgpreprocess/preprocess.h>
+#include <opm/grid/utility/SetupProfile.hpp>
 
 #include "Entity2IndexDataHandle.hpp"
+#include "CommunicationRequest.hpp"
 #include "CpGridDataTraits.hpp"
 //#include "DataHandleWrappers.hpp"
 //#include "GlobalIdMapping.hpp"
 #include "Geometry.hpp"
+#include "FaceNeighbourTable.hpp"
+#include "GeometryArrays.hpp"
+#include "InteriorCellSets.hpp"
+#include "Renumbering.hpp"
+#include "SingleCellRefinement.hpp"
 
+#include <algorithm>
 #include <array>
 #include <initializer_list>
+#include <map>
+#include <memory>
+#include <mutex>
 #include <set>
 #include <vector>
 
@@ -483,6 +495,50 @@ public:
         return geometry_;
     }
 
+    /// @brief Cell volumes and centroids, and face areas and centroids, in contiguous arrays.
+    ///
+    /// Built from the geometries on first use and kept for the lifetime of this view.
+    /// Must therefore not be called before the geometry of the view is complete.
+    /// Thread safe.
+    const GeometryArrays& geometryArrays() const;
+
+    /// @brief Faces and neighbours of all cells, in the order of the intersections of each cell.
+    ///
+    /// Built on first use from the face-cell relations, face tags and orientations, and kept
+    /// for the lifetime of this view. Must therefore not be called before the topology of the
+    /// view is complete. Thread safe.
+    const FaceNeighbourTable& faceNeighbourTable() const;
+
+    /// @brief The interior cells split into boundary-adjacent and deep interior cells.
+    ///
+    /// Built on first use from the face neighbour table and the partition types of the cells,
+    /// and kept for the lifetime of this view. Must therefore not be called before the
+    /// partition types of the view are complete. Thread safe.
+    const InteriorCellSets& interiorCellSets() const;
+
+    /// @brief The end of the index range of the interior cells, if they come first.
+    ///
+    /// If the interior cells precede all overlap cells, as guaranteed by load balancing
+    /// with ownersFirst and by renumber() with ownersFirst, the interior cells are
+    /// [0, interiorCellsEnd()) and the overlap cells [interiorCellsEnd(), size(0)). Partition
+    /// iterators over the cells then become plain index ranges. Views without overlap have
+    /// interior cells only. Returns -1 if the interior and overlap cells are interleaved.
+    int interiorCellsEnd() const;
+
+    /// @brief Renumbers the cells, faces and points of this view to improve memory locality.
+    ///
+    /// The cells are ordered by the given method, and the faces and points in the order
+    /// in which the renumbered cells reach them. All topology and geometry, the global
+    /// cells, ids, partition types, the parallel index set and the communication interfaces
+    /// are permuted consistently. Cached arrays like geometryArrays() are rebuilt. Purely
+    /// local, no communication between processes takes place. Views with refined cells
+    /// cannot be renumbered.
+    /// @param method How the cells are ordered.
+    /// @param ownersFirst Whether the interior cells are put before all other cells,
+    ///                    each group keeping the order of the method.
+    /// @return The permutations applied.
+    Renumbering renumber(RenumberingMethod method, bool ownersFirst);
+
     int getLeafIdxFromLevelIdx(int level_cell_idx) const
     {
         if (level_to_leaf_cells_.empty()) {
@@ -520,6 +576,18 @@ public:
                 const std::vector<std::array<int,2>>>                // child_to_parent_cells
     refineSingleCell(const std::array<int,3>& cells_per_dim, const int& parent_idx) const;
 
+    /// @brief Refine a single cell without creating a CpGridData for the refinement.
+    ///
+    /// Same as refineSingleCell(), but the refined cell is stored in a SingleCellRefinement,
+    /// which only holds geometries and topology. Used by adapt() for every marked element.
+    std::tuple< const std::shared_ptr<SingleCellRefinement>,
+                const std::vector<std::array<int,2>>,                // parent_to_refined_corners(~boundary_old_to_new_corners)
+                const std::vector<std::tuple<int,std::vector<int>>>, // parent_to_children_faces (~boundary_old_to_new_faces)
+                const std::tuple<int, std::vector<int>>,             // parent_to_children_cells
+                const std::vector<std::array<int,2>>,                // child_to_parent_faces
+                const std::vector<std::array<int,2>>>                // child_to_parent_cells
+    refineSingleCellCompact(const std::array<int,3>& cells_per_dim, const int& parent_idx) const;
+
     // @breif Compute center of an entity/element/cell in the Eclipse way:
     //        - Average of the 4 corners of the bottom face.
     //        - Average of the 4 corners of the top face.
@@ -599,6 +667,33 @@ public:
                               const CpGridData& view_data,
                               const std::vector<int>& cell_part);
 
+    /// \brief Build this process' part of a distributed grid directly
+    /// from a slab of the corner-point input.
+    ///
+    /// Every process owns a contiguous range of Cartesian rows (constant
+    /// j) of the global grid and only ever sees the COORD/ZCORN/ACTNUM of
+    /// those rows plus a halo, see CpGrid::slabInputRows(). Cells in the
+    /// owned rows become interior cells, the cells in the adjacent row on
+    /// either side become overlap cells. Global ids of shared faces and
+    /// points are agreed upon with the neighbouring processes only.
+    ///
+    /// \param slab_input Corner-point input of the rows
+    ///        CpGrid::slabInputRows(owned_rows, global_ny).
+    /// \param global_ny Number of rows in the global grid.
+    /// \param owned_rows First and one past last row owned by this process.
+    /// \param turn_normals Whether or not to turn all normals.
+    /// \param pinchActive Whether or not to force specific pinch behaviour.
+    /// \param tolerance_unique_points Tolerance used to identify points
+    ///        based on their coordinate.
+    /// \param edge_conformal Whether or not to construct an edge-conformal grid.
+    void processEclipseFormatDistributed(const grdecl& slab_input,
+                                         int global_ny,
+                                         const std::array<int,2>& owned_rows,
+                                         bool turn_normals,
+                                         bool pinchActive,
+                                         double tolerance_unique_points,
+                                         bool edge_conformal);
+
     /// \brief communicate objects for all codims on a given level
     /// \param data The data handle describing the data. Has to adhere to the
     /// Dune::DataHandleIF interface.
@@ -607,8 +702,35 @@ public:
     template<class DataHandle>
     void communicate(DataHandle& data, InterfaceType iftype, CommunicationDirection dir);
 
+    /// \brief Start communicating objects for all codims on a given level.
+    ///
+    /// Sends the data like communicate(), but returns before receiving it. The
+    /// communication is completed by wait() on the returned request, or by its
+    /// destructor. Only one communication per interface type and direction can
+    /// be pending at a time, but a forward and a backward one may be pending together.
+    /// The first communication of a direction with a data type and size per entity
+    /// waits for the neighbours to set up its plan, so has to be started in the same
+    /// order relative to the other direction on all processes.
+    /// \param data The data handle describing the data. Has to adhere to the
+    /// Dune::DataHandleIF interface and to stay alive until the request is completed.
+    /// \param iftype The interface to use for the communication.
+    /// \param dir The direction of the communication along the interface (forward or backward).
+    template<class DataHandle>
+    CommunicationRequest<DataHandle> communicateBegin(DataHandle& data, InterfaceType iftype,
+                                                      CommunicationDirection dir);
+
+    /// \brief Choose how communicate() and communicateBegin() exchange data between processes.
+    ///
+    /// Applied to the communicators of the interfaces kept so far and to those created later.
+    /// Has to be called with the same method on all processes and not while a communication
+    /// is pending.
+    void setCommunicationMethod(CommunicationMethod method);
+
     void computeCellPartitionType();
 
+    /// \brief Records whether the interior cells come first, see interiorCellsEnd().
+    void computeInteriorCellsEnd();
+
     void computePointPartitionType();
 
     void computeCommunicationInterfaces(int noexistingPoints);
@@ -628,6 +750,9 @@ public:
     /// \brief The type of the map describing communication interfaces.
     using InterfaceMap = CpGridDataTraits::InterfaceMap;
 
+    /// \brief The type of the communicator reusing persistent plans.
+    using PersistentCommunicator = CpGridDataTraits::PersistentCommunicator;
+
     /// \brief type of OwnerOverlap communication for cells
     using CommunicationType = CpGridDataTraits::CommunicationType;
 
@@ -685,6 +810,13 @@ private:
     /// \brief Adds entries to the parallel index set of the cells during grid construction
     void populateGlobalCellIndexSet();
 
+    /// \brief Computes global ids, the cell index set and the communication
+    /// interfaces at the end of processEclipseFormatDistributed().
+    /// \param all_rows First and one past last owned row of each process.
+    /// \param row_owner The process owning each row.
+    void agreeOnDistributedIds(const std::vector<int>& all_rows,
+                               const std::vector<int>& row_owner);
+
 #if HAVE_MPI
 
     /// \brief Gather data on a global grid representation.
@@ -753,9 +885,39 @@ private:
     void communicateCodim(Entity2IndexDataHandle<DataHandle, codim>& data, CommunicationDirection dir,
                           const InterfaceMap& interface);
 
+    /// \brief Communicates data of a given codimension over one of the interfaces of this grid.
+    ///
+    /// Uses a communicator kept per interface, whose persistent plans are reused by subsequent
+    /// communications of data with a fixed size per entity.
+    /// \param interface One of cell_interfaces_ or point_interfaces_.
+    template<int codim, class DataHandle>
+    void communicateCodimPersistent(Entity2IndexDataHandle<DataHandle, codim>& data, CommunicationDirection dir,
+                                    const InterfaceMap& interface);
+
+    /// \brief The communicator kept for one of the interfaces of this grid, created on first use.
+    PersistentCommunicator& persistentCommunicator(const InterfaceMap& interface);
+
+    /// \brief Set up this view from the cells of another view.
+    ///
+    /// The cell index set of this view has to be populated already. Topology,
+    /// geometry and global ids of all cells in it are sent from view_data.
+    /// \param view_data The view the cells are taken from.
+    /// \param cell_inf Interface sending the cells of view_data to the ones of this view.
+    /// \param point_inf Filled with the matching interface for the points.
+    void distributeCells(const CpGridData& view_data, const InterfaceMap& cell_inf,
+                         InterfaceMap& point_inf);
+
 #endif
 
-    void computeGeometry(const CpGrid& grid,
+    std::unique_ptr<GeometryArrays> buildGeometryArrays() const;
+    std::unique_ptr<FaceNeighbourTable> buildFaceNeighbourTable() const;
+    std::unique_ptr<InteriorCellSets> buildInteriorCellSets() const;
+
+    /// \brief The new order of the cells for renumber().
+    std::vector<int> renumberedCellOrder(RenumberingMethod method, bool ownersFirst) const;
+
+    template<class Scatter>
+    void computeGeometry(const Scatter& scatter,
                          const DefaultGeometryPolicy&  globalGeometry,
                          const std::vector<int>& globalAquiferCells,
                          const OrientedEntityTable<0, 1>& globalCell2Faces,
@@ -797,6 +959,16 @@ private:
     cpgrid::EntityVariable<enum face_tag, 1> face_tag_;
     /** @brief The geometries representing the grid. */
     cpgrid::DefaultGeometryPolicy geometry_;
+    /** @brief Contiguous copies of volumes, areas and centroids, see geometryArrays(). */
+    mutable std::unique_ptr<GeometryArrays> geometry_arrays_;
+    mutable std::once_flag geometry_arrays_flag_;
+    /** @brief Cell faces and neighbours, see faceNeighbourTable(). */
+    mutable std::unique_ptr<FaceNeighbourTable> face_neighbour_table_;
+    mutable std::once_flag face_neighbour_table_flag_;
+    mutable std::unique_ptr<InteriorCellSets> interior_cell_sets_;
+    mutable std::once_flag interior_cell_sets_flag_;
+    /** @brief The number of interior cells if they precede all others, -1 otherwise. */
+    int interior_cells_end_ = -1;
     /** @brief The type of a point in the grid. */
     typedef FieldVector<double, 3> PointType;
     /** @brief The face normals of the grid. */
@@ -854,6 +1026,10 @@ private:
     /// \brief Sorted vector of aquifer cell indices.
     std::vector<int> aquifer_cells_;
 
+    /// \brief Where the setup phases are recorded. Set and owned by the CpGrid,
+    /// null if the phases are not recorded.
+    Opm::SetupProfile* setup_profile_ = nullptr;
+
 #if HAVE_MPI
 
     /// \brief OwnerOverlap communication for cells
@@ -872,8 +1048,15 @@ private:
     std::tuple<InterfaceMap,InterfaceMap,InterfaceMap,InterfaceMap,InterfaceMap>
     point_interfaces_;
 
+    /// \brief The communicators used by communicate, one per interface of cell_interfaces_
+    /// and point_interfaces_ used so far. Cleared when the interfaces are recomputed.
+    std::map<const InterfaceMap*, std::unique_ptr<PersistentCommunicator>> persistent_communicators_;
+
 #endif
 
+    /// \brief How communicate() exchanges data between processes.
+    CommunicationMethod communication_method_ = pointToPoint;
+
     // Return the geometry vector corresponding to the given codim.
     template <int codim>
     const EntityVariable<Geometry<3 - codim, 3>, codim>& geomVector() const
@@ -918,6 +1101,17 @@ T& getInterface(InterfaceType iftype,
     OPM_THROW(std::runtime_error, "Invalid Interface type was used during communication");
 }
 
+/// \brief Throw if a split-phase communication in the direction is still pending on comm.
+///
+/// Starting another one would reset the plan that the pending requests still use.
+inline void checkNoPersistentPending(const CpGridDataTraits::PersistentCommunicator& comm, bool forward)
+{
+    if (comm.persistentPending(forward)) {
+        OPM_THROW(std::logic_error, "A communication over the same interface and in the same "
+                  "direction has been started and not completed yet");
+    }
+}
+
 } // end unnamed namespace
 
 template<int codim, class DataHandle>
@@ -931,6 +1125,16 @@ template<int codim, class DataHandle>
 void CpGridData::communicateCodim(Entity2IndexDataHandle<DataHandle, codim>& data_wrapper, CommunicationDirection dir,
                                   const InterfaceMap& interface)
 {
+    if constexpr (Entity2IndexDataHandle<DataHandle, codim>::contiguous) {
+        // Sent from and received into the vectors of the handle with derived datatypes.
+        PersistentCommunicator comm(ccobj_, interface);
+        if(dir==ForwardCommunication)
+            comm.forwardPersistent(data_wrapper);
+        else
+            comm.backwardPersistent(data_wrapper);
+        return;
+    }
+
     Communicator comm(ccobj_, interface);
 
     if(dir==ForwardCommunication)
@@ -938,6 +1142,19 @@ void CpGridData::communicateCodim(Entity2IndexDataHandle<DataHandle, codim>& dat
     else
         comm.backward(data_wrapper);
 }
+
+template<int codim, class DataHandle>
+void CpGridData::communicateCodimPersistent(Entity2IndexDataHandle<DataHandle, codim>& data_wrapper,
+                                            CommunicationDirection dir, const InterfaceMap& interface)
+{
+    auto& comm = persistentCommunicator(interface);
+    checkNoPersistentPending(comm, dir == ForwardCommunication);
+
+    if(dir==ForwardCommunication)
+        comm.forwardPersistent(data_wrapper);
+    else
+        comm.backwardPersistent(data_wrapper);
+}
 #endif
 
 template<class DataHandle>
@@ -948,12 +1165,13 @@ void CpGridData::communicate(DataHandle& data, InterfaceType iftype,
     if(data.contains(3,0))
     {
         Entity2IndexDataHandle<DataHandle, 0> data_wrapper(*this, data);
-        communicateCodim<0>(data_wrapper, dir, getInterface(iftype, cell_interfaces_));
+        const Interface& interface = getInterface(iftype, cell_interfaces_);
+        communicateCodimPersistent<0>(data_wrapper, dir, interface.interfaces());
     }
     if(data.contains(3,3))
     {
         Entity2IndexDataHandle<DataHandle, 3> data_wrapper(*this, data);
-        communicateCodim<3>(data_wrapper, dir, getInterface(iftype, point_interfaces_));
+        communicateCodimPersistent<3>(data_wrapper, dir, getInterface(iftype, point_interfaces_));
     }
 #else
     // Suppress warnings for unused arguments.
@@ -962,6 +1180,43 @@ void CpGridData::communicate(DataHandle& data, InterfaceType iftype,
     (void) dir;
 #endif
 }
+
+template<class DataHandle>
+CommunicationRequest<DataHandle> CpGridData::communicateBegin(DataHandle& data, InterfaceType iftype,
+                                                              CommunicationDirection dir)
+{
+    CommunicationRequest<DataHandle> request;
+#if HAVE_MPI
+    const bool forward = dir == ForwardCommunication;
+    request.forward_ = forward;
+    auto begin = [forward](PersistentCommunicator& comm, auto& data_wrapper)
+    {
+        checkNoPersistentPending(comm, forward);
+        if (forward)
+            comm.forwardPersistentBegin(data_wrapper);
+        else
+            comm.backwardPersistentBegin(data_wrapper);
+    };
+    if(data.contains(3,0))
+    {
+        auto& comm = persistentCommunicator(getInterface(iftype, cell_interfaces_).interfaces());
+        begin(comm, request.cells_.emplace(*this, data));
+        request.cell_comm_ = &comm;
+    }
+    if(data.contains(3,3))
+    {
+        auto& comm = persistentCommunicator(getInterface(iftype, point_interfaces_));
+        begin(comm, request.points_.emplace(*this, data));
+        request.point_comm_ = &comm;
+    }
+#else
+    // Suppress warnings for unused arguments.
+    (void) data;
+    (void) iftype;
+    (void) dir;
+#endif
+    return request;
+}
 }}
 
 #if HAVE_MPI
@@ -1273,8 +1528,19 @@ void CpGridData::gatherCodimData(DataHandle& data, CpGridData* global_data,
     }
     global_data_buffer.resize(no_data_recv);
 
-    DataGatherer<DataHandle> gatherer(local_data_buffer, data);
-    visitInterior<codim>(*distributed_data, mapping.begin(), mapping.end(), gatherer);
+    if constexpr (Entity2IndexDataHandle<DataHandle, codim>::contiguous) {
+        const std::size_t block_size = data.blockSize();
+        auto* out = local_data_buffer.buffer_.data();
+        auto copy_block = [&out, in = data.sourceData(), block_size]
+            (const auto&, const auto& entity)
+        {
+            out = std::copy_n(in + entity.index() * block_size, block_size, out);
+        };
+        visitInterior<codim>(*distributed_data, mapping.begin(), mapping.end(), copy_block);
+    } else {
+        DataGatherer<DataHandle> gatherer(local_data_buffer, data);
+        visitInterior<codim>(*distributed_data, mapping.begin(), mapping.end(), gatherer);
+    }
     MPI_Allgatherv(&(local_data_buffer.buffer_[0]), no_data_send[distributed_data->ccobj_.rank()],
                    MPITraits<typename DataHandle::DataType>::getType(),
                    &(global_data_buffer.buffer_[0]), &(no_data_send[0]), &(displ[0]),
@@ -1285,12 +1551,26 @@ void CpGridData::gatherCodimData(DataHandle& data, CpGridData* global_data,
     for(int i=0; i< codim; ++i)
         offset+=global_data->size(i);
 
-    typename std::vector<int>::const_iterator s=global_sizes.begin();
-    for(typename std::vector<int>::const_iterator i=global_indices.begin(),
-            end=global_indices.end();
-        i!=end; ++s, ++i)
-    {
-        edata.scatter(global_data_buffer, *i-offset, *s);
+    if constexpr (Entity2IndexDataHandle<DataHandle, codim>::contiguous) {
+        // Only the ranks holding the global grid have cells to copy to.
+        const std::size_t block_size = data.blockSize();
+        const int num_entities = global_data->size(codim);
+        const auto* in = global_data_buffer.buffer_.data();
+        auto* out = data.targetData();
+        for (const int index : global_indices) {
+            if (index - offset < num_entities) {
+                std::copy_n(in, block_size, out + (index - offset) * block_size);
+            }
+            in += block_size;
+        }
+    } else {
+        typename std::vector<int>::const_iterator s=global_sizes.begin();
+        for(typename std::vector<int>::const_iterator i=global_indices.begin(),
+                end=global_indices.end();
+            i!=end; ++s, ++i)
+        {
+            edata.scatter(global_data_buffer, *i-offset, *s);
+        }
     }
 #endif
 }
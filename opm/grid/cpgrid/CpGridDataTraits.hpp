@@ -44,6 +44,8 @@
 #include <dune/common/parallel/variablesizecommunicator.hh>
 #include <dune/istl/owneroverlapcopy.hh>
 
+#include <opm/grid/utility/VariableSizeCommunicator.hpp>
+
 #include <list>
 #include <map>
 
@@ -73,6 +75,10 @@ struct CpGridDataTraits
     /// \brief The type of the map describing communication interfaces.
     using InterfaceMap = Communicator::InterfaceMap;
 
+    /// \brief The type of the communicator reusing persistent plans for repeated
+    /// communication over the same interface.
+    using PersistentCommunicator = Opm::VariableSizeCommunicator<>;
+
     /// \brief type of OwnerOverlap communication for cells
     using CommunicationType = Dune::OwnerOverlapCopyCommunication<int,int>;
 
@@ -0,0 +1,272 @@
+/*
+  Copyright 2025 Equinor ASA.
+
+  This file is part of the Open Porous Media project (OPM).
+
+  OPM is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  OPM is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with OPM.  If not, see <http://www.gnu.org/licenses/>.
+*/
+#ifndef OPM_CPGRID_ELEMENT_CHUNKS_HEADER
+#define OPM_CPGRID_ELEMENT_CHUNKS_HEADER
+
+#include <opm/grid/CpGrid.hpp>
+#include <opm/grid/utility/ElementChunks.hpp>
+
+#include <algorithm>
+#include <compare>
+#include <cstddef>
+#include <iterator>
+#include <stdexcept>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace Opm
+{
+
+/// ElementChunks for the leaf view of a CpGrid.
+///
+/// The cells of a CpGrid are numbered consecutively, so chunks are
+/// stored as index ranges and their iterators are created on demand.
+/// Equally sized chunks are found without visiting the cells. If the
+/// interior cells are not numbered before the overlap cells, the
+/// index ranges split the cells of the partition less evenly, and
+/// the iterators of a chunk skip the cells outside the partition.
+///
+/// Besides the constructor of the generic class, there is one that
+/// balances a cost per cell between the chunks, and firstTouch()
+/// initialises per cell data chunk by chunk in a parallel loop. With
+/// the operating system placing memory pages on the NUMA node of the
+/// thread writing them first, and chunks being handed to the threads
+/// by the same static schedule in later loops, threads then mostly
+/// work on memory local to them:
+///
+/// ElementChunks chunks(gridview, Dune::Partitions::all, num_threads);
+/// FirstTouchVector<double> pressure(gridview.size(0));
+/// chunks.firstTouch(pressure, 0.0);
+/// #pragma omp parallel for schedule(static)
+/// for (const auto& chunk : chunks) {
+///     for (const auto& elem : chunk) {
+///         pressure[elem.index()] = ...;
+///     }
+/// }
+template <class PartitionSet>
+class ElementChunks<Dune::CpGrid::LeafGridView, PartitionSet>
+{
+private:
+    using GridView = Dune::CpGrid::LeafGridView;
+    using Iter = decltype(std::begin(elements(std::declval<const GridView&>(), PartitionSet())));
+
+public:
+    /// Chunks with the same number of cells, except for the last
+    /// one, which also gets the remainder, as in the generic class.
+    ElementChunks(const GridView& gv,
+                  const PartitionSet included_partition,
+                  const std::size_t num_chunks)
+        : ElementChunks(gv, included_partition, num_chunks, Tag{})
+    {
+        const int num_elem = last_ - first_;
+        const int chunk_size = std::max(num_elem / static_cast<int>(num_chunks), 1);
+        for (std::size_t c = 1; c < num_chunks; ++c) {
+            bounds_[c] = first_ + static_cast<int>(std::min<std::size_t>(c * chunk_size, num_elem));
+        }
+    }
+
+    /// Chunks with about the same total cost of their cells.
+    /// \param[in] cost  The cost of each cell, indexed by the cell index.
+    ///                  Costs must not be negative. If they are all zero,
+    ///                  the chunks get the same number of cells.
+    template <class CostVector>
+    ElementChunks(const GridView& gv,
+                  const PartitionSet included_partition,
+                  const std::size_t num_chunks,
+                  const CostVector& cost)
+        : ElementChunks(gv, included_partition, num_chunks, Tag{})
+    {
+        if (static_cast<int>(std::size(cost)) != gv.size(0)) {
+            throw std::invalid_argument("ElementChunks needs one cost per cell, got "
+                                        + std::to_string(std::size(cost)) + " for "
+                                        + std::to_string(gv.size(0)) + " cells.");
+        }
+        const auto range = elements(gv, included_partition);
+        double total = 0.0;
+        int num_elem = 0;
+        for (const auto& elem : range) {
+            const double c = cost[elem.index()];
+            if (c < 0.0) {
+                throw std::invalid_argument("ElementChunks needs non-negative cell costs.");
+            }
+            total += c;
+            ++num_elem;
+        }
+        // A cell belongs to the chunk containing the midpoint of its
+        // cost interval, and zero costs are replaced by unit costs.
+        const bool unit_cost = !(total > 0.0);
+        if (unit_cost) {
+            total = num_elem;
+        }
+        const double num = num_chunks;
+        std::size_t c = 1;
+        double before = 0.0;
+        for (const auto& elem : range) {
+            const double cell_cost = unit_cost ? 1.0 : static_cast<double>(cost[elem.index()]);
+            const double mid = before + 0.5 * cell_cost;
+            for (; c < num_chunks && mid * num >= total * c; ++c) {
+                bounds_[c] = elem.index();
+            }
+            before += cell_cost;
+        }
+        for (; c < num_chunks; ++c) {
+            bounds_[c] = last_;
+        }
+    }
+
+    struct Chunk
+    {
+        Chunk(const Iter& i1, const Iter& i2) : pi_(i1, i2) {}
+        auto begin() const { return pi_.first; }
+        auto end() const { return pi_.second; }
+        std::pair<Iter, Iter> pi_;
+    };
+
+    /// Random access iterator over the chunks, creating the cell
+    /// iterators of a chunk when dereferenced.
+    class ChunkIterator
+    {
+    public:
+        using iterator_category = std::random_access_iterator_tag;
+        using value_type = Chunk;
+        using difference_type = std::ptrdiff_t;
+        using pointer = void;
+        using reference = Chunk;
+
+        ChunkIterator() = default;
+        ChunkIterator(const ElementChunks* chunks, difference_type chunk)
+            : chunks_(chunks), chunk_(chunk)
+        {}
+
+        Chunk operator*() const { return (*chunks_)[chunk_]; }
+        Chunk operator[](difference_type n) const { return (*chunks_)[chunk_ + n]; }
+
+        ChunkIterator& operator++() { ++chunk_; return *this; }
+        ChunkIterator& operator--() { --chunk_; return *this; }
+        ChunkIterator operator++(int) { auto old = *this; ++chunk_; return old; }
+        ChunkIterator operator--(int) { auto old = *this; --chunk_; return old; }
+        ChunkIterator& operator+=(difference_type n) { chunk_ += n; return *this; }
+        ChunkIterator& operator-=(difference_type n) { chunk_ -= n; return *this; }
+        friend ChunkIterator operator+(ChunkIterator it, difference_type n) { return it += n; }
+        friend ChunkIterator operator+(difference_type n, ChunkIterator it) { return it += n; }
+        friend ChunkIterator operator-(ChunkIterator it, difference_type n) { return it -= n; }
+        friend difference_type operator-(const ChunkIterator& a, const ChunkIterator& b)
+        {
+            return a.chunk_ - b.chunk_;
+        }
+        friend bool operator==(const ChunkIterator& a, const ChunkIterator& b)
+        {
+            return a.chunk_ == b.chunk_;
+        }
+        friend auto operator<=>(const ChunkIterator& a, const ChunkIterator& b)
+        {
+            return a.chunk_ <=> b.chunk_;
+        }
+
+    private:
+        const ElementChunks* chunks_ = nullptr;
+        difference_type chunk_ = 0;
+    };
+
+    auto begin() const
+    {
+        return ChunkIterator(this, 0);
+    }
+    auto end() const
+    {
+        return ChunkIterator(this, size());
+    }
+    auto size() const
+    {
+        return bounds_.size() - 1;
+    }
+
+    Chunk operator[](std::size_t chunk) const
+    {
+        return Chunk{Iter(*data_, bounds_[chunk], true), Iter(*data_, bounds_[chunk + 1], true)};
+    }
+
+    /// The cell indices [first, second) covered by a chunk. Unless the
+    /// cells of the partition form an index range, it also contains
+    /// cells outside the partition.
+    std::pair<int, int> indexRange(std::size_t chunk) const
+    {
+        return {bounds_[chunk], bounds_[chunk + 1]};
+    }
+
+    /// Assigns value to entries_per_cell consecutive entries per cell,
+    /// each chunk in its own iteration of an OpenMP loop with static
+    /// schedule. Entries of cells outside all chunks are assigned by
+    /// the calling thread. To let the threads touch the memory first,
+    /// data must not have been initialised already, as is the case
+    /// for a FirstTouchVector of a trivial type.
+    template <class Container, class T>
+    void firstTouch(Container& data, const T& value, const std::size_t entries_per_cell = 1) const
+    {
+        const std::size_t num_entries = std::size(data);
+        const auto entry = [&](const int cell) {
+            return std::min(cell * entries_per_cell, num_entries);
+        };
+        auto start = std::begin(data);
+        std::fill(start, start + entry(first_), value);
+        std::fill(start + entry(last_), std::end(data), value);
+        const int num_chunks = size();
+#ifdef _OPENMP
+#pragma omp parallel for schedule(static)
+#endif
+        for (int c = 0; c < num_chunks; ++c) {
+            std::fill(start + entry(bounds_[c]), start + entry(bounds_[c + 1]), value);
+        }
+    }
+
+private:
+    struct Tag {};
+
+    ElementChunks(const GridView& gv,
+                  const PartitionSet included_partition,
+                  const std::size_t num_chunks,
+                  Tag)
+        : data_(&gv.grid().currentLeafData())
+    {
+        if (num_chunks < 1) {
+            throw std::logic_error("ElementChunks must create at least one chunk.");
+        }
+        // The cell iterators of the partition start at their first cell and
+        // end at the end of the cell range of the partition, if there is one.
+        const auto range = elements(gv, included_partition);
+        first_ = std::begin(range).index();
+        last_ = std::end(range).index();
+        bounds_.assign(num_chunks + 1, first_);
+        bounds_.back() = last_;
+    }
+
+    const Dune::cpgrid::CpGridData* data_;
+    int first_ = 0;
+    int last_ = 0;
+    std::vector<int> bounds_;
+};
+
+template <class GridView, class PartitionSet, class CostVector>
+ElementChunks(const GridView&, PartitionSet, std::size_t, const CostVector&)
+    -> ElementChunks<GridView, PartitionSet>;
+
+} // namespace Opm
+
+#endif // OPM_CPGRID_ELEMENT_CHUNKS_HEADER
@@ -36,6 +36,8 @@
 
 #include <dune/common/version.hh>
 
+#include "CellBlockDataHandle.hpp"
+
 #include <cstddef>
 
 namespace Dune
@@ -57,6 +59,11 @@ class Entity2IndexDataHandle
 public:
     typedef typename DataHandle::DataType DataType;
 
+    /// \brief Whether the data of index i is stored at sourceData()+i*blockSize()
+    /// and targetData()+i*blockSize(), which allows communicating it without
+    /// calling gather and scatter per index.
+    static constexpr bool contiguous = IsCellBlockDataHandle<DataHandle>::value && codim == 0;
+
     Entity2IndexDataHandle(const CpGridData& grid, DataHandle& data)
         : fromGrid_(grid), toGrid_(grid), data_(data)
     {}
@@ -86,6 +93,21 @@ public:
         data_.scatter(buffer, Entity<codim>(toGrid_, i, true), s);
     }
 
+    const DataType* sourceData() const
+    {
+        return data_.sourceData();
+    }
+
+    DataType* targetData()
+    {
+        return data_.targetData();
+    }
+
+    std::size_t blockSize() const
+    {
+        return data_.blockSize();
+    }
+
 private:
     const CpGridData& fromGrid_;
     const CpGridData& toGrid_;
@@ -0,0 +1,70 @@
+/*
+  Copyright 2025 Equinor ASA.
+
+  This file is part of the Open Porous Media project (OPM).
+
+  OPM is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  OPM is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with OPM.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#ifndef OPM_FACENEIGHBOURTABLE_HEADER
+#define OPM_FACENEIGHBOURTABLE_HEADER
+
+#include <opm/grid/cpgpreprocess/preprocess.h>
+#include <opm/grid/utility/SparseTable.hpp>
+
+namespace Dune
+{
+namespace cpgrid
+{
+
+/// @brief One face of a cell together with the cell on its other side.
+///
+/// The entries of a cell come in the order of its intersections, such
+/// that entry i describes the i-th intersection of the cell.
+struct FaceNeighbour
+{
+    /// Values of neighbour for faces without a neighbour on this process.
+    enum { Boundary = -1, ProcessBoundary = -2 };
+
+    /// Index of the face.
+    int face;
+    /// Index of the cell on the other side of the face, Boundary on the
+    /// domain boundary and ProcessBoundary if that cell is not known to
+    /// this process.
+    int neighbour;
+    /// Tag of the face.
+    enum face_tag tag;
+    /// Whether the face normal points out of the cell.
+    bool normal_is_outward;
+
+    bool hasNeighbour() const
+    {
+        return neighbour >= 0;
+    }
+
+    /// Sign turning the face normal into the outer normal of the cell.
+    double normalSign() const
+    {
+        return normal_is_outward ? 1.0 : -1.0;
+    }
+};
+
+/// @brief All faces and neighbours of the cells of a grid view; row c holds
+///        the entries of cell c.
+using FaceNeighbourTable = Opm::SparseTable<FaceNeighbour>;
+
+} // namespace cpgrid
+} // namespace Dune
+
+#endif // OPM_FACENEIGHBOURTABLE_HEADER
@@ -0,0 +1,51 @@
+/*
+  Copyright 2025 Equinor ASA.
+
+  This file is part of the Open Porous Media project (OPM).
+
+  OPM is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  OPM is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with OPM.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#ifndef OPM_GEOMETRYARRAYS_HEADER
+#define OPM_GEOMETRYARRAYS_HEADER
+
+#include <dune/common/fvector.hh>
+
+#include <vector>
+
+namespace Dune
+{
+namespace cpgrid
+{
+
+/// @brief Cell volumes and centroids, and face areas and centroids, each
+///        stored in its own contiguous array indexed by entity index.
+///
+/// The Geometry objects of a grid view keep these values next to corner
+/// references and are therefore several times larger than the values
+/// themselves. Loops that need only volumes, areas or centroids, e.g.
+/// the assembly of fluxes, read these arrays instead. Face normals are
+/// already stored contiguously in CpGridData::face_normals_.
+struct GeometryArrays
+{
+    std::vector<double> cell_volumes;
+    std::vector<FieldVector<double,3>> cell_centroids;
+    std::vector<double> face_areas;
+    std::vector<FieldVector<double,3>> face_centroids;
+};
+
+} // namespace cpgrid
+} // namespace Dune
+
+#endif // OPM_GEOMETRYARRAYS_HEADER
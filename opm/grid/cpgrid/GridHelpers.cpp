@@ -205,6 +205,11 @@ double faceArea(const Dune::CpGrid& grid, int face_index)
     return grid.faceArea(face_index);
 }
 
+const double* faceAreas(const Dune::CpGrid& grid)
+{
+    return grid.faceAreas().data();
+}
+
 int faceTag(const Dune::CpGrid& grid,
             const Dune::cpgrid::Cell2FacesRow::iterator& cell_face)
 {
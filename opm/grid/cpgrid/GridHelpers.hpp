@@ -565,6 +565,10 @@ const double* faceNormal(const Dune::CpGrid& grid, int face_index);
 
 double faceArea(const Dune::CpGrid& grid, int face_index);
 
+/// \brief Get the areas of all faces of the grid, indexed by face.
+/// \note The face normals of Dune::CpGrid have unit length.
+const double* faceAreas(const Dune::CpGrid& grid);
+
 /// \brief Get Eclipse Cartesian tag of a face
 /// \param grid The grid that the face is part of.
 /// \param cell_face The face attached to a cell. Usually obtained from face2Cells.
@@ -0,0 +1,56 @@
+/*
+  Copyright 2025 Equinor ASA.
+
+  This file is part of the Open Porous Media project (OPM).
+
+  OPM is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  OPM is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with OPM.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#ifndef OPM_INDEXPAIRMAP_HEADER_INCLUDED
+#define OPM_INDEXPAIRMAP_HEADER_INCLUDED
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <unordered_map>
+
+namespace Dune
+{
+namespace cpgrid
+{
+
+/// @brief Hash for a pair of indices, e.g. {marked element index, entity index in its refinement}.
+struct IndexPairHash
+{
+    std::size_t operator()(const std::array<int,2>& pair) const noexcept
+    {
+        const auto key = (static_cast<std::uint64_t>(static_cast<std::uint32_t>(pair[0])) << 32)
+            | static_cast<std::uint32_t>(pair[1]);
+        return std::hash<std::uint64_t>{}(key);
+    }
+};
+
+/// @brief Map keyed by a pair of indices.
+///
+/// Used for the relations between single-cell refinements, refined level grids,
+/// and the leaf grid view built in adapt(). Lookups are constant time on average.
+/// Iteration order is unspecified.
+template<class T>
+using IndexPairMap = std::unordered_map<std::array<int,2>, T, IndexPairHash>;
+
+} // namespace cpgrid
+} // namespace Dune
+
+#endif // OPM_INDEXPAIRMAP_HEADER_INCLUDED
@@ -85,11 +85,16 @@ GlobalIdSet::IdType GlobalIdSet::subId(const cpgrid::Entity<0>& e, int i, int cc
 
 void GlobalIdSet::insertIdSet(const CpGridData& view)
 {
-    idSets_.insert(std::make_pair(&view,view.global_id_set_));
+    if (std::find(views_.begin(), views_.end(), &view) == views_.end())
+        views_.push_back(&view);
 }
-GlobalIdSet::GlobalIdSet(const CpGridData& view)
+
+void GlobalIdSet::removeIdSet(const CpGridData& view)
 {
-    idSets_.insert(std::make_pair(&view,view.global_id_set_));
+    views_.erase(std::remove(views_.begin(), views_.end(), &view), views_.end());
 }
+GlobalIdSet::GlobalIdSet(const CpGridData& view)
+    : views_{&view}
+{}
 } // end namespace cpgrid
 } // end namespace Dune
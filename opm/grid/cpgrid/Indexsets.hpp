@@ -42,9 +42,11 @@ along with OPM.  If not, see <http://www.gnu.org/licenses/>.
 #include "GlobalIdMapping.hpp"
 #include "Intersection.hpp"
 
+#include <algorithm>
 #include <cstdint>
 #include <unordered_map>
 #include <utility>
+#include <vector>
 
 namespace Dune
 {
@@ -468,6 +470,31 @@ namespace Dune
                 return std::max(getMaxCodimGlobalId<0>(), getMaxCodimGlobalId<3>());
             }
 
+            /// \brief Get the global ids of all entities of a codimension in one go.
+            ///
+            /// The result is ordered by entity index, i.e. ids()[i] equals id() of the
+            /// entity with index i. For distributed views this is a plain copy of the
+            /// mapping and avoids the per-entity lookup.
+            /// \tparam codim The codimension (0 or 3).
+            template<int codim>
+            std::vector<IdType> ids() const
+            {
+                static_assert(codim == 0 || codim == 3,
+                              "LevelGlobalIdSet::ids only implemented for codims 0 and 3.");
+                if(idSet_)
+                {
+                    std::vector<IdType> entity_ids(view_->size(codim));
+                    for (int index = 0; index < static_cast<int>(entity_ids.size()); ++index) {
+                        entity_ids[index] = idSet_->id(cpgrid::Entity<codim>(*view_, index, true));
+                    }
+                    return entity_ids;
+                }
+                else {
+                    const auto& mapping = this->template getMapping<codim>();
+                    return std::vector<IdType>(mapping.begin(), mapping.end());
+                }
+            }
+
         private:
             std::shared_ptr<const IdSet> idSet_;
             const CpGridData* view_;
@@ -513,17 +540,32 @@ namespace Dune
 
         IdType subId(const typename Codim<0>::Entity& e, int i, int cc) const;
 
+        /// \brief Get the global ids of all entities of a codimension of a view.
+        ///
+        /// \see LevelGlobalIdSet::ids
+        /// \param view A level grid or the leaf grid view registered with insertIdSet.
+        template<int codim>
+        std::vector<IdType> ids(const CpGridData& view) const
+        {
+            return levelIdSet(&view).template ids<codim>();
+        }
+
         void insertIdSet(const CpGridData& view);
+
+        /// \brief Unregisters a view that is about to be destroyed.
+        void removeIdSet(const CpGridData& view);
     private:
         /// \brief Get the correct id set of a level (global or distributed)
+        ///
+        /// Each view owns its level id set, hence this is a direct pointer
+        /// access instead of a search in the registered views.
         const LevelGlobalIdSet& levelIdSet(const CpGridData* const data) const
         {
-            auto candidate = idSets_.find(data);
-            assert(candidate != idSets_.end());
-            return *candidate->second;
+            assert(std::find(views_.begin(), views_.end(), data) != views_.end());
+            return *data->global_id_set_;
         }
-        /// \brief map of views onto idesets if the view.
-        std::map<const CpGridData* const, std::shared_ptr<const LevelGlobalIdSet>> idSets_;
+        /// \brief The views that were registered with this id set.
+        std::vector<const CpGridData*> views_;
     };
 
     class ReversePointGlobalIdSet
@@ -0,0 +1,50 @@
+/*
+  Copyright 2025 Equinor ASA.
+
+  This file is part of the Open Porous Media project (OPM).
+
+  OPM is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  OPM is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with OPM.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#ifndef OPM_INTERIORCELLSETS_HEADER
+#define OPM_INTERIORCELLSETS_HEADER
+
+#include <vector>
+
+namespace Dune
+{
+namespace cpgrid
+{
+
+/// @brief The interior cells of a grid view split by whether they need
+///        data of non-interior cells.
+///
+/// A boundary-adjacent cell shares a face with an overlap cell or with a
+/// cell on another process. All other interior cells are deep interior
+/// cells, whose face neighbours are interior cells or the domain boundary.
+/// Together with CpGridData::communicateBegin() this allows to work on the
+/// deep interior cells while the data of the overlap cells is in flight,
+/// and on the boundary-adjacent cells after it has arrived. Both lists are
+/// sorted by cell index. Without overlap, e.g. on a single process, all
+/// interior cells are deep interior cells.
+struct InteriorCellSets
+{
+    std::vector<int> boundary_adjacent;
+    std::vector<int> deep_interior;
+};
+
+} // namespace cpgrid
+} // namespace Dune
+
+#endif // OPM_INTERIORCELLSETS_HEADER
@@ -76,7 +76,7 @@ namespace Dune
             Iterator& operator++()
             {
                 EntityRep<cd>::increment();
-                if(rule_.fullSet || rule_.emptySet)
+                if(!filter_)
                     return *this;
                 while(this->index()<noEntities_ && rule_.isInvalid(*this))
                     EntityRep<cd>::increment();
@@ -106,7 +106,12 @@ namespace Dune
 
         private:
             /// \brief The number of Entities with codim cd.   (no = number)
-            int noEntities_;
+            ///
+            /// For cells of a partition that forms a contiguous range, see
+            /// CpGridData::interiorCellsEnd(), the end of that range.
+            int noEntities_{};
+            /// \brief Whether entities outside of the partition have to be skipped.
+            bool filter_{};
             PartitionIteratorRule<pitype> rule_;
         };
 
@@ -269,11 +274,28 @@ Iterator<cd, pitype>::Iterator(const CpGridData& grid, int index, bool orientati
                  // If the partition is empty, goto to end iterator!
                  EntityRep<cd>(PartitionIteratorRule<pitype>::emptySet?grid.size(cd):index,
                                orientation)),
-      noEntities_(grid.size(cd))
+      noEntities_(grid.size(cd)),
+      filter_(!PartitionIteratorRule<pitype>::fullSet && !PartitionIteratorRule<pitype>::emptySet)
 {
-    if(rule_.fullSet || rule_.emptySet)
+    if(!filter_)
         return;
 
+    if constexpr (cd == 0) {
+        // If the interior cells come first, the cells of every partition form an index
+        // range, and iterating over them needs no partition types. There are only
+        // interior and overlap cells.
+        const int interiorEnd = grid.interiorCellsEnd();
+        if (interiorEnd >= 0) {
+            filter_ = false;
+            if (pitype == Interior_Partition || pitype == InteriorBorder_Partition) {
+                noEntities_ = interiorEnd;
+                if (this->index() > noEntities_)
+                    EntityRep<cd>::setValue(noEntities_, orientation);
+            }
+            return;
+        }
+    }
+
     while(this->index()<noEntities_ && rule_.isInvalid(*this))
         EntityRep<cd>::increment();
 }
@@ -28,7 +28,6 @@
 
 #include <algorithm>    // for std::max
 #include <array>
-#include <map>
 #include <memory>
 #include <stdexcept>
 #include <string>
@@ -43,7 +42,7 @@ namespace Opm
 namespace Lgr
 {
 
-void insertBidirectional(std::map<std::array<int,2>,int>& a_to_b,
+void insertBidirectional(Dune::cpgrid::IndexPairMap<int>& a_to_b,
                          std::unordered_map<int,std::array<int,2>>& b_to_a,
                          const std::array<int,2>& keyA,
                          int& counter)
@@ -53,8 +52,8 @@ void insertBidirectional(std::map<std::array<int,2>,int>& a_to_b,
     ++counter;
 }
 
-void insertBidirectional(std::map<std::array<int,2>,std::array<int,2>>& a_to_b,
-                         std::map<std::array<int,2>,std::array<int,2>>& b_to_a,
+void insertBidirectional(Dune::cpgrid::IndexPairMap<std::array<int,2>>& a_to_b,
+                         Dune::cpgrid::IndexPairMap<std::array<int,2>>& b_to_a,
                          const std::array<int,2>& keyA,
                          const std::array<int,2>& keyB,
                          int& counter)
@@ -64,8 +63,8 @@ void insertBidirectional(std::map<std::array<int,2>,std::array<int,2>>& a_to_b,
     ++counter;
 }
 
-void insertBidirectional(std::map<std::array<int,2>,std::array<int,2>>& a_to_b,
-                         std::map<std::array<int,2>,std::array<int,2>>& b_to_a,
+void insertBidirectional(Dune::cpgrid::IndexPairMap<std::array<int,2>>& a_to_b,
+                         Dune::cpgrid::IndexPairMap<std::array<int,2>>& b_to_a,
                          const std::array<int,2>& keyA,
                          int keyBfirst,
                          int& counter)
@@ -76,19 +75,19 @@ void insertBidirectional(std::map<std::array<int,2>,std::array<int,2>>& a_to_b,
 }
 
 void refineAndProvideMarkedRefinedRelations(const Dune::CpGrid& grid, /* Marked elements parameters */
-                                            std::vector<std::shared_ptr<Dune::cpgrid::CpGridData>>& markedElem_to_itsLgr,
+                                            std::vector<std::shared_ptr<Dune::cpgrid::SingleCellRefinement>>& markedElem_to_itsLgr,
                                             int& markedElem_count,
                                             std::vector<std::vector<std::array<int,2>>>& cornerInMarkedElemWithEquivRefinedCorner,
-                                            std::map<std::array<int,2>,int>& markedElemAndEquivRefinedCorn_to_corner,
+                                            Dune::cpgrid::IndexPairMap<int>& markedElemAndEquivRefinedCorn_to_corner,
                                             std::vector<std::vector<std::pair<int, std::vector<int>>>>& faceInMarkedElemAndRefinedFaces,
                                             /* Refined cells parameters */
-                                            std::map<std::array<int,2>,std::array<int,2>>& elemLgrAndElemLgrCell_to_refinedLevelAndRefinedCell,
-                                            std::map<std::array<int,2>,std::array<int,2>>& refinedLevelAndRefinedCell_to_elemLgrAndElemLgrCell,
+                                            Dune::cpgrid::IndexPairMap<std::array<int,2>>& elemLgrAndElemLgrCell_to_refinedLevelAndRefinedCell,
+                                            Dune::cpgrid::IndexPairMap<std::array<int,2>>& refinedLevelAndRefinedCell_to_elemLgrAndElemLgrCell,
                                             std::vector<int>& refined_cell_count_vec,
                                             const std::vector<int>& assignRefinedLevel,
                                             std::vector<std::vector<std::tuple<int,std::vector<int>>>>& preAdapt_parent_to_children_cells_vec,
                                             /* Adapted cells parameters */
-                                            std::map<std::array<int,2>,int>& elemLgrAndElemLgrCell_to_adaptedCell,
+                                            Dune::cpgrid::IndexPairMap<int>& elemLgrAndElemLgrCell_to_adaptedCell,
                                             std::unordered_map<int,std::array<int,2>>& adaptedCell_to_elemLgrAndElemLgrCell,
                                             int& cell_count,
                                             std::vector<std::vector<int>>& preAdapt_level_to_leaf_cells_vec,
@@ -129,7 +128,7 @@ void refineAndProvideMarkedRefinedRelations(const Dune::CpGrid& grid, /* Marked
                          parentCell_to_itsRefinedCells,
                          refinedFace_to_itsParentFace,
                          refinedCell_to_itsParentCell]
-                = grid.currentLeafData().refineSingleCell(cells_per_dim_vec[shiftedLevel], element.index());
+                = grid.currentLeafData().refineSingleCellCompact(cells_per_dim_vec[shiftedLevel], element.index());
             markedElem_to_itsLgr[ element.index() ] = elemLgr_ptr;
 
             const int childrenCount = cells_per_dim_vec[shiftedLevel][0]*cells_per_dim_vec[shiftedLevel][1]*cells_per_dim_vec[shiftedLevel][2];
@@ -165,7 +164,7 @@ void refineAndProvideMarkedRefinedRelations(const Dune::CpGrid& grid, /* Marked
 std::tuple<std::vector<std::vector<std::array<int,2>>>, std::vector<std::vector<int>>, std::vector<std::array<int,2>>, std::vector<int>>
 defineChildToParentAndIdxInParentCell(const Dune::cpgrid::CpGridData& current_data,
                                       int preAdaptMaxLevel,
-                                      const std::map<std::array<int,2>,std::array<int,2>>& refinedLevelAndRefinedCell_to_elemLgrAndElemLgrCell,
+                                      const Dune::cpgrid::IndexPairMap<std::array<int,2>>& refinedLevelAndRefinedCell_to_elemLgrAndElemLgrCell,
                                       const std::vector<int>& refined_cell_count_vec,
                                       const std::unordered_map<int,std::array<int,2>>& adaptedCell_to_elemLgrAndElemLgrCell,
                                       const int& cell_count)
@@ -233,10 +232,10 @@ defineChildToParentAndIdxInParentCell(const Dune::cpgrid::CpGridData& current_da
 std::pair<std::vector<std::vector<int>>, std::vector<std::array<int,2>>>
 defineLevelToLeafAndLeafToLevelCells(const Dune::cpgrid::CpGridData& current_data,
                                      int preAdaptMaxLevel,
-                                     const std::map<std::array<int,2>,std::array<int,2>>& elemLgrAndElemLgrCell_to_refinedLevelAndRefinedCell,
-                                     const std::map<std::array<int,2>,std::array<int,2>>& refinedLevelAndRefinedCell_to_elemLgrAndElemLgrCell,
+                                     const Dune::cpgrid::IndexPairMap<std::array<int,2>>& elemLgrAndElemLgrCell_to_refinedLevelAndRefinedCell,
+                                     const Dune::cpgrid::IndexPairMap<std::array<int,2>>& refinedLevelAndRefinedCell_to_elemLgrAndElemLgrCell,
                                      const std::vector<int>& refined_cell_count_vec,
-                                     const std::map<std::array<int,2>,int>& elemLgrAndElemLgrCell_to_adaptedCell,
+                                     const Dune::cpgrid::IndexPairMap<int>& elemLgrAndElemLgrCell_to_adaptedCell,
                                      const std::unordered_map<int,std::array<int,2>>& adaptedCell_to_elemLgrAndElemLgrCell,
                                      const int& cell_count)
 {
@@ -272,11 +271,11 @@ defineLevelToLeafAndLeafToLevelCells(const Dune::cpgrid::CpGridData& current_dat
 
 void identifyRefinedCornersPerLevel(const Dune::cpgrid::CpGridData& current_data,
                                     int preAdaptMaxLevel,
-                                    std::map<std::array<int,2>,std::array<int,2>>& elemLgrAndElemLgrCorner_to_refinedLevelAndRefinedCorner,
-                                    std::map<std::array<int,2>,std::array<int,2>>& refinedLevelAndRefinedCorner_to_elemLgrAndElemLgrCorner,
+                                    Dune::cpgrid::IndexPairMap<std::array<int,2>>& elemLgrAndElemLgrCorner_to_refinedLevelAndRefinedCorner,
+                                    Dune::cpgrid::IndexPairMap<std::array<int,2>>& refinedLevelAndRefinedCorner_to_elemLgrAndElemLgrCorner,
                                     std::vector<int>& refined_corner_count_vec,
-                                    std::map<std::array<int,2>, std::array<int,2>>& vanishedRefinedCorner_to_itsLastAppearance,
-                                    const std::vector<std::shared_ptr<Dune::cpgrid::CpGridData>>& markedElem_to_itsLgr,
+                                    Dune::cpgrid::IndexPairMap<std::array<int,2>>& vanishedRefinedCorner_to_itsLastAppearance,
+                                    const std::vector<std::shared_ptr<Dune::cpgrid::SingleCellRefinement>>& markedElem_to_itsLgr,
                                     const std::vector<int>& assignRefinedLevel,
                                     const std::vector<std::vector<std::array<int,2>>>& cornerInMarkedElemWithEquivRefinedCorner,
                                     const std::vector<std::vector<std::pair<int, std::vector<int>>>>& faceInMarkedElemAndRefinedFaces,
@@ -727,15 +726,15 @@ int replaceLgr1CornerIdxByLgr2CornerIdx(const Dune::cpgrid::CpGridData& current_
 
 void markVanishedCorner(const std::array<int,2>& vanished,
                         const std::array<int,2>& lastAppearance,
-                        std::map<std::array<int,2>, std::array<int,2>>& vanishedRefinedCorner_to_itsLastAppearance)
+                        Dune::cpgrid::IndexPairMap<std::array<int,2>>& vanishedRefinedCorner_to_itsLastAppearance)
 {
     vanishedRefinedCorner_to_itsLastAppearance[vanished] = lastAppearance;
 }
 
 void processInteriorCorners(int elemIdx, int shiftedLevel,
-                            const std::shared_ptr<Dune::cpgrid::CpGridData>& lgr,
+                            const std::shared_ptr<Dune::cpgrid::SingleCellRefinement>& lgr,
                             int& corner_count,
-                            std::map<std::array<int,2>,int>& elemLgrAndElemLgrCorner_to_adaptedCorner,
+                            Dune::cpgrid::IndexPairMap<int>& elemLgrAndElemLgrCorner_to_adaptedCorner,
                             std::unordered_map<int,std::array<int,2>>& adaptedCorner_to_elemLgrAndElemLgrCorner,
                             const std::vector<std::array<int,3>>& cells_per_dim_vec)
 {
@@ -753,11 +752,11 @@ void processInteriorCorners(int elemIdx, int shiftedLevel,
 }
 
 void processEdgeCorners(int elemIdx, int shiftedLevel,
-                        const std::shared_ptr<Dune::cpgrid::CpGridData>& lgr,
+                        const std::shared_ptr<Dune::cpgrid::SingleCellRefinement>& lgr,
                         int& corner_count,
-                        std::map<std::array<int,2>,int>& elemLgrAndElemLgrCorner_to_adaptedCorner,
+                        Dune::cpgrid::IndexPairMap<int>& elemLgrAndElemLgrCorner_to_adaptedCorner,
                         std::unordered_map<int,std::array<int,2>>& adaptedCorner_to_elemLgrAndElemLgrCorner,
-                        std::map<std::array<int,2>, std::array<int,2>>& vanishedRefinedCorner_to_itsLastAppearance,
+                        Dune::cpgrid::IndexPairMap<std::array<int,2>>& vanishedRefinedCorner_to_itsLastAppearance,
                         const Dune::cpgrid::CpGridData& current_data,
                         int preAdaptMaxLevel,
                         const std::vector<int>& assignRefinedLevel,
@@ -805,11 +804,11 @@ void processEdgeCorners(int elemIdx, int shiftedLevel,
 }
 
 void processBoundaryCorners(int elemIdx, int shiftedLevel,
-                            const std::shared_ptr<Dune::cpgrid::CpGridData>& lgr,
+                            const std::shared_ptr<Dune::cpgrid::SingleCellRefinement>& lgr,
                             int& corner_count,
-                            std::map<std::array<int,2>,int>& elemLgrAndElemLgrCorner_to_adaptedCorner,
+                            Dune::cpgrid::IndexPairMap<int>& elemLgrAndElemLgrCorner_to_adaptedCorner,
                             std::unordered_map<int,std::array<int,2>>& adaptedCorner_to_elemLgrAndElemLgrCorner,
-                            std::map<std::array<int,2>, std::array<int,2>>& vanishedRefinedCorner_to_itsLastAppearance,
+                            Dune::cpgrid::IndexPairMap<std::array<int,2>>& vanishedRefinedCorner_to_itsLastAppearance,
                             const Dune::cpgrid::CpGridData& current_data,
                             int preAdaptMaxLevel,
                             const std::vector<int>& assignRefinedLevel,
@@ -851,13 +850,13 @@ void processBoundaryCorners(int elemIdx, int shiftedLevel,
 
 void identifyLeafGridCorners(const Dune::cpgrid::CpGridData& current_data,
                              int preAdaptMaxLevel,
-                             std::map<std::array<int,2>,int>& elemLgrAndElemLgrCorner_to_adaptedCorner,
+                             Dune::cpgrid::IndexPairMap<int>& elemLgrAndElemLgrCorner_to_adaptedCorner,
                              std::unordered_map<int,std::array<int,2>>& adaptedCorner_to_elemLgrAndElemLgrCorner,
                              int& corner_count,
-                             const std::vector<std::shared_ptr<Dune::cpgrid::CpGridData>>& markedElem_to_itsLgr,
+                             const std::vector<std::shared_ptr<Dune::cpgrid::SingleCellRefinement>>& markedElem_to_itsLgr,
                              const std::vector<int>& assignRefinedLevel,
                              const std::vector<std::vector<std::array<int,2>>>& cornerInMarkedElemWithEquivRefinedCorner,
-                             std::map<std::array<int,2>, std::array<int,2>>& vanishedRefinedCorner_to_itsLastAppearance,
+                             Dune::cpgrid::IndexPairMap<std::array<int,2>>& vanishedRefinedCorner_to_itsLastAppearance,
                              const std::vector<std::vector<std::pair<int, std::vector<int>>>>& faceInMarkedElemAndRefinedFaces,
                              const std::vector<std::array<int,3>>& cells_per_dim_vec)
 {
@@ -911,10 +910,10 @@ void identifyLeafGridCorners(const Dune::cpgrid::CpGridData& current_data,
 
 void identifyRefinedFacesPerLevel(const Dune::cpgrid::CpGridData& current_data,
                                   int preAdaptMaxLevel,
-                                  std::map<std::array<int,2>,std::array<int,2>>& elemLgrAndElemLgrFace_to_refinedLevelAndRefinedFace,
-                                  std::map<std::array<int,2>,std::array<int,2>>& refinedLevelAndRefinedFace_to_elemLgrAndElemLgrFace,
+                                  Dune::cpgrid::IndexPairMap<std::array<int,2>>& elemLgrAndElemLgrFace_to_refinedLevelAndRefinedFace,
+                                  Dune::cpgrid::IndexPairMap<std::array<int,2>>& refinedLevelAndRefinedFace_to_elemLgrAndElemLgrFace,
                                   std::vector<int>& refined_face_count_vec,
-                                  const std::vector<std::shared_ptr<Dune::cpgrid::CpGridData>>& markedElem_to_itsLgr,
+                                  const std::vector<std::shared_ptr<Dune::cpgrid::SingleCellRefinement>>& markedElem_to_itsLgr,
                                   const std::vector<int>& assignRefinedLevel,
                                   const std::vector<std::vector<std::pair<int, std::vector<int>>>>& faceInMarkedElemAndRefinedFaces,
                                   const std::vector<std::array<int,3>>& cells_per_dim_vec)
@@ -1001,10 +1000,10 @@ void identifyRefinedFacesPerLevel(const Dune::cpgrid::CpGridData& current_data,
 
 void identifyLeafGridFaces(const Dune::cpgrid::CpGridData& current_data,
                            int preAdaptMaxLevel,
-                           std::map<std::array<int,2>,int>& elemLgrAndElemLgrFace_to_adaptedFace,
+                           Dune::cpgrid::IndexPairMap<int>& elemLgrAndElemLgrFace_to_adaptedFace,
                            std::unordered_map<int,std::array<int,2>>& adaptedFace_to_elemLgrAndElemLgrFace,
                            int& face_count,
-                           const std::vector<std::shared_ptr<Dune::cpgrid::CpGridData>>& markedElem_to_itsLgr,
+                           const std::vector<std::shared_ptr<Dune::cpgrid::SingleCellRefinement>>& markedElem_to_itsLgr,
                            const std::vector<int>& assignRefinedLevel,
                            const std::vector<std::vector<std::pair<int, std::vector<int>>>>& faceInMarkedElemAndRefinedFaces,
                            const std::vector<std::array<int,3>>& cells_per_dim_vec)
@@ -1064,9 +1063,10 @@ void identifyLeafGridFaces(const Dune::cpgrid::CpGridData& current_data,
     }
 }
 
+template<class RefinedCell>
 std::array<int,3> getRefinedFaceIJK(const std::array<int,3>& cells_per_dim,
                                     int faceIdxInLgr,
-                                    const std::shared_ptr<Dune::cpgrid::CpGridData>& elemLgr_ptr)
+                                    const std::shared_ptr<RefinedCell>& elemLgr_ptr)
 {
     // Order defined in Geometry::refine
     // K_FACES  (k*cells_per_dim[0]*cells_per_dim[1]) + (j*cells_per_dim[0]) + i
@@ -1122,7 +1122,10 @@ std::array<int,3> getRefinedFaceIJK(const std::array<int,3>& cells_per_dim,
     return ijk;
 }
 
-bool isRefinedFaceInInteriorLgr(const std::array<int,3>& cells_per_dim, int faceIdxInLgr, const std::shared_ptr<Dune::cpgrid::CpGridData>& elemLgr_ptr)
+template std::array<int,3> getRefinedFaceIJK(const std::array<int,3>&, int, const std::shared_ptr<Dune::cpgrid::SingleCellRefinement>&);
+template std::array<int,3> getRefinedFaceIJK(const std::array<int,3>&, int, const std::shared_ptr<Dune::cpgrid::CpGridData>&);
+
+bool isRefinedFaceInInteriorLgr(const std::array<int,3>& cells_per_dim, int faceIdxInLgr, const std::shared_ptr<Dune::cpgrid::SingleCellRefinement>& elemLgr_ptr)
 {
 
     int refined_k_faces = cells_per_dim[0]*cells_per_dim[1]*(cells_per_dim[2]+1);
@@ -1138,7 +1141,7 @@ bool isRefinedFaceInInteriorLgr(const std::array<int,3>& cells_per_dim, int face
 
 
 bool isRefinedFaceOnLgrBoundary(const std::array<int,3>& cells_per_dim, int faceIdxInLgr,
-                                const std::shared_ptr<Dune::cpgrid::CpGridData>& elemLgr_ptr)
+                                const std::shared_ptr<Dune::cpgrid::SingleCellRefinement>& elemLgr_ptr)
 {
     const auto& ijk = getRefinedFaceIJK(cells_per_dim, faceIdxInLgr, elemLgr_ptr);
 
@@ -1159,7 +1162,7 @@ bool isRefinedFaceOnLgrBoundary(const std::array<int,3>& cells_per_dim, int face
 int getParentFaceWhereNewRefinedFaceLiesOn(const Dune::cpgrid::CpGridData& current_data,
                                            const std::array<int,3>& cells_per_dim,
                                            int faceIdxInLgr,
-                                           const std::shared_ptr<Dune::cpgrid::CpGridData>& elemLgr_ptr,
+                                           const std::shared_ptr<Dune::cpgrid::SingleCellRefinement>& elemLgr_ptr,
                                            int elemLgr)
 {
     assert(isRefinedFaceOnLgrBoundary(cells_per_dim, faceIdxInLgr, elemLgr_ptr));
@@ -1218,9 +1221,9 @@ int getParentFaceWhereNewRefinedFaceLiesOn(const Dune::cpgrid::CpGridData& curre
 
 void populateRefinedCorners(std::vector<Dune::cpgrid::EntityVariableBase<Dune::cpgrid::Geometry<0,3>>>& refined_corners_vec,
                             const std::vector<int>& refined_corner_count_vec,
-                            const std::vector<std::shared_ptr<Dune::cpgrid::CpGridData>>& markedElem_to_itsLgr,
+                            const std::vector<std::shared_ptr<Dune::cpgrid::SingleCellRefinement>>& markedElem_to_itsLgr,
                             const int& preAdaptMaxLevel,
-                            const std::map<std::array<int,2>,std::array<int,2>>& refinedLevelAndRefinedCorner_to_elemLgrAndElemLgrCorner)
+                            const Dune::cpgrid::IndexPairMap<std::array<int,2>>& refinedLevelAndRefinedCorner_to_elemLgrAndElemLgrCorner)
 {
     for (std::size_t shiftedLevel = 0; shiftedLevel < refined_corner_count_vec.size(); ++shiftedLevel) {
         refined_corners_vec[shiftedLevel].resize(refined_corner_count_vec[shiftedLevel]);
@@ -1237,13 +1240,13 @@ void populateRefinedFaces(std::vector<Dune::cpgrid::EntityVariableBase<Dune::cpg
                           std::vector<Dune::cpgrid::EntityVariableBase<Dune::FieldVector<double,3>>>& mutable_refined_face_normals_vec,
                           std::vector<Opm::SparseTable<int>>& refined_face_to_point_vec,
                           const std::vector<int>& refined_face_count_vec,
-                          const std::map<std::array<int,2>,std::array<int,2>>& refinedLevelAndRefinedFace_to_elemLgrAndElemLgrFace,
-                          const std::map<std::array<int,2>,std::array<int,2>>& elemLgrAndElemLgrCorner_to_refinedLevelAndRefinedCorner,
-                          const std::map<std::array<int,2>, std::array<int,2>>& vanishedRefinedCorner_to_itsLastAppearance,
-                          const std::vector<std::shared_ptr<Dune::cpgrid::CpGridData>>& markedElem_to_itsLgr,
+                          const Dune::cpgrid::IndexPairMap<std::array<int,2>>& refinedLevelAndRefinedFace_to_elemLgrAndElemLgrFace,
+                          const Dune::cpgrid::IndexPairMap<std::array<int,2>>& elemLgrAndElemLgrCorner_to_refinedLevelAndRefinedCorner,
+                          const Dune::cpgrid::IndexPairMap<std::array<int,2>>& vanishedRefinedCorner_to_itsLastAppearance,
+                          const std::vector<std::shared_ptr<Dune::cpgrid::SingleCellRefinement>>& markedElem_to_itsLgr,
                           const int& preAdaptMaxLevel,
                           const std::vector<std::vector<std::array<int,2>>>& cornerInMarkedElemWithEquivRefinedCorner,
-                          const std::map<std::array<int,2>,int>& markedElemAndEquivRefinedCorn_to_corner)
+                          const Dune::cpgrid::IndexPairMap<int>& markedElemAndEquivRefinedCorn_to_corner)
 {
     for (std::size_t shiftedLevel = 0; shiftedLevel < refined_face_count_vec.size(); ++shiftedLevel) {
 
@@ -1325,16 +1328,16 @@ void populateRefinedCells(const Dune::cpgrid::CpGridData& current_data,
                           const std::vector<int>& refined_cell_count_vec,
                           std::vector<Dune::cpgrid::OrientedEntityTable<0,1>>& refined_cell_to_face_vec,
                           std::vector<Dune::cpgrid::OrientedEntityTable<1,0>>& refined_face_to_cell_vec,
-                          const std::map<std::array<int,2>,std::array<int,2>>& refinedLevelAndRefinedCell_to_elemLgrAndElemLgrCell,
-                          const std::map<std::array<int,2>,std::array<int,2>>& elemLgrAndElemLgrFace_to_refinedLevelAndRefinedFace,
+                          const Dune::cpgrid::IndexPairMap<std::array<int,2>>& refinedLevelAndRefinedCell_to_elemLgrAndElemLgrCell,
+                          const Dune::cpgrid::IndexPairMap<std::array<int,2>>& elemLgrAndElemLgrFace_to_refinedLevelAndRefinedFace,
                           const std::vector<std::vector<std::pair<int, std::vector<int>>>>& faceInMarkedElemAndRefinedFaces,
                           const std::vector<Dune::cpgrid::DefaultGeometryPolicy>& refined_geometries_vec,
-                          const std::map<std::array<int,2>,std::array<int,2>>& elemLgrAndElemLgrCorner_to_refinedLevelAndRefinedCorner,
-                          const std::map<std::array<int,2>, std::array<int,2>>& vanishedRefinedCorner_to_itsLastAppearance,
-                          const std::vector<std::shared_ptr<Dune::cpgrid::CpGridData>>& markedElem_to_itsLgr,
+                          const Dune::cpgrid::IndexPairMap<std::array<int,2>>& elemLgrAndElemLgrCorner_to_refinedLevelAndRefinedCorner,
+                          const Dune::cpgrid::IndexPairMap<std::array<int,2>>& vanishedRefinedCorner_to_itsLastAppearance,
+                          const std::vector<std::shared_ptr<Dune::cpgrid::SingleCellRefinement>>& markedElem_to_itsLgr,
                           const std::vector<int>& assignRefinedLevel,
                           const int& preAdaptMaxLevel,
-                          const std::map<std::array<int,2>,int>& markedElemAndEquivRefinedCorn_to_corner,
+                          const Dune::cpgrid::IndexPairMap<int>& markedElemAndEquivRefinedCorn_to_corner,
                           const std::vector<std::vector<std::array<int,2>>>& cornerInMarkedElemWithEquivRefinedCorner,
                           const std::vector<std::array<int,3>>&  cells_per_dim_vec)
 {
@@ -1440,9 +1443,10 @@ void populateRefinedCells(const Dune::cpgrid::CpGridData& current_data,
     } // end-shiftedLevel-for-loop
 }
 
+template<class RefinedCell>
 int replaceLgr1FaceIdxByLgr2FaceIdx(const std::array<int,3>& cells_per_dim_lgr1,
                                     int faceIdxInLgr1,
-                                    const std::shared_ptr<Dune::cpgrid::CpGridData>& elemLgr1_ptr,
+                                    const std::shared_ptr<RefinedCell>& elemLgr1_ptr,
                                     const std::array<int,3>& cells_per_dim_lgr2)
 {
     const auto& ijkLgr1 = getRefinedFaceIJK(cells_per_dim_lgr1, faceIdxInLgr1, elemLgr1_ptr);
@@ -1495,10 +1499,17 @@ int replaceLgr1FaceIdxByLgr2FaceIdx(const std::array<int,3>& cells_per_dim_lgr1,
     OPM_THROW(std::logic_error,  "Cannot convert face index from one LGR to its neighboring LGR.");
 }
 
+template int replaceLgr1FaceIdxByLgr2FaceIdx(const std::array<int,3>&, int,
+                                             const std::shared_ptr<Dune::cpgrid::SingleCellRefinement>&,
+                                             const std::array<int,3>&);
+template int replaceLgr1FaceIdxByLgr2FaceIdx(const std::array<int,3>&, int,
+                                             const std::shared_ptr<Dune::cpgrid::CpGridData>&,
+                                             const std::array<int,3>&);
+
 void populateLeafGridCorners(const Dune::cpgrid::CpGridData& current_data,
                              Dune::cpgrid::EntityVariableBase<Dune::cpgrid::Geometry<0,3>>& adapted_corners,
                              const int& corner_count,
-                             const std::vector<std::shared_ptr<Dune::cpgrid::CpGridData>>& markedElem_to_itsLgr,
+                             const std::vector<std::shared_ptr<Dune::cpgrid::SingleCellRefinement>>& markedElem_to_itsLgr,
                              const std::unordered_map<int,std::array<int,2>>& adaptedCorner_to_elemLgrAndElemLgrCorner)
 {
     adapted_corners.resize(corner_count);
@@ -1506,9 +1517,9 @@ void populateLeafGridCorners(const Dune::cpgrid::CpGridData& current_data,
         const auto& [elemLgr, elemLgrCorner] = adaptedCorner_to_elemLgrAndElemLgrCorner.at(corner);
         // Note: Since we are associating each LGR with its parent cell index, and this index can take
         //       the value 0, we represent the current leaf data with the value -1
-        adapted_corners[corner] = ((elemLgr == -1) ?
-                                   current_data :
-                                   *markedElem_to_itsLgr[elemLgr]).getGeometry().geomVector(std::integral_constant<int,3>())-> get(elemLgrCorner);
+        adapted_corners[corner] = (elemLgr == -1) ?
+            current_data.getGeometry().geomVector(std::integral_constant<int,3>())-> get(elemLgrCorner) :
+            markedElem_to_itsLgr[elemLgr]->getGeometry().geomVector(std::integral_constant<int,3>())-> get(elemLgrCorner);
     }
 }
 
@@ -1519,11 +1530,11 @@ void populateLeafGridFaces(const Dune::cpgrid::CpGridData& current_data,
                            Opm::SparseTable<int>& adapted_face_to_point,
                            const int& face_count,
                            const std::unordered_map<int,std::array<int,2>>& adaptedFace_to_elemLgrAndElemLgrFace,
-                           const std::map<std::array<int,2>,int>& elemLgrAndElemLgrCorner_to_adaptedCorner,
-                           const std::map<std::array<int,2>, std::array<int,2>>& vanishedRefinedCorner_to_itsLastAppearance,
-                           const std::vector<std::shared_ptr<Dune::cpgrid::CpGridData>>& markedElem_to_itsLgr,
+                           const Dune::cpgrid::IndexPairMap<int>& elemLgrAndElemLgrCorner_to_adaptedCorner,
+                           const Dune::cpgrid::IndexPairMap<std::array<int,2>>& vanishedRefinedCorner_to_itsLastAppearance,
+                           const std::vector<std::shared_ptr<Dune::cpgrid::SingleCellRefinement>>& markedElem_to_itsLgr,
                            [[maybe_unused]] const std::vector<int>& assignRefinedLevel,
-                           const std::map<std::array<int,2>,int>& markedElemAndEquivRefinedCorn_to_corner,
+                           const Dune::cpgrid::IndexPairMap<int>& markedElemAndEquivRefinedCorn_to_corner,
                            const std::vector<std::vector<std::array<int,2>>>& cornerInMarkedElemWithEquivRefinedCorner,
                            [[maybe_unused]] const std::vector<std::array<int,3>>& cells_per_dim_vec,
                            [[maybe_unused]] const int& preAdaptMaxLevel)
@@ -1543,16 +1554,16 @@ void populateLeafGridFaces(const Dune::cpgrid::CpGridData& current_data,
         // Note: Since we are associating each LGR with its parent cell index, and this index can take
         //       the value 0, with the value -1 we refer to current leaf grid data (grid where the elements have been marked).
         const auto& elemLgrFaceEntity =  Dune::cpgrid::EntityRep<1>(elemLgrFace, true);
-        const auto& grid_or_elemLgr_data = (elemLgr == -1) ? current_data : *markedElem_to_itsLgr[elemLgr];
+        const auto& grid_or_elemLgr_geometry = (elemLgr == -1) ? current_data.getGeometry() : markedElem_to_itsLgr[elemLgr]->getGeometry();
 
         // Get the face geometry.
-        adapted_faces[face] = (*(grid_or_elemLgr_data.getGeometry().geomVector(std::integral_constant<int,1>())))[elemLgrFaceEntity];
+        adapted_faces[face] = (*(grid_or_elemLgr_geometry.geomVector(std::integral_constant<int,1>())))[elemLgrFaceEntity];
         // Get the face tag.
-        mutable_face_tags[face] = grid_or_elemLgr_data.faceTag(elemLgrFace);
+        mutable_face_tags[face] = (elemLgr == -1) ? current_data.faceTag(elemLgrFace) : markedElem_to_itsLgr[elemLgr]->faceTag(elemLgrFace);
         // Get the face normal.
-        mutable_face_normals[face] = grid_or_elemLgr_data.faceNormals(elemLgrFace);
+        mutable_face_normals[face] = (elemLgr == -1) ? current_data.faceNormals(elemLgrFace) : markedElem_to_itsLgr[elemLgr]->faceNormals(elemLgrFace);
         // Get face_to_point_ before adapting - we need to replace the level corners by the adapted ones.
-        const auto& preAdapt_face_to_point = grid_or_elemLgr_data.faceToPoint(elemLgrFace);
+        const auto& preAdapt_face_to_point = (elemLgr == -1) ? current_data.faceToPoint(elemLgrFace) : markedElem_to_itsLgr[elemLgr]->faceToPoint(elemLgrFace);
         // Add the amount of points to the count num_points.
         num_points += preAdapt_face_to_point.size();
 
@@ -1612,14 +1623,14 @@ void populateLeafGridCells(const Dune::cpgrid::CpGridData& current_data,
                            Dune::cpgrid::OrientedEntityTable<0,1>& adapted_cell_to_face,
                            Dune::cpgrid::OrientedEntityTable<1,0>& adapted_face_to_cell,
                            const std::unordered_map<int,std::array<int,2>>& adaptedCell_to_elemLgrAndElemLgrCell,
-                           const std::map<std::array<int,2>,int>& elemLgrAndElemLgrFace_to_adaptedFace,
+                           const Dune::cpgrid::IndexPairMap<int>& elemLgrAndElemLgrFace_to_adaptedFace,
                            const std::vector<std::vector<std::pair<int, std::vector<int>>>>& faceInMarkedElemAndRefinedFaces,
                            const Dune::cpgrid::DefaultGeometryPolicy& adapted_geometries,
-                           const std::map<std::array<int,2>,int>& elemLgrAndElemLgrCorner_to_adaptedCorner,
-                           const std::map<std::array<int,2>, std::array<int,2>>& vanishedRefinedCorner_to_itsLastAppearance,
-                           const std::vector<std::shared_ptr<Dune::cpgrid::CpGridData>>& markedElem_to_itsLgr,
+                           const Dune::cpgrid::IndexPairMap<int>& elemLgrAndElemLgrCorner_to_adaptedCorner,
+                           const Dune::cpgrid::IndexPairMap<std::array<int,2>>& vanishedRefinedCorner_to_itsLastAppearance,
+                           const std::vector<std::shared_ptr<Dune::cpgrid::SingleCellRefinement>>& markedElem_to_itsLgr,
                            const std::vector<int>& assignRefinedLevel,
-                           const std::map<std::array<int,2>,int>& markedElemAndEquivRefinedCorn_to_corner,
+                           const Dune::cpgrid::IndexPairMap<int>& markedElemAndEquivRefinedCorn_to_corner,
                            const std::vector<std::vector<std::array<int,2>>>& cornerInMarkedElemWithEquivRefinedCorner,
                            const std::vector<std::array<int,3>>& cells_per_dim_vec,
                            const int& preAdaptMaxLevel)
@@ -1637,14 +1648,14 @@ void populateLeafGridCells(const Dune::cpgrid::CpGridData& current_data,
         std::vector<Dune::cpgrid::EntityRep<1>> aux_cell_to_face;
 
         const auto& allCorners = adapted_geometries.geomVector(std::integral_constant<int,3>());
-        const auto& grid_or_elemLgr_data = (elemLgr == -1) ? current_data : *markedElem_to_itsLgr.at(elemLgr);
+        const auto& grid_or_elemLgr_geometry = (elemLgr == -1) ? current_data.getGeometry() : markedElem_to_itsLgr.at(elemLgr)->getGeometry();
 
         // Get the cell geometry.
-        const auto& cellGeom = (*(grid_or_elemLgr_data.getGeometry().geomVector(std::integral_constant<int,0>()) ) )[elemLgrCellEntity];
+        const auto& cellGeom = (*(grid_or_elemLgr_geometry.geomVector(std::integral_constant<int,0>()) ) )[elemLgrCellEntity];
         // Get pre-adapt corners of the cell that will be replaced with leaf view ones.
-        const auto& preAdapt_cell_to_point  =  grid_or_elemLgr_data.cellToPoint(elemLgrCell);
+        const auto& preAdapt_cell_to_point  =  (elemLgr == -1) ? current_data.cellToPoint(elemLgrCell) : markedElem_to_itsLgr.at(elemLgr)->cellToPoint(elemLgrCell);
         // Get pre-adapt faces of the cell that will be replaced with leaf view ones.
-        const auto& preAdapt_cell_to_face =  grid_or_elemLgr_data.cellToFace(elemLgrCell);
+        const auto& preAdapt_cell_to_face =  (elemLgr == -1) ? current_data.cellToFace(elemLgrCell) : markedElem_to_itsLgr.at(elemLgr)->cellToFace(elemLgrCell);
 
         // Cell to point.
         for (int corn = 0; corn < 8; ++corn) {
@@ -24,9 +24,10 @@
 #include <dune/common/version.hh>
 
 #include <opm/grid/CpGrid.hpp>
+#include <opm/grid/cpgrid/IndexPairMap.hpp>
+#include <opm/grid/cpgrid/SingleCellRefinement.hpp>
 
 #include <array>
-#include <map>
 #include <memory>
 #include <string>
 #include <tuple>
@@ -86,19 +87,19 @@ namespace Lgr
 /// --- Additional ---
 /// @param [in]  cells_per_dim_vec       Refinement factors per dimension for each refined level grid.
 void refineAndProvideMarkedRefinedRelations(const Dune::CpGrid& grid,/* Marked elements parameters */
-                                            std::vector<std::shared_ptr<Dune::cpgrid::CpGridData>>& markedElem_to_itsLgr,
+                                            std::vector<std::shared_ptr<Dune::cpgrid::SingleCellRefinement>>& markedElem_to_itsLgr,
                                             int& markedElem_count,
                                             std::vector<std::vector<std::array<int,2>>>& cornerInMarkedElemWithEquivRefinedCorner,
-                                            std::map<std::array<int,2>,int>& markedElemAndEquivRefinedCorn_to_corner,
+                                            Dune::cpgrid::IndexPairMap<int>& markedElemAndEquivRefinedCorn_to_corner,
                                             std::vector<std::vector<std::pair<int, std::vector<int>>>>& faceInMarkedElemAndRefinedFaces,
                                             /* Refined cells parameters */
-                                            std::map<std::array<int,2>,std::array<int,2>>& elemLgrAndElemLgrCell_to_refinedLevelAdRefinedCell,
-                                            std::map<std::array<int,2>,std::array<int,2>>& refinedLevelAndRefinedCell_to_elemLgrAndElemLgrCell,
+                                            Dune::cpgrid::IndexPairMap<std::array<int,2>>& elemLgrAndElemLgrCell_to_refinedLevelAdRefinedCell,
+                                            Dune::cpgrid::IndexPairMap<std::array<int,2>>& refinedLevelAndRefinedCell_to_elemLgrAndElemLgrCell,
                                             std::vector<int>& refined_cell_count_vec,
                                             const std::vector<int>& assignRefinedLevel,
                                             std::vector<std::vector<std::tuple<int,std::vector<int>>>>& preAdapt_parent_to_children_cells_vec,
                                             /* Adapted cells parameters */
-                                            std::map<std::array<int,2>,int>& elemLgrAndElemLgrCell_to_adaptedCell,
+                                            Dune::cpgrid::IndexPairMap<int>& elemLgrAndElemLgrCell_to_adaptedCell,
                                             std::unordered_map<int,std::array<int,2>>& adaptedCell_to_elemLgrAndElemLgrCell,
                                             int& cell_count,
                                             std::vector<std::vector<int>>& preAdapt_level_to_leaf_cells_vec,
@@ -129,7 +130,7 @@ std::tuple< std::vector<std::vector<std::array<int,2>>>,
             std::vector<int>>
 defineChildToParentAndIdxInParentCell(const Dune::cpgrid::CpGridData& current_data,
                                       int preAdaptMaxLevel,
-                                      const std::map<std::array<int,2>,std::array<int,2>>& refinedLevelAndRefinedCell_to_elemLgrAndElemLgrCell,
+                                      const Dune::cpgrid::IndexPairMap<std::array<int,2>>& refinedLevelAndRefinedCell_to_elemLgrAndElemLgrCell,
                                       const std::vector<int>& refined_cell_count_vec,
                                       const std::unordered_map<int,std::array<int,2>>& adaptedCell_to_elemLgrAndElemLgrCell,
                                       const int& cell_count);
@@ -157,10 +158,10 @@ defineChildToParentAndIdxInParentCell(const Dune::cpgrid::CpGridData& current_da
 std::pair<std::vector<std::vector<int>>, std::vector<std::array<int,2>>>
 defineLevelToLeafAndLeafToLevelCells(const Dune::cpgrid::CpGridData& current_data,
                                      int preAdaptMaxLevel,
-                                     const std::map<std::array<int,2>,std::array<int,2>>& elemLgrAndElemLgrCell_to_refinedLevelAndRefinedCell,
-                                     const std::map<std::array<int,2>,std::array<int,2>>& refinedLevelAndRefinedCell_to_elemLgrAndElemLgrCell,
+                                     const Dune::cpgrid::IndexPairMap<std::array<int,2>>& elemLgrAndElemLgrCell_to_refinedLevelAndRefinedCell,
+                                     const Dune::cpgrid::IndexPairMap<std::array<int,2>>& refinedLevelAndRefinedCell_to_elemLgrAndElemLgrCell,
                                      const std::vector<int>& refined_cell_count_vec,
-                                     const std::map<std::array<int,2>,int>& elemLgrAndElemLgrCell_to_adaptedCell,
+                                     const Dune::cpgrid::IndexPairMap<int>& elemLgrAndElemLgrCell_to_adaptedCell,
                                      const std::unordered_map<int,std::array<int,2>>& adaptedCell_to_elemLgrAndElemLgrCell,
                                      const int& cell_count);
 
@@ -185,11 +186,11 @@ defineLevelToLeafAndLeafToLevelCells(const Dune::cpgrid::CpGridData& current_dat
 /// @param [in] cells_per_dim_vec
 void identifyRefinedCornersPerLevel(const Dune::cpgrid::CpGridData& current_data,
                                     int preAdaptMaxLevel,
-                                    std::map<std::array<int,2>,std::array<int,2>>& elemLgrAndElemLgrCorner_to_refinedLevelAndRefinedCorner,
-                                    std::map<std::array<int,2>,std::array<int,2>>& refinedLevelAndRefinedCorner_to_elemLgrAndElemLgrCorner,
+                                    Dune::cpgrid::IndexPairMap<std::array<int,2>>& elemLgrAndElemLgrCorner_to_refinedLevelAndRefinedCorner,
+                                    Dune::cpgrid::IndexPairMap<std::array<int,2>>& refinedLevelAndRefinedCorner_to_elemLgrAndElemLgrCorner,
                                     std::vector<int>& refined_corner_count_vec,
-                                    std::map<std::array<int,2>, std::array<int,2>>& vanishedRefinedCorner_to_itsLastAppearance,
-                                    const std::vector<std::shared_ptr<Dune::cpgrid::CpGridData>>& markedElem_to_itsLgr,
+                                    Dune::cpgrid::IndexPairMap<std::array<int,2>>& vanishedRefinedCorner_to_itsLastAppearance,
+                                    const std::vector<std::shared_ptr<Dune::cpgrid::SingleCellRefinement>>& markedElem_to_itsLgr,
                                     const std::vector<int>& assignRefinedLevel,
                                     const std::vector<std::vector<std::array<int,2>>>& cornerInMarkedElemWithEquivRefinedCorner,
                                     const std::vector<std::vector<std::pair<int, std::vector<int>>>>& faceInMarkedElemAndRefinedFaces,
@@ -302,33 +303,33 @@ int replaceLgr1CornerIdxByLgr2CornerIdx(const Dune::cpgrid::CpGridData& current_
 /// @param [in] cells_per_dim_vec
 void identifyLeafGridCorners(const Dune::cpgrid::CpGridData& current_data,
                              int preAdaptMaxLevel,
-                             std::map<std::array<int,2>,int>& elemLgrAndElemLgrCorner_to_adaptedCorner,
+                             Dune::cpgrid::IndexPairMap<int>& elemLgrAndElemLgrCorner_to_adaptedCorner,
                              std::unordered_map<int,std::array<int,2>>& adaptedCorner_to_elemLgrAndElemLgrCorner,
                              int& corner_count,
-                             const std::vector<std::shared_ptr<Dune::cpgrid::CpGridData>>& markedElem_to_itsLgr,
+                             const std::vector<std::shared_ptr<Dune::cpgrid::SingleCellRefinement>>& markedElem_to_itsLgr,
                              const std::vector<int>& assignRefinedLevel,
                              const std::vector<std::vector<std::array<int,2>>>& cornerInMarkedElemWithEquivRefinedCorner,
-                             std::map<std::array<int,2>, std::array<int,2>>& vanishedRefinedCorner_to_itsLastAppearance,
+                             Dune::cpgrid::IndexPairMap<std::array<int,2>>& vanishedRefinedCorner_to_itsLastAppearance,
                              const std::vector<std::vector<std::pair<int, std::vector<int>>>>& faceInMarkedElemAndRefinedFaces,
                              const std::vector<std::array<int,3>>& cells_per_dim_vec);
 
 void markVanishedCorner(const std::array<int,2>& vanished,
                                const std::array<int,2>& lastAppearance,
-                        std::map<std::array<int,2>, std::array<int,2>>& vanishedRefinedCorner_to_itsLastAppearance);
+                        Dune::cpgrid::IndexPairMap<std::array<int,2>>& vanishedRefinedCorner_to_itsLastAppearance);
 
 void processInteriorCorners(int elemIdx, int shiftedLevel,
-                            const std::shared_ptr<Dune::cpgrid::CpGridData>& lgr,
+                            const std::shared_ptr<Dune::cpgrid::SingleCellRefinement>& lgr,
                             int& corner_count,
-                            std::map<std::array<int,2>,int>& elemLgrAndElemLgrCorner_to_adaptedCorner,
+                            Dune::cpgrid::IndexPairMap<int>& elemLgrAndElemLgrCorner_to_adaptedCorner,
                             std::unordered_map<int,std::array<int,2>>& adaptedCorner_to_elemLgrAndElemLgrCorner,
                             const std::vector<std::array<int,3>>& cells_per_dim_vec);
 
 void processEdgeCorners(int elemIdx, int shiftedLevel,
-                        const std::shared_ptr<Dune::cpgrid::CpGridData>& lgr,
+                        const std::shared_ptr<Dune::cpgrid::SingleCellRefinement>& lgr,
                         int& corner_count,
-                        std::map<std::array<int,2>,int>& elemLgrAndElemLgrCorner_to_adaptedCorner,
+                        Dune::cpgrid::IndexPairMap<int>& elemLgrAndElemLgrCorner_to_adaptedCorner,
                         std::unordered_map<int,std::array<int,2>>& adaptedCorner_to_elemLgrAndElemLgrCorner,
-                        std::map<std::array<int,2>, std::array<int,2>>& vanishedRefinedCorner_to_itsLastAppearance,
+                        Dune::cpgrid::IndexPairMap<std::array<int,2>>& vanishedRefinedCorner_to_itsLastAppearance,
                         const Dune::cpgrid::CpGridData& current_data,
                         int preAdaptMaxLevel,
                         const std::vector<int>& assignRefinedLevel,
@@ -336,11 +337,11 @@ void processEdgeCorners(int elemIdx, int shiftedLevel,
                         const std::vector<std::array<int,3>>& cells_per_dim_vec);
 
 void processBoundaryCorners(int elemIdx, int shiftedLevel,
-                            const std::shared_ptr<Dune::cpgrid::CpGridData>& lgr,
+                            const std::shared_ptr<Dune::cpgrid::SingleCellRefinement>& lgr,
                             int& corner_count,
-                            std::map<std::array<int,2>,int>& elemLgrAndElemLgrCorner_to_adaptedCorner,
+                            Dune::cpgrid::IndexPairMap<int>& elemLgrAndElemLgrCorner_to_adaptedCorner,
                             std::unordered_map<int,std::array<int,2>>& adaptedCorner_to_elemLgrAndElemLgrCorner,
-                            std::map<std::array<int,2>, std::array<int,2>>& vanishedRefinedCorner_to_itsLastAppearance,
+                            Dune::cpgrid::IndexPairMap<std::array<int,2>>& vanishedRefinedCorner_to_itsLastAppearance,
                             const Dune::cpgrid::CpGridData& current_data,
                             int preAdaptMaxLevel,
                             const std::vector<int>& assignRefinedLevel,
@@ -349,22 +350,22 @@ void processBoundaryCorners(int elemIdx, int shiftedLevel,
 
 // To insert bidirectional mapping and increment counter
 // keyB is equal to counter, before it gets increased by one.
-void insertBidirectional(std::map<std::array<int,2>,int>& a_to_b,
+void insertBidirectional(Dune::cpgrid::IndexPairMap<int>& a_to_b,
                          std::unordered_map<int,std::array<int,2>>& b_to_a,
                          const std::array<int,2>& keyA,
                          int& counter);
 
 // To insert bidirectional mapping and increment counter
-void insertBidirectional(std::map<std::array<int,2>,std::array<int,2>>& a_to_b,
-                         std::map<std::array<int,2>,std::array<int,2>>& b_to_a,
+void insertBidirectional(Dune::cpgrid::IndexPairMap<std::array<int,2>>& a_to_b,
+                         Dune::cpgrid::IndexPairMap<std::array<int,2>>& b_to_a,
                          const std::array<int,2>& keyA,
                          const std::array<int,2>& keyB,
                          int& counter);
 
 // To insert bidirectional mapping and increment counter
 // keyB = {keyBfirst, counter before it gets increased by one}.
-void insertBidirectional(std::map<std::array<int,2>,std::array<int,2>>& a_to_b,
-                         std::map<std::array<int,2>,std::array<int,2>>& b_to_a,
+void insertBidirectional(Dune::cpgrid::IndexPairMap<std::array<int,2>>& a_to_b,
+                         Dune::cpgrid::IndexPairMap<std::array<int,2>>& b_to_a,
                          const std::array<int,2>& keyA,
                          int keyBfirst,
                          int& counter);
@@ -385,10 +386,10 @@ void insertBidirectional(std::map<std::array<int,2>,std::array<int,2>>& a_to_b,
 /// @param [in] cells_per_dim_vec
 void identifyRefinedFacesPerLevel(const Dune::cpgrid::CpGridData& current_data,
                                   int preAdaptMaxLevel,
-                                  std::map<std::array<int,2>,std::array<int,2>>& elemLgrAndElemLgrFace_to_refinedLevelAndRefinedFace,
-                                  std::map<std::array<int,2>,std::array<int,2>>& refinedLevelAndRefinedFace_to_elemLgrAndElemLgrFace,
+                                  Dune::cpgrid::IndexPairMap<std::array<int,2>>& elemLgrAndElemLgrFace_to_refinedLevelAndRefinedFace,
+                                  Dune::cpgrid::IndexPairMap<std::array<int,2>>& refinedLevelAndRefinedFace_to_elemLgrAndElemLgrFace,
                                   std::vector<int>& refined_face_count_vec,
-                                  const std::vector<std::shared_ptr<Dune::cpgrid::CpGridData>>& markedElem_to_itsLgr,
+                                  const std::vector<std::shared_ptr<Dune::cpgrid::SingleCellRefinement>>& markedElem_to_itsLgr,
                                   const std::vector<int>& assignRefinedLevel,
                                   const std::vector<std::vector<std::pair<int, std::vector<int>>>>& faceInMarkedElemAndRefinedFaces,
                                   const std::vector<std::array<int,3>>& cells_per_dim_vec);
@@ -409,10 +410,10 @@ void identifyRefinedFacesPerLevel(const Dune::cpgrid::CpGridData& current_data,
 /// @param [in] cells_per_dim_vec
 void identifyLeafGridFaces(const Dune::cpgrid::CpGridData& current_data,
                            int preAdaptMaxLevel,
-                           std::map<std::array<int,2>,int>& elemLgrAndElemLgrFace_to_adaptedFace,
+                           Dune::cpgrid::IndexPairMap<int>& elemLgrAndElemLgrFace_to_adaptedFace,
                            std::unordered_map<int,std::array<int,2>>& adaptedFace_to_elemLgrAndElemLgrFace,
                            int& face_count,
-                           const std::vector<std::shared_ptr<Dune::cpgrid::CpGridData>>& markedElem_to_itsLgr,
+                           const std::vector<std::shared_ptr<Dune::cpgrid::SingleCellRefinement>>& markedElem_to_itsLgr,
                            const std::vector<int>& assignRefinedLevel,
                            const std::vector<std::vector<std::pair<int, std::vector<int>>>>& faceInMarkedElemAndRefinedFaces,
                            const std::vector<std::array<int,3>>& cells_per_dim_vec);
@@ -429,10 +430,11 @@ void identifyLeafGridFaces(const Dune::cpgrid::CpGridData& current_data,
 ///
 /// @param [in] cells_per_dim  Number of child cells in {x,y,z} directions.
 /// @param [in] faceIdxInLgr   Face index in the single-cell refinement.
-/// @param [in] elemLgr_ptr    Pointer to the single-cell refinement grid.
+/// @param [in] elemLgr_ptr    Pointer to the single-cell refinement (SingleCellRefinement or CpGridData).
 /// @return {i,j,k} index of the face
+template<class RefinedCell>
 std::array<int,3> getRefinedFaceIJK(const std::array<int,3>& cells_per_dim, int faceIdxInLgr,
-                                    const std::shared_ptr<Dune::cpgrid::CpGridData>& elemLgr_ptr);
+                                    const std::shared_ptr<RefinedCell>& elemLgr_ptr);
 
 /// @brief Check if a refined face lies in the interior of a single-cell refinement.
 ///
@@ -441,7 +443,7 @@ std::array<int,3> getRefinedFaceIJK(const std::array<int,3>& cells_per_dim, int
 /// @param [in] elemLgr_ptr    Pointer to the single-cell refinement grid.
 /// @return true if the face is interior, false otherwise.
 bool isRefinedFaceInInteriorLgr(const std::array<int,3>& cells_per_dim, int faceIdxInLgr,
-                                const std::shared_ptr<Dune::cpgrid::CpGridData>& elemLgr_ptr);
+                                const std::shared_ptr<Dune::cpgrid::SingleCellRefinement>& elemLgr_ptr);
 
 /// @brief Check if a refined face lies on the boundary of a single-cell refinement.
 ///
@@ -450,7 +452,7 @@ bool isRefinedFaceInInteriorLgr(const std::array<int,3>& cells_per_dim, int face
 /// @param [in] elemLgr_ptr    Pointer to the single-cell refinement grid.
 /// @return true if the face is on the boundary, false otherwise.
 bool isRefinedFaceOnLgrBoundary(const std::array<int,3>& cells_per_dim, int faceIdxInLgr,
-                                const std::shared_ptr<Dune::cpgrid::CpGridData>& elemLgr_ptr);
+                                const std::shared_ptr<Dune::cpgrid::SingleCellRefinement>& elemLgr_ptr);
 
 /// @brief Get the parent face containing a new refined face.
 ///
@@ -462,15 +464,15 @@ bool isRefinedFaceOnLgrBoundary(const std::array<int,3>& cells_per_dim, int face
 int getParentFaceWhereNewRefinedFaceLiesOn(const Dune::cpgrid::CpGridData& current_data,
                                            const std::array<int,3>& cells_per_dim,
                                            int faceIdxInLgr,
-                                           const std::shared_ptr<Dune::cpgrid::CpGridData>& elemLgr_ptr,
+                                           const std::shared_ptr<Dune::cpgrid::SingleCellRefinement>& elemLgr_ptr,
                                            int elemLgr);
 
 /// @brief Define the corners (geometry) for each refined level grid.
 void populateRefinedCorners(std::vector<Dune::cpgrid::EntityVariableBase<Dune::cpgrid::Geometry<0,3>>>& refined_corners_vec,
                             const std::vector<int>& refined_corner_count_vec,
-                            const std::vector<std::shared_ptr<Dune::cpgrid::CpGridData>>& markedElem_to_itsLgr,
+                            const std::vector<std::shared_ptr<Dune::cpgrid::SingleCellRefinement>>& markedElem_to_itsLgr,
                             const int& preAdaptMaxLevel,
-                            const std::map<std::array<int,2>,std::array<int,2>>& refinedLevelAndRefinedCorner_to_elemLgrAndElemLgrCorner);
+                            const Dune::cpgrid::IndexPairMap<std::array<int,2>>& refinedLevelAndRefinedCorner_to_elemLgrAndElemLgrCorner);
 
 /// @brief Define the faces, face tags, face normarls, and face_to_point_, for each refined level grid.
 void populateRefinedFaces(std::vector<Dune::cpgrid::EntityVariableBase<Dune::cpgrid::Geometry<2,3>>>& refined_faces_vec,
@@ -478,13 +480,13 @@ void populateRefinedFaces(std::vector<Dune::cpgrid::EntityVariableBase<Dune::cpg
                           std::vector<Dune::cpgrid::EntityVariableBase<Dune::FieldVector<double,3>>>& mutable_refine_face_normals_vec,
                           std::vector<Opm::SparseTable<int>>& refined_face_to_point_vec,
                           const std::vector<int>& refined_face_count_vec,
-                          const std::map<std::array<int,2>,std::array<int,2>>& refinedLevelAndRefinedFace_to_elemLgrAndElemLgrFace,
-                          const std::map<std::array<int,2>,std::array<int,2>>& elemLgrAndElemLgrCorner_to_refinedLevelAndRefinedCorner,
-                          const std::map<std::array<int,2>, std::array<int,2>>& vanishedRefinedCorner_to_itsLastAppearance,
-                          const std::vector<std::shared_ptr<Dune::cpgrid::CpGridData>>& markedElem_to_itsLgr,
+                          const Dune::cpgrid::IndexPairMap<std::array<int,2>>& refinedLevelAndRefinedFace_to_elemLgrAndElemLgrFace,
+                          const Dune::cpgrid::IndexPairMap<std::array<int,2>>& elemLgrAndElemLgrCorner_to_refinedLevelAndRefinedCorner,
+                          const Dune::cpgrid::IndexPairMap<std::array<int,2>>& vanishedRefinedCorner_to_itsLastAppearance,
+                          const std::vector<std::shared_ptr<Dune::cpgrid::SingleCellRefinement>>& markedElem_to_itsLgr,
                           const int& preAdaptMaxLevel,
                           const std::vector<std::vector<std::array<int,2>>>& cornerInMarkedElemWithEquivRefinedCorner,
-                          const std::map<std::array<int,2>,int>& markedElemAndEquivRefinedCorn_to_corner);
+                          const Dune::cpgrid::IndexPairMap<int>& markedElemAndEquivRefinedCorn_to_corner);
 
 
 /// @brief Define the cells, cell_to_point_, global_cell_, cell_to_face_, face_to_cell_, for each refined level grid.
@@ -495,16 +497,16 @@ void populateRefinedCells(const Dune::cpgrid::CpGridData& current_data,
                           const std::vector<int>& refined_cell_count_vec,
                           std::vector<Dune::cpgrid::OrientedEntityTable<0,1>>& refined_cell_to_face_vec,
                           std::vector<Dune::cpgrid::OrientedEntityTable<1,0>>& refined_face_to_cell_vec,
-                          const std::map<std::array<int,2>,std::array<int,2>>& refinedLevelAndRefinedCell_to_elemLgrAndElemLgrCell,
-                          const std::map<std::array<int,2>,std::array<int,2>>& elemLgrAndElemLgrFace_to_refinedLevelAndRefinedFace,
+                          const Dune::cpgrid::IndexPairMap<std::array<int,2>>& refinedLevelAndRefinedCell_to_elemLgrAndElemLgrCell,
+                          const Dune::cpgrid::IndexPairMap<std::array<int,2>>& elemLgrAndElemLgrFace_to_refinedLevelAndRefinedFace,
                           const std::vector<std::vector<std::pair<int, std::vector<int>>>>& faceInMarkedElemAndRefinedFaces,
                           const std::vector<Dune::cpgrid::DefaultGeometryPolicy>& refined_geometries_vec,
-                          const std::map<std::array<int,2>,std::array<int,2>>& elemLgrAndElemLgrCorner_to_refinedLevelAndRefinedCorner,
-                          const std::map<std::array<int,2>, std::array<int,2>>& vanishedRefinedCorner_to_itsLastAppearance,
-                          const std::vector<std::shared_ptr<Dune::cpgrid::CpGridData>>& markedElem_to_itsLgr,
+                          const Dune::cpgrid::IndexPairMap<std::array<int,2>>& elemLgrAndElemLgrCorner_to_refinedLevelAndRefinedCorner,
+                          const Dune::cpgrid::IndexPairMap<std::array<int,2>>& vanishedRefinedCorner_to_itsLastAppearance,
+                          const std::vector<std::shared_ptr<Dune::cpgrid::SingleCellRefinement>>& markedElem_to_itsLgr,
                           const std::vector<int>& assignRefinedLevel,
                           const int& preAdaptMaxLevel,
-                          const std::map<std::array<int,2>,int>& markedElemAndEquivRefinedCorn_to_corner,
+                          const Dune::cpgrid::IndexPairMap<int>& markedElemAndEquivRefinedCorn_to_corner,
                           const std::vector<std::vector<std::array<int,2>>>& cornerInMarkedElemWithEquivRefinedCorner,
                           const std::vector<std::array<int,3>>&  cells_per_dim_vec);
 
@@ -515,18 +517,19 @@ void populateRefinedCells(const Dune::cpgrid::CpGridData& current_data,
 ///
 /// @param [in] cells_per_dim_lgr1  Number of child cells in {x,y,z} directions for the first refinement.
 /// @param [in] faceIdxInLgr1       Face index in the first single-cell refinement.
-/// @param [in] elemLgr1_ptr        Pointer to the first single-cell refinement grid.
+/// @param [in] elemLgr1_ptr        Pointer to the first single-cell refinement (SingleCellRefinement or CpGridData).
 /// @param [in] cells_per_dim_lgr2  Number of child cells in {x,y,z} directions for the second refinement.
 /// @return Corresponding face index in the second single-cell refinement.
+template<class RefinedCell>
 int replaceLgr1FaceIdxByLgr2FaceIdx(const std::array<int,3>& cells_per_dim_lgr1, int faceIdxInLgr1,
-                                    const std::shared_ptr<Dune::cpgrid::CpGridData>& elemLgr1_ptr,
+                                    const std::shared_ptr<RefinedCell>& elemLgr1_ptr,
                                     const std::array<int,3>& cells_per_dim_lgr2);
 
 /// @brief Define the corners (gemotry) for the leaf grid view (or adapted grid).
 void populateLeafGridCorners(const Dune::cpgrid::CpGridData& current_data,
                              Dune::cpgrid::EntityVariableBase<Dune::cpgrid::Geometry<0,3>>& adapted_corners,
                              const int& corners_count,
-                             const std::vector<std::shared_ptr<Dune::cpgrid::CpGridData>>& markedElem_to_itsLgr,
+                             const std::vector<std::shared_ptr<Dune::cpgrid::SingleCellRefinement>>& markedElem_to_itsLgr,
                              const std::unordered_map<int,std::array<int,2>>& adaptedCorner_to_elemLgrAndElemLgrCorner);
 
 /// @brief Define the faces, face tags, face normarls, and face_to_point_, for the leaf grid view.
@@ -537,11 +540,11 @@ void populateLeafGridFaces(const Dune::cpgrid::CpGridData& current_data,
                            Opm::SparseTable<int>& adapted_face_to_point,
                            const int& face_count,
                            const std::unordered_map<int,std::array<int,2>>& adaptedFace_to_elemLgrAndElemLgrFace,
-                           const std::map<std::array<int,2>,int>& elemLgrAndElemLgrCorner_to_adaptedCorner,
-                           const std::map<std::array<int,2>, std::array<int,2>>& vanishedRefinedCorner_to_itsLastAppearance,
-                           const std::vector<std::shared_ptr<Dune::cpgrid::CpGridData>>& markedElem_to_itsLgr,
+                           const Dune::cpgrid::IndexPairMap<int>& elemLgrAndElemLgrCorner_to_adaptedCorner,
+                           const Dune::cpgrid::IndexPairMap<std::array<int,2>>& vanishedRefinedCorner_to_itsLastAppearance,
+                           const std::vector<std::shared_ptr<Dune::cpgrid::SingleCellRefinement>>& markedElem_to_itsLgr,
                            const std::vector<int>& assignRefinedLevel,
-                           const std::map<std::array<int,2>,int>& markedElemAndEquivRefinedCorn_to_corner,
+                           const Dune::cpgrid::IndexPairMap<int>& markedElemAndEquivRefinedCorn_to_corner,
                            const std::vector<std::vector<std::array<int,2>>>& cornerInMarkedElemWithEquivRefinedCorner,
                            const std::vector<std::array<int,3>>& cells_per_dim_vec,
                            const int& preAdaptMaxLevel);
@@ -554,14 +557,14 @@ void populateLeafGridCells(const Dune::cpgrid::CpGridData& current_data,
                            Dune::cpgrid::OrientedEntityTable<0,1>& adapted_cell_to_face,
                            Dune::cpgrid::OrientedEntityTable<1,0>& adapted_face_to_cell,
                            const std::unordered_map<int,std::array<int,2>>& adaptedCell_to_elemLgrAndElemLgrCell,
-                           const std::map<std::array<int,2>,int>& elemLgrAndElemLgrFace_to_adaptedFace,
+                           const Dune::cpgrid::IndexPairMap<int>& elemLgrAndElemLgrFace_to_adaptedFace,
                            const std::vector<std::vector<std::pair<int, std::vector<int>>>>& faceInMarkedElemAndRefinedFaces,
                            const Dune::cpgrid::DefaultGeometryPolicy& adapted_geometries,
-                           const std::map<std::array<int,2>,int>& elemLgrAndElemLgrCorner_to_adaptedCorner,
-                           const std::map<std::array<int,2>, std::array<int,2>>& vanishedRefinedCorner_to_itsLastAppearance,
-                           const std::vector<std::shared_ptr<Dune::cpgrid::CpGridData>>& markedElem_to_itsLgr,
+                           const Dune::cpgrid::IndexPairMap<int>& elemLgrAndElemLgrCorner_to_adaptedCorner,
+                           const Dune::cpgrid::IndexPairMap<std::array<int,2>>& vanishedRefinedCorner_to_itsLastAppearance,
+                           const std::vector<std::shared_ptr<Dune::cpgrid::SingleCellRefinement>>& markedElem_to_itsLgr,
                            const std::vector<int>& assignRefinedLevel,
-                           const std::map<std::array<int,2>,int>& markedElemAndEquivRefinedCorn_to_corner,
+                           const Dune::cpgrid::IndexPairMap<int>& markedElemAndEquivRefinedCorn_to_corner,
                            const std::vector<std::vector<std::array<int,2>>>& cornerInMarkedElemWithEquivRefinedCorner,
                            const std::vector<std::array<int,3>>& cells_per_dim_vec,
                            const int& preAdaptMaxLevel);
@@ -0,0 +1,214 @@
+/*
+  Copyright 2025 Equinor ASA.
+
+  This file is part of the Open Porous Media project (OPM).
+
+  OPM is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  OPM is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with OPM.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#if HAVE_CONFIG_H
+#include "config.h"
+#endif
+#include <opm/grid/cpgrid/Renumbering.hpp>
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstdint>
+#include <limits>
+#include <numeric>
+#include <utility>
+
+namespace Dune
+{
+namespace cpgrid
+{
+namespace
+{
+/// Breadth-first search from root within its connected component.
+/// \return The number of levels and the vertex of least degree on the last level.
+template<class Degree>
+std::pair<int, int> lastLevel(int root, const std::vector<int>& xadj, const std::vector<int>& adjncy,
+                              const Degree& degree, std::vector<int>& distance, std::vector<int>& queue)
+{
+    queue.clear();
+    queue.push_back(root);
+    distance[root] = 0;
+    for (std::size_t i = 0; i < queue.size(); ++i) {
+        const int vertex = queue[i];
+        for (int e = xadj[vertex]; e < xadj[vertex + 1]; ++e) {
+            const int neighbour = adjncy[e];
+            if (distance[neighbour] < 0) {
+                distance[neighbour] = distance[vertex] + 1;
+                queue.push_back(neighbour);
+            }
+        }
+    }
+    const int depth = distance[queue.back()];
+    int candidate = queue.back();
+    for (auto v = queue.rbegin(); v != queue.rend() && distance[*v] == depth; ++v) {
+        if (degree(*v) <= degree(candidate)) {
+            candidate = *v;
+        }
+    }
+    for (const int vertex : queue) {
+        distance[vertex] = -1;
+    }
+    return {depth, candidate};
+}
+
+/// Position of a point along the Hilbert curve through a cube of 2^bits positions per
+/// direction, following J. Skilling, Programming the Hilbert curve, AIP Conf. Proc. 707, 2004.
+std::uint64_t hilbertKey(std::array<std::uint32_t, 3> x, int bits)
+{
+    const std::uint32_t highest = std::uint32_t(1) << (bits - 1);
+    // Inverse undo of the excess work.
+    for (std::uint32_t q = highest; q > 1; q >>= 1) {
+        const std::uint32_t p = q - 1;
+        for (int i = 0; i < 3; ++i) {
+            if (x[i] & q) {
+                x[0] ^= p;
+            }
+            else {
+                const std::uint32_t t = (x[0] ^ x[i]) & p;
+                x[0] ^= t;
+                x[i] ^= t;
+            }
+        }
+    }
+    // Gray encoding.
+    x[1] ^= x[0];
+    x[2] ^= x[1];
+    std::uint32_t t = 0;
+    for (std::uint32_t q = highest; q > 1; q >>= 1) {
+        if (x[2] & q) {
+            t ^= q - 1;
+        }
+    }
+    for (auto& coordinate : x) {
+        coordinate ^= t;
+    }
+    // Interleave the transposed bits, most significant first.
+    std::uint64_t key = 0;
+    for (int b = bits - 1; b >= 0; --b) {
+        for (int i = 0; i < 3; ++i) {
+            key = (key << 1) | ((x[i] >> b) & 1u);
+        }
+    }
+    return key;
+}
+} // anonymous namespace
+
+std::vector<int> reverseCuthillMcKeeOrder(const std::vector<int>& xadj,
+                                          const std::vector<int>& adjncy)
+{
+    const int num_vertices = xadj.empty() ? 0 : static_cast<int>(xadj.size()) - 1;
+    const auto degree = [&xadj](int vertex) { return xadj[vertex + 1] - xadj[vertex]; };
+    const auto byDegree = [&degree](int a, int b) { return degree(a) < degree(b); };
+
+    // Components are started from their vertex of least degree.
+    std::vector<int> candidates(num_vertices);
+    std::iota(candidates.begin(), candidates.end(), 0);
+    std::ranges::stable_sort(candidates, byDegree);
+
+    std::vector<char> visited(num_vertices, false);
+    std::vector<int> distance(num_vertices, -1);
+    std::vector<int> queue;
+    std::vector<int> order;
+    order.reserve(num_vertices);
+
+    for (const int candidate : candidates) {
+        if (visited[candidate]) {
+            continue;
+        }
+        // Move to a pseudo-peripheral vertex, as proposed by George and Liu.
+        int root = candidate;
+        auto levels = lastLevel(root, xadj, adjncy, degree, distance, queue);
+        while (true) {
+            const auto next = lastLevel(levels.second, xadj, adjncy, degree, distance, queue);
+            if (next.first <= levels.first) {
+                break;
+            }
+            root = levels.second;
+            levels = next;
+        }
+
+        std::size_t current = order.size();
+        order.push_back(root);
+        visited[root] = true;
+        for (; current < order.size(); ++current) {
+            const int vertex = order[current];
+            const auto first = order.size();
+            for (int e = xadj[vertex]; e < xadj[vertex + 1]; ++e) {
+                const int neighbour = adjncy[e];
+                if (!visited[neighbour]) {
+                    visited[neighbour] = true;
+                    order.push_back(neighbour);
+                }
+            }
+            std::stable_sort(order.begin() + first, order.end(), byDegree);
+        }
+    }
+    std::ranges::reverse(order);
+    return order;
+}
+
+std::vector<int> hilbertCurveOrder(const std::vector<FieldVector<double, 3>>& points)
+{
+    constexpr int bits = 21;
+    const int num_points = points.size();
+
+    // Points without a valid position, e.g. centroids of cells without volume, are put at
+    // the lower corner of the bounding box.
+    FieldVector<double, 3> lower(std::numeric_limits<double>::max());
+    FieldVector<double, 3> upper(std::numeric_limits<double>::lowest());
+    for (const auto& point : points) {
+        for (int d = 0; d < 3; ++d) {
+            if (std::isfinite(point[d])) {
+                lower[d] = std::min(lower[d], point[d]);
+                upper[d] = std::max(upper[d], point[d]);
+            }
+        }
+    }
+    // The same scale in all directions keeps the curve local in thin, wide domains.
+    double extent = 0.0;
+    for (int d = 0; d < 3; ++d) {
+        extent = std::max(extent, upper[d] - lower[d]);
+    }
+    const double max_position = (std::uint32_t(1) << bits) - 1;
+    const double scale = extent > 0.0 ? max_position / extent : 0.0;
+
+    std::vector<std::pair<std::uint64_t, int>> keys(num_points);
+#ifdef _OPENMP
+#pragma omp parallel for schedule(static)
+#endif
+    for (int i = 0; i < num_points; ++i) {
+        std::array<std::uint32_t, 3> position {};
+        for (int d = 0; d < 3; ++d) {
+            if (std::isfinite(points[i][d])) {
+                const double scaled = (points[i][d] - lower[d]) * scale;
+                position[d] = static_cast<std::uint32_t>(std::clamp(scaled, 0.0, max_position));
+            }
+        }
+        keys[i] = {hilbertKey(position, bits), i};
+    }
+    std::ranges::sort(keys);
+
+    std::vector<int> order(num_points);
+    std::ranges::transform(keys, order.begin(), [](const auto& key) { return key.second; });
+    return order;
+}
+
+} // namespace cpgrid
+} // namespace Dune
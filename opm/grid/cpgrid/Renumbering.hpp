@@ -0,0 +1,66 @@
+/*
+  Copyright 2025 Equinor ASA.
+
+  This file is part of the Open Porous Media project (OPM).
+
+  OPM is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  OPM is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with OPM.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#ifndef OPM_RENUMBERING_HEADER
+#define OPM_RENUMBERING_HEADER
+
+#include <dune/common/fvector.hh>
+
+#include <vector>
+
+namespace Dune
+{
+namespace cpgrid
+{
+
+/// @brief The permutations applied by CpGrid::renumber() to the entities of a grid view.
+///
+/// Entry i of each vector is the index the entity now numbered i had before the
+/// renumbering. Data attached to the old indices is therefore carried over by
+/// new_data[i] = old_data[cells[i]], and likewise for faces and points.
+struct Renumbering
+{
+    std::vector<int> cells;
+    std::vector<int> faces;
+    std::vector<int> points;
+};
+
+/// @brief Reverse Cuthill-McKee ordering of a graph in compressed sparse row format.
+///
+/// Each connected component is traversed breadth-first from a pseudo-peripheral
+/// vertex, visiting the neighbours of a vertex by increasing degree, and the
+/// resulting order is reversed. This keeps the bandwidth of a matrix with the
+/// sparsity of the graph small.
+/// @param xadj Start of the neighbours of each vertex in adjncy, one entry more than vertices.
+/// @param adjncy The neighbours of all vertices.
+/// @return The vertices in their new order.
+std::vector<int> reverseCuthillMcKeeOrder(const std::vector<int>& xadj,
+                                          const std::vector<int>& adjncy);
+
+/// @brief Ordering of points along a Hilbert space-filling curve through their bounding box.
+///
+/// The points are mapped to a grid of 2^21 positions per direction, and points
+/// with the same position keep their relative order.
+/// @return The indices of the points in their new order.
+std::vector<int> hilbertCurveOrder(const std::vector<FieldVector<double, 3>>& points);
+
+} // namespace cpgrid
+} // namespace Dune
+
+#endif // OPM_RENUMBERING_HEADER
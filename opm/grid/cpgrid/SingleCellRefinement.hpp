@@ -0,0 +1,114 @@
+/*
+  Copyright 2025 Equinor ASA.
+
+  This file is part of the Open Porous Media project (OPM).
+
+  OPM is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  OPM is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with OPM.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#ifndef OPM_SINGLECELLREFINEMENT_HEADER_INCLUDED
+#define OPM_SINGLECELLREFINEMENT_HEADER_INCLUDED
+
+#include <dune/common/fvector.hh>
+
+#include <opm/grid/cpgpreprocess/preprocess.h>
+#include <opm/grid/cpgrid/DefaultGeometryPolicy.hpp>
+#include <opm/grid/cpgrid/EntityRep.hpp>
+#include <opm/grid/cpgrid/Geometry.hpp>
+#include <opm/grid/cpgrid/OrientedEntityTable.hpp>
+#include <opm/grid/utility/SparseTable.hpp>
+
+#include <array>
+#include <vector>
+
+namespace Dune
+{
+namespace cpgrid
+{
+
+class CpGridData;
+
+/// @brief Geometry and topology of a single cell refined into cells_per_dim children.
+///
+/// Holds exactly the containers filled by Geometry::refineCellifiedPatch, without the index sets,
+/// id sets, and communication objects of a CpGridData. adapt() keeps one of these per marked
+/// element while building the refined level grids and the leaf grid view. The geometry and
+/// topology are still computed for every marked element, they are not shared between elements
+/// refined with the same cells_per_dim.
+/// The accessors mirror the ones of CpGridData.
+class SingleCellRefinement
+{
+    friend class CpGridData;
+public:
+    using PointType = Dune::FieldVector<double,3>;
+
+    /// @brief Number of cells (codim 0) or corners (codim 3), 0 otherwise.
+    int size(int codim) const
+    {
+        switch (codim) {
+        case 0: return cell_to_face_.size();
+        case 3: return geometry_.geomVector<3>().size();
+        default: return 0;
+        }
+    }
+
+    int numFaces() const
+    {
+        return face_to_cell_.size();
+    }
+
+    auto cellToFace(int cellIdx) const
+    {
+        return cell_to_face_[EntityRep<0>(cellIdx, true)];
+    }
+
+    const auto& cellToPoint(int cellIdx) const
+    {
+        return cell_to_point_[cellIdx];
+    }
+
+    auto faceTag(int faceIdx) const
+    {
+        return face_tag_[EntityRep<1>(faceIdx, true)];
+    }
+
+    auto faceNormals(int faceIdx) const
+    {
+        return face_normals_[EntityRep<1>(faceIdx, true)];
+    }
+
+    auto faceToPoint(int faceIdx) const
+    {
+        return face_to_point_[faceIdx];
+    }
+
+    const DefaultGeometryPolicy& getGeometry() const
+    {
+        return geometry_;
+    }
+
+private:
+    DefaultGeometryPolicy geometry_;
+    std::vector<std::array<int,8>> cell_to_point_;
+    OrientedEntityTable<0,1> cell_to_face_;
+    Opm::SparseTable<int> face_to_point_;
+    OrientedEntityTable<1,0> face_to_cell_;
+    EntityVariable<enum face_tag,1> face_tag_;
+    SignedEntityVariable<PointType,1> face_normals_;
+};
+
+} // namespace cpgrid
+} // namespace Dune
+
+#endif // OPM_SINGLECELLREFINEMENT_HEADER_INCLUDED
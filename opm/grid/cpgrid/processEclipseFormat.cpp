@@ -37,6 +37,7 @@
 #include <config.h>
 #endif
 
+#include <opm/grid/CpGrid.hpp>
 #include <opm/grid/cpgrid/CpGridData.hpp>
 
 #include <opm/grid/common/GeometryHelpers.hpp>
@@ -45,7 +46,7 @@
 #include <opm/grid/MinpvProcessor.hpp>
 #include <opm/grid/RepairZCORN.hpp>
 #include <opm/grid/utility/OpmLog.hpp>
-#include <opm/grid/utility/StopWatch.hpp>
+#include <opm/grid/utility/SetupProfile.hpp>
 
 #include <opm/grid/cpgrid/Entity.hpp>
 #include <opm/grid/cpgrid/Geometry.hpp>
@@ -62,6 +63,8 @@
 #include <fstream>
 #include <initializer_list>
 #include <iostream>
+#include <limits>
+#include <map>
 #include <memory>
 #include <numeric>
 #include <set>
@@ -71,6 +74,14 @@
 #include <utility>
 #include <vector>
 
+#if HAVE_MPI
+#include <dune/common/parallel/mpitraits.hh>
+#endif
+
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
 namespace Dune
 {
 
@@ -101,7 +112,17 @@ namespace Dune
 #endif
 
         void removeOuterCellLayer(processed_grid& grid);
-        // void removeUnusedNodes(processed_grid& grid); // NOTE: not deleted, see comment at definition.
+        std::vector<char> removeSlabHaloRows(processed_grid& grid, int row_begin, int row_end);
+        void removeUnusedNodes(processed_grid& grid);
+#if HAVE_MPI
+        template <class T>
+        std::vector<std::vector<T>>
+        exchangeWithNeighbors(const cpgrid::CpGridData::Communication& cc,
+                              const std::vector<int>& send_ranks,
+                              const std::vector<std::vector<T>>& send_buffers,
+                              const std::vector<int>& recv_ranks,
+                              int tag);
+#endif
         void buildTopo(const processed_grid& output,
                        const NNCMaps& nnc,
                        std::vector<int>& global_cell,
@@ -119,7 +140,8 @@ namespace Dune
                        cpgrid::EntityVariable<cpgrid::Geometry<2, 3>, 1>& face_geom,
                        std::shared_ptr<cpgrid::EntityVariable<cpgrid::Geometry<0, 3>, 3>> point_geom,
                        cpgrid::SignedEntityVariable<FieldVector<double, 3> , 1>& normals,
-                       bool turn_normals);
+                       bool turn_normals,
+                       Opm::SetupProfile* profile);
     } // anon namespace
 
 
@@ -191,6 +213,7 @@ namespace cpgrid
             }();
 
             try {
+                Opm::SetupProfile::Scope minpv_scope(setup_profile_, "minpv");
                 Opm::MinpvProcessor mp(g.dims[0], g.dims[1], g.dims[2]);
                 std::vector<double> thickness(cartGridSize);
                 for (size_t i = 0; i < cartGridSize; ++i) {
@@ -451,13 +474,18 @@ namespace cpgrid
                       "description only supported on rank 0");
         }
 
-#ifdef VERBOSE
-        std::cout << "Processing corner-point grid description." << std::endl;
-#endif
-
+        Opm::SetupProfile::Scope preprocess_scope(setup_profile_, "preprocess");
         processed_grid output{};
         int process_ok{};
 
+        // The pillar sweeps are threaded when OpenMP is available.  The
+        // number of threads follows the OpenMP runtime setting, e.g.,
+        // OMP_NUM_THREADS or omp_set_num_threads().
+        int num_threads = 1;
+#ifdef _OPENMP
+        num_threads = omp_get_max_threads();
+#endif
+
 #if HAVE_OPM_COMMON
         if ((ecl_state != nullptr) && ecl_state->aquifer().hasNumericalAquifer()) {
             const std::size_t global_nc =
@@ -474,22 +502,24 @@ namespace cpgrid
                 is_aquifer_cell[global_index] = 1;
             }
 
-            process_ok = process_grdecl(static_cast<int>(pinchActive),
-                                        static_cast<int>(edge_conformal),
-                                        tolerance_unique_points,
-                                        &input_data,
-                                        is_aquifer_cell.data(),
-                                        &output);
+            process_ok = process_grdecl_threaded(static_cast<int>(pinchActive),
+                                                 static_cast<int>(edge_conformal),
+                                                 tolerance_unique_points,
+                                                 &input_data,
+                                                 is_aquifer_cell.data(),
+                                                 num_threads,
+                                                 &output);
         }
         else
 #endif
         {
-            process_ok = process_grdecl(static_cast<int>(pinchActive),
-                                        static_cast<int>(edge_conformal),
-                                        tolerance_unique_points,
-                                        &input_data,
-                                        /* is_aquifer_cell = */ nullptr,
-                                        &output);
+            process_ok = process_grdecl_threaded(static_cast<int>(pinchActive),
+                                                 static_cast<int>(edge_conformal),
+                                                 tolerance_unique_points,
+                                                 &input_data,
+                                                 /* is_aquifer_cell = */ nullptr,
+                                                 num_threads,
+                                                 &output);
         }
 
         if (process_ok == 0) {
@@ -532,21 +562,22 @@ namespace cpgrid
         }
 #endif
 
+        preprocess_scope.close();
+
         // Move data into the grid's structures.
-#ifdef VERBOSE
-        std::cout << "Building topology." << std::endl;
-#endif
+        Opm::SetupProfile::Scope topology_scope(setup_profile_, "topology");
         std::vector<int> face_to_output_face{};
         buildTopo(output, nnc, global_cell_,
                   cell_to_face_, face_to_cell_,
                   face_to_point_, cell_to_point_,
                   face_to_output_face);
+        topology_scope.count("cells", cell_to_face_.size());
+        topology_scope.count("faces", face_to_cell_.size());
+        topology_scope.close();
 
         std::copy_n(output.dimensions, 3, logical_cartesian_size_.begin());
 
-#ifdef VERBOSE
-        std::cout << "Building geometry." << std::endl;
-#endif
+        Opm::SetupProfile::Scope geometry_scope(setup_profile_, "geometry");
         // here we need the cell volumes based on the active index order
         std::unordered_map<std::size_t, double> aquifer_cell_volumes_local{};
 #if HAVE_OPM_COMMON
@@ -575,11 +606,9 @@ namespace cpgrid
                   *geometry_.geomVector(std::integral_constant<int,1>()),
                   geometry_.geomVector(std::integral_constant<int,3>()),
                   face_normals_,
-                  turn_normals);
+                  turn_normals,
+                  setup_profile_);
 
-#ifdef VERBOSE
-        std::cout << "Assigning face tags." << std::endl;
-#endif
         const int nf = face_to_output_face.size();
         std::vector<enum face_tag> temp_tags(nf);
         for (int i = 0; i < nf; ++i) {
@@ -590,10 +619,8 @@ namespace cpgrid
         }
 
         face_tag_.assign(temp_tags.begin(), temp_tags.end());
-
-#ifdef VERBOSE
-        std::cout << "Cleaning up." << std::endl;
-#endif
+        geometry_scope.count("points", geomVector<3>().size());
+        geometry_scope.close();
 
         // Clean up the output struct.
         free_processed_grid(&output);
@@ -605,9 +632,451 @@ namespace cpgrid
         }
 
         index_set_ = std::make_unique<IndexSet>(cell_to_face_.size(), geomVector<3>().size());
+    }
 
-#ifdef VERBOSE
-        std::cout << "Done with grid processing." << std::endl;
+
+    void CpGridData::processEclipseFormatDistributed(const grdecl& slab_input,
+                                                     const int global_ny,
+                                                     const std::array<int,2>& owned_rows,
+                                                     const bool turn_normals,
+                                                     const bool pinchActive,
+                                                     const double tolerance_unique_points,
+                                                     const bool edge_conformal)
+    {
+        const int nx = slab_input.dims[0];
+        const int nz = slab_input.dims[2];
+        const auto slab_rows = CpGrid::slabInputRows(owned_rows, global_ny);
+        const int num_procs = ccobj_.size();
+
+        // Which process owns which row. Checked on all processes, such
+        // that either all or none of them throw.
+        std::vector<int> all_rows(2*num_procs);
+        ccobj_.allgather(owned_rows.data(), 2, all_rows.data());
+        std::vector<int> row_owner(global_ny, -1);
+        for (int p = 0; p < num_procs; ++p) {
+            if (all_rows[2*p] < 0 || all_rows[2*p] >= all_rows[2*p + 1] || all_rows[2*p + 1] > global_ny) {
+                OPM_THROW(std::invalid_argument, "Process " + std::to_string(p) + " owns an invalid "
+                          "range of rows for distributed grid processing.");
+            }
+            for (int j = all_rows[2*p]; j < all_rows[2*p + 1]; ++j) {
+                if (row_owner[j] != -1) {
+                    OPM_THROW(std::invalid_argument, "Row " + std::to_string(j) + " is owned by more "
+                              "than one process in distributed grid processing.");
+                }
+                row_owner[j] = p;
+            }
+        }
+        if (std::ranges::find(row_owner, -1) != row_owner.end()) {
+            OPM_THROW(std::invalid_argument, "The owned rows of the processes do not cover the grid "
+                      "in distributed grid processing.");
+        }
+        const bool slab_ok = (slab_input.dims[1] == slab_rows[1] - slab_rows[0]);
+        if (!ccobj_.min(slab_ok)) {
+            OPM_THROW(std::invalid_argument, "The corner-point input of at least one process does "
+                      "not hold the rows given by CpGrid::slabInputRows().");
+        }
+
+        Opm::SetupProfile::Scope preprocess_scope(setup_profile_, "preprocess");
+        processed_grid output{};
+        int num_threads = 1;
+#ifdef _OPENMP
+        num_threads = omp_get_max_threads();
+#endif
+        const int process_ok = process_grdecl_threaded(static_cast<int>(pinchActive),
+                                                       static_cast<int>(edge_conformal),
+                                                       tolerance_unique_points,
+                                                       &slab_input,
+                                                       /* is_aquifer_cell = */ nullptr,
+                                                       num_threads,
+                                                       &output);
+        if (process_ok == 0) {
+            OPM_THROW(std::runtime_error,
+                      "Failed to build unstructured "
+                      "grid from COORD/ZCORN");
+        }
+
+        // Keep the owned rows and one overlap row on either side. The
+        // faces and points between the overlap rows and the outer halo
+        // rows are exact, as those rows have been processed, too.
+        const int keep_begin = std::max(owned_rows[0] - 1, 0) - slab_rows[0];
+        const int keep_end = std::min(owned_rows[1] + 1, global_ny) - slab_rows[0];
+        const std::vector<char> removed_neighbor = removeSlabHaloRows(output, keep_begin, keep_end);
+        removeUnusedNodes(output);
+        preprocess_scope.close();
+
+        Opm::SetupProfile::Scope topology_scope(setup_profile_, "topology");
+        NNCMaps nnc;
+        std::vector<int> face_to_output_face{};
+        buildTopo(output, nnc, global_cell_,
+                  cell_to_face_, face_to_cell_,
+                  face_to_point_, cell_to_point_,
+                  face_to_output_face);
+        topology_scope.count("cells", cell_to_face_.size());
+        topology_scope.count("faces", face_to_cell_.size());
+        topology_scope.close();
+
+        // Map the logical cartesian indices of the slab to the global grid.
+        const int slab_ny = slab_input.dims[1];
+        for (auto& cart : global_cell_) {
+            const int i = cart % nx;
+            const int j = (cart / nx) % slab_ny + slab_rows[0];
+            const int k = cart / (nx*slab_ny);
+            cart = i + nx*(j + global_ny*k);
+        }
+        logical_cartesian_size_ = { nx, global_ny, nz };
+
+        Opm::SetupProfile::Scope geometry_scope(setup_profile_, "geometry");
+        buildGeom(output, cell_to_face_, cell_to_point_,
+                  face_to_output_face,
+                  /* aquifer_cell_volumes = */ {},
+                  *geometry_.geomVector(std::integral_constant<int,0>()),
+                  *geometry_.geomVector(std::integral_constant<int,1>()),
+                  geometry_.geomVector(std::integral_constant<int,3>()),
+                  face_normals_,
+                  turn_normals,
+                  setup_profile_);
+
+        const int nf = face_to_output_face.size();
+        std::vector<enum face_tag> temp_tags(nf);
+        for (int i = 0; i < nf; ++i) {
+            temp_tags[i] = output.face_tag[face_to_output_face[i]];
+        }
+        face_tag_.assign(temp_tags.begin(), temp_tags.end());
+        geometry_scope.count("points", geomVector<3>().size());
+        geometry_scope.close();
+
+        free_processed_grid(&output);
+
+        // Faces towards removed halo cells get a neighbor with index
+        // std::numeric_limits<int>::max(), just like the faces towards
+        // cells on other processes in distributeGlobalGrid().
+        if (std::ranges::find(removed_neighbor, 1) != removed_neighbor.end()) {
+            OrientedEntityTable<1, 0> face_to_cell;
+            for (int face = 0; face < nf; ++face) {
+                std::array<EntityRep<0>, 2> cells;
+                int cellcount = 0;
+                for (const auto& cell : face_to_cell_[EntityRep<1>(face, true)]) {
+                    cells[cellcount++] = cell;
+                }
+                const int output_face = face_to_output_face[face];
+                for (int side = 0; side < 2; ++side) {
+                    if (removed_neighbor[2*output_face + side]) {
+                        cells[cellcount++] = EntityRep<0>(std::numeric_limits<int>::max(), side == 0);
+                    }
+                }
+                std::sort(cells.begin(), cells.begin() + cellcount);
+                face_to_cell.appendRow(cells.begin(), cells.begin() + cellcount);
+            }
+            face_to_cell_.swap(face_to_cell);
+        }
+
+        if (num_procs > 1) {
+            agreeOnDistributedIds(all_rows, row_owner);
+        }
+
+        index_set_ = std::make_unique<IndexSet>(cell_to_face_.size(), geomVector<3>().size());
+    }
+
+    void CpGridData::agreeOnDistributedIds([[maybe_unused]] const std::vector<int>& all_rows,
+                                           [[maybe_unused]] const std::vector<int>& row_owner)
+    {
+#if HAVE_MPI
+        const int nx = logical_cartesian_size_[0];
+        const int global_ny = logical_cartesian_size_[1];
+        const int nz = logical_cartesian_size_[2];
+        const int num_procs = ccobj_.size();
+        const int rank = ccobj_.rank();
+        const int nc = cell_to_face_.size();
+        const int nf = face_to_cell_.size();
+        const int np = geomVector<3>().size();
+
+        const auto cellRow = [nx, global_ny](int cart) { return (cart / nx) % global_ny; };
+        const auto rowOwner = [&row_owner, global_ny](int row) { return row_owner[std::min(row, global_ny - 1)]; };
+
+        // The row of a face or point is the row of its cells, or the
+        // pillar row for those on a plane of constant j. Every process
+        // seeing an entity computes the same row, and the process owning
+        // that row sees all cells around it. It therefore owns the entity.
+        std::vector<int> face_row(nf, -1);
+        for (int face = 0; face < nf; ++face) {
+            const EntityRep<1> frep(face, true);
+            for (const auto& cell : face_to_cell_[frep]) {
+                if (cell.index() == std::numeric_limits<int>::max()) {
+                    continue;
+                }
+                // The cell with positive orientation is the one below a J face.
+                face_row[face] = cellRow(global_cell_[cell.index()])
+                    + ((face_tag_[frep] == J_FACE && cell.orientation()) ? 1 : 0);
+                break;
+            }
+        }
+        std::vector<int> point_row(np, -1);
+        for (int face = 0; face < nf; ++face) {
+            for (const int point : face_to_point_[face]) {
+                point_row[point] = std::max(point_row[point], face_row[face]);
+            }
+        }
+
+        // Global ids: cells use their global cartesian index, owned faces
+        // and points are numbered consecutively per process after that.
+        std::vector<int> face_ids(nf, -1);
+        std::vector<int> point_ids(np, -1);
+        std::array<int,2> num_owned = { 0, 0 };
+        for (int face = 0; face < nf; ++face) {
+            if (rowOwner(face_row[face]) == rank) {
+                face_ids[face] = num_owned[0]++;
+            }
+        }
+        for (int point = 0; point < np; ++point) {
+            if (rowOwner(point_row[point]) == rank) {
+                point_ids[point] = num_owned[1]++;
+            }
+        }
+        std::vector<int> all_owned(2*num_procs);
+        ccobj_.allgather(num_owned.data(), 2, all_owned.data());
+        int face_offset = nx*global_ny*nz;
+        int point_offset = face_offset;
+        for (int p = 0; p < num_procs; ++p) {
+            point_offset += all_owned[2*p];
+            if (p < rank) {
+                face_offset += all_owned[2*p];
+                point_offset += all_owned[2*p + 1];
+            }
+        }
+        for (auto& id : face_ids) {
+            id += (id != -1) ? face_offset : 0;
+        }
+        for (auto& id : point_ids) {
+            id += (id != -1) ? point_offset : 0;
+        }
+
+        // Faces and points of process p lie in the rows from one below
+        // its first to one above its last owned row. Process p owns those
+        // in its rows, and the last process also those on the top plane.
+        const auto seenRows = [&all_rows](int p) {
+            return std::array<int,2>{ all_rows[2*p] - 1, all_rows[2*p + 1] + 1 };
+        };
+        const auto ownedRows = [&all_rows, global_ny](int p) {
+            return std::array<int,2>{ all_rows[2*p], all_rows[2*p + 1] - 1 + (all_rows[2*p + 1] == global_ny) };
+        };
+        const auto intersects = [](const std::array<int,2>& a, const std::array<int,2>& b) {
+            return a[0] <= b[1] && b[0] <= a[1];
+        };
+        std::vector<int> send_ranks;
+        std::vector<int> recv_ranks;
+        for (int p = 0; p < num_procs; ++p) {
+            if (p == rank) {
+                continue;
+            }
+            if (intersects(seenRows(p), ownedRows(rank))) {
+                send_ranks.push_back(p);
+            }
+            if (intersects(seenRows(rank), ownedRows(p))) {
+                recv_ranks.push_back(p);
+            }
+        }
+
+        // Points are identified by their coordinates, which are computed
+        // from the same input in the same way on every process. Distinct
+        // points may coincide, e.g. on collapsed pillars or pinched faults.
+        // They are told apart by the cells around them: a point is the
+        // corner c of some cells, {global cell, c}, and lies on faces of
+        // some cells, {global cell, -1}. The owner of a point sees all
+        // cells around it, any other process a subset of them.
+        const auto& points = geomVector<3>();
+        const auto coordinates = [&points](int point) {
+            const auto& c = points[EntityRep<3>(point, true)].center();
+            return std::array<double,3>{ c[0], c[1], c[2] };
+        };
+        std::vector<std::vector<std::array<int,2>>> point_cells(np);
+        for (int cell = 0; cell < nc; ++cell) {
+            for (int corner = 0; corner < 8; ++corner) {
+                point_cells[cell_to_point_[cell][corner]].push_back({ global_cell_[cell], corner });
+            }
+        }
+        for (int face = 0; face < nf; ++face) {
+            for (const auto& cell : face_to_cell_[EntityRep<1>(face, true)]) {
+                if (cell.index() == std::numeric_limits<int>::max()) {
+                    continue;
+                }
+                for (const int point : face_to_point_[face]) {
+                    point_cells[point].push_back({ global_cell_[cell.index()], -1 });
+                }
+            }
+        }
+        for (auto& cells : point_cells) {
+            std::ranges::sort(cells);
+            cells.erase(std::unique(cells.begin(), cells.end()), cells.end());
+        }
+        bool ambiguous = false;
+        {
+            // Layout per point: point id, number of cells, cells.
+            std::vector<std::vector<double>> send_coords(send_ranks.size());
+            std::vector<std::vector<int>> send_points(send_ranks.size());
+            for (std::size_t i = 0; i < send_ranks.size(); ++i) {
+                const auto rows = seenRows(send_ranks[i]);
+                for (int point = 0; point < np; ++point) {
+                    if (point_ids[point] != -1 && intersects(rows, { point_row[point], point_row[point] })) {
+                        const auto c = coordinates(point);
+                        send_coords[i].insert(send_coords[i].end(), c.begin(), c.end());
+                        send_points[i].push_back(point_ids[point]);
+                        send_points[i].push_back(static_cast<int>(point_cells[point].size()));
+                        for (const auto& cell : point_cells[point]) {
+                            send_points[i].insert(send_points[i].end(), cell.begin(), cell.end());
+                        }
+                    }
+                }
+            }
+            const auto recv_coords = exchangeWithNeighbors(ccobj_, send_ranks, send_coords, recv_ranks, 1871);
+            const auto recv_points = exchangeWithNeighbors(ccobj_, send_ranks, send_points, recv_ranks, 1873);
+
+            std::vector<std::pair<std::array<double,3>, int>> unresolved;
+            for (int point = 0; point < np; ++point) {
+                if (point_ids[point] == -1) {
+                    unresolved.emplace_back(coordinates(point), point);
+                }
+            }
+            std::ranges::sort(unresolved);
+            std::vector<std::array<int,2>> cells;
+            for (std::size_t i = 0; i < recv_ranks.size(); ++i) {
+                auto entry = recv_points[i].begin();
+                for (std::size_t n = 0; 3*n < recv_coords[i].size(); ++n) {
+                    const std::array<double,3> c = { recv_coords[i][3*n], recv_coords[i][3*n + 1],
+                                                     recv_coords[i][3*n + 2] };
+                    const int id = *entry++;
+                    const int num_cells = *entry++;
+                    cells.resize(num_cells);
+                    for (auto& cell : cells) {
+                        cell = { entry[0], entry[1] };
+                        entry += 2;
+                    }
+                    int match = -1;
+                    for (auto candidate = std::lower_bound(unresolved.begin(), unresolved.end(),
+                                                           std::make_pair(c, std::numeric_limits<int>::min()));
+                         candidate != unresolved.end() && candidate->first == c; ++candidate) {
+                        const auto& local_cells = point_cells[candidate->second];
+                        if (std::includes(cells.begin(), cells.end(), local_cells.begin(), local_cells.end())) {
+                            // Points around the same cells at the same place cannot be told apart.
+                            ambiguous = ambiguous || (match != -1);
+                            match = candidate->second;
+                        }
+                    }
+                    if (match != -1) {
+                        point_ids[match] = id;
+                    }
+                }
+            }
+        }
+
+        // Faces are identified by the sorted ids of their points. Zero
+        // thickness cells may have several faces with the same points,
+        // these are told apart by the ids of their cells (-1 on the
+        // boundary). Cells not present here match any id.
+        const auto faceCellIds = [this](int face) {
+            std::array<int,2> ids = { -1, -1 };
+            for (const auto& cell : face_to_cell_[EntityRep<1>(face, true)]) {
+                ids[cell.orientation() ? 0 : 1] = (cell.index() == std::numeric_limits<int>::max())
+                    ? std::numeric_limits<int>::max()
+                    : global_cell_[cell.index()];
+            }
+            return ids;
+        };
+        const auto facePointIds = [this, &point_ids](int face) {
+            std::vector<int> ids;
+            for (const int point : face_to_point_[face]) {
+                ids.push_back(point_ids[point]);
+            }
+            std::ranges::sort(ids);
+            return ids;
+        };
+        {
+            // Layout per face: face id, cell ids, number of points, point ids.
+            std::vector<std::vector<int>> send_faces(send_ranks.size());
+            for (std::size_t i = 0; i < send_ranks.size(); ++i) {
+                const auto rows = seenRows(send_ranks[i]);
+                for (int face = 0; face < nf; ++face) {
+                    if (face_ids[face] != -1 && intersects(rows, { face_row[face], face_row[face] })) {
+                        const auto cell_ids = faceCellIds(face);
+                        const auto ids = facePointIds(face);
+                        send_faces[i].push_back(face_ids[face]);
+                        send_faces[i].insert(send_faces[i].end(), cell_ids.begin(), cell_ids.end());
+                        send_faces[i].push_back(static_cast<int>(ids.size()));
+                        send_faces[i].insert(send_faces[i].end(), ids.begin(), ids.end());
+                    }
+                }
+            }
+            const auto recv_faces = exchangeWithNeighbors(ccobj_, send_ranks, send_faces, recv_ranks, 1877);
+
+            std::map<std::vector<int>, std::vector<int>> unresolved;
+            for (int face = 0; face < nf; ++face) {
+                if (face_ids[face] == -1) {
+                    unresolved[facePointIds(face)].push_back(face);
+                }
+            }
+            for (const auto& buffer : recv_faces) {
+                for (auto entry = buffer.begin(); entry != buffer.end(); ) {
+                    const int id = *entry++;
+                    const std::array<int,2> cell_ids = { entry[0], entry[1] };
+                    const int num_points = entry[2];
+                    entry += 3;
+                    const std::vector<int> key(entry, entry + num_points);
+                    entry += num_points;
+                    auto candidates = unresolved.find(key);
+                    if (candidates == unresolved.end()) {
+                        continue;
+                    }
+                    for (const int face : candidates->second) {
+                        const auto local_ids = faceCellIds(face);
+                        bool match = true;
+                        for (int side = 0; side < 2; ++side) {
+                            match = match && (local_ids[side] == cell_ids[side] ||
+                                              local_ids[side] == std::numeric_limits<int>::max());
+                        }
+                        if (match) {
+                            face_ids[face] = id;
+                        }
+                    }
+                }
+            }
+        }
+
+        const bool resolved = !ambiguous
+            && std::ranges::find(face_ids, -1) == face_ids.end()
+            && std::ranges::find(point_ids, -1) == point_ids.end();
+        if (!ccobj_.min(resolved)) {
+            OPM_THROW(std::runtime_error, "Failed to agree on global ids of faces and points "
+                      "in distributed grid processing.");
+        }
+
+        std::vector<int> cell_ids(global_cell_);
+        global_id_set_->swap(cell_ids, face_ids, point_ids);
+
+        auto& cell_indexset = cellIndexSet();
+        cell_indexset.beginResize();
+        for (int cell = 0; cell < nc; ++cell) {
+            const bool owner = rowOwner(cellRow(global_cell_[cell])) == rank;
+            cell_indexset.add(global_cell_[cell],
+                              ParallelIndexSet::LocalIndex(cell, owner ? AttributeSet::owner : AttributeSet::copy, true));
+        }
+        cell_indexset.endResize();
+
+        // Processes holding cells of the same rows are the only ones
+        // that need to talk to each other.
+        std::vector<int> neighbors;
+        const auto cellRows = [&all_rows](int p) {
+            return std::array<int,2>{ all_rows[2*p] - 1, all_rows[2*p + 1] };
+        };
+        for (int p = 0; p < num_procs; ++p) {
+            if (p != rank && intersects(cellRows(p), cellRows(rank))) {
+                neighbors.push_back(p);
+            }
+        }
+        cellRemoteIndices().setNeighbours(neighbors);
+        cellRemoteIndices().template rebuild<false>();
+
+        computeCellPartitionType();
+        computePointPartitionType();
+        computeCommunicationInterfaces(np);
 #endif
     }
 
@@ -916,16 +1385,49 @@ namespace cpgrid
             std::ranges::copy(new_index_to_new_lcart, grid.local_cell_index);
         }
 
+        /// Removes all cells outside the rows [row_begin, row_end) from a
+        /// grid. Unlike removeOuterCellLayer() the dimensions and the
+        /// logical cartesian indices are left unchanged.
+        ///
+        /// Returns, for every entry of grid.face_neighbors, whether it
+        /// referred to a removed cell.
+        std::vector<char> removeSlabHaloRows(processed_grid& grid, const int row_begin, const int row_end)
+        {
+            const int nx = grid.dimensions[0];
+            const int ny = grid.dimensions[1];
+
+            // Part 1, the new cell indices (-1 for removed cells).
+            std::vector<int> old_to_new_index(grid.number_of_cells, -1);
+            int num_kept = 0;
+            for (int i = 0; i < grid.number_of_cells; ++i) {
+                const int lcart = grid.local_cell_index[i];
+                const int j = (lcart / nx) % ny;
+                if (j >= row_begin && j < row_end) {
+                    grid.local_cell_index[num_kept] = lcart;
+                    old_to_new_index[i] = num_kept++;
+                }
+            }
+
+            // Part 2, modifying the face->cell connections.
+            std::vector<char> removed_neighbor(2*grid.number_of_faces, 0);
+            for (int i = 0; i < 2*grid.number_of_faces; ++i) {
+                const int old_index = grid.face_neighbors[i];
+                if (old_index != -1) {
+                    grid.face_neighbors[i] = old_to_new_index[old_index];
+                    removed_neighbor[i] = (grid.face_neighbors[i] == -1);
+                }
+            }
 
+            grid.number_of_cells = num_kept;
+            return removed_neighbor;
+        }
 
 
 
-        /*
 
-        // NOTE: This function has been commented out as it is not in use, and therefore
-        //       generates warnings. It has not been deleted, as it should eventually be
-        //       used, what is missing is thorough testing of the method.
 
+        /// Removes the nodes that are not reachable from a cell. Used
+        /// after removeSlabHaloRows().
         void removeUnusedNodes(processed_grid& grid)
         {
             // Nodes are considered unused if they are unreachable from a cell.
@@ -950,7 +1452,7 @@ namespace cpgrid
             for (int face = 0; face < grid.number_of_faces; ++face) {
                 if (grid.face_neighbors[2*face] != -1 || grid.face_neighbors[2*face + 1] != -1) {
                     // Face is reachable
-                    for (int ii = grid.face_node_ptr[face]; ii < grid.face_node_ptr[face + 1]; ++ii) {
+                    for (unsigned ii = grid.face_node_ptr[face]; ii < grid.face_node_ptr[face + 1]; ++ii) {
                         int node = grid.face_nodes[ii];
                         old_to_new[node] = 0;
                     }
@@ -967,7 +1469,7 @@ namespace cpgrid
             }
 
             //   2. Use old_to_new to transform grid.face_nodes and grid.node_coordinates[].
-            for (int fnode = 0; fnode < grid.face_node_ptr[grid.number_of_faces]; ++fnode) {
+            for (unsigned fnode = 0; fnode < grid.face_node_ptr[grid.number_of_faces]; ++fnode) {
                 int old = grid.face_nodes[fnode];
                 grid.face_nodes[fnode] = old_to_new[old];
             }
@@ -984,7 +1486,47 @@ namespace cpgrid
             //   3. Set grid.number_of_nodes.
             grid.number_of_nodes = nodecount;
         }
-        */
+
+
+#if HAVE_MPI
+        /// Sends one buffer to each process in send_ranks and receives
+        /// one buffer from each process in recv_ranks.
+        template <class T>
+        std::vector<std::vector<T>>
+        exchangeWithNeighbors(const cpgrid::CpGridData::Communication& cc,
+                              const std::vector<int>& send_ranks,
+                              const std::vector<std::vector<T>>& send_buffers,
+                              const std::vector<int>& recv_ranks,
+                              int tag)
+        {
+            // communicate number of entries
+            std::vector<int> recv_sizes(recv_ranks.size());
+            std::vector<MPI_Request> requests(recv_ranks.size());
+            for (std::size_t i = 0; i < recv_ranks.size(); ++i) {
+                MPI_Irecv(&recv_sizes[i], 1, MPI_INT, recv_ranks[i], tag, cc, &requests[i]);
+            }
+            for (std::size_t i = 0; i < send_ranks.size(); ++i) {
+                int size = send_buffers[i].size();
+                MPI_Send(&size, 1, MPI_INT, send_ranks[i], tag, cc);
+            }
+            std::vector<MPI_Status> statuses(requests.size());
+            MPI_Waitall(requests.size(), requests.data(), statuses.data());
+
+            // communicate entries
+            ++tag;
+            const auto mpiType = MPITraits<T>::getType();
+            std::vector<std::vector<T>> recv_buffers(recv_ranks.size());
+            for (std::size_t i = 0; i < recv_ranks.size(); ++i) {
+                recv_buffers[i].resize(recv_sizes[i]);
+                MPI_Irecv(recv_buffers[i].data(), recv_sizes[i], mpiType, recv_ranks[i], tag, cc, &requests[i]);
+            }
+            for (std::size_t i = 0; i < send_ranks.size(); ++i) {
+                MPI_Send(send_buffers[i].data(), send_buffers[i].size(), mpiType, send_ranks[i], tag, cc);
+            }
+            MPI_Waitall(requests.size(), requests.data(), statuses.data());
+            return recv_buffers;
+        }
+#endif
 
 
 
@@ -1246,19 +1788,21 @@ namespace cpgrid
 #endif
         }
 
-        /// Encapsulate a vector<T>, and a permutation array used for access.
+        /// Encapsulate the node coordinates of a processed_grid, and a
+        /// permutation array used for access.
         template <typename T>
-        class IndirectArray
+        class IndirectPoints
         {
         public:
-            IndirectArray(const std::vector<T>& data, const int* beg, const int* end)
-                : data_(data), beg_(beg), end_(end)
+            IndirectPoints(const double* coords, const int* beg, const int* end)
+                : coords_(coords), beg_(beg), end_(end)
             {
             }
-            const T& operator[](int index) const
+            T operator[](int index) const
             {
                 assert(index >= 0 && index < size());
-                return data_[beg_[index]];
+                const double* c = coords_ + 3*beg_[index];
+                return T { c[0], c[1], c[2] };
             }
             int size() const
             {
@@ -1266,51 +1810,12 @@ namespace cpgrid
             }
             typedef T value_type;
         private:
-            const std::vector<T>& data_;
+            const double* coords_;
             const int* beg_;
             const int* end_;
         };
 
 
-        // Helper template for making Geometry objects.
-        // The generic one is suitable for dim == 0 (vertices).
-        template <int dim>
-        struct MakeGeometry
-        {
-            cpgrid::Geometry<dim, 3> operator()(const FieldVector<double, 3>& pos)
-            {
-                return cpgrid::Geometry<dim, 3>(pos);
-            }
-        };
-
-        // Specialization for cells.
-        template <>
-        struct MakeGeometry<3>
-        {
-            std::shared_ptr<const cpgrid::EntityVariable<cpgrid::Geometry<0, 3>, 3>> allcorners_;
-            explicit MakeGeometry(std::shared_ptr<const cpgrid::EntityVariable<cpgrid::Geometry<0, 3>, 3>> allcorners)
-                : allcorners_(std::move(allcorners))
-            {
-            }
-            cpgrid::Geometry<3, 3> operator()(const FieldVector<double, 3>& pos,
-                                                      double vol,
-                                                      const std::array<int,8>& corner_indices)
-            {
-                return cpgrid::Geometry<3, 3>(pos, vol, allcorners_, &corner_indices[0]);
-            }
-        };
-
-        // Specialization for intersections.
-        template <>
-        struct MakeGeometry<2>
-        {
-            cpgrid::Geometry<2, 3> operator()(const FieldVector<double, 3>& pos, double vol)
-            {
-                return cpgrid::Geometry<2, 3>(pos, vol);
-            }
-        };
-
-
 
         void buildGeom(const processed_grid& output,
                        const cpgrid::OrientedEntityTable<0, 1>& c2f,
@@ -1321,49 +1826,50 @@ namespace cpgrid
                        cpgrid::EntityVariable<cpgrid::Geometry<2, 3>, 1>& face_geom,
                        std::shared_ptr<cpgrid::EntityVariable<cpgrid::Geometry<0, 3>, 3>> point_geom_ptr,
                        cpgrid::SignedEntityVariable<FieldVector<double, 3>, 1>& normals,
-                       bool turn_normals)
+                       bool turn_normals,
+                       Opm::SetupProfile* profile)
         {
             typedef FieldVector<double, 3> point_t;
-            std::vector<point_t> points;
-            std::vector<point_t> face_normals;
-            std::vector<point_t> face_centroids;
-            std::vector<double>  face_areas;
-            std::vector<point_t> cell_centroids;
-            std::vector<double>  cell_volumes;
             auto& point_geom = *point_geom_ptr;
             using namespace GeometryHelpers;
-#ifdef VERBOSE
-            Opm::time::StopWatch clock;
-            clock.start();
-#endif
+            // All geometry containers are sized up front, and every
+            // loop below writes its own entries directly, so the loops
+            // are safe to run concurrently.
+            const int np = output.number_of_nodes;
+            const int nf = face_to_output_face.size();
+            const int nc = output.number_of_cells;
+            const double* coords = output.node_coordinates;
+
+            point_geom.resize(np);
+            face_geom.resize(nf);
+            normals.resize(nf);
+            cell_geom.resize(nc);
+
             // Get the points.
-            int np = output.number_of_nodes;
-            points.clear();
-            points.reserve(np);
+            Opm::SetupProfile::Scope points_scope(profile, "points");
+            auto* points = point_geom.data();
+#ifdef _OPENMP
+#pragma omp parallel for
+#endif
             for (int i = 0; i < np; ++i) {
-                // \TODO add a convenience explicit constructor
-                // for FieldVector taking an iterator.
-                point_t pt;
-                for (int dd = 0; dd < 3; ++dd) {
-                    pt[dd] = output.node_coordinates[3*i + dd];
-                }
-                points.push_back(pt);
+                points[i] = cpgrid::Geometry<0, 3>(point_t { coords[3*i + 0],
+                                                             coords[3*i + 1],
+                                                             coords[3*i + 2] });
             }
-#ifdef VERBOSE
-            std::cout << "Points:             " << clock.secsSinceLast() << std::endl;
-#endif
+            points_scope.close();
 
             // Get the face data.
-            // \TODO Both the face and (especially) the cell section
-            // is not very efficient. It could be rewritten easily
-            // (focus on the polygonCellXXX methods first).
             // \TODO Use exact geometry instead of these approximations.
-            int nf = face_to_output_face.size();
+            Opm::SetupProfile::Scope faces_scope(profile, "faces");
             const int* fn = output.face_nodes;
             const unsigned* fp = output.face_node_ptr;
+            auto* faces = face_geom.data();
+            auto* face_normals = normals.data();
+            const double normal_sign = turn_normals ? -1.0 : 1.0;
+#ifdef _OPENMP
+#pragma omp parallel for schedule(static)
+#endif
             for (int face = 0; face < nf; ++face) {
-                // Computations in this loop could be speeded up
-                // by doing more of them simultaneously.
                 int output_face = face_to_output_face[face];
                 if (output_face == cpgrid::NNCFace) {
                     // NNC faces are purely topological constructs,
@@ -1373,37 +1879,50 @@ namespace cpgrid
                     // for the cell-centered FV discretization (because
                     // it wants to deal with velocities rather than fluxes),
                     // we have to set the areas to 1 to avoid trouble.
-                    face_normals.push_back({-1e100, -1e100, -1e100});
-                    face_centroids.push_back({-1e100, -1e100, -1e100});
-                    face_areas.push_back(1.0);
+                    face_normals[face] = point_t { -1e100, -1e100, -1e100 };
+                    face_normals[face] *= normal_sign;
+                    faces[face] = cpgrid::Geometry<2, 3>(point_t { -1e100, -1e100, -1e100 }, 1.0);
                 } else {
-                    IndirectArray<point_t> face_pts(points, fn + fp[output_face], fn + fp[output_face+1]);
+                    IndirectPoints<point_t> face_pts(coords, fn + fp[output_face], fn + fp[output_face+1]);
                     point_t avg = average(face_pts);
                     point_t centroid = polygonCentroid(face_pts, avg);
                     point_t normal = polygonNormal(face_pts, centroid);
                     double area = polygonArea(face_pts, centroid);
-                    face_normals.push_back(normal);
-                    face_centroids.push_back(centroid);
-                    face_areas.push_back(area);
+                    normal *= normal_sign;
+                    face_normals[face] = normal;
+                    faces[face] = cpgrid::Geometry<2, 3>(centroid, area);
                 }
             }
-#ifdef VERBOSE
-            std::cout << "Faces:              " << clock.secsSinceLast() << std::endl;
-#endif
+            faces_scope.close();
+
             // Get the cell data.
-            int nc = output.number_of_cells;
-            std::vector<int> face_indices;
+            Opm::SetupProfile::Scope cells_scope(profile, "cells");
+            auto* cells = cell_geom.data();
+            std::shared_ptr<const cpgrid::EntityVariable<cpgrid::Geometry<0, 3>, 3>> allcorners = point_geom_ptr;
+#ifdef _OPENMP
+#pragma omp parallel for schedule(static)
+#endif
             for (int cell = 0; cell < nc; ++cell) {
                 cpgrid::EntityRep<0> cell_ent(cell, true);
                 cpgrid::OrientedEntityTable<0, 1>::row_type cf = c2f[cell_ent];
-                face_indices.clear();
+
+                // Average of the centroids of all non-NNC faces.
+                point_t cell_avg(0.0);
+                int num_geom_faces = 0;
                 for (int local_index = 0; local_index < cf.size(); ++local_index) {
-                    if (face_to_output_face[cf[local_index].index()] != cpgrid::NNCFace) {
-                        face_indices.push_back(cf[local_index].index());
+                    int face = cf[local_index].index();
+                    if (face_to_output_face[face] != cpgrid::NNCFace) {
+                        if (num_geom_faces == 0) {
+                            cell_avg = faces[face].center();
+                        } else {
+                            cell_avg += faces[face].center();
+                        }
+                        ++num_geom_faces;
                     }
                 }
-                IndirectArray<point_t> cell_pts(face_centroids, &face_indices[0], &face_indices[0] + face_indices.size());
-                point_t cell_avg = average(cell_pts);
+                assert(num_geom_faces > 0);
+                cell_avg /= double(num_geom_faces);
+
                 point_t cell_centroid(0.0);
                 double tot_cell_vol = 0.0;
                 for (int local_index = 0; local_index < cf.size(); ++local_index) {
@@ -1413,10 +1932,11 @@ namespace cpgrid
                         // Skip NNC face, do not contribute to cell geometry.
                         continue;
                     }
-                    IndirectArray<point_t> face_pts(points, fn + fp[output_face], fn + fp[output_face+1]);
-                    double small_vol = polygonCellVolume(face_pts, face_centroids[face], cell_avg);
+                    IndirectPoints<point_t> face_pts(coords, fn + fp[output_face], fn + fp[output_face+1]);
+                    const point_t& face_centroid = faces[face].center();
+                    double small_vol = polygonCellVolume(face_pts, face_centroid, cell_avg);
                     tot_cell_vol += small_vol;
-                    point_t face_contrib = polygonCellCentroid(face_pts, face_centroids[face], cell_avg);
+                    point_t face_contrib = polygonCellCentroid(face_pts, face_centroid, cell_avg);
                     face_contrib *= small_vol;
                     cell_centroid += face_contrib;
                 }
@@ -1428,64 +1948,20 @@ namespace cpgrid
 // #define HACK_CELL_CENTROIDS     // when this is defined, you get the average of top and bottom face centroids.
 #ifdef HACK_CELL_CENTROIDS
                 int numf = cf.size();
-                cell_centroid = face_centroids[face_indices[numf - 2]];
-                cell_centroid += face_centroids[face_indices[numf - 1]];
+                cell_centroid = faces[cf[numf - 2].index()].center();
+                cell_centroid += faces[cf[numf - 1].index()].center();
                 cell_centroid *= 0.5;
 #endif
-                cell_centroids.push_back(cell_centroid);
-                cell_volumes.push_back(tot_cell_vol);
-            }
-            // update the volumes of numerical aquifer cells
-            for (const auto& [index, volume] : aquifer_cell_volumes) {
-                cell_volumes[index] = volume;
-            }
-
-
-
-#ifdef VERBOSE
-            std::cout << "Cells:              " << clock.secsSinceLast() << std::endl;
-#endif
-
-
-            // \TODO Fix the code below , as it is:
-            // A) wasteful
-            // B) wordy,
-            // C) slow
-            // D) copied from readSintefLegacyFormat.cpp
-            // Points
-            // Points
-            point_geom.reserve(points.size());
-            MakeGeometry<0> mpointg;
-            std::ranges::transform(points, std::back_inserter(point_geom), mpointg);
-            // Cells
-            cell_geom.reserve(nc);
-            MakeGeometry<3> mcellg(point_geom_ptr);
-//             std::transform(cell_centroids.begin(), cell_centroids.end(),
-//                            cell_volumes.begin(),
-//                            std::back_inserter(cell_geom, mcellg);
-            for (int c = 0;  c < nc; ++c) {
-                cell_geom.push_back(mcellg(cell_centroids[c], cell_volumes[c], c2p[c]));
-            }
-            // Faces
-            face_geom.reserve(face_centroids.size());
-            MakeGeometry<2> mfaceg;
-            std::ranges::transform(face_centroids, face_areas,
-                                   std::back_inserter(face_geom), mfaceg);
-#ifdef VERBOSE
-            std::cout << "Transforms/copies:  " << clock.secsSinceLast() << std::endl;
-#endif
-
-            // The final, combined object (yes, a lot of copying goes on here).
-            if (turn_normals) {
-                int num_normals = face_normals.size();
-                for (int i = 0; i < num_normals; ++i) {
-                    face_normals[i] *= -1.0;
+                // update the volumes of numerical aquifer cells
+                if (!aquifer_cell_volumes.empty()) {
+                    const auto aquifer_volume = aquifer_cell_volumes.find(cell);
+                    if (aquifer_volume != aquifer_cell_volumes.end()) {
+                        tot_cell_vol = aquifer_volume->second;
+                    }
                 }
+                cells[cell] = cpgrid::Geometry<3, 3>(cell_centroid, tot_cell_vol,
+                                                     allcorners, c2p[cell].data());
             }
-            normals.assign(face_normals.begin(), face_normals.end());
-#ifdef VERBOSE
-            std::cout << "Final construction: " << clock.secsSinceLast() << std::endl;
-#endif
         }
     } // anon namespace
 } // namespace Dune
@@ -1,8 +1,9 @@
-#include <opm/common/utility/numeric/blas_lapack.h>
 #include <opm/grid/transmissibility/trans_tpfa.h>
 #include <opm/grid/GridHelpers.hpp>
 
+#include <cassert>
 #include <cmath>
+#include <vector>
 
 namespace Dune
 {
@@ -15,35 +16,116 @@ namespace UgGridHelpers
 {
 int dimensions(const Dune::CpGrid&);
 
-double faceArea(const Dune::CpGrid&, int);
+const double* faceAreas(const Dune::CpGrid&);
 }
 }
 
 namespace
 {
-inline const double* multiplyFaceNormalWithArea(const Dune::CpGrid& grid, int face_index, const double* in)
+// The face normals of CpGrid have unit length, so they are scaled by the
+// face areas. Those of UnstructuredGrid already are.
+inline const double* faceAreasForNormals(const Dune::CpGrid& grid)
 {
-    int d=Opm::UgGridHelpers::dimensions(grid);
-    double* out=new double[d];
-    double area=Opm::UgGridHelpers::faceArea(grid, face_index);
+    return Opm::UgGridHelpers::faceAreas(grid);
+}
+
+inline const double* faceAreasForNormals(const UnstructuredGrid&)
+{
+    return nullptr;
+}
 
-    for(int i=0;i<d;++i)
-        out[i]=in[i]*area;
-    return out;
+/* Index of the first half-face of each cell, with one additional entry
+ * holding the total number of half-faces. */
+template<class Grid>
+std::vector<int> halfFaceOffsets(const Grid& G)
+{
+    using namespace Opm::UgGridHelpers;
+    const int nc = numCells(G);
+    std::vector<int> offsets(nc + 1, 0);
+    const auto c2f = cell2Faces(G);
+    for (int c = 0; c < nc; ++c) {
+        const auto faces = c2f[c];
+        offsets[c + 1] = offsets[c] + static_cast<int>(faces.end() - faces.begin());
+    }
+    return offsets;
 }
 
-inline void maybeFreeFaceNormal(const Dune::CpGrid&, const double* array)
+/* The half-faces of each face, at 2*f for the first cell of the face and
+ * at 2*f+1 for the second one, or -1 if there is no such half-face. Every
+ * entry is written by one cell only, hence the loop is parallel. */
+template<class Grid>
+std::vector<int> faceHalfFaces(const Grid& G, const std::vector<int>& offsets)
 {
-    delete[] array;
+    using namespace Opm::UgGridHelpers;
+    const int nc = numCells(G);
+    std::vector<int> half_faces(2 * numFaces(G), -1);
+    const auto c2f = cell2Faces(G);
+    const auto face_cells = faceCells(G);
+#ifdef _OPENMP
+#pragma omp parallel for schedule(static)
+#endif
+    for (int c = 0; c < nc; ++c) {
+        int i = offsets[c];
+        for (const int f : c2f[c]) {
+            half_faces[2 * f + (face_cells(f, 0) == c ? 0 : 1)] = i++;
+        }
+    }
+    return half_faces;
 }
 
-inline const double* multiplyFaceNormalWithArea(const UnstructuredGrid&, int, const double* in)
+/* |n' K (x_f - x_c)| / |x_f - x_c|^2 with K in column major order. */
+template<int dim>
+inline double halfTrans(const double* K, const double* n, double area,
+                        const double* fc, const double* cc)
 {
-    return in;
+    double Kn[dim];
+    for (int r = 0; r < dim; ++r) {
+        Kn[r] = 0.0;
+        for (int j = 0; j < dim; ++j) {
+            Kn[r] += K[r + j * dim] * n[j];
+        }
+    }
+    double num = 0.0, denom = 0.0;
+    for (int j = 0; j < dim; ++j) {
+        const double dist = fc[j] - cc[j];
+        num   += dist * Kn[j];
+        denom += dist * dist;
+    }
+    assert (denom > 0);
+    return std::abs(area * num / denom);
 }
 
-inline void maybeFreeFaceNormal(const UnstructuredGrid&, const double*)
-{}
+template<int dim, class Grid>
+void
+tpfa_htrans_compute_dim(const Grid& G, const double* perm, double* htrans)
+{
+    using namespace Opm::UgGridHelpers;
+    const int nc = numCells(G);
+    if (nc == 0) {
+        return;
+    }
+    // Cell and face geometry is stored contiguously for both grid types.
+    const double* cell_centroids = cellCentroid(G, 0);
+    const double* face_centroids = &(faceCentroid(G, 0)[0]);
+    const double* face_normals   = faceNormal(G, 0);
+    const double* face_areas     = faceAreasForNormals(G);
+    const auto offsets = halfFaceOffsets(G);
+    const auto c2f = cell2Faces(G);
+
+#ifdef _OPENMP
+#pragma omp parallel for schedule(static)
+#endif
+    for (int c = 0; c < nc; ++c) {
+        const double* K  = perm + c * dim * dim;
+        const double* cc = cell_centroids + c * dim;
+        int i = offsets[c];
+        for (const int f : c2f[c]) {
+            const double area = face_areas ? face_areas[f] : 1.0;
+            htrans[i++] = halfTrans<dim>(K, face_normals + f * dim, area,
+                                         face_centroids + f * dim, cc);
+        }
+    }
+}
 }
 
 /* ---------------------------------------------------------------------- */
@@ -55,57 +137,16 @@ tpfa_htrans_compute(const Grid* G, const double *perm, double *htrans)
 /* ---------------------------------------------------------------------- */
 {
     using namespace Opm::UgGridHelpers;
-    int    d, j;
-    double s, dist, denom;
-
-    double Kn[3];
-    typename CellCentroidTraits<Grid>::IteratorType cc = beginCellCentroids(*G);
-    typename Cell2FacesTraits<Grid>::Type c2f = cell2Faces(*G);
-    typename FaceCellTraits<Grid>::Type face_cells = faceCells(*G);
-
-    const double *n;
-    const double *K;
 
-    MAT_SIZE_T nrows, ncols, ldA, incx, incy;
-    double a1, a2;
-
-    d = dimensions(*G);
-
-    nrows = ncols    = ldA = d;
-    incx  = incy     = 1      ;
-    a1    = 1.0;  a2 = 0.0    ;
-
-    for (int c =0, i = 0; c < numCells(*G); c++) {
-        K  = perm + (c * d * d);
-
-        typedef typename Cell2FacesTraits<Grid>::Type::row_type FaceRow;
-        FaceRow faces = c2f[c];
-
-        for(typename FaceRow::const_iterator f=faces.begin(), end=faces.end();
-            f!=end; ++f, ++i)
-        {
-            s = 2.0*(face_cells(*f, 0) == c) - 1.0;
-            n = faceNormal(*G, *f);
-            const double* nn=multiplyFaceNormalWithArea(*G, *f, n);
-            const double* fc = &(faceCentroid(*G, *f)[0]);
-            dgemv_("No Transpose", &nrows, &ncols,
-                   &a1, K, &ldA, nn, &incx, &a2, &Kn[0], &incy);
-            maybeFreeFaceNormal(*G, nn);
-
-            htrans[i] = denom = 0.0;
-            for (j = 0; j < d; j++) {
-                dist = fc[j] - getCoordinate(cc, j);
-
-                htrans[i] += s * dist * Kn[j];
-                denom     +=     dist * dist;
-            }
-
-            assert (denom > 0);
-            htrans[i] /= denom;
-            htrans[i]  = std::abs(htrans[i]);
-        }
-        // Move to next cell centroid.
-        cc = increment(cc, 1, d);
+    switch (dimensions(*G)) {
+    case 2:
+        tpfa_htrans_compute_dim<2>(*G, perm, htrans);
+        break;
+    case 3:
+        tpfa_htrans_compute_dim<3>(*G, perm, htrans);
+        break;
+    default:
+        assert (false);
     }
 }
 
@@ -118,25 +159,21 @@ tpfa_trans_compute(const Grid* G, const double *htrans, double *trans)
 {
     using namespace Opm::UgGridHelpers;
 
-    for (int f = 0; f < numFaces(*G); f++) {
-        trans[f] = 0.0;
-    }
-
-    typename Cell2FacesTraits<Grid>::Type c2f = cell2Faces(*G);
-
-    for (int c = 0, i = 0; c < numCells(*G); c++) {
-        typedef typename Cell2FacesTraits<Grid>::Type::row_type FaceRow;
-        FaceRow faces = c2f[c];
-
-        for(typename FaceRow::const_iterator f=faces.begin(), end=faces.end();
-            f!=end; ++f, ++i)
-        {
-            trans[*f] += 1.0 / htrans[i];
+    const auto half_faces = faceHalfFaces(*G, halfFaceOffsets(*G));
+    const int nf = numFaces(*G);
+
+#ifdef _OPENMP
+#pragma omp parallel for schedule(static)
+#endif
+    for (int f = 0; f < nf; f++) {
+        double t = 0.0;
+        for (int side = 0; side < 2; ++side) {
+            const int i = half_faces[2 * f + side];
+            if (i >= 0) {
+                t += 1.0 / htrans[i];
+            }
         }
-    }
-
-    for (int f = 0; f < numFaces(*G); f++) {
-        trans[f] = 1.0 / trans[f];
+        trans[f] = 1.0 / t;
     }
 }
 
@@ -152,24 +189,21 @@ tpfa_eff_trans_compute(const Grid*        G,
 {
     using namespace Opm::UgGridHelpers;
 
-    for (int f = 0; f < numFaces(*G); f++) {
-        trans[f] = 0.0;
-    }
-
-    typename Cell2FacesTraits<Grid>::Type c2f = cell2Faces(*G);
-
-    for (int c = 0, i = 0; c < numCells(*G); c++) {
-        typedef typename Cell2FacesTraits<Grid>::Type::row_type FaceRow;
-        FaceRow faces = c2f[c];
-
-        for(typename FaceRow::const_iterator f=faces.begin(), end=faces.end();
-            f!=end; ++f, ++i)
-        {
-            trans[*f] += 1.0 / (totmob[c] * htrans[i]);
+    const auto half_faces = faceHalfFaces(*G, halfFaceOffsets(*G));
+    const auto face_cells = faceCells(*G);
+    const int nf = numFaces(*G);
+
+#ifdef _OPENMP
+#pragma omp parallel for schedule(static)
+#endif
+    for (int f = 0; f < nf; f++) {
+        double t = 0.0;
+        for (int side = 0; side < 2; ++side) {
+            const int i = half_faces[2 * f + side];
+            if (i >= 0) {
+                t += 1.0 / (totmob[face_cells(f, side)] * htrans[i]);
+            }
         }
-    }
-
-             for (int f = 0; f < numFaces(*G); f++) {
-        trans[f] = 1.0 / trans[f];
+        trans[f] = 1.0 / t;
     }
 }
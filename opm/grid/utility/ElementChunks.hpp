@@ -23,6 +23,8 @@
 
 #include <cstddef>
 #include <iterator>
+#include <memory>
+#include <new>
 #include <utility>
 #include <vector>
 
@@ -127,6 +129,40 @@ private:
 };
 
 
+/// Allocator that default-initialises instead of value-initialising
+/// the elements it constructs without arguments. A vector of a
+/// trivial type using it is left uninitialised by resize(), so its
+/// memory is first touched by whichever thread assigns the values.
+template <class T>
+struct DefaultInitAllocator : public std::allocator<T>
+{
+    template <class U>
+    struct rebind
+    {
+        using other = DefaultInitAllocator<U>;
+    };
+
+    DefaultInitAllocator() = default;
+    template <class U>
+    DefaultInitAllocator(const DefaultInitAllocator<U>&) noexcept {}
+
+    template <class U>
+    void construct(U* p)
+    {
+        ::new (static_cast<void*>(p)) U;
+    }
+    template <class U, class... Args>
+    void construct(U* p, Args&&... args)
+    {
+        ::new (static_cast<void*>(p)) U(std::forward<Args>(args)...);
+    }
+};
+
+/// Vector to be initialised in parallel, for example by
+/// ElementChunks<CpGrid::LeafGridView, ...>::firstTouch().
+template <class T>
+using FirstTouchVector = std::vector<T, DefaultInitAllocator<T>>;
+
 } // namespace Opm
 
 #endif // OPM_ELEMENT_CHUNKS_HEADER
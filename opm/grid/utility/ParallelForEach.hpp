@@ -0,0 +1,442 @@
+/*
+  Copyright 2025 Equinor ASA.
+
+  This file is part of the Open Porous Media project (OPM).
+
+  OPM is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  OPM is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with OPM.  If not, see <http://www.gnu.org/licenses/>.
+*/
+#ifndef OPM_PARALLEL_FOR_EACH_HEADER
+#define OPM_PARALLEL_FOR_EACH_HEADER
+
+#include <opm/grid/GridHelpers.hpp>
+#include <opm/grid/cpgrid/GridHelpers.hpp>
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <exception>
+#include <mutex>
+#include <numeric>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
+namespace Opm
+{
+
+namespace Impl
+{
+
+/// The blocks [head, tail) left to a thread, packed into one word
+/// so that the owner and thieves update them with a single CAS.
+struct alignas(64) BlockRange
+{
+    static std::uint64_t pack(std::uint32_t head, std::uint32_t tail)
+    {
+        return (std::uint64_t(head) << 32) | tail;
+    }
+    static std::uint32_t head(std::uint64_t range) { return range >> 32; }
+    static std::uint32_t tail(std::uint64_t range) { return range & 0xffffffffu; }
+
+    /// Takes the first block, returns -1 if there is none.
+    int pop()
+    {
+        auto range = blocks.load(std::memory_order_relaxed);
+        while (head(range) < tail(range)) {
+            if (blocks.compare_exchange_weak(range, pack(head(range) + 1, tail(range)))) {
+                return head(range);
+            }
+        }
+        return -1;
+    }
+
+    /// Takes the last half of the blocks, returns an empty range if there is none.
+    std::pair<int, int> steal()
+    {
+        auto range = blocks.load(std::memory_order_relaxed);
+        while (head(range) < tail(range)) {
+            const std::uint32_t middle = tail(range) - (tail(range) - head(range) + 1) / 2;
+            if (blocks.compare_exchange_weak(range, pack(head(range), middle))) {
+                return {static_cast<int>(middle), static_cast<int>(tail(range))};
+            }
+        }
+        return {0, 0};
+    }
+
+    int size() const
+    {
+        const auto range = blocks.load(std::memory_order_relaxed);
+        return head(range) < tail(range) ? tail(range) - head(range) : 0;
+    }
+
+    std::atomic<std::uint64_t> blocks{0};
+};
+
+} // namespace Impl
+
+/// Calls body(i) for every i in [0, num_indices) from the threads of
+/// an OpenMP parallel region.
+///
+/// The indices are split into blocks of block_size consecutive
+/// indices. Each thread starts with an equal share of consecutive
+/// blocks, which it processes in order. A thread that runs out of
+/// blocks steals the last half of the blocks left to the thread with
+/// the most, so threads stay busy when the cost per index varies.
+/// Calls of body for different indices may run concurrently, and if
+/// body throws, the remaining blocks are skipped and the first
+/// exception is rethrown. Called from within a parallel region, or
+/// without OpenMP, the indices are processed in order by the calling
+/// thread.
+template <class Body>
+void parallelForEachIndex(const int num_indices, Body&& body, const int block_size = 64)
+{
+    if (block_size < 1) {
+        throw std::logic_error("parallelForEachIndex() needs a positive block size.");
+    }
+    const int num_blocks = num_indices > 0 ? (num_indices - 1) / block_size + 1 : 0;
+    const auto run_block = [&](const int block) {
+        const int end = std::min(num_indices, (block + 1) * block_size);
+        for (int i = block * block_size; i < end; ++i) {
+            body(i);
+        }
+    };
+#ifdef _OPENMP
+    const int max_threads = std::min(omp_get_max_threads(), num_blocks);
+    if (max_threads > 1 && !omp_in_parallel()) {
+        std::vector<Impl::BlockRange> ranges(max_threads);
+        std::atomic<bool> failed{false};
+        std::exception_ptr exception;
+        std::mutex exception_mutex;
+#pragma omp parallel num_threads(max_threads)
+        {
+            const int num_threads = omp_get_num_threads();
+            const int thread = omp_get_thread_num();
+            const auto share = [&](int t) {
+                return static_cast<std::uint32_t>((std::int64_t(num_blocks) * t) / num_threads);
+            };
+            ranges[thread].blocks.store(Impl::BlockRange::pack(share(thread), share(thread + 1)));
+#pragma omp barrier
+            try {
+                auto& own = ranges[thread];
+                while (!failed.load(std::memory_order_relaxed)) {
+                    const int block = own.pop();
+                    if (block >= 0) {
+                        run_block(block);
+                        continue;
+                    }
+                    // Steal from the thread with the most blocks left.
+                    std::pair<int, int> stolen{0, 0};
+                    while (stolen.first == stolen.second) {
+                        int victim = -1;
+                        int most = 0;
+                        for (int t = 0; t < num_threads; ++t) {
+                            const int left = ranges[t].size();
+                            if (left > most) {
+                                most = left;
+                                victim = t;
+                            }
+                        }
+                        if (victim < 0) {
+                            break;
+                        }
+                        stolen = ranges[victim].steal();
+                    }
+                    if (stolen.first == stolen.second) {
+                        break;
+                    }
+                    // Run the first stolen block and leave the others to be stolen back.
+                    own.blocks.store(Impl::BlockRange::pack(stolen.first + 1, stolen.second));
+                    run_block(stolen.first);
+                }
+            }
+            catch (...) {
+                const std::lock_guard lock(exception_mutex);
+                if (!exception) {
+                    exception = std::current_exception();
+                }
+                failed = true;
+            }
+        }
+        if (exception) {
+            std::rethrow_exception(exception);
+        }
+        return;
+    }
+#endif
+    for (int block = 0; block < num_blocks; ++block) {
+        run_block(block);
+    }
+}
+
+/// Computes combine(...combine(combine(init, map(0)), map(1))..., map(num_indices - 1))
+/// in parallel, with the bracketing fixed by the blocks of block_size indices.
+///
+/// The partial results of the blocks are combined in block order, so
+/// the result does not depend on the number of threads or on which
+/// thread processed a block, even if combine is not associative, as
+/// for sums of floating-point numbers.
+template <class T, class Map, class Combine>
+T parallelTransformReduce(const int num_indices, T init, Map&& map, Combine&& combine,
+                          const int block_size = 64)
+{
+    if (block_size < 1) {
+        throw std::logic_error("parallelTransformReduce() needs a positive block size.");
+    }
+    const int num_blocks = num_indices > 0 ? (num_indices - 1) / block_size + 1 : 0;
+    std::vector<T> partial(num_blocks, init);
+    parallelForEachIndex(num_blocks, [&](const int block) {
+        const int end = std::min(num_indices, (block + 1) * block_size);
+        T result = map(block * block_size);
+        for (int i = block * block_size + 1; i < end; ++i) {
+            result = combine(std::move(result), map(i));
+        }
+        partial[block] = std::move(result);
+    }, 1);
+    for (auto& result : partial) {
+        init = combine(std::move(init), std::move(result));
+    }
+    return init;
+}
+
+/// Parallel loops over the cells, intersections and faces of the leaf
+/// view of a CpGrid or PolyhedralGrid, scheduled by parallelForEachIndex().
+///
+/// The faces are those of the UgGridHelpers interface, and a face is
+/// passed to the user function with its index and those of its two
+/// cells, where -1 stands for no cell on a boundary.
+///
+/// With colour_cells set, the cells are coloured such that cells
+/// sharing a face or a neighbour get different colours. Then
+/// forEachFaceColoured() handles one colour at a time, each face with
+/// the first cell it has, so concurrent calls never share a cell and
+/// can add to the data of both cells without atomics:
+///
+/// ParallelGridLoop loop(grid.leafGridView(), true);
+/// loop.forEachFaceColoured([&](int face, int c0, int c1) {
+///     const double flux = ...;
+///     if (c0 >= 0) residual[c0] += flux;
+///     if (c1 >= 0) residual[c1] -= flux;
+/// });
+template <class GridView>
+class ParallelGridLoop
+{
+public:
+    using Element = typename GridView::template Codim<0>::Entity;
+    using ElementSeed = typename Element::EntitySeed;
+
+    explicit ParallelGridLoop(const GridView& gv,
+                              const bool colour_cells = false,
+                              const int block_size = 64)
+        : gv_(gv)
+        , block_size_(block_size)
+    {
+        seeds_.resize(gv.size(0));
+        const auto& index_set = gv.indexSet();
+        for (const auto& elem : elements(gv)) {
+            seeds_[index_set.index(elem)] = elem.seed();
+        }
+
+        const auto& grid = gv.grid();
+        const int num_faces = UgGridHelpers::numFaces(grid);
+        const auto face_cells = UgGridHelpers::faceCells(grid);
+        face_cells_.resize(num_faces);
+        for (int face = 0; face < num_faces; ++face) {
+            face_cells_[face] = {face_cells(face, 0), face_cells(face, 1)};
+        }
+
+        if (colour_cells) {
+            colourCells();
+        }
+    }
+
+    int numCells() const
+    {
+        return seeds_.size();
+    }
+
+    int numFaces() const
+    {
+        return face_cells_.size();
+    }
+
+    Element element(const int cell) const
+    {
+        return gv_.grid().entity(seeds_[cell]);
+    }
+
+    /// Calls f(element) for every cell.
+    template <class F>
+    void forEachCell(F&& f) const
+    {
+        parallelForEachIndex(numCells(), [&](const int cell) {
+            f(element(cell));
+        }, block_size_);
+    }
+
+    /// Calls f(element, intersection) for every intersection of every
+    /// cell, so interior faces are visited once from each side.
+    template <class F>
+    void forEachIntersection(F&& f) const
+    {
+        parallelForEachIndex(numCells(), [&](const int cell) {
+            const auto elem = element(cell);
+            for (const auto& intersection : intersections(gv_, elem)) {
+                f(elem, intersection);
+            }
+        }, block_size_);
+    }
+
+    /// Calls f(face, cell0, cell1) for every face. Faces sharing a
+    /// cell may be handled concurrently.
+    template <class F>
+    void forEachFace(F&& f) const
+    {
+        parallelForEachIndex(numFaces(), [&](const int face) {
+            f(face, face_cells_[face][0], face_cells_[face][1]);
+        }, block_size_);
+    }
+
+    /// Calls f(face, cell0, cell1) for every face, such that faces
+    /// sharing a cell are never handled concurrently. Each face is
+    /// handled by the same thread as the other faces of its first cell,
+    /// in increasing order. Needs the cells to have been coloured.
+    template <class F>
+    void forEachFaceColoured(F&& f) const
+    {
+        if (colour_start_.empty()) {
+            throw std::logic_error("ParallelGridLoop::forEachFaceColoured() needs coloured cells.");
+        }
+        for (int colour = 0; colour < numColours(); ++colour) {
+            const int first = colour_start_[colour];
+            parallelForEachIndex(colour_start_[colour + 1] - first, [&](const int i) {
+                const int cell = colour_cells_[first + i];
+                for (int j = owned_start_[cell]; j < owned_start_[cell + 1]; ++j) {
+                    const int face = owned_faces_[j];
+                    f(face, face_cells_[face][0], face_cells_[face][1]);
+                }
+            }, block_size_);
+        }
+    }
+
+    /// The result of combining init with map(element) for all cells
+    /// in index order, as explained for parallelTransformReduce().
+    template <class T, class Map, class Combine>
+    T transformReduceCells(T init, Map&& map, Combine&& combine) const
+    {
+        return parallelTransformReduce(numCells(), std::move(init),
+                                       [&](const int cell) { return map(element(cell)); },
+                                       std::forward<Combine>(combine), block_size_);
+    }
+
+    /// The number of colours, zero if the cells are not coloured.
+    int numColours() const
+    {
+        return colour_start_.empty() ? 0 : static_cast<int>(colour_start_.size()) - 1;
+    }
+
+    int cellColour(const int cell) const
+    {
+        return colour_[cell];
+    }
+
+private:
+    /// Greedy colouring in index order, with a cell getting the least
+    /// colour not used by the cells it shares a face or a neighbour with.
+    void colourCells()
+    {
+        const int num_cells = numCells();
+        // Neighbours and faces of each cell, the latter only those of
+        // which it is the first cell.
+        std::vector<int> neighbour_start(num_cells + 1, 0);
+        owned_start_.assign(num_cells + 1, 0);
+        for (const auto& cells : face_cells_) {
+            if (cells[0] >= 0 && cells[1] >= 0) {
+                ++neighbour_start[cells[0] + 1];
+                ++neighbour_start[cells[1] + 1];
+            }
+            ++owned_start_[(cells[0] >= 0 ? cells[0] : cells[1]) + 1];
+        }
+        std::partial_sum(neighbour_start.begin(), neighbour_start.end(), neighbour_start.begin());
+        std::partial_sum(owned_start_.begin(), owned_start_.end(), owned_start_.begin());
+        std::vector<int> neighbours(neighbour_start.back());
+        owned_faces_.resize(owned_start_.back());
+        {
+            auto next_neighbour = neighbour_start;
+            auto next_owned = owned_start_;
+            for (int face = 0; face < numFaces(); ++face) {
+                const auto& cells = face_cells_[face];
+                if (cells[0] >= 0 && cells[1] >= 0) {
+                    neighbours[next_neighbour[cells[0]]++] = cells[1];
+                    neighbours[next_neighbour[cells[1]]++] = cells[0];
+                }
+                owned_faces_[next_owned[cells[0] >= 0 ? cells[0] : cells[1]]++] = face;
+            }
+        }
+
+        colour_.assign(num_cells, -1);
+        std::vector<int> used_by;
+        int num_colours = 0;
+        const auto mark = [&](const int cell, const int by) {
+            if (colour_[cell] >= 0) {
+                used_by[colour_[cell]] = by;
+            }
+        };
+        for (int cell = 0; cell < num_cells; ++cell) {
+            used_by.resize(num_colours + 1, -1);
+            for (int j = neighbour_start[cell]; j < neighbour_start[cell + 1]; ++j) {
+                const int neighbour = neighbours[j];
+                mark(neighbour, cell);
+                for (int k = neighbour_start[neighbour]; k < neighbour_start[neighbour + 1]; ++k) {
+                    mark(neighbours[k], cell);
+                }
+            }
+            int colour = 0;
+            while (used_by[colour] == cell) {
+                ++colour;
+            }
+            colour_[cell] = colour;
+            num_colours = std::max(num_colours, colour + 1);
+        }
+
+        colour_start_.assign(num_colours + 1, 0);
+        for (const int colour : colour_) {
+            ++colour_start_[colour + 1];
+        }
+        std::partial_sum(colour_start_.begin(), colour_start_.end(), colour_start_.begin());
+        colour_cells_.resize(num_cells);
+        auto next = colour_start_;
+        for (int cell = 0; cell < num_cells; ++cell) {
+            colour_cells_[next[colour_[cell]]++] = cell;
+        }
+    }
+
+    GridView gv_;
+    int block_size_;
+    std::vector<ElementSeed> seeds_;
+    std::vector<std::array<int, 2>> face_cells_;
+    std::vector<int> colour_;
+    std::vector<int> colour_start_;
+    std::vector<int> colour_cells_;
+    std::vector<int> owned_start_;
+    std::vector<int> owned_faces_;
+};
+
+} // namespace Opm
+
+#endif // OPM_PARALLEL_FOR_EACH_HEADER
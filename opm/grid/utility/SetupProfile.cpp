@@ -0,0 +1,190 @@
+/*
+  Copyright 2025 Equinor ASA.
+
+  This file is part of the Open Porous Media project (OPM).
+
+  OPM is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  OPM is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with OPM.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#if HAVE_CONFIG_H
+#include "config.h"
+#endif
+#include <opm/grid/utility/SetupProfile.hpp>
+
+#include <cassert>
+#include <cstdlib>
+#include <iomanip>
+#include <ostream>
+
+#if defined(__unix__) || defined(__APPLE__)
+#include <sys/resource.h>
+#endif
+
+namespace Opm
+{
+
+    namespace
+    {
+        /// Peak resident set size of the process in kilobytes, 0 if unknown.
+        long peakRssKb()
+        {
+#if defined(__unix__) || defined(__APPLE__)
+            rusage usage;
+            if (getrusage(RUSAGE_SELF, &usage) == 0) {
+#ifdef __APPLE__
+                return usage.ru_maxrss / 1024;
+#else
+                return usage.ru_maxrss;
+#endif
+            }
+#endif
+            return 0;
+        }
+
+        void writeJsonString(std::ostream& os, const std::string& s)
+        {
+            os << '"';
+            for (const char c : s) {
+                if (c == '"' || c == '\\') {
+                    os << '\\';
+                }
+                os << c;
+            }
+            os << '"';
+        }
+    } // anonymous namespace
+
+
+    SetupProfile::Scope::Scope(SetupProfile* profile, const char* name)
+        : profile_(profile && profile->enabled() ? profile : nullptr)
+        , phase_(profile_ ? profile_->begin(name) : -1)
+    {
+    }
+
+    SetupProfile::Scope::~Scope()
+    {
+        close();
+    }
+
+    void SetupProfile::Scope::count(const char* what, long long n)
+    {
+        if (profile_) {
+            profile_->phases_[phase_].counts.emplace_back(what, n);
+        }
+    }
+
+    void SetupProfile::Scope::close()
+    {
+        if (profile_) {
+            profile_->end(phase_);
+            profile_ = nullptr;
+        }
+    }
+
+
+    SetupProfile::SetupProfile()
+        : enabled_(enabledByEnvironment())
+        , origin_(Clock::now())
+    {
+    }
+
+    bool SetupProfile::enabledByEnvironment()
+    {
+        const char* value = std::getenv("OPM_GRID_PROFILE");
+        return value != nullptr && value[0] != '\0' && std::string(value) != "0";
+    }
+
+    void SetupProfile::clear()
+    {
+        assert(open_.empty());
+        phases_.clear();
+    }
+
+    int SetupProfile::begin(const char* name)
+    {
+        Phase phase;
+        phase.name = name;
+        phase.parent = open_.empty() ? -1 : open_.back();
+        phase.depth = open_.size();
+        phase.start = secondsSinceOrigin();
+        phases_.push_back(std::move(phase));
+        open_.push_back(phases_.size() - 1);
+        open_peak_rss_kb_.push_back(peakRssKb());
+        return phases_.size() - 1;
+    }
+
+    void SetupProfile::end(int phase)
+    {
+        // Scopes are strictly nested.
+        assert(!open_.empty() && open_.back() == phase);
+        auto& p = phases_[phase];
+        p.seconds = secondsSinceOrigin() - p.start;
+        p.peak_rss_delta_kb = peakRssKb() - open_peak_rss_kb_.back();
+        open_.pop_back();
+        open_peak_rss_kb_.pop_back();
+    }
+
+    double SetupProfile::secondsSinceOrigin() const
+    {
+        return std::chrono::duration<double>(Clock::now() - origin_).count();
+    }
+
+    void SetupProfile::writeReport(std::ostream& os) const
+    {
+        const auto flags = os.flags();
+        const auto precision = os.precision();
+        os << std::left << std::setw(40) << "phase"
+           << std::right << std::setw(12) << "seconds"
+           << std::setw(16) << "peak RSS +MB" << "  counts\n";
+        for (const auto& phase : phases_) {
+            os << std::left << std::setw(40) << (std::string(2*phase.depth, ' ') + phase.name)
+               << std::right << std::fixed << std::setprecision(3)
+               << std::setw(12) << phase.seconds
+               << std::setw(16) << phase.peak_rss_delta_kb / 1024.0 << " ";
+            for (const auto& [what, n] : phase.counts) {
+                os << ' ' << what << '=' << n;
+            }
+            os << '\n';
+        }
+        os.flags(flags);
+        os.precision(precision);
+    }
+
+    void SetupProfile::writeChromeTrace(std::ostream& os, int pid) const
+    {
+        const auto flags = os.flags();
+        const auto precision = os.precision();
+        os << "{\"traceEvents\":[";
+        for (std::size_t i = 0; i < phases_.size(); ++i) {
+            const auto& phase = phases_[i];
+            os << (i == 0 ? "\n" : ",\n") << "{\"name\":";
+            writeJsonString(os, phase.name);
+            os << ",\"cat\":\"grid\",\"ph\":\"X\",\"pid\":" << pid << ",\"tid\":0"
+               << std::fixed << std::setprecision(1)
+               << ",\"ts\":" << 1e6*phase.start
+               << ",\"dur\":" << 1e6*phase.seconds
+               << ",\"args\":{\"peak_rss_delta_kb\":" << phase.peak_rss_delta_kb;
+            for (const auto& [what, n] : phase.counts) {
+                os << ',';
+                writeJsonString(os, what);
+                os << ':' << n;
+            }
+            os << "}}";
+        }
+        os << "\n],\"displayTimeUnit\":\"ms\"}\n";
+        os.flags(flags);
+        os.precision(precision);
+    }
+
+} // namespace Opm
@@ -0,0 +1,121 @@
+/*
+  Copyright 2025 Equinor ASA.
+
+  This file is part of the Open Porous Media project (OPM).
+
+  OPM is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  OPM is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with OPM.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#ifndef OPM_SETUPPROFILE_HEADER
+#define OPM_SETUPPROFILE_HEADER
+
+#include <chrono>
+#include <iosfwd>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace Opm
+{
+
+    /// Record of named, nested phases of grid setup.
+    ///
+    /// Each phase records its wall time, the growth of the peak resident
+    /// set size of the process while it ran, and entity counts attached
+    /// to it. Recording is switched on at runtime, either by
+    /// setEnabled() or by setting the environment variable
+    /// OPM_GRID_PROFILE to a non-empty value other than "0". When
+    /// disabled, scopes cost a pointer check.
+    ///
+    /// Phases are opened and closed on the calling thread only; the
+    /// threaded loops inside a phase are timed as a whole.
+    class SetupProfile
+    {
+    public:
+        struct Phase
+        {
+            std::string name;
+            /// Index of the enclosing phase, or -1 for a top-level phase.
+            int parent = -1;
+            int depth = 0;
+            /// Seconds from the creation of the profile to the start of the phase.
+            double start = 0.0;
+            double seconds = 0.0;
+            /// Growth of the peak resident set size in kilobytes.
+            long peak_rss_delta_kb = 0;
+            std::vector<std::pair<std::string, long long>> counts;
+        };
+
+        /// Records a phase from construction until close() or destruction.
+        /// A null or disabled profile makes the scope a no-op.
+        class Scope
+        {
+        public:
+            Scope(SetupProfile* profile, const char* name);
+            ~Scope();
+
+            Scope(const Scope&) = delete;
+            Scope& operator=(const Scope&) = delete;
+
+            /// Attach an entity count to the phase.
+            void count(const char* what, long long n);
+
+            /// End the phase before the end of the enclosing block.
+            void close();
+
+        private:
+            SetupProfile* profile_;
+            int phase_;
+        };
+
+        SetupProfile();
+
+        bool enabled() const { return enabled_; }
+        void setEnabled(bool enabled) { enabled_ = enabled; }
+
+        /// Phases in the order in which they were opened.
+        const std::vector<Phase>& phases() const { return phases_; }
+
+        /// Forget all recorded phases. Must not be called while a scope is open.
+        void clear();
+
+        /// Write an indented table of all phases.
+        void writeReport(std::ostream& os) const;
+
+        /// Write all phases as complete events in the Chrome trace event
+        /// format, viewable in chrome://tracing or Perfetto.
+        ///
+        /// \param pid Process id of the events, typically the MPI rank.
+        void writeChromeTrace(std::ostream& os, int pid = 0) const;
+
+        /// Whether OPM_GRID_PROFILE requests profiling.
+        static bool enabledByEnvironment();
+
+    private:
+        using Clock = std::chrono::steady_clock;
+
+        int begin(const char* name);
+        void end(int phase);
+        double secondsSinceOrigin() const;
+
+        bool enabled_;
+        Clock::time_point origin_;
+        std::vector<Phase> phases_;
+        std::vector<int> open_;
+        std::vector<long> open_peak_rss_kb_;
+    };
+
+} // namespace Opm
+
+#endif // OPM_SETUPPROFILE_HEADER
@@ -19,20 +19,23 @@ Copyright 2013-2017 Statoil ASA
 #if HAVE_MPI
 
 #include <algorithm>
+#include <array>
 #include <cassert>
 #include <cstddef>
 #include <functional>
+#include <iterator>
 #include <map>
 #include <memory>
+#include <type_traits>
+#include <typeindex>
+#include <typeinfo>
 #include <utility>
 #include <vector>
-#include <algorithm>
 
 #include <mpi.h>
 
 #include <dune/common/parallel/interface.hh>
 #include <dune/common/parallel/mpitraits.hh>
-#include <dune/common/unused.hh>
 
 /**
  * @addtogroup Common_Parallel
@@ -289,6 +292,260 @@ private:
   std::vector<std::size_t> sizes_;
 };
 
+/**
+ * @brief Base class of the persistent communication plans.
+ *
+ * Allows the communicator to hold plans for different data types.
+ */
+class PersistentPlanBase
+{
+public:
+  virtual ~PersistentPlanBase() = default;
+
+  /** @brief Whether a communication was started but not yet completed. */
+  bool pending = false;
+};
+
+/**
+ * @brief A persistent plan for communicating a fixed amount of data per index.
+ *
+ * Holds the local indices and a buffer for the whole message for each
+ * neighbour, together with persistent send and receive requests on these
+ * buffers.
+ * @tparam T The type of data communicated.
+ */
+template<class T>
+class PersistentPlan : public PersistentPlanBase
+{
+public:
+  /**
+   * @brief A message of the plan.
+   */
+  struct Message
+  {
+    Message(int rank_, const InterfaceInformation& info, std::size_t itemsPerIndex_)
+      : rank(rank_), indices(info.size()), itemsPerIndex(itemsPerIndex_),
+        buffer(info.size()*itemsPerIndex_)
+    {
+      for(std::size_t i=0; i<info.size(); ++i)
+        indices[i]=info[i];
+    }
+    /** @brief The rank of the neighbour. */
+    int rank;
+    /** @brief The local indices to gather from or scatter to. */
+    std::vector<std::size_t> indices;
+    /** @brief The number of data items per index. */
+    std::size_t itemsPerIndex;
+    /** @brief The buffer holding the whole message. */
+    MessageBuffer<T> buffer;
+  };
+
+  /**
+   * @brief Constructor.
+   * @param fixedSize The number of data items per index on this rank.
+   */
+  explicit PersistentPlan(std::size_t fixedSize)
+    : fixedSize_(fixedSize)
+  {}
+
+  ~PersistentPlan() override
+  {
+    int finalized=0;
+    MPI_Finalized(&finalized);
+    if(finalized)
+      return;
+    for(auto& request : send_requests)
+      MPI_Request_free(&request);
+    for(auto& request : recv_requests)
+      MPI_Request_free(&request);
+  }
+
+  /** @brief The number of data items per index on this rank. */
+  std::size_t fixedSize() const
+  {
+    return fixedSize_;
+  }
+
+  /**
+   * @brief The messages sent and received.
+   *
+   * Reserved before any message is added, as the persistent requests
+   * refer to the buffers of the messages.
+   */
+  std::vector<Message> sends, recvs;
+  /** @brief The persistent requests, one per message. */
+  std::vector<MPI_Request> send_requests, recv_requests;
+
+private:
+  std::size_t fixedSize_;
+};
+
+/**
+ * @brief A plan for communicating a fixed amount of data per index with
+ * one neighbourhood collective (MPI_Ineighbor_alltoallv).
+ *
+ * The messages to and from all neighbours are stored one after another
+ * in one send and one receive buffer, in the order of the destinations
+ * and sources of the graph communicator of the direction.
+ * @tparam T The type of data communicated.
+ */
+template<class T>
+class NeighbourhoodPlan : public PersistentPlanBase
+{
+public:
+  /**
+   * @brief The indices received from a neighbour.
+   */
+  struct Receive
+  {
+    /** @brief The local indices to scatter to. */
+    std::vector<std::size_t> indices;
+    /** @brief The number of data items per index. */
+    std::size_t itemsPerIndex;
+  };
+
+  /**
+   * @brief Constructor.
+   * @param fixedSize The number of data items per index on this rank.
+   * @param sendSize The number of data items sent to all neighbours.
+   * @param recvSize The number of data items received from all neighbours.
+   */
+  NeighbourhoodPlan(std::size_t fixedSize, std::size_t sendSize, std::size_t recvSize)
+    : send_buffer(sendSize), recv_buffer(recvSize), fixedSize_(fixedSize)
+  {}
+
+  /** @brief The number of data items per index on this rank. */
+  std::size_t fixedSize() const
+  {
+    return fixedSize_;
+  }
+
+  /** @brief The local indices to gather from, for all destinations. */
+  std::vector<std::size_t> send_indices;
+  /** @brief The indices received from each source. */
+  std::vector<Receive> recvs;
+  /** @brief Counts and displacements of the collective, in data items. */
+  std::vector<int> send_counts, send_displs, recv_counts, recv_displs;
+  /** @brief The buffers holding all messages. */
+  MessageBuffer<T> send_buffer, recv_buffer;
+  /** @brief The request of the pending collective. */
+  MPI_Request request = MPI_REQUEST_NULL;
+
+private:
+  std::size_t fixedSize_;
+};
+
+/**
+ * @brief A plan for communicating data stored contiguously with a fixed
+ * number of items per index, without packing it.
+ *
+ * Holds an MPI derived datatype per neighbour selecting the blocks of the
+ * indices sent or received. Messages are sent from and received into the
+ * storage of the handle directly. MPI does not allow pending receives to
+ * write memory that other pending receives or sends access. If an index is
+ * received from several neighbours, or is sent and received with the same
+ * storage for both, the messages are therefore received into a buffer and
+ * copied to the storage of the handle when the communication completes.
+ * @tparam T The type of data communicated.
+ */
+template<class T>
+class IndexedPlan : public PersistentPlanBase
+{
+public:
+  /**
+   * @brief Constructor.
+   * @param blockSize The number of data items per index.
+   */
+  explicit IndexedPlan(std::size_t blockSize)
+    : blockSize_(blockSize)
+  {}
+
+  ~IndexedPlan() override
+  {
+    int finalized=0;
+    MPI_Finalized(&finalized);
+    if(finalized)
+      return;
+    for(auto& type : send_types)
+      MPI_Type_free(&type);
+    for(auto& type : recv_types)
+      MPI_Type_free(&type);
+  }
+
+  /** @brief The number of data items per index. */
+  std::size_t blockSize() const
+  {
+    return blockSize_;
+  }
+
+  /**
+   * @brief Add the datatype for the indices of one neighbour.
+   * @param info The local indices sent or received.
+   * @param[out] types The datatypes to add to.
+   */
+  void addType(const InterfaceInformation& info, std::vector<MPI_Datatype>& types)
+  {
+    std::vector<MPI_Aint> displacements(info.size());
+    for(std::size_t i=0; i<info.size(); ++i)
+      displacements[i]=static_cast<MPI_Aint>(info[i]*blockSize_*sizeof(T));
+    MPI_Datatype& type=types.emplace_back();
+    MPI_Type_create_hindexed_block(info.size(), blockSize_, displacements.data(),
+                                   Dune::MPITraits<T>::getType(), &type);
+    MPI_Type_commit(&type);
+  }
+
+  /**
+   * @brief Whether the messages have to be received into recv_buffer.
+   * @param source The first data item gathered.
+   * @param target The first data item scattered.
+   */
+  bool receiveIntoBuffer(const T* source, const T* target) const
+  {
+    return recvs_overlap || (sends_overlap_recvs && source == target);
+  }
+
+  /** @brief The ranks sent to and received from. */
+  std::vector<int> send_ranks, recv_ranks;
+  /** @brief The datatypes, one per neighbour. */
+  std::vector<MPI_Datatype> send_types, recv_types;
+  /** @brief Counts and byte displacements of a neighbourhood collective. */
+  std::vector<int> send_counts, recv_counts;
+  std::vector<MPI_Aint> send_displs, recv_displs;
+  /** @brief The requests of the pending communication. */
+  std::vector<MPI_Request> requests;
+
+  /** @brief Whether an index is received from more than one neighbour. */
+  bool recvs_overlap = false;
+  /** @brief Whether an index is both sent and received. */
+  bool sends_overlap_recvs = false;
+  /** @brief Whether the pending communication receives into recv_buffer. */
+  bool buffered = false;
+  /** @brief The local indices received from each neighbour, in the order of recv_ranks. */
+  std::vector<std::vector<std::size_t> > recv_indices;
+  /** @brief Offsets of the messages in recv_buffer, in data items, one more than neighbours. */
+  std::vector<std::size_t> buffer_offsets;
+  /** @brief Buffer receiving the messages one after another. */
+  std::vector<T> recv_buffer;
+  /** @brief Counts, byte displacements and types of a neighbourhood collective receiving into recv_buffer. */
+  std::vector<int> buffer_counts;
+  std::vector<MPI_Aint> buffer_displs;
+  std::vector<MPI_Datatype> buffer_types;
+
+private:
+  std::size_t blockSize_;
+};
+
+/**
+ * @brief Whether a handle stores its data contiguously, see VariableSizeCommunicator::forward().
+ */
+template<class DataHandle, class = void>
+struct IsContiguousHandle : std::false_type
+{};
+
+template<class DataHandle>
+struct IsContiguousHandle<DataHandle, std::void_t<decltype(DataHandle::contiguous)> >
+  : std::bool_constant<DataHandle::contiguous>
+{};
 
 } // end unnamed namespace
 
@@ -339,7 +596,7 @@ public:
      */
   typedef std::map<int,std::pair<InterfaceInformation,InterfaceInformation>,
                    std::less<int>,
-                   typename Allocator::template rebind<std::pair<const int,std::pair<InterfaceInformation,InterfaceInformation> > >::other> InterfaceMap;
+                   typename std::allocator_traits<Allocator>::template rebind_alloc<std::pair<const int,std::pair<InterfaceInformation,InterfaceInformation> > > > InterfaceMap;
 
 #ifndef DUNE_PARALLEL_MAX_COMMUNICATION_BUFFER_SIZE
   /**
@@ -411,6 +668,15 @@ public:
 
   ~VariableSizeCommunicator()
   {
+    // The persistent requests have to be freed before the communicator.
+    freePersistentPlans();
+    int finalized=0;
+    MPI_Finalized(&finalized);
+    if(finalized)
+      return;
+    for(auto& graphComm : graphCommunicators_)
+      if(graphComm!=MPI_COMM_NULL)
+        MPI_Comm_free(&graphComm);
     MPI_Comm_free(&communicator_);
   }
 
@@ -422,7 +688,7 @@ public:
    * to the following interface:
    * \code{.cpp}
    * // returns whether the number of data items per entry is fixed
-   * bool fixedsize();
+   * bool fixedSize();
    * // get the number of data items for an entry with index i
    * std::size_t size(std::size_t i);
    * // gather the data at index i
@@ -432,6 +698,19 @@ public:
    * template<class MessageBuffer>
    * void scatter(MessageBuffer& buf, std::size_t i, std::size_t n);
    * \endcode
+   * The persistent communication (forwardPersistent() etc.) in addition
+   * recognises handles whose data is stored contiguously with the same
+   * number of items per index on all ranks:
+   * \code{.cpp}
+   * static constexpr bool contiguous = true;
+   * // the data of index i starts at sourceData()+i*blockSize() when gathering
+   * const DataType* sourceData() const;
+   * // and at targetData()+i*blockSize() when scattering
+   * DataType* targetData();
+   * std::size_t blockSize() const;
+   * \endcode
+   * Their data is sent and received directly using MPI derived datatypes,
+   * without calling gather and scatter.
    * @param handle A handle responsible for describing the data, gathering, and scattering it.
    */
   template<class DataHandle>
@@ -447,7 +726,7 @@ public:
    * to the following interface:
    * \code{.cpp}
    * // returns whether the number of data items per entry is fixed
-   * bool fixedsize();
+   * bool fixedSize();
    * // get the number of data items for an entry with index i
    * std::size_t size(std::size_t i);
    * // gather the data at index i
@@ -465,6 +744,157 @@ public:
     communicate<false>(handle);
   }
 
+  /**
+   * @brief Communicate forward reusing a persistent communication plan.
+   *
+   * Does the same as forward(). If the handle has a fixed amount of data
+   * per index, the first call sets up a buffer for each whole message and
+   * persistent requests (MPI_Send_init/MPI_Recv_init). The plans are kept
+   * per data type and amount of data per index. Subsequent calls with a
+   * combination seen before only pack, start, wait, and unpack, also when
+   * handles of other types were communicated in between. Setting up the plan
+   * of a new combination has to happen on all ranks in the same call.
+   * Handles with a variable amount of data per index are communicated
+   * with forward().
+   * @param handle A handle responsible for describing the data, gathering, and scattering it.
+   */
+  template<class DataHandle>
+  void forwardPersistent(DataHandle& handle)
+  {
+    communicatePersistentBegin<true>(handle);
+    communicatePersistentEnd<true>(handle);
+  }
+
+  /**
+   * @brief Start communicating forward with a persistent communication plan.
+   *
+   * Gathers and sends the data and posts the receives, but does not wait
+   * for any message. The communication is completed by forwardPersistentEnd()
+   * with the same handle, which has to stay alive in between. Neither the
+   * data sent nor the data received may be touched before that. Handles with
+   * a variable amount of data per index are communicated completely here.
+   *
+   * A forward and a backward communication may be pending at the same time.
+   * Setting up the plan of a direction exchanges the amount of data per index
+   * with the neighbours and waits for it, though. The first communication of
+   * a direction, and the first after a change of data type or amount of data
+   * per index, therefore have to be started in the same order relative to
+   * those of the other direction on all ranks.
+   * @param handle A handle responsible for describing the data, gathering, and scattering it.
+   */
+  template<class DataHandle>
+  void forwardPersistentBegin(DataHandle& handle)
+  {
+    communicatePersistentBegin<true>(handle);
+  }
+
+  /**
+   * @brief Complete a communication started by forwardPersistentBegin().
+   *
+   * Waits for the messages and scatters them in the order they arrive.
+   * Does nothing if no forward communication is pending.
+   * @param handle The handle passed to forwardPersistentBegin().
+   */
+  template<class DataHandle>
+  void forwardPersistentEnd(DataHandle& handle)
+  {
+    communicatePersistentEnd<true>(handle);
+  }
+
+  /**
+   * @brief Communicate backwards reusing a persistent communication plan.
+   *
+   * See forwardPersistent().
+   * @param handle A handle responsible for describing the data, gathering, and scattering it.
+   */
+  template<class DataHandle>
+  void backwardPersistent(DataHandle& handle)
+  {
+    communicatePersistentBegin<false>(handle);
+    communicatePersistentEnd<false>(handle);
+  }
+
+  /**
+   * @brief Start communicating backwards with a persistent communication plan.
+   *
+   * See forwardPersistentBegin().
+   * @param handle A handle responsible for describing the data, gathering, and scattering it.
+   */
+  template<class DataHandle>
+  void backwardPersistentBegin(DataHandle& handle)
+  {
+    communicatePersistentBegin<false>(handle);
+  }
+
+  /**
+   * @brief Complete a communication started by backwardPersistentBegin().
+   * @param handle The handle passed to backwardPersistentBegin().
+   */
+  template<class DataHandle>
+  void backwardPersistentEnd(DataHandle& handle)
+  {
+    communicatePersistentEnd<false>(handle);
+  }
+
+  /**
+   * @brief Whether a split-phase communication is pending.
+   * @param forward If true asks for the forward, otherwise the backward direction.
+   */
+  bool persistentPending(bool forward) const
+  {
+    const auto* plan = activePlans_[forward ? 0 : 1];
+    return plan && plan->pending;
+  }
+
+  /**
+   * @brief Release the buffers and requests of the persistent plans.
+   */
+  void freePersistentPlans()
+  {
+    activePlans_ = {nullptr, nullptr};
+    persistentPlans_[0].clear();
+    persistentPlans_[1].clear();
+  }
+
+  /**
+   * @brief The number of persistent plans set up so far.
+   *
+   * Plans freed by freePersistentPlans() are included.
+   */
+  std::size_t persistentPlanSetups() const
+  {
+    return persistentPlanSetups_;
+  }
+
+  /**
+   * @brief Choose between point-to-point messages and neighbourhood collectives.
+   *
+   * With neighbourhood collectives the persistent communication of handles
+   * with a fixed amount of data per index uses one MPI_Ineighbor_alltoallv
+   * on a graph communicator (MPI_Dist_graph_create_adjacent) per direction,
+   * instead of one message per neighbour. The graph communicator is created
+   * in the first such communication of a direction. Each of these calls then
+   * has to be made on all ranks of the communicator, including those without
+   * any neighbours. Handles with a variable amount of data per index are
+   * always communicated with point-to-point messages.
+   *
+   * Must be called with the same value on all ranks, and not while a
+   * communication is pending. Changing it frees the persistent plans.
+   * @param use Whether to use neighbourhood collectives.
+   */
+  void setNeighbourhoodCollectives(bool use)
+  {
+    if(use!=useNeighbourhoodCollectives_)
+      freePersistentPlans();
+    useNeighbourhoodCollectives_=use;
+  }
+
+  /** @brief Whether neighbourhood collectives are used, see setNeighbourhoodCollectives(). */
+  bool neighbourhoodCollectives() const
+  {
+    return useNeighbourhoodCollectives_;
+  }
+
 private:
   template<bool FORWARD, class DataHandle>
   void communicateSizes(DataHandle& handle,
@@ -509,6 +939,108 @@ private:
    */
   template<bool FORWARD, class DataHandle>
   void communicateVariableSize(DataHandle& handle);
+  /**
+   * @brief Start a communication using the persistent plan of the direction.
+   *
+   * Sets up the plan if needed, starts the receives and packs and starts
+   * the sends.
+   * @tparam FORWARD If true we send in the forward direction.
+   * @tparam DataHandle DataHandle The type of the data handle.
+   * @param handle The handle describing the data and responsible for gather
+   * and scatter operations.
+   */
+  template<bool FORWARD, class DataHandle>
+  void communicatePersistentBegin(DataHandle& handle);
+  /**
+   * @brief Complete a communication started by communicatePersistentBegin().
+   *
+   * Unpacks the messages in the order they arrive and waits for the sends.
+   * @tparam FORWARD If true we send in the forward direction.
+   * @tparam DataHandle DataHandle The type of the data handle.
+   * @param handle The handle describing the data and responsible for gather
+   * and scatter operations.
+   */
+  template<bool FORWARD, class DataHandle>
+  void communicatePersistentEnd(DataHandle& handle);
+  /**
+   * @brief Set up the messages and persistent requests of a plan.
+   *
+   * The number of data items per index is exchanged with the neighbours
+   * once here, as the receiving side may not know it.
+   * @tparam FORWARD If true we send in the forward direction.
+   * @param plan The plan to set up.
+   */
+  template<bool FORWARD, class T>
+  void setupPersistentPlan(PersistentPlan<T>& plan);
+  /**
+   * @brief Set up a plan for neighbourhood collectives.
+   * @tparam FORWARD If true we send in the forward direction.
+   * @param fixedSize The number of data items per index on this rank.
+   */
+  template<bool FORWARD, class T>
+  std::unique_ptr<NeighbourhoodPlan<T> > setupNeighbourhoodPlan(std::size_t fixedSize);
+  /**
+   * @brief Start a communication with the neighbourhood collective of the direction.
+   */
+  template<bool FORWARD, class DataHandle>
+  void communicateNeighbourhoodBegin(DataHandle& handle);
+  /**
+   * @brief Complete a communication started by communicateNeighbourhoodBegin().
+   */
+  template<bool FORWARD, class DataHandle>
+  void communicateNeighbourhoodEnd(DataHandle& handle,
+                                   NeighbourhoodPlan<typename DataHandle::DataType>& plan);
+  /**
+   * @brief Start communicating the data of a contiguous handle with derived datatypes.
+   */
+  template<bool FORWARD, class DataHandle>
+  void communicateIndexedBegin(DataHandle& handle);
+  /**
+   * @brief Set up the datatypes of a plan for contiguous handles.
+   * @tparam FORWARD If true we send in the forward direction.
+   * @param plan The plan to set up.
+   */
+  template<bool FORWARD, class T>
+  void setupIndexedPlan(IndexedPlan<T>& plan);
+  /**
+   * @brief Create the graph communicator of the direction, if not done yet.
+   */
+  template<bool FORWARD>
+  MPI_Comm graphCommunicator();
+  /**
+   * @brief The plan of a direction for a type of plan and amount of data per index.
+   *
+   * Sets the plan up if there is none yet and makes it the active one of
+   * the direction.
+   * @tparam FORWARD If true we send in the forward direction.
+   * @tparam Plan The type of the plan.
+   * @param fixedSize The number of data items per index on this rank.
+   * @param setup Called without arguments to create a new plan.
+   */
+  template<bool FORWARD, class Plan, class Setup>
+  Plan& persistentPlan(std::size_t fixedSize, Setup&& setup);
+  /**
+   * @brief Exchange the number of data items per index with the neighbours.
+   *
+   * Needed once per plan, as the receiving side may not know it.
+   * @tparam FORWARD If true we send in the forward direction.
+   * @param fixedSize The number of data items per index on this rank.
+   * @param[out] sends The ranks and indices to send to, in the order of the interface.
+   * @param[out] recvs The ranks and indices to receive from, in the order of the interface.
+   * @return The number of data items per index received from each entry of recvs.
+   */
+  template<bool FORWARD>
+  std::vector<std::size_t>
+  exchangeFixedSize(std::size_t fixedSize,
+                    std::vector<std::pair<int,const InterfaceInformation*> >& sends,
+                    std::vector<std::pair<int,const InterfaceInformation*> >& recvs);
+  /**
+   * @brief The number of data items per index of a fixed size handle on this rank.
+   *
+   * Taken from any local index of the interface, 0 if there is none.
+   */
+  template<bool FORWARD, class DataHandle>
+  std::size_t localFixedSize(DataHandle& handle);
   /**
    * @brief The maximum size if the buffers used for gather and scatter.
    *
@@ -530,6 +1062,54 @@ private:
    * This is a cloned communicator to ensure there are no interferences.
    */
   MPI_Comm communicator_;
+  /**
+   * @brief The persistent plans for the forward and the backward direction.
+   *
+   * Keyed by the type of the plan, which includes the data type, and the
+   * number of data items per index, such that handles of different types
+   * used alternately each keep their plan.
+   */
+  std::array<std::map<std::pair<std::type_index,std::size_t>,std::unique_ptr<PersistentPlanBase> >,2> persistentPlans_;
+  /**
+   * @brief The plan used by the last communication of each direction.
+   */
+  std::array<PersistentPlanBase*,2> activePlans_ = {nullptr, nullptr};
+  /**
+   * @brief The number of persistent plans set up so far.
+   */
+  std::size_t persistentPlanSetups_ = 0;
+  /**
+   * @brief Whether neighbourhood collectives are used for fixed size data.
+   */
+  bool useNeighbourhoodCollectives_ = false;
+  /**
+   * @brief The graph communicators for the forward and the backward direction.
+   *
+   * Their sources are the ranks we receive from and their destinations the
+   * ranks we send to, in the order of the interface.
+   */
+  std::array<MPI_Comm,2> graphCommunicators_ = {MPI_COMM_NULL, MPI_COMM_NULL};
+  /**
+   * @brief The message tags of the persistent communication of a direction.
+   *
+   * Differ between the directions, such that the messages of a forward and
+   * a backward communication pending at the same time are never matched
+   * with each other, whatever order the ranks start them in.
+   */
+  static constexpr int persistentTag(bool forward)
+  {
+    return forward ? 933400 : 933402;
+  }
+  /** @brief The message tags of communication with derived datatypes, see persistentTag(). */
+  static constexpr int indexedTag(bool forward)
+  {
+    return forward ? 933401 : 933403;
+  }
+  /** @brief The message tags of the exchange of the amount of data per index, see persistentTag(). */
+  static constexpr int fixedSizeTag(bool forward)
+  {
+    return forward ? 933882 : 933883;
+  }
 };
 
 /** @} */
@@ -548,13 +1128,13 @@ public:
                  std::vector<InterfaceTracker>& trackers)
     : data_(data), trackers_(trackers), index_()
   {}
-  bool fixedsize()
+  bool fixedSize()
   {
     return true;
   }
   std::size_t size(std::size_t i)
   {
-    DUNE_UNUSED_PARAMETER(i);
+    static_cast<void>(i);
     return 1;
   }
   template<class B>
@@ -644,7 +1224,7 @@ struct PackEntries
                  MessageBuffer<typename DataHandle::DataType>& buffer,
                  int i) const
   {
-    DUNE_UNUSED_PARAMETER(i);
+    static_cast<void>(i);
     return operator()(handle,tracker,buffer);
   }
 
@@ -984,7 +1564,7 @@ std::size_t checkReceiveAndContinueReceiving(DataHandle& handle,
 {
   return checkAndContinue(handle, trackers, requests, requests, buffers, comm,
                           UnpackEntries<DataHandle>(), SetupRecvRequest<DataHandle>(),
-                          true, !handle.fixedsize());
+                          true, !handle.fixedSize());
 }
 
 
@@ -1041,7 +1621,7 @@ void VariableSizeCommunicator<Allocator>::setupInterfaceTrackers(DataHandle& han
   recv_trackers.reserve(interface_->size());
 
   int fixedsize=0;
-  if(handle.fixedsize())
+  if(handle.fixedSize())
     ++fixedsize;
 
 
@@ -1049,9 +1629,9 @@ void VariableSizeCommunicator<Allocator>::setupInterfaceTrackers(DataHandle& han
   for(IIter inf=interface_->begin(), end=interface_->end(); inf!=end; ++inf)
   {
 
-    if(handle.fixedsize() && InterfaceInformationChooser<FORWARD>::getSend(inf->second).size())
+    if(handle.fixedSize() && InterfaceInformationChooser<FORWARD>::getSend(inf->second).size())
       fixedsize=handle.size(InterfaceInformationChooser<FORWARD>::getSend(inf->second)[0]);
-    assert(!handle.fixedsize()||fixedsize>0);
+    assert(!handle.fixedSize()||fixedsize>0);
     send_trackers.push_back(InterfaceTracker(inf->first,
                                              InterfaceInformationChooser<FORWARD>::getSend(inf->second), fixedsize));
     recv_trackers.push_back(InterfaceTracker(inf->first,
@@ -1212,11 +1792,402 @@ void VariableSizeCommunicator<Allocator>::communicate(DataHandle& handle)
     // either for MPI_Wait_all or MPI_Test_some.
     return;
 
-  if(handle.fixedsize())
+  if(handle.fixedSize())
     communicateFixedSize<FORWARD>(handle);
   else
     communicateVariableSize<FORWARD>(handle);
 }
+
+template<class Allocator>
+template<bool FORWARD>
+std::vector<std::size_t>
+VariableSizeCommunicator<Allocator>::exchangeFixedSize(std::size_t fixedSize,
+                                                       std::vector<std::pair<int,const InterfaceInformation*> >& sends,
+                                                       std::vector<std::pair<int,const InterfaceInformation*> >& recvs)
+{
+  for(const auto& [rank, infos] : *interface_)
+  {
+    if(InterfaceInformationChooser<FORWARD>::getSend(infos).size())
+      sends.emplace_back(rank, &InterfaceInformationChooser<FORWARD>::getSend(infos));
+    if(InterfaceInformationChooser<FORWARD>::getReceive(infos).size())
+      recvs.emplace_back(rank, &InterfaceInformationChooser<FORWARD>::getReceive(infos));
+  }
+  std::vector<std::size_t> recv_sizes(recvs.size());
+  std::vector<MPI_Request> requests(sends.size()+recvs.size(), MPI_REQUEST_NULL);
+  for(std::size_t i=0; i<recvs.size(); ++i)
+    MPI_Irecv(&recv_sizes[i], 1, Dune::MPITraits<std::size_t>::getType(),
+              recvs[i].first, fixedSizeTag(FORWARD), communicator_, &requests[i]);
+  for(std::size_t i=0; i<sends.size(); ++i)
+    MPI_Isend(&fixedSize, 1, Dune::MPITraits<std::size_t>::getType(),
+              sends[i].first, fixedSizeTag(FORWARD), communicator_, &requests[recvs.size()+i]);
+  MPI_Waitall(requests.size(), requests.data(), MPI_STATUSES_IGNORE);
+  return recv_sizes;
+}
+
+template<class Allocator>
+template<bool FORWARD, class DataHandle>
+std::size_t VariableSizeCommunicator<Allocator>::localFixedSize(DataHandle& handle)
+{
+  for(const auto& entry : *interface_)
+  {
+    const auto& send=InterfaceInformationChooser<FORWARD>::getSend(entry.second);
+    const auto& recv=InterfaceInformationChooser<FORWARD>::getReceive(entry.second);
+    if(send.size())
+      return handle.size(send[0]);
+    if(recv.size())
+      return handle.size(recv[0]);
+  }
+  return 0;
+}
+
+template<class Allocator>
+template<bool FORWARD, class T>
+void VariableSizeCommunicator<Allocator>::setupPersistentPlan(PersistentPlan<T>& plan)
+{
+  std::vector<std::pair<int,const InterfaceInformation*> > sends, recvs;
+  std::size_t fixedSize=plan.fixedSize();
+  const auto recv_sizes=exchangeFixedSize<FORWARD>(fixedSize, sends, recvs);
+
+  // Set up the messages and persistent requests on their buffers.
+  plan.sends.reserve(sends.size());
+  plan.recvs.reserve(recvs.size());
+  plan.send_requests.assign(sends.size(), MPI_REQUEST_NULL);
+  plan.recv_requests.assign(recvs.size(), MPI_REQUEST_NULL);
+  for(std::size_t i=0; i<recvs.size(); ++i)
+  {
+    auto& message=plan.recvs.emplace_back(recvs[i].first, *recvs[i].second, recv_sizes[i]);
+    MPI_Recv_init(message.buffer, message.buffer.size(), Dune::MPITraits<T>::getType(),
+                  message.rank, persistentTag(FORWARD), communicator_, &plan.recv_requests[i]);
+  }
+  for(std::size_t i=0; i<sends.size(); ++i)
+  {
+    auto& message=plan.sends.emplace_back(sends[i].first, *sends[i].second, fixedSize);
+    MPI_Send_init(message.buffer, message.buffer.size(), Dune::MPITraits<T>::getType(),
+                  message.rank, persistentTag(FORWARD), communicator_, &plan.send_requests[i]);
+  }
+}
+
+template<class Allocator>
+template<bool FORWARD, class DataHandle>
+void VariableSizeCommunicator<Allocator>::communicatePersistentBegin(DataHandle& handle)
+{
+  assert(!persistentPending(FORWARD));
+
+  if constexpr (IsContiguousHandle<DataHandle>::value)
+  {
+    communicateIndexedBegin<FORWARD>(handle);
+    return;
+  }
+
+  // Has to come first, as the collective is called on ranks without neighbours, too.
+  if(useNeighbourhoodCollectives_ && handle.fixedSize())
+  {
+    communicateNeighbourhoodBegin<FORWARD>(handle);
+    return;
+  }
+
+  if( interface_->size() == 0)
+    return;
+
+  if(!handle.fixedSize())
+  {
+    communicateVariableSize<FORWARD>(handle);
+    return;
+  }
+
+  const std::size_t fixedSize=localFixedSize<FORWARD>(handle);
+
+  typedef typename DataHandle::DataType DataType;
+  auto* plan=&persistentPlan<FORWARD,PersistentPlan<DataType> >(fixedSize, [this, fixedSize]()
+  {
+    auto newPlan=std::make_unique<PersistentPlan<DataType> >(fixedSize);
+    setupPersistentPlan<FORWARD>(*newPlan);
+    return newPlan;
+  });
+
+  if(!plan->recv_requests.empty())
+    MPI_Startall(plan->recv_requests.size(), plan->recv_requests.data());
+  for(std::size_t i=0; i<plan->sends.size(); ++i)
+  {
+    auto& message=plan->sends[i];
+    message.buffer.reset();
+    for(const auto index : message.indices)
+      handle.gather(message.buffer, index);
+    MPI_Start(&plan->send_requests[i]);
+  }
+  plan->pending=true;
+}
+
+template<class Allocator>
+template<bool FORWARD, class DataHandle>
+void VariableSizeCommunicator<Allocator>::communicatePersistentEnd(DataHandle& handle)
+{
+  if(!persistentPending(FORWARD))
+    return;
+
+  auto* planBase=activePlans_[FORWARD ? 0 : 1];
+  if(auto* indexedPlan=dynamic_cast<IndexedPlan<typename DataHandle::DataType>*>(planBase))
+  {
+    MPI_Waitall(indexedPlan->requests.size(), indexedPlan->requests.data(), MPI_STATUSES_IGNORE);
+    if(indexedPlan->buffered)
+    {
+      const std::size_t blockSize=indexedPlan->blockSize();
+      auto* target=handle.targetData();
+      for(std::size_t i=0; i<indexedPlan->recv_indices.size(); ++i)
+      {
+        const auto* in=indexedPlan->recv_buffer.data()+indexedPlan->buffer_offsets[i];
+        for(const auto index : indexedPlan->recv_indices[i])
+        {
+          std::copy_n(in, blockSize, target+index*blockSize);
+          in+=blockSize;
+        }
+      }
+    }
+    indexedPlan->pending=false;
+    return;
+  }
+  if(auto* neighbourhoodPlan=dynamic_cast<NeighbourhoodPlan<typename DataHandle::DataType>*>(planBase))
+  {
+    communicateNeighbourhoodEnd<FORWARD>(handle, *neighbourhoodPlan);
+    return;
+  }
+  auto* plan=dynamic_cast<PersistentPlan<typename DataHandle::DataType>*>(planBase);
+  assert(plan);
+
+  // Unpack the messages in the order they arrive.
+  std::vector<int> finished(plan->recvs.size());
+  for(std::size_t left=plan->recvs.size(); left;)
+  {
+    int no_finished=MPI_UNDEFINED;
+    MPI_Waitsome(plan->recv_requests.size(), plan->recv_requests.data(), &no_finished,
+                 finished.data(), MPI_STATUSES_IGNORE);
+    assert(no_finished!=MPI_UNDEFINED);
+    for(int i=0; i<no_finished; ++i)
+    {
+      auto& message=plan->recvs[finished[i]];
+      message.buffer.reset();
+      for(const auto index : message.indices)
+        handle.scatter(message.buffer, index, message.itemsPerIndex);
+    }
+    left-=no_finished;
+  }
+  if(!plan->send_requests.empty())
+    MPI_Waitall(plan->send_requests.size(), plan->send_requests.data(), MPI_STATUSES_IGNORE);
+  plan->pending=false;
+}
+
+template<class Allocator>
+template<bool FORWARD, class T>
+std::unique_ptr<NeighbourhoodPlan<T> >
+VariableSizeCommunicator<Allocator>::setupNeighbourhoodPlan(std::size_t fixedSize)
+{
+  std::vector<std::pair<int,const InterfaceInformation*> > sends, recvs;
+  const auto recv_sizes=exchangeFixedSize<FORWARD>(fixedSize, sends, recvs);
+
+  std::size_t send_size=0, recv_size=0;
+  for(const auto& send : sends)
+    send_size+=send.second->size()*fixedSize;
+  for(std::size_t i=0; i<recvs.size(); ++i)
+    recv_size+=recvs[i].second->size()*recv_sizes[i];
+
+  auto plan=std::make_unique<NeighbourhoodPlan<T> >(fixedSize, send_size, recv_size);
+  int displ=0;
+  for(const auto& send : sends)
+  {
+    const auto& info=*send.second;
+    for(std::size_t i=0; i<info.size(); ++i)
+      plan->send_indices.push_back(info[i]);
+    plan->send_counts.push_back(static_cast<int>(info.size()*fixedSize));
+    plan->send_displs.push_back(displ);
+    displ+=plan->send_counts.back();
+  }
+  displ=0;
+  for(std::size_t n=0; n<recvs.size(); ++n)
+  {
+    const auto& info=*recvs[n].second;
+    auto& recv=plan->recvs.emplace_back();
+    recv.indices.resize(info.size());
+    for(std::size_t i=0; i<info.size(); ++i)
+      recv.indices[i]=info[i];
+    recv.itemsPerIndex=recv_sizes[n];
+    plan->recv_counts.push_back(static_cast<int>(info.size()*recv_sizes[n]));
+    plan->recv_displs.push_back(displ);
+    displ+=plan->recv_counts.back();
+  }
+  return plan;
+}
+
+template<class Allocator>
+template<bool FORWARD, class Plan, class Setup>
+Plan& VariableSizeCommunicator<Allocator>::persistentPlan(std::size_t fixedSize, Setup&& setup)
+{
+  auto& planPtr=persistentPlans_[FORWARD ? 0 : 1][{std::type_index(typeid(Plan)), fixedSize}];
+  if(!planPtr)
+  {
+    planPtr=setup();
+    ++persistentPlanSetups_;
+  }
+  activePlans_[FORWARD ? 0 : 1]=planPtr.get();
+  return static_cast<Plan&>(*planPtr);
+}
+
+template<class Allocator>
+template<bool FORWARD>
+MPI_Comm VariableSizeCommunicator<Allocator>::graphCommunicator()
+{
+  auto& graphComm=graphCommunicators_[FORWARD ? 0 : 1];
+  if(graphComm==MPI_COMM_NULL)
+  {
+    std::vector<int> sources, destinations;
+    for(const auto& [rank, infos] : *interface_)
+    {
+      if(InterfaceInformationChooser<FORWARD>::getSend(infos).size())
+        destinations.push_back(rank);
+      if(InterfaceInformationChooser<FORWARD>::getReceive(infos).size())
+        sources.push_back(rank);
+    }
+    MPI_Dist_graph_create_adjacent(communicator_, sources.size(), sources.data(), MPI_UNWEIGHTED,
+                                   destinations.size(), destinations.data(), MPI_UNWEIGHTED,
+                                   MPI_INFO_NULL, 0, &graphComm);
+  }
+  return graphComm;
+}
+
+template<class Allocator>
+template<bool FORWARD, class DataHandle>
+void VariableSizeCommunicator<Allocator>::communicateNeighbourhoodBegin(DataHandle& handle)
+{
+  MPI_Comm graphComm=this->template graphCommunicator<FORWARD>();
+  const std::size_t fixedSize=localFixedSize<FORWARD>(handle);
+  typedef typename DataHandle::DataType DataType;
+  auto* plan=&persistentPlan<FORWARD,NeighbourhoodPlan<DataType> >(fixedSize, [this, fixedSize]()
+  {
+    return setupNeighbourhoodPlan<FORWARD,DataType>(fixedSize);
+  });
+
+  plan->send_buffer.reset();
+  for(const auto index : plan->send_indices)
+    handle.gather(plan->send_buffer, index);
+  MPI_Ineighbor_alltoallv(static_cast<DataType*>(plan->send_buffer), plan->send_counts.data(),
+                          plan->send_displs.data(), Dune::MPITraits<DataType>::getType(),
+                          static_cast<DataType*>(plan->recv_buffer), plan->recv_counts.data(),
+                          plan->recv_displs.data(), Dune::MPITraits<DataType>::getType(),
+                          graphComm, &plan->request);
+  plan->pending=true;
+}
+
+template<class Allocator>
+template<bool FORWARD, class DataHandle>
+void VariableSizeCommunicator<Allocator>::communicateNeighbourhoodEnd(DataHandle& handle,
+                                                                      NeighbourhoodPlan<typename DataHandle::DataType>& plan)
+{
+  MPI_Wait(&plan.request, MPI_STATUS_IGNORE);
+  plan.recv_buffer.reset();
+  for(const auto& recv : plan.recvs)
+    for(const auto index : recv.indices)
+      handle.scatter(plan.recv_buffer, index, recv.itemsPerIndex);
+  plan.pending=false;
+}
+
+template<class Allocator>
+template<bool FORWARD, class T>
+void VariableSizeCommunicator<Allocator>::setupIndexedPlan(IndexedPlan<T>& plan)
+{
+  std::vector<std::pair<int,const InterfaceInformation*> > sends, recvs;
+  [[maybe_unused]] const auto recv_sizes=exchangeFixedSize<FORWARD>(plan.blockSize(), sends, recvs);
+  std::vector<std::size_t> recv_indices, send_indices;
+  plan.buffer_offsets.assign(1, 0);
+  for(std::size_t i=0; i<recvs.size(); ++i)
+  {
+    assert(recv_sizes[i]==plan.blockSize());
+    plan.recv_ranks.push_back(recvs[i].first);
+    plan.addType(*recvs[i].second, plan.recv_types);
+    const auto& info=*recvs[i].second;
+    auto& indices=plan.recv_indices.emplace_back(info.size());
+    for(std::size_t j=0; j<info.size(); ++j)
+      indices[j]=info[j];
+    recv_indices.insert(recv_indices.end(), indices.begin(), indices.end());
+    plan.buffer_offsets.push_back(plan.buffer_offsets.back()+info.size()*plan.blockSize());
+    plan.buffer_counts.push_back(info.size()*plan.blockSize());
+    plan.buffer_displs.push_back(plan.buffer_offsets[i]*sizeof(T));
+    plan.buffer_types.push_back(Dune::MPITraits<T>::getType());
+  }
+  for(const auto& [rank, info] : sends)
+  {
+    plan.send_ranks.push_back(rank);
+    plan.addType(*info, plan.send_types);
+    for(std::size_t j=0; j<info->size(); ++j)
+      send_indices.push_back((*info)[j]);
+  }
+  plan.send_counts.assign(sends.size(), 1);
+  plan.recv_counts.assign(recvs.size(), 1);
+  plan.send_displs.assign(sends.size(), 0);
+  plan.recv_displs.assign(recvs.size(), 0);
+
+  std::sort(recv_indices.begin(), recv_indices.end());
+  plan.recvs_overlap=std::adjacent_find(recv_indices.begin(), recv_indices.end())!=recv_indices.end();
+  std::sort(send_indices.begin(), send_indices.end());
+  std::vector<std::size_t> common;
+  std::set_intersection(recv_indices.begin(), recv_indices.end(), send_indices.begin(), send_indices.end(),
+                        std::back_inserter(common));
+  plan.sends_overlap_recvs=!common.empty();
+}
+
+template<class Allocator>
+template<bool FORWARD, class DataHandle>
+void VariableSizeCommunicator<Allocator>::communicateIndexedBegin(DataHandle& handle)
+{
+  if(!useNeighbourhoodCollectives_ && interface_->size() == 0)
+    return;
+
+  typedef typename DataHandle::DataType DataType;
+  const std::size_t blockSize=handle.blockSize();
+  auto* plan=&persistentPlan<FORWARD,IndexedPlan<DataType> >(blockSize, [this, blockSize]()
+  {
+    auto newPlan=std::make_unique<IndexedPlan<DataType> >(blockSize);
+    setupIndexedPlan<FORWARD>(*newPlan);
+    return newPlan;
+  });
+
+  // The messages sent are the same either way, hence each rank decides on its own.
+  plan->buffered=plan->receiveIntoBuffer(handle.sourceData(), handle.targetData());
+  if(plan->buffered)
+    plan->recv_buffer.resize(plan->buffer_offsets.back());
+
+  if(useNeighbourhoodCollectives_)
+  {
+    plan->requests.assign(1, MPI_REQUEST_NULL);
+    if(plan->buffered)
+      MPI_Ineighbor_alltoallw(handle.sourceData(), plan->send_counts.data(), plan->send_displs.data(),
+                              plan->send_types.data(), plan->recv_buffer.data(), plan->buffer_counts.data(),
+                              plan->buffer_displs.data(), plan->buffer_types.data(),
+                              this->template graphCommunicator<FORWARD>(), plan->requests.data());
+    else
+      MPI_Ineighbor_alltoallw(handle.sourceData(), plan->send_counts.data(), plan->send_displs.data(),
+                              plan->send_types.data(), handle.targetData(), plan->recv_counts.data(),
+                              plan->recv_displs.data(), plan->recv_types.data(),
+                              this->template graphCommunicator<FORWARD>(), plan->requests.data());
+  }
+  else
+  {
+    const std::size_t no_recvs=plan->recv_ranks.size();
+    plan->requests.assign(no_recvs+plan->send_ranks.size(), MPI_REQUEST_NULL);
+    for(std::size_t i=0; i<no_recvs; ++i)
+    {
+      if(plan->buffered)
+        MPI_Irecv(plan->recv_buffer.data()+plan->buffer_offsets[i], plan->buffer_counts[i],
+                  Dune::MPITraits<DataType>::getType(), plan->recv_ranks[i],
+                  indexedTag(FORWARD), communicator_, &plan->requests[i]);
+      else
+        MPI_Irecv(handle.targetData(), 1, plan->recv_types[i], plan->recv_ranks[i],
+                  indexedTag(FORWARD), communicator_, &plan->requests[i]);
+    }
+    for(std::size_t i=0; i<plan->send_ranks.size(); ++i)
+      MPI_Isend(handle.sourceData(), 1, plan->send_types[i], plan->send_ranks[i],
+                indexedTag(FORWARD), communicator_, &plan->requests[no_recvs+i]);
+  }
+  plan->pending=true;
+}
 } // end namespace Dune
 
 #endif // HAVE_MPI
@@ -0,0 +1,94 @@
+/*
+  Copyright 2025 Equinor ASA.
+
+  This file is part of the Open Porous Media project (OPM).
+
+  OPM is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  OPM is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with OPM.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#ifndef OPM_FAULTEDSTAIRCASE_HEADER_INCLUDED
+#define OPM_FAULTEDSTAIRCASE_HEADER_INCLUDED
+
+#include <opm/grid/cpgpreprocess/preprocess.h>
+
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <vector>
+
+namespace Opm
+{
+
+/// Corner-point input owning its arrays.
+struct CornerPointInput
+{
+    std::array<int,3> dims;
+    std::vector<double> coord;
+    std::vector<double> zcorn;
+    std::vector<int> actnum;
+
+    grdecl asGrdecl() const
+    {
+        grdecl g;
+        std::copy(dims.begin(), dims.end(), g.dims);
+        g.coord = coord.data();
+        g.zcorn = zcorn.data();
+        g.actnum = actnum.data();
+        return g;
+    }
+};
+
+/// Pillars on a unit spaced mesh.  Every cell column is tilted in opposite
+/// directions along alternating pillars, creating crossing faults across the
+/// vertical connections in both the i and the j direction, and every seventh
+/// cell is inactive.  The pillars are vertical unless slant is nonzero, which
+/// moves the top of the pillars in row j by slant*j in the x direction.
+inline CornerPointInput faultedStaircase(const int nx, const int ny, const int nz,
+                                         const double slant = 0.0)
+{
+    CornerPointInput input { {nx, ny, nz}, {},
+                             std::vector<double>(8*nx*ny*nz),
+                             std::vector<int>(nx*ny*nz, 1) };
+
+    input.coord.reserve(6*(nx + 1)*(ny + 1));
+    for (int j = 0; j <= ny; ++j) {
+        for (int i = 0; i <= nx; ++i) {
+            input.coord.insert(input.coord.end(), {
+                    1.0*i, 1.0*j, 0.0,
+                    1.0*i + slant*j, 1.0*j, 1.0*(nz + 3),
+                });
+        }
+    }
+
+    for (int k = 0; k < 2*nz; ++k) {
+        for (int j = 0; j < 2*ny; ++j) {
+            for (int i = 0; i < 2*nx; ++i) {
+                const double tilt = ((i/2 + j/2) % 2 == 0) ? 0.3 : -0.3;
+                const double fault_throw = tilt * ((i % 2) + (j % 2) - 1);
+
+                input.zcorn[i + 2*nx*(j + 2*ny*k)] = (k + 1)/2 + fault_throw;
+            }
+        }
+    }
+
+    for (std::size_t c = 0; c < input.actnum.size(); c += 7) {
+        input.actnum[c] = 0;
+    }
+
+    return input;
+}
+
+} // namespace Opm
+
+#endif // OPM_FAULTEDSTAIRCASE_HEADER_INCLUDED
@@ -7,6 +7,10 @@
 #include <boost/test/unit_test.hpp>
 
 #include <opm/grid/CpGrid.hpp>
+#include <opm/grid/cpgrid/CellBlockDataHandle.hpp>
+#include <opm/grid/common/GridPartitioning.hpp>
+
+#include <tests/FaultedStaircase.hpp>
 
 
 // Warning suppression for Dune includes.
@@ -22,7 +26,11 @@
 #include <opm/grid/utility/platform_dependent/reenable_warnings.h>
 #include <dune/grid/common/mcmgmapper.hh>
 
+#include <algorithm>
+#include <map>
 #include <numeric>
+#include <optional>
+#include <tuple>
 
 #if defined(HAVE_ZOLTAN) && defined(HAVE_METIS)
 const int partition_methods[] = {1,2};
@@ -144,6 +152,44 @@ private:
     const std::vector<int>& recvindex_;
 };
 
+/// \brief Like CheckGlobalCellHandle, but sends the global cell index as a double.
+class CheckGlobalCellAsDoubleHandle
+{
+public:
+    CheckGlobalCellAsDoubleHandle(const std::vector<int>& sendindex,
+                                  const std::vector<int>& recvindex)
+        : sendindex_(sendindex), recvindex_(recvindex)
+    {}
+
+    typedef double DataType;
+
+    bool fixedSize()
+    {
+        return true;
+    }
+
+    template<class T>
+    std::size_t size(const T&)
+    {
+        return 1;
+    }
+    template<class B>
+    void gather(B& buffer, std::size_t i)
+    {
+        buffer.write(static_cast<double>(sendindex_[i]));
+    }
+    template<class B>
+    void scatter(B& buffer, const std::size_t& i, std::size_t)
+    {
+        double gid;
+        buffer.read(gid);
+        BOOST_REQUIRE(gid==recvindex_[i]);
+    }
+private:
+    const std::vector<int>& sendindex_;
+    const std::vector<int>& recvindex_;
+};
+
 class GatherGlobalIdDataHandle
 {
 public:
@@ -415,6 +461,63 @@ BOOST_AUTO_TEST_CASE(testDistributedComm)
 }
 #endif
 
+template<int codim>
+void checkBulkIds(const Dune::CpGrid& grid)
+{
+    const auto& view = *grid.currentData().back();
+    const auto ids = grid.globalIdSet().ids<codim>(view);
+    BOOST_REQUIRE_EQUAL(ids.size(), static_cast<std::size_t>(grid.size(codim)));
+    for (const auto& entity : entities(grid.leafGridView(), Dune::Codim<codim>()))
+        BOOST_CHECK_EQUAL(ids[entity.index()], grid.globalIdSet().id(entity));
+}
+
+BOOST_AUTO_TEST_CASE(bulkGlobalIds)
+{
+    Dune::CpGrid grid;
+    std::array<int, 3> dims={{8, 4, 2}};
+    std::array<double, 3> size={{ 8.0, 4.0, 2.0}};
+    grid.createCartesian(dims, size);
+    checkBulkIds<0>(grid);
+    checkBulkIds<3>(grid);
+    grid.loadBalance(1, 0);
+    checkBulkIds<0>(grid);
+    checkBulkIds<3>(grid);
+}
+
+void checkFaceNeighbours(const Dune::CpGrid& grid)
+{
+    const auto& table = grid.faceNeighbourTable();
+    BOOST_REQUIRE_EQUAL(table.size(), grid.size(0));
+    for (const auto& element : elements(grid.leafGridView())) {
+        const auto row = grid.faceNeighbours(element.index());
+        BOOST_REQUIRE_EQUAL(row.size(), static_cast<std::size_t>(grid.numCellFaces(element.index())));
+        std::size_t i = 0;
+        for (const auto& intersection : intersections(grid.leafGridView(), element)) {
+            const auto& entry = row[i++];
+            BOOST_CHECK_EQUAL(entry.face, intersection.id());
+            BOOST_CHECK_EQUAL(entry.hasNeighbour(), intersection.neighbor());
+            BOOST_CHECK_EQUAL(entry.neighbour == Dune::cpgrid::FaceNeighbour::Boundary, intersection.boundary());
+            if (intersection.neighbor()) {
+                BOOST_CHECK_EQUAL(entry.neighbour, intersection.outside().index());
+            }
+            auto normal = grid.faceNormal(entry.face);
+            normal *= entry.normalSign();
+            BOOST_CHECK_EQUAL(normal, intersection.centerUnitOuterNormal());
+        }
+    }
+}
+
+BOOST_AUTO_TEST_CASE(faceNeighbourTable)
+{
+    Dune::CpGrid grid;
+    std::array<int, 3> dims={{8, 4, 2}};
+    std::array<double, 3> size={{ 8.0, 4.0, 2.0}};
+    grid.createCartesian(dims, size);
+    checkFaceNeighbours(grid);
+    grid.loadBalance(1, 0);
+    checkFaceNeighbours(grid);
+}
+
 #if HAVE_MPI
 BOOST_AUTO_TEST_CASE(compareWithSequential)
 {
@@ -663,6 +766,40 @@ BOOST_AUTO_TEST_CASE(PartitionTestWithCorners)
 #endif
 }
 
+BOOST_AUTO_TEST_CASE(overlapLayers)
+{
+    // A row of 8 cells split in the middle.
+    Dune::CpGrid grid(Dune::MPIHelper::getLocalCommunicator());
+    grid.createCartesian({8, 1, 1}, {1.0, 1.0, 1.0});
+    std::vector<int> parts = { 0, 0, 0, 0, 1, 1, 1, 1 };
+
+    for (int layers = 1; layers < 4; ++layers) {
+        std::vector<std::set<int>> overlap;
+        Dune::addOverlapLayer(grid, parts, overlap, 0, layers, /* all = */ true);
+        for (int cell = 0; cell < 4; ++cell) {
+            BOOST_CHECK_EQUAL(overlap[cell].count(1) == 1, cell >= 4 - layers);
+            BOOST_CHECK_EQUAL(overlap[7 - cell].count(0) == 1, 7 - cell < 4 + layers);
+        }
+    }
+
+    // 2x2 partitions of a 4x4 grid; the overlap of the lower left one
+    // includes the cell sharing just a corner with it.
+    Dune::CpGrid grid2(Dune::MPIHelper::getLocalCommunicator());
+    grid2.createCartesian({4, 4, 1}, {1.0, 1.0, 1.0});
+    parts.resize(16);
+    for (int j = 0; j < 4; ++j) {
+        for (int i = 0; i < 4; ++i) {
+            parts[i + 4*j] = (i / 2) + 2 * (j / 2);
+        }
+    }
+    std::vector<std::set<int>> overlap;
+    Dune::addOverlapLayer(grid2, parts, overlap, 0, 1);
+    const std::set<int> expected = { 2, 6, 8, 9, 10 };
+    for (int cell = 0; cell < 16; ++cell) {
+        BOOST_CHECK_EQUAL(overlap[cell].count(0) == 1, expected.count(cell) == 1);
+    }
+}
+
 BOOST_AUTO_TEST_CASE(distribute)
 {
 for (auto partition_method : partition_methods) {
@@ -1003,6 +1140,849 @@ for (auto partition_method : partition_methods) {
 }
 }
 
+/// \brief A data handle that checks that the sending and receiving
+/// process agree on the global ids of cells and points.
+class CheckGlobalIdHandle
+{
+public:
+    explicit CheckGlobalIdHandle(const Dune::CpGrid::GlobalIdSet& gid_set)
+        : gid_set_(gid_set)
+    {}
+    typedef int DataType;
+    bool fixedSize(int /*dim*/, int /*codim*/)
+    {
+        return true;
+    }
+    template<class T>
+    std::size_t size(const T&)
+    {
+        return 1;
+    }
+    template<class B, class T>
+    void gather(B& buffer, const T& t)
+    {
+        buffer.write(gid_set_.id(t));
+    }
+    template<class B, class T>
+    void scatter(B& buffer, const T& t, std::size_t)
+    {
+        int gid;
+        buffer.read(gid);
+        BOOST_REQUIRE(gid == gid_set_.id(t));
+    }
+    bool contains(int dim, int codim)
+    {
+        return dim==3 && (codim==0 || codim==3);
+    }
+private:
+    const Dune::CpGrid::GlobalIdSet& gid_set_;
+};
+
+// The rows [rows[0], rows[1]) of a corner-point input.
+Opm::CornerPointInput slabOf(const Opm::CornerPointInput& input, const std::array<int,2>& rows)
+{
+    const int nx = input.dims[0];
+    const int ny = input.dims[1];
+    const int nz = input.dims[2];
+    Opm::CornerPointInput slab{{nx, rows[1] - rows[0], nz}, {}, {}, {}};
+    slab.coord.assign(input.coord.begin() + 6*(nx + 1)*rows[0],
+                      input.coord.begin() + 6*(nx + 1)*(rows[1] + 1));
+    for (int k = 0; k < 2*nz; ++k) {
+        slab.zcorn.insert(slab.zcorn.end(),
+                          input.zcorn.begin() + 2*nx*(2*rows[0] + 2*ny*k),
+                          input.zcorn.begin() + 2*nx*(2*rows[1] + 2*ny*k));
+    }
+    for (int k = 0; k < nz; ++k) {
+        slab.actnum.insert(slab.actnum.end(),
+                           input.actnum.begin() + nx*(rows[0] + ny*k),
+                           input.actnum.begin() + nx*(rows[1] + ny*k));
+    }
+    return slab;
+}
+
+// Moves pillar column i + 1 onto column i, such that the cells between them have
+// zero width and distinct points on the two pillars coincide.
+Opm::CornerPointInput collapsePillars(Opm::CornerPointInput input, int i)
+{
+    const int nx = input.dims[0];
+    for (int j = 0; j <= input.dims[1]; ++j) {
+        std::copy_n(input.coord.begin() + 6*(i + (nx + 1)*j), 6,
+                    input.coord.begin() + 6*(i + 1 + (nx + 1)*j));
+    }
+    return input;
+}
+
+BOOST_AUTO_TEST_CASE(distributedConstruction)
+{
+    int procs = 1;
+    int rank = 0;
+#if HAVE_MPI
+    MPI_Comm_size(MPI_COMM_WORLD, &procs);
+    MPI_Comm_rank(MPI_COMM_WORLD, &rank);
+#endif
+    for (const bool edge_conformal : { false, true }) {
+        for (const bool collapsed : { false, true }) {
+            // Uneven number of rows per process, every other process owns a
+            // single row only.
+            const int ny = 3*((procs + 1)/2) + procs/2;
+            const auto slanted = Opm::faultedStaircase(5, ny, 4, /* slant = */ 0.1);
+            const auto input = collapsed ? collapsePillars(slanted, 2) : slanted;
+
+            // Reference grid, processed serially on every process.
+#if HAVE_MPI
+            Dune::CpGrid serial(MPI_COMM_SELF);
+#else
+            Dune::CpGrid serial;
+#endif
+            serial.processEclipseFormat(input.asGrdecl(), false, false, edge_conformal);
+            std::map<int, int> cart_to_serial;
+            for (int cell = 0; cell < serial.numCells(); ++cell) {
+                cart_to_serial[serial.globalCell()[cell]] = cell;
+            }
+
+            std::array<int,2> owned_rows = { 0, 0 };
+            for (int p = 0; p <= rank; ++p) {
+                owned_rows[0] = owned_rows[1];
+                owned_rows[1] += (p % 2 == 0) ? 3 : 1;
+            }
+            const auto slab = slabOf(input, Dune::CpGrid::slabInputRows(owned_rows, ny));
+
+            Dune::CpGrid grid;
+            grid.processEclipseFormatDistributed(slab.asGrdecl(), ny, owned_rows, false, edge_conformal);
+            BOOST_CHECK(grid.logicalCartesianSize() == (std::array<int,3>{ 5, ny, 4 }));
+
+            int interior_cells = 0;
+            const auto& gridView = grid.leafGridView();
+            for (const auto& element : elements(gridView)) {
+                const int cell = gridView.indexSet().index(element);
+                const auto serial_cell = cart_to_serial.find(grid.globalCell()[cell]);
+                BOOST_REQUIRE(serial_cell != cart_to_serial.end());
+                BOOST_CHECK_CLOSE(grid.cellVolume(cell), serial.cellVolume(serial_cell->second), 1e-10);
+                // Cells without volume have no centroid.
+                for (int d = 0; d < 3 && serial.cellVolume(serial_cell->second) > 0.0; ++d) {
+                    BOOST_CHECK_CLOSE(grid.cellCentroid(cell)[d], serial.cellCentroid(serial_cell->second)[d], 1e-10);
+                }
+                if (element.partitionType() == Dune::InteriorEntity) {
+                    ++interior_cells;
+                    BOOST_CHECK_EQUAL(grid.numCellFaces(cell), serial.numCellFaces(serial_cell->second));
+                }
+            }
+            BOOST_CHECK_EQUAL(grid.comm().sum(interior_cells), serial.numCells());
+
+            if (procs > 1) {
+                checkPartitionType(gridView);
+                CheckGlobalIdHandle handle(grid.globalIdSet());
+                grid.communicate(handle, Dune::All_All_Interface, Dune::ForwardCommunication);
+            }
+        }
+    }
+}
+
+/// \brief A data handle that moves one value per cell, stored by global id.
+class GlobalIdValueHandle
+{
+public:
+    GlobalIdValueHandle(const Dune::CpGrid& grid, std::map<int, double>& values)
+        : grid_(grid), values_(values)
+    {}
+    typedef double DataType;
+    bool fixedSize(int /*dim*/, int /*codim*/)
+    {
+        return true;
+    }
+    template<class T>
+    std::size_t size(const T&)
+    {
+        return 1;
+    }
+    template<class B, class T>
+    void gather(B& buffer, const T& t)
+    {
+        buffer.write(values_.at(grid_.globalIdSet().id(t)));
+    }
+    template<class B, class T>
+    void scatter(B& buffer, const T& t, std::size_t)
+    {
+        double value;
+        buffer.read(value);
+        values_[grid_.globalIdSet().id(t)] = value;
+    }
+    bool contains(int dim, int codim)
+    {
+        return dim==3 && codim==0;
+    }
+private:
+    const Dune::CpGrid& grid_;
+    std::map<int, double>& values_;
+};
+
+#if HAVE_MPI
+// Repeated communication reuses the persistent plans of the grid's communicators,
+// also when handles of different data types alternate.
+BOOST_AUTO_TEST_CASE(repeatedCommunication)
+{
+    Dune::CpGrid grid;
+    grid.createCartesian({8, 4, 2}, {8.0, 4.0, 2.0});
+    grid.loadBalance();
+    const auto& gidSet = grid.globalIdSet();
+    const auto& indexSet = grid.leafIndexSet();
+
+    for (int round = 0; round < 3; ++round) {
+        std::vector<int> cont(grid.size(0), -1);
+        for (const auto& element : elements(grid.leafGridView(), Dune::Partitions::interior)) {
+            cont[indexSet.index(element)] = gidSet.id(element) + round;
+        }
+        CopyCellValues handle(cont);
+        grid.communicate(handle, Dune::InteriorBorder_All_Interface, Dune::ForwardCommunication);
+        for (const auto& element : elements(grid.leafGridView())) {
+            BOOST_CHECK_EQUAL(cont[indexSet.index(element)], gidSet.id(element) + round);
+        }
+
+        std::map<int, double> values;
+        for (const auto& element : elements(grid.leafGridView(), Dune::Partitions::interior)) {
+            values[gidSet.id(element)] = 0.5 * gidSet.id(element) + round;
+        }
+        GlobalIdValueHandle valueHandle(grid, values);
+        grid.communicate(valueHandle, Dune::InteriorBorder_All_Interface, Dune::ForwardCommunication);
+        for (const auto& element : elements(grid.leafGridView())) {
+            BOOST_REQUIRE(values.count(gidSet.id(element)));
+            BOOST_CHECK_EQUAL(values[gidSet.id(element)], 0.5 * gidSet.id(element) + round);
+        }
+    }
+}
+
+// The persistent plans are kept per data type, such that alternating
+// handles of different types reuse them instead of setting them up again.
+BOOST_AUTO_TEST_CASE(persistentPlanReuse)
+{
+    Dune::CpGrid grid;
+    grid.createCartesian({8, 4, 2}, {8.0, 4.0, 2.0});
+    grid.loadBalance();
+    auto global_grid = grid;
+    global_grid.switchToGlobalView();
+
+    auto intHandle = CheckGlobalCellHandle(global_grid.globalCell(), grid.globalCell());
+    auto doubleHandle = CheckGlobalCellAsDoubleHandle(global_grid.globalCell(), grid.globalCell());
+    Opm::VariableSizeCommunicator<> comm(grid.comm(), grid.cellScatterGatherInterface(), 8*4*2*8);
+
+    comm.forwardPersistent(intHandle);
+    const auto intSetups = comm.persistentPlanSetups();
+    for (int round = 0; round < 3; ++round) {
+        comm.forwardPersistent(intHandle);
+    }
+    BOOST_CHECK_EQUAL(comm.persistentPlanSetups(), intSetups);
+
+    comm.forwardPersistent(doubleHandle);
+    const auto setups = comm.persistentPlanSetups();
+    BOOST_CHECK_EQUAL(setups, 2 * intSetups);
+    for (int round = 0; round < 3; ++round) {
+        comm.forwardPersistent(intHandle);
+        comm.forwardPersistent(doubleHandle);
+    }
+    BOOST_CHECK_EQUAL(comm.persistentPlanSetups(), setups);
+}
+
+BOOST_AUTO_TEST_CASE(splitPhaseCommunication)
+{
+    Dune::CpGrid grid;
+    grid.createCartesian({8, 4, 2}, {8.0, 4.0, 2.0});
+    grid.loadBalance();
+    const auto& gidSet = grid.globalIdSet();
+    const auto& indexSet = grid.leafIndexSet();
+
+    std::vector<bool> interior(grid.size(0), false);
+    std::vector<int> interiorCells;
+    for (const auto& element : elements(grid.leafGridView(), Dune::Partitions::interior)) {
+        interior[indexSet.index(element)] = true;
+        interiorCells.push_back(indexSet.index(element));
+    }
+    std::sort(interiorCells.begin(), interiorCells.end());
+
+    // The two sets partition the interior cells, and only deep interior
+    // cells have no face neighbours outside the interior.
+    const auto& sets = grid.interiorCellSets();
+    std::vector<int> allCells = sets.boundary_adjacent;
+    allCells.insert(allCells.end(), sets.deep_interior.begin(), sets.deep_interior.end());
+    std::sort(allCells.begin(), allCells.end());
+    BOOST_CHECK_EQUAL_COLLECTIONS(allCells.begin(), allCells.end(),
+                                  interiorCells.begin(), interiorCells.end());
+    auto onlyInteriorNeighbours = [&](int cell)
+    {
+        for (const auto& entry : grid.faceNeighbours(cell)) {
+            if (entry.neighbour == Dune::cpgrid::FaceNeighbour::ProcessBoundary ||
+                (entry.hasNeighbour() && !interior[entry.neighbour])) {
+                return false;
+            }
+        }
+        return true;
+    };
+    for (const int cell : sets.deep_interior) {
+        BOOST_CHECK(onlyInteriorNeighbours(cell));
+    }
+    for (const int cell : sets.boundary_adjacent) {
+        BOOST_CHECK(!onlyInteriorNeighbours(cell));
+    }
+    if (grid.comm().size() == 1) {
+        BOOST_CHECK(sets.boundary_adjacent.empty());
+    }
+
+    for (int round = 0; round < 2; ++round) {
+        std::vector<int> cont(grid.size(0), -1);
+        std::vector<int> expected(grid.size(0));
+        for (const auto& element : elements(grid.leafGridView())) {
+            expected[indexSet.index(element)] = gidSet.id(element) + round;
+            if (element.partitionType() == Dune::InteriorEntity) {
+                cont[indexSet.index(element)] = gidSet.id(element) + round;
+            }
+        }
+        CopyCellValues handle(cont);
+        auto request = grid.communicateBegin(handle, Dune::InteriorBorder_All_Interface,
+                                             Dune::ForwardCommunication);
+        if (grid.comm().size() > 1) {
+            BOOST_CHECK(request.pending());
+            BOOST_CHECK_THROW(grid.communicateBegin(handle, Dune::InteriorBorder_All_Interface,
+                                                    Dune::ForwardCommunication),
+                              std::logic_error);
+            BOOST_CHECK_THROW(grid.communicate(handle, Dune::InteriorBorder_All_Interface,
+                                               Dune::ForwardCommunication),
+                              std::logic_error);
+        }
+        // Work on the deep interior cells while the overlap is in flight.
+        for (const int cell : sets.deep_interior) {
+            BOOST_CHECK_EQUAL(cont[cell], expected[cell]);
+        }
+        request.wait();
+        BOOST_CHECK(!request.pending());
+        BOOST_CHECK(cont == expected);
+    }
+}
+
+// A forward and a backward communication over the same interface may be
+// pending together, whichever order the processes start them in.
+BOOST_AUTO_TEST_CASE(bothDirectionsPending)
+{
+    Dune::CpGrid grid;
+    grid.createCartesian({8, 4, 2}, {8.0, 4.0, 2.0});
+    grid.loadBalance();
+    const auto& gidSet = grid.globalIdSet();
+    const auto& indexSet = grid.leafIndexSet();
+
+    std::vector<int> forwardValues(grid.size(0)), backwardValues(grid.size(0));
+    auto reset = [&]()
+    {
+        for (const auto& element : elements(grid.leafGridView())) {
+            forwardValues[indexSet.index(element)] = 2 * gidSet.id(element);
+            backwardValues[indexSet.index(element)] = 3 * gidSet.id(element);
+        }
+    };
+    CopyCellValues forwardHandle(forwardValues);
+    CopyCellValues backwardHandle(backwardValues);
+    // The plans are set up in the same order on all processes.
+    reset();
+    grid.communicate(forwardHandle, Dune::All_All_Interface, Dune::ForwardCommunication);
+    grid.communicate(backwardHandle, Dune::All_All_Interface, Dune::BackwardCommunication);
+
+    for (int round = 0; round < 2; ++round) {
+        reset();
+        const bool forwardFirst = (grid.comm().rank() + round) % 2 == 0;
+        std::optional<Dune::cpgrid::CommunicationRequest<CopyCellValues>> forward, backward;
+        for (const bool startForward : {forwardFirst, !forwardFirst}) {
+            if (startForward) {
+                forward.emplace(grid.communicateBegin(forwardHandle, Dune::All_All_Interface,
+                                                      Dune::ForwardCommunication));
+            } else {
+                backward.emplace(grid.communicateBegin(backwardHandle, Dune::All_All_Interface,
+                                                       Dune::BackwardCommunication));
+            }
+        }
+        forward->wait();
+        backward->wait();
+        for (const auto& element : elements(grid.leafGridView())) {
+            BOOST_CHECK_EQUAL(forwardValues[indexSet.index(element)], 2 * gidSet.id(element));
+            BOOST_CHECK_EQUAL(backwardValues[indexSet.index(element)], 3 * gidSet.id(element));
+        }
+    }
+}
+
+BOOST_AUTO_TEST_CASE(neighbourhoodCollectives)
+{
+    Dune::CpGrid grid;
+    grid.createCartesian({8, 4, 2}, {8.0, 4.0, 2.0});
+    grid.loadBalance();
+    const auto& gidSet = grid.globalIdSet();
+    const auto& indexSet = grid.leafIndexSet();
+
+    // Switch back and forth, as the communicators of the interfaces are kept.
+    for (const auto method : {Dune::neighbourhoodCollectives, Dune::pointToPoint,
+                              Dune::neighbourhoodCollectives}) {
+        grid.setCommunicationMethod(method);
+        BOOST_CHECK_EQUAL(grid.communicationMethod(), method);
+
+        std::vector<int> cont(grid.size(0), -1);
+        for (const auto& element : elements(grid.leafGridView(), Dune::Partitions::interior)) {
+            cont[indexSet.index(element)] = gidSet.id(element);
+        }
+        CopyCellValues handle(cont);
+        grid.communicate(handle, Dune::InteriorBorder_All_Interface, Dune::ForwardCommunication);
+        for (const auto& element : elements(grid.leafGridView())) {
+            BOOST_CHECK_EQUAL(cont[indexSet.index(element)], gidSet.id(element));
+        }
+
+        std::vector<int> split(grid.size(0), -1);
+        for (const auto& element : elements(grid.leafGridView(), Dune::Partitions::interior)) {
+            split[indexSet.index(element)] = 2 * gidSet.id(element);
+        }
+        CopyCellValues splitHandle(split);
+        auto request = grid.communicateBegin(splitHandle, Dune::InteriorBorder_All_Interface,
+                                             Dune::ForwardCommunication);
+        request.wait();
+        for (const auto& element : elements(grid.leafGridView())) {
+            BOOST_CHECK_EQUAL(split[indexSet.index(element)], 2 * gidSet.id(element));
+        }
+
+        // Another data type replaces the plan of the interface.
+        std::map<int, double> values;
+        for (const auto& element : elements(grid.leafGridView(), Dune::Partitions::interior)) {
+            values[gidSet.id(element)] = 0.5 * gidSet.id(element);
+        }
+        GlobalIdValueHandle valueHandle(grid, values);
+        grid.communicate(valueHandle, Dune::InteriorBorder_All_Interface, Dune::ForwardCommunication);
+        for (const auto& element : elements(grid.leafGridView())) {
+            BOOST_REQUIRE(values.count(gidSet.id(element)));
+            BOOST_CHECK_EQUAL(values[gidSet.id(element)], 0.5 * gidSet.id(element));
+        }
+    }
+}
+
+BOOST_AUTO_TEST_CASE(cellBlockDataHandle)
+{
+    Dune::CpGrid grid;
+    grid.createCartesian({8, 4, 2}, {8.0, 4.0, 2.0});
+    constexpr std::size_t blockSize = 3;
+    // Only the root rank has the cells of the global grid.
+    std::vector<double> global(grid.size(0) * blockSize);
+    for (std::size_t i = 0; i < global.size(); ++i) {
+        global[i] = 10.0 * (i / blockSize) + i % blockSize;
+    }
+    grid.loadBalance();
+    const auto& gidSet = grid.globalIdSet();
+    const auto& indexSet = grid.leafIndexSet();
+    auto expected = [&](const auto& element, std::size_t k, double shift)
+    {
+        return 10.0 * gidSet.id(element) + k + shift;
+    };
+
+    // Data can only be moved if the grid was distributed.
+    const bool distributed = grid.comm().size() > 1;
+    std::vector<double> local(grid.size(0) * blockSize, -1.0);
+    Dune::cpgrid::CellBlockDataHandle<double> scatterHandle(global, local, blockSize);
+    if (distributed) {
+        grid.scatterData(scatterHandle);
+    } else {
+        local = global;
+    }
+    for (const auto& element : elements(grid.leafGridView(), Dune::Partitions::interior)) {
+        for (std::size_t k = 0; k < blockSize; ++k) {
+            BOOST_CHECK_EQUAL(local[indexSet.index(element) * blockSize + k], expected(element, k, 0.0));
+        }
+    }
+
+    for (const auto method : {Dune::pointToPoint, Dune::neighbourhoodCollectives}) {
+        grid.setCommunicationMethod(method);
+        std::vector<double> values(local.size(), -1.0);
+        for (const auto& element : elements(grid.leafGridView(), Dune::Partitions::interior)) {
+            for (std::size_t k = 0; k < blockSize; ++k) {
+                values[indexSet.index(element) * blockSize + k] = expected(element, k, 1.0);
+            }
+        }
+        Dune::cpgrid::CellBlockDataHandle<double> handle(values, blockSize);
+        grid.communicate(handle, Dune::InteriorBorder_All_Interface, Dune::ForwardCommunication);
+        for (const auto& element : elements(grid.leafGridView())) {
+            for (std::size_t k = 0; k < blockSize; ++k) {
+                BOOST_CHECK_EQUAL(values[indexSet.index(element) * blockSize + k], expected(element, k, 1.0));
+            }
+        }
+        auto request = grid.communicateBegin(handle, Dune::InteriorBorder_All_Interface,
+                                             Dune::ForwardCommunication);
+        request.wait();
+        BOOST_CHECK(!request.pending());
+
+        // Interfaces sending and receiving the same cells, from and into the same vector.
+        for (const auto iftype : {Dune::All_All_Interface, Dune::Overlap_OverlapFront_Interface}) {
+            for (const auto dir : {Dune::ForwardCommunication, Dune::BackwardCommunication}) {
+                grid.communicate(handle, iftype, dir);
+                auto split = grid.communicateBegin(handle, iftype, dir);
+                split.wait();
+                for (const auto& element : elements(grid.leafGridView())) {
+                    for (std::size_t k = 0; k < blockSize; ++k) {
+                        BOOST_CHECK_EQUAL(values[indexSet.index(element) * blockSize + k],
+                                          expected(element, k, 1.0));
+                    }
+                }
+            }
+        }
+    }
+    grid.setCommunicationMethod(Dune::pointToPoint);
+
+    if (!distributed) {
+        return;
+    }
+    for (auto& value : local) {
+        value += 2.0;
+    }
+    std::vector<double> gathered(global.size(), -1.0);
+    Dune::cpgrid::CellBlockDataHandle<double> gatherHandle(local, gathered, blockSize);
+    grid.gatherData(gatherHandle);
+    for (std::size_t i = 0; i < gathered.size(); ++i) {
+        BOOST_CHECK_EQUAL(gathered[i], global[i] + 2.0);
+    }
+}
+#endif
+
+BOOST_AUTO_TEST_CASE(rebalancePartition)
+{
+    Dune::CpGrid grid;
+    grid.createCartesian({10, 10, 10}, {1.0, 1.0, 1.0});
+    if (grid.comm().rank() != 0) {
+        return;
+    }
+    // Two slabs where the first one has three times the work per cell.
+    std::vector<int> parts(grid.size(0));
+    std::vector<double> weights(grid.size(0));
+    for (int cell = 0; cell < grid.size(0); ++cell) {
+        parts[cell] = cell < 500 ? 0 : 1;
+        weights[cell] = cell < 500 ? 3.0 : 1.0;
+    }
+    const auto initialParts = parts;
+    Dune::rebalancePartition(grid, parts, weights, 2, 1.1);
+
+    std::array<double, 2> load{};
+    int moved = 0;
+    for (int cell = 0; cell < grid.size(0); ++cell) {
+        load[parts[cell]] += weights[cell];
+        moved += parts[cell] != initialParts[cell];
+        // Only cells of the overloaded slab move.
+        BOOST_CHECK(parts[cell] == initialParts[cell] || initialParts[cell] == 0);
+    }
+    BOOST_CHECK_LE(std::max(load[0], load[1]), 1.1 * (load[0] + load[1]) / 2);
+    BOOST_CHECK_LT(moved, 500);
+
+    // A balanced partitioning is left alone.
+    std::fill(weights.begin(), weights.end(), 1.0);
+    parts = initialParts;
+    Dune::rebalancePartition(grid, parts, weights, 2, 1.1);
+    BOOST_CHECK(parts == initialParts);
+}
+
+BOOST_AUTO_TEST_CASE(rebalance)
+{
+    Dune::CpGrid grid;
+    grid.createCartesian({10, 10, 10}, {1.0, 1.0, 1.0});
+    const auto& cc = grid.comm();
+    if (cc.size() == 1) {
+        return;
+    }
+
+    // Slabs of equal size, where the cells of rank 0 have three times the work.
+    const int numCells = 1000;
+    const int numCellsPerProc = numCells / cc.size();
+    std::vector<int> parts;
+    if (cc.rank() == 0) {
+        parts.resize(numCells);
+        for (int cell = 0; cell < numCells; ++cell) {
+            parts[cell] = std::min(cell / numCellsPerProc, cc.size() - 1);
+        }
+    }
+    grid.loadBalance(parts);
+
+    const auto work = [numCellsPerProc](int gid) { return gid < numCellsPerProc ? 3.0 : 1.0; };
+    const auto& gidSet = grid.globalIdSet();
+    const auto& indexSet = grid.leafIndexSet();
+    std::vector<double> weights(grid.size(0));
+    std::map<int, double> values;
+    for (const auto& element : elements(grid.leafGridView())) {
+        const int gid = gidSet.id(element);
+        weights[indexSet.index(element)] = work(gid);
+        values[gid] = 0.5 * gid;
+    }
+
+    std::vector<int> oldOwner(numCells, -1);
+    for (const auto& element : elements(grid.leafGridView(), Dune::Partitions::interior)) {
+        oldOwner[gidSet.id(element)] = cc.rank();
+    }
+    cc.max(oldOwner.data(), numCells);
+
+    GlobalIdValueHandle handle(grid, values);
+    const auto ret = grid.rebalance(handle, weights);
+    BOOST_REQUIRE(std::get<0>(ret));
+
+    double load = 0;
+    int ownedCells = 0;
+    std::vector<int> owner(numCells, -1);
+    for (const auto& element : elements(grid.leafGridView(), Dune::Partitions::interior)) {
+        const int gid = gidSet.id(element);
+        load += work(gid);
+        ++ownedCells;
+        owner[gid] = cc.rank();
+    }
+    for (const auto& element : elements(grid.leafGridView())) {
+        const int gid = gidSet.id(element);
+        BOOST_REQUIRE(values.count(gid));
+        BOOST_CHECK_EQUAL(values[gid], 0.5 * gid);
+    }
+    BOOST_CHECK_EQUAL(cc.sum(ownedCells), numCells);
+    BOOST_CHECK_LE(cc.max(load), 1.1 * cc.sum(load) / cc.size());
+    cc.max(owner.data(), numCells);
+    int moved = 0;
+    for (int gid = 0; gid < numCells; ++gid) {
+        moved += owner[gid] != oldOwner[gid];
+    }
+    BOOST_CHECK_GT(moved, 0);
+    // Only cells that need to change owner do so.
+    BOOST_CHECK_LT(moved, numCells / 2);
+
+    checkPartitionType(grid.leafGridView());
+    CheckGlobalIdHandle gidHandle(grid.globalIdSet());
+    grid.communicate(gidHandle, Dune::All_All_Interface, Dune::ForwardCommunication);
+
+    // Load balancing the global grid with the new owners yields the same distributed view.
+    Dune::CpGrid reference;
+    reference.createCartesian({10, 10, 10}, {1.0, 1.0, 1.0});
+    reference.loadBalance(cc.rank() == 0 ? owner : std::vector<int>());
+    BOOST_REQUIRE_EQUAL(reference.size(0), grid.size(0));
+    BOOST_CHECK_EQUAL(reference.numFaces(), grid.numFaces());
+    BOOST_REQUIRE_EQUAL(reference.size(3), grid.size(3));
+    auto referenceElement = elements(reference.leafGridView()).begin();
+    for (const auto& element : elements(grid.leafGridView())) {
+        BOOST_CHECK_EQUAL(reference.globalIdSet().id(*referenceElement), gidSet.id(element));
+        BOOST_CHECK(referenceElement->partitionType() == element.partitionType());
+        const auto center = element.geometry().center();
+        const auto referenceCenter = referenceElement->geometry().center();
+        for (int d = 0; d < 3; ++d) {
+            BOOST_CHECK_CLOSE(center[d], referenceCenter[d], 1e-10);
+        }
+        ++referenceElement;
+    }
+    auto referenceVertex = vertices(reference.leafGridView()).begin();
+    for (const auto& vertex : vertices(grid.leafGridView())) {
+        BOOST_CHECK_EQUAL(reference.globalIdSet().id(*referenceVertex), gidSet.id(vertex));
+        BOOST_CHECK(referenceVertex->partitionType() == vertex.partitionType());
+        ++referenceVertex;
+    }
+
+    // Data is still scattered from and gathered to the global view.
+    std::vector<double> global(cc.rank() == 0 ? numCells : 0);
+    std::iota(global.begin(), global.end(), 0.0);
+    std::vector<double> local(grid.size(0), -1.0);
+    Dune::cpgrid::CellBlockDataHandle<double> scatterHandle(global, local, 1);
+    grid.scatterData(scatterHandle);
+    for (const auto& element : elements(grid.leafGridView())) {
+        BOOST_CHECK_EQUAL(local[grid.leafIndexSet().index(element)], gidSet.id(element));
+    }
+    std::vector<double> gathered(global.size(), -1.0);
+    Dune::cpgrid::CellBlockDataHandle<double> gatherHandle(local, gathered, 1);
+    grid.gatherData(gatherHandle);
+    BOOST_CHECK(gathered == global);
+
+    // The grid can be rebalanced again, without data.
+    weights.assign(grid.size(0), 1.0);
+    BOOST_CHECK(std::get<0>(grid.rebalance(weights)));
+    ownedCells = 0;
+    for ([[maybe_unused]] const auto& element : elements(grid.leafGridView(), Dune::Partitions::interior)) {
+        ++ownedCells;
+    }
+    BOOST_CHECK_EQUAL(cc.sum(ownedCells), numCells);
+}
+
+BOOST_AUTO_TEST_CASE(weightedLoadBalance)
+{
+    // The cells of the lower half have three times the work. The simple
+    // method meets the tolerance exactly, the graph partitioners roughly.
+    std::vector<std::pair<int, double>> methods{{Dune::PartitionMethod::simple, 1.1}};
+    for (auto partition_method : partition_methods) {
+        methods.emplace_back(partition_method, 1.25);
+    }
+    for (const auto& [partition_method, bound] : methods) {
+        Dune::CpGrid grid;
+        grid.createCartesian({10, 10, 10}, {1.0, 1.0, 1.0});
+        const auto& cc = grid.comm();
+        if (cc.size() == 1) {
+            return;
+        }
+        const auto work = [](int gid) { return gid < 500 ? 3.0 : 1.0; };
+        std::vector<double> weights(grid.size(0));
+        for (std::size_t cell = 0; cell < weights.size(); ++cell) {
+            weights[cell] = work(cell);
+        }
+#if IS_SCOTCH_METIS_HEADER
+        const double imbalanceTol = partition_method == 2 ? 0.1 : 1.1;
+#else
+        const double imbalanceTol = 1.1;
+#endif
+        grid.loadBalance(Dune::EdgeWeightMethod::uniformEdgeWgt, nullptr, {}, nullptr, false, false, 1,
+                         partition_method, imbalanceTol, -1, weights);
+
+        double load = 0;
+        int ownedCells = 0;
+        for (const auto& element : elements(grid.leafGridView(), Dune::Partitions::interior)) {
+            load += work(grid.globalIdSet().id(element));
+            ++ownedCells;
+        }
+        BOOST_CHECK_EQUAL(cc.sum(ownedCells), 1000);
+        BOOST_CHECK_LE(cc.max(load), bound * cc.sum(load) / cc.size());
+    }
+
+    // The number of weights has to be a multiple of the number of cells.
+    Dune::CpGrid grid;
+    grid.createCartesian({4, 4, 4}, {1.0, 1.0, 1.0});
+    if (grid.comm().size() > 1) {
+        const std::vector<double> weights(grid.size(0) > 0 ? grid.size(0) + 1 : 0, 1.0);
+        BOOST_CHECK_THROW(grid.loadBalance(Dune::EdgeWeightMethod::uniformEdgeWgt, nullptr, {}, nullptr, false, false, 1,
+                                           Dune::PartitionMethod::simple, 1.1, -1, weights),
+                          std::invalid_argument);
+    }
+}
+
+BOOST_AUTO_TEST_CASE(contiguousPartitions)
+{
+    Dune::CpGrid grid;
+    grid.createCartesian({8, 4, 2}, {8.0, 4.0, 2.0});
+    BOOST_CHECK_EQUAL(grid.currentLeafData().interiorCellsEnd(), grid.size(0));
+
+    grid.loadBalance(Dune::EdgeWeightMethod::uniformEdgeWgt, nullptr, {}, nullptr, /* ownersFirst = */ true);
+    const auto& indexSet = grid.leafIndexSet();
+    const int interiorEnd = grid.currentLeafData().interiorCellsEnd();
+    BOOST_REQUIRE_GE(interiorEnd, 0);
+    BOOST_REQUIRE_LE(interiorEnd, grid.size(0));
+    for (const auto& element : elements(grid.leafGridView())) {
+        BOOST_CHECK_EQUAL(element.partitionType() == Dune::InteriorEntity,
+                          indexSet.index(element) < interiorEnd);
+    }
+
+    // The partition iterators visit exactly the index ranges.
+    int index = 0;
+    for (const auto& element : elements(grid.leafGridView(), Dune::Partitions::interior)) {
+        BOOST_CHECK_EQUAL(indexSet.index(element), index++);
+    }
+    BOOST_CHECK_EQUAL(index, interiorEnd);
+    index = 0;
+    for (const auto& element : elements(grid.leafGridView(), Dune::Partitions::interiorBorder)) {
+        BOOST_CHECK_EQUAL(indexSet.index(element), index++);
+    }
+    BOOST_CHECK_EQUAL(index, interiorEnd);
+    index = 0;
+    for (const auto& element : elements(grid.leafGridView(), Dune::Partitions::all)) {
+        BOOST_CHECK_EQUAL(indexSet.index(element), index++);
+    }
+    BOOST_CHECK_EQUAL(index, grid.size(0));
+    index = 0;
+    for ([[maybe_unused]] const auto& element : elements(grid.leafGridView(), Dune::Partitions::interiorBorderOverlap)) {
+        ++index;
+    }
+    BOOST_CHECK_EQUAL(index, grid.size(0));
+    BOOST_CHECK(grid.leafGridView().begin<0, Dune::Ghost_Partition>() == grid.leafGridView().end<0, Dune::Ghost_Partition>());
+}
+
+BOOST_AUTO_TEST_CASE(renumbering)
+{
+    Dune::CpGrid grid;
+    grid.createCartesian({8, 4, 2}, {8.0, 4.0, 2.0});
+    const auto& indexSet = grid.leafIndexSet();
+
+    // Centroid, corners and neighbours of each cell, by its global cell.
+    using Cell = std::tuple<Dune::FieldVector<double, 3>, std::vector<Dune::FieldVector<double, 3>>, std::vector<int>>;
+    auto cellsByGlobalCell = [&grid, &indexSet]()
+    {
+        std::map<int, Cell> cells;
+        for (const auto& element : elements(grid.leafGridView())) {
+            std::vector<Dune::FieldVector<double, 3>> corners;
+            for (int corner = 0; corner < element.geometry().corners(); ++corner) {
+                corners.push_back(element.geometry().corner(corner));
+            }
+            std::vector<int> neighbours;
+            for (const auto& intersection : intersections(grid.leafGridView(), element)) {
+                if (intersection.neighbor()) {
+                    neighbours.push_back(grid.globalCell()[indexSet.index(intersection.outside())]);
+                }
+            }
+            std::ranges::sort(neighbours);
+            cells[grid.globalCell()[indexSet.index(element)]] = {element.geometry().center(), corners, neighbours};
+        }
+        return cells;
+    };
+
+    const auto before = cellsByGlobalCell();
+    const auto globalCellBefore = grid.globalCell();
+    const auto renumbering = grid.renumber(Dune::reverseCuthillMcKee);
+    BOOST_REQUIRE_EQUAL(renumbering.cells.size(), globalCellBefore.size());
+    for (std::size_t cell = 0; cell < renumbering.cells.size(); ++cell) {
+        BOOST_CHECK_EQUAL(grid.globalCell()[cell], globalCellBefore[renumbering.cells[cell]]);
+    }
+    BOOST_CHECK_EQUAL(renumbering.faces.size(), static_cast<std::size_t>(grid.numFaces()));
+    BOOST_CHECK_EQUAL(renumbering.points.size(), static_cast<std::size_t>(grid.size(3)));
+    const auto after = cellsByGlobalCell();
+    BOOST_REQUIRE_EQUAL(after.size(), before.size());
+    for (const auto& [globalCell, cell] : after) {
+        const auto& old = before.at(globalCell);
+        auto centroidDifference = std::get<0>(cell);
+        centroidDifference -= std::get<0>(old);
+        BOOST_CHECK_SMALL(centroidDifference.two_norm(), 1e-12);
+        BOOST_REQUIRE_EQUAL(std::get<1>(cell).size(), std::get<1>(old).size());
+        for (std::size_t corner = 0; corner < std::get<1>(cell).size(); ++corner) {
+            auto difference = std::get<1>(cell)[corner];
+            difference -= std::get<1>(old)[corner];
+            BOOST_CHECK_SMALL(difference.two_norm(), 1e-12);
+        }
+        BOOST_CHECK(std::get<2>(cell) == std::get<2>(old));
+    }
+
+    // The renumbered global grid is distributed, and the distributed view renumbered with
+    // its interior cells first.
+    grid.loadBalance();
+    const auto distributedRenumbering = grid.renumber(Dune::hilbertCurve, true);
+    BOOST_CHECK_EQUAL(distributedRenumbering.cells.size(), static_cast<std::size_t>(grid.size(0)));
+    int numInterior = 0;
+    for (const auto& element : elements(grid.leafGridView(), Dune::Partitions::interior)) {
+        BOOST_CHECK_EQUAL(indexSet.index(element), numInterior);
+        ++numInterior;
+    }
+    BOOST_CHECK_EQUAL(grid.currentLeafData().interiorCellsEnd(), numInterior);
+
+    // The communication interfaces follow the renumbering.
+    const auto& gidSet = grid.globalIdSet();
+    std::vector<double> values(grid.size(0), -1.0);
+    for (const auto& element : elements(grid.leafGridView(), Dune::Partitions::interior)) {
+        values[indexSet.index(element)] = gidSet.id(element);
+    }
+    Dune::cpgrid::CellBlockDataHandle<double> handle(values, 1);
+    grid.communicate(handle, Dune::InteriorBorder_All_Interface, Dune::ForwardCommunication);
+    for (const auto& element : elements(grid.leafGridView())) {
+        BOOST_CHECK_EQUAL(values[indexSet.index(element)], gidSet.id(element));
+    }
+
+    // So do the ones scattering from and gathering to the global grid.
+    if (grid.comm().size() > 1) {
+        std::vector<int> globalCells;
+        if (grid.comm().rank() == 0) {
+            grid.switchToGlobalView();
+            globalCells = grid.globalCell();
+            // The distributed view refers to the global view by its indices.
+            BOOST_CHECK_THROW(grid.renumber(Dune::hilbertCurve), std::logic_error);
+            grid.switchToDistributedView();
+        }
+        std::vector<int> scattered(grid.size(0), -1);
+        Dune::cpgrid::CellBlockDataHandle<int> scatterHandle(globalCells, scattered, 1);
+        grid.scatterData(scatterHandle);
+        for (const auto& element : elements(grid.leafGridView(), Dune::Partitions::interior)) {
+            BOOST_CHECK_EQUAL(scattered[indexSet.index(element)], grid.globalCell()[indexSet.index(element)]);
+        }
+        std::vector<int> gathered(globalCells.size(), -1);
+        Dune::cpgrid::CellBlockDataHandle<int> gatherHandle(scattered, gathered, 1);
+        grid.gatherData(gatherHandle);
+        BOOST_CHECK(gathered == globalCells);
+    }
+}
+
 bool
 init_unit_test_func()
 {
@@ -35,6 +35,8 @@
 #include <opm/grid/utility/OpmLog.hpp>
 
 #include <algorithm>
+#include <array>
+#include <cmath>
 
 struct Fixture
 {
@@ -571,3 +573,38 @@ BOOST_AUTO_TEST_CASE(refine_distorted_cube)
     refine_and_check(g, {2, 3, 4});
 
 }
+
+BOOST_AUTO_TEST_CASE(contiguous_geometry_arrays)
+{
+    Dune::CpGrid grid;
+    grid.createCartesian({4, 3, 2}, {1.0, 2.0, 0.5});
+    grid.globalRefine(1);
+
+    for (int level = 0; level <= grid.maxLevel(); ++level) {
+        const auto& arrays = grid.currentData()[level]->geometryArrays();
+        BOOST_REQUIRE_EQUAL(arrays.cell_volumes.size(), static_cast<std::size_t>(grid.size(level, 0)));
+        BOOST_REQUIRE_EQUAL(arrays.face_areas.size(), static_cast<std::size_t>(grid.numFaces(level)));
+        for (const auto& element : elements(grid.levelGridView(level))) {
+            BOOST_CHECK_EQUAL(arrays.cell_volumes[element.index()], element.geometry().volume());
+            BOOST_CHECK_EQUAL(arrays.cell_centroids[element.index()], element.geometry().center());
+        }
+        // Built once per view.
+        BOOST_CHECK_EQUAL(&grid.currentData()[level]->geometryArrays(), &arrays);
+    }
+
+    // The CpGrid accessors read the leaf view, which has cells of size 0.5 x 1 x 0.25.
+    BOOST_REQUIRE_EQUAL(grid.cellVolumes().size(), static_cast<std::size_t>(grid.size(0)));
+    for (const auto& element : elements(grid.leafGridView())) {
+        BOOST_CHECK_CLOSE(grid.cellVolume(element.index()), element.geometry().volume(), 1e-12);
+        BOOST_CHECK_CLOSE(grid.cellVolume(element.index()), 0.125, 1e-12);
+        BOOST_CHECK_EQUAL(&grid.cellCentroid(element.index()), &grid.cellCentroids()[element.index()]);
+    }
+    BOOST_REQUIRE_EQUAL(grid.faceAreas().size(), static_cast<std::size_t>(grid.numFaces()));
+    const std::array<double, 3> areas = {0.25, 0.125, 0.5};
+    for (int face = 0; face < grid.numFaces(); ++face) {
+        const auto& normal = grid.faceNormal(face);
+        const int dir = std::abs(normal[0]) > 0.5 ? 0 : (std::abs(normal[1]) > 0.5 ? 1 : 2);
+        BOOST_CHECK_CLOSE(grid.faceArea(face), areas[dir], 1e-12);
+        BOOST_CHECK_EQUAL(&grid.faceCentroid(face), &grid.faceCentroids()[face]);
+    }
+}
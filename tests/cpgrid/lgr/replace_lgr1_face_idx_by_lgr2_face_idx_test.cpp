@@ -258,3 +258,128 @@ BOOST_AUTO_TEST_CASE(neighboring_singleCellRefinements_z)
     BOOST_CHECK_EQUAL( Opm::Lgr::replaceLgr1FaceIdxByLgr2FaceIdx(lgr2_dim, faceTrue_lgr2, lgr2_ptr, lgr1_dim), faceFalse_lgr1);
     BOOST_CHECK_EQUAL( Opm::Lgr::replaceLgr1FaceIdxByLgr2FaceIdx(lgr1_dim, faceFalse_lgr1, lgr1_ptr, lgr2_dim), faceTrue_lgr2);
 }
+
+BOOST_AUTO_TEST_CASE(compactSingleCellRefinement_of_known_cell)
+{
+    // adapt() refines each marked element into a SingleCellRefinement instead of a CpGridData.
+    // Refine the cell [0,1]x[0,2]x[0,3] into 3x2x4 children and check the result against the
+    // numbering introduced in Geometry::refineCellifiedPatch.
+    Dune::CpGrid grid;
+    grid.createCartesian(/*grid_dim*/ {1,1,1}, /*cell_sizes*/ {1.0, 2.0, 3.0});
+    const auto& parent = grid.currentLeafData();
+
+    const std::array<int,3> lgr_dim = {3,2,4};
+    const auto& [lgr_ptr, parent_to_refined_corners, parent_to_children_faces, parent_to_children_cells,
+                 child_to_parent_faces, child_to_parent_cells]
+        = parent.refineSingleCellCompact(lgr_dim, 0);
+
+    // 4x3x5 corners, 24 cells, and 3x2x5 K_FACES, 4x2x4 I_FACES, 3x3x4 J_FACES.
+    BOOST_REQUIRE_EQUAL(lgr_ptr->size(0), 24);
+    BOOST_REQUIRE_EQUAL(lgr_ptr->size(3), 60);
+    BOOST_REQUIRE_EQUAL(lgr_ptr->numFaces(), 98);
+
+    // Refined corner with index J*20 + I*5 + K sits at {I/3, J, 3K/4}.
+    const auto& corners = *lgr_ptr->getGeometry().geomVector(std::integral_constant<int,3>());
+    for (int j = 0; j < 3; ++j) {
+        for (int i = 0; i < 4; ++i) {
+            for (int k = 0; k < 5; ++k) {
+                const Dune::FieldVector<double,3> expected = {i/3.0, 1.0*j, 0.75*k};
+                BOOST_CHECK_SMALL((corners.get(j*20 + i*5 + k).center() - expected).two_norm(), 1e-12);
+            }
+        }
+    }
+    const std::array<int,8> refined_parent_corners = {0, 15, 40, 55, 4, 19, 44, 59};
+    BOOST_REQUIRE_EQUAL(parent_to_refined_corners.size(), 8u);
+    for (int corner = 0; corner < 8; ++corner) {
+        BOOST_CHECK_EQUAL(parent_to_refined_corners[corner][0], parent.cellToPoint(0)[corner]);
+        BOOST_CHECK_EQUAL(parent_to_refined_corners[corner][1], refined_parent_corners[corner]);
+    }
+
+    for (int face = 0; face < 98; ++face) {
+        const auto expected_tag = face < 30 ? face_tag::K_FACE : (face < 62 ? face_tag::I_FACE : face_tag::J_FACE);
+        BOOST_CHECK_EQUAL(lgr_ptr->faceTag(face), expected_tag);
+    }
+
+    // Each child cell with index k*6 + j*3 + i has volume 1/4, its 8 corners and 6 faces ordered
+    // {K false, J false, I false, I true, J true, K true}.
+    const auto& cells = *lgr_ptr->getGeometry().geomVector(std::integral_constant<int,0>());
+    for (int k = 0; k < 4; ++k) {
+        for (int j = 0; j < 2; ++j) {
+            for (int i = 0; i < 3; ++i) {
+                const int cell = k*6 + j*3 + i;
+                const auto& geometry = cells[Dune::cpgrid::EntityRep<0>(cell, true)];
+                BOOST_CHECK_CLOSE(geometry.volume(), 0.25, 1e-10);
+                const Dune::FieldVector<double,3> center = {(i + 0.5)/3, j + 0.5, 0.75*(k + 0.5)};
+                BOOST_CHECK_SMALL((geometry.center() - center).two_norm(), 1e-12);
+
+                const int c0 = j*20 + i*5 + k;
+                const std::array<int,8> cell_to_point = {c0, c0 + 5, c0 + 20, c0 + 25,
+                                                         c0 + 1, c0 + 6, c0 + 21, c0 + 26};
+                BOOST_CHECK(lgr_ptr->cellToPoint(cell) == cell_to_point);
+
+                const std::array<int,6> cell_to_face = {k*6 + j*3 + i,
+                                                        62 + j*12 + i*4 + k,
+                                                        30 + i*8 + k*2 + j,
+                                                        30 + (i+1)*8 + k*2 + j,
+                                                        62 + (j+1)*12 + i*4 + k,
+                                                        (k+1)*6 + j*3 + i};
+                const auto& faces = lgr_ptr->cellToFace(cell);
+                BOOST_REQUIRE_EQUAL(static_cast<int>(faces.size()), 6);
+                for (int local_face = 0; local_face < 6; ++local_face) {
+                    BOOST_CHECK_EQUAL(faces[local_face].index(), cell_to_face[local_face]);
+                    BOOST_CHECK_EQUAL(faces[local_face].orientation(), local_face > 2);
+                }
+            }
+        }
+    }
+
+    // The children of the parent faces are the consecutive refined faces on the parent cell's boundary.
+    BOOST_REQUIRE_EQUAL(parent_to_children_faces.size(), 6u);
+    BOOST_CHECK_EQUAL(child_to_parent_faces.size(), 52u);
+    std::size_t child_entry = 0;
+    for (const auto& [parent_face, children] : parent_to_children_faces) {
+        const auto tag = parent.faceTag(parent_face);
+        bool orientation = false;
+        for (const auto& face : parent.cellToFace(0)) {
+            if (face.index() == parent_face) {
+                orientation = face.orientation();
+            }
+        }
+        int first_child = 0;
+        int num_children = 0;
+        switch (tag) {
+        case face_tag::K_FACE:
+            first_child = orientation ? 24 : 0;
+            num_children = 6;
+            break;
+        case face_tag::I_FACE:
+            first_child = orientation ? 54 : 30;
+            num_children = 8;
+            break;
+        case face_tag::J_FACE:
+            first_child = orientation ? 86 : 62;
+            num_children = 12;
+            break;
+        default:
+            BOOST_FAIL("Unexpected face tag.");
+        }
+        BOOST_REQUIRE_EQUAL(static_cast<int>(children.size()), num_children);
+        for (int child = 0; child < num_children; ++child) {
+            BOOST_CHECK_EQUAL(children[child], first_child + child);
+            BOOST_REQUIRE(child_entry < child_to_parent_faces.size());
+            BOOST_CHECK_EQUAL(child_to_parent_faces[child_entry][0], first_child + child);
+            BOOST_CHECK_EQUAL(child_to_parent_faces[child_entry][1], parent_face);
+            ++child_entry;
+        }
+    }
+
+    const auto& [parent_cell, children_cells] = parent_to_children_cells;
+    BOOST_CHECK_EQUAL(parent_cell, 0);
+    BOOST_REQUIRE_EQUAL(children_cells.size(), 24u);
+    BOOST_REQUIRE_EQUAL(child_to_parent_cells.size(), 24u);
+    for (int cell = 0; cell < 24; ++cell) {
+        BOOST_CHECK_EQUAL(children_cells[cell], cell);
+        BOOST_CHECK_EQUAL(child_to_parent_cells[cell][0], cell);
+        BOOST_CHECK_EQUAL(child_to_parent_cells[cell][1], 0);
+    }
+}
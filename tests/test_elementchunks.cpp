@@ -35,6 +35,10 @@
 #include <opm/grid/utility/ElementChunks.hpp>
 #include <opm/grid/utility/OpmLog.hpp>
 
+#include <algorithm>
+#include <array>
+#include <vector>
+
 struct Fixture
 {
     Fixture()
@@ -101,3 +105,66 @@ BOOST_FIXTURE_TEST_CASE(ElementChunksTests, Fixture)
     testCase(gv, all, 11, { 1, 1, 1, 1, 1, 1, 1, 1, 0, 0, 0 });
     testCase(gv, interior, 11, { 1, 1, 1, 1, 1, 1, 1, 1, 0, 0, 0 });
 }
+
+template <class PartitionSet>
+void
+testWeightedCase(const GV& gv,
+                 const PartitionSet part,
+                 const std::size_t num_chunks,
+                 const std::vector<double>& cost,
+                 const std::vector<int>& expected)
+{
+    Opm::ElementChunks chunks(gv, part, num_chunks, cost);
+    auto counts = countChunks(chunks);
+    BOOST_CHECK_EQUAL_COLLECTIONS(counts.begin(), counts.end(), expected.begin(), expected.end());
+}
+
+BOOST_FIXTURE_TEST_CASE(WeightedElementChunksTests, Fixture)
+{
+    std::array<int, 3> dims = { 8, 1, 1 };
+    std::array<double, 3> cellsz = { 1.0, 1.0, 1.0 };
+    Dune::CpGrid grid;
+    grid.createCartesian(dims, cellsz);
+    const auto& gv = grid.leafGridView();
+    using namespace Dune::Partitions;
+    const std::vector<double> unit(8, 1.0);
+    BOOST_CHECK_THROW(Opm::ElementChunks(gv, all, 2, std::vector<double>(7, 1.0)), std::invalid_argument);
+    BOOST_CHECK_THROW(Opm::ElementChunks(gv, all, 2, std::vector<double>(8, -1.0)), std::invalid_argument);
+    // Uniform costs
+    testWeightedCase(gv, all, 1, unit, { 8 });
+    testWeightedCase(gv, all, 2, unit, { 4, 4 });
+    testWeightedCase(gv, interior, 3, unit, { 3, 2, 3 });
+    testWeightedCase(gv, all, 11, unit, { 1, 0, 1, 1, 1, 0, 1, 1, 1, 0, 1 });
+    // Zero costs are treated as uniform
+    testWeightedCase(gv, all, 2, std::vector<double>(8, 0.0), { 4, 4 });
+    // Varying costs
+    testWeightedCase(gv, all, 2, { 3.0, 3.0, 1.0, 1.0, 1.0, 1.0, 1.0, 1.0 }, { 2, 6 });
+    testWeightedCase(gv, interior, 3, { 5.0, 1.0, 1.0, 1.0, 1.0, 1.0, 1.0, 4.0 }, { 1, 5, 2 });
+}
+
+BOOST_FIXTURE_TEST_CASE(ElementChunksIndexRanges, Fixture)
+{
+    std::array<int, 3> dims = { 8, 1, 1 };
+    std::array<double, 3> cellsz = { 1.0, 1.0, 1.0 };
+    Dune::CpGrid grid;
+    grid.createCartesian(dims, cellsz);
+    const auto& gv = grid.leafGridView();
+    Opm::ElementChunks chunks(gv, Dune::Partitions::all, 3);
+    BOOST_CHECK_EQUAL(chunks.end() - chunks.begin(), 3);
+    int start = 0;
+    for (std::size_t c = 0; c < chunks.size(); ++c) {
+        const auto [first, last] = chunks.indexRange(c);
+        BOOST_CHECK_EQUAL(first, start);
+        int index = first;
+        for (const auto& elem : chunks.begin()[c]) {
+            BOOST_CHECK_EQUAL(elem.index(), index++);
+        }
+        BOOST_CHECK_EQUAL(index, last);
+        start = last;
+    }
+    BOOST_CHECK_EQUAL(start, 8);
+
+    Opm::FirstTouchVector<int> data(2 * gv.size(0));
+    chunks.firstTouch(data, 7, 2);
+    BOOST_CHECK(std::ranges::all_of(data, [](const int d) { return d == 7; }));
+}
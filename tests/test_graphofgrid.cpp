@@ -114,6 +114,67 @@ BOOST_AUTO_TEST_CASE(SimpleGraphWithVertexContraction)
 
 }
 
+// cell weights are summed up over contracted vertices
+BOOST_AUTO_TEST_CASE(CellWeights)
+{
+    Dune::CpGrid grid;
+    std::array<int,3> dims{2,2,2};
+    std::array<double,3> size{2.,2.,2.};
+    grid.createCartesian(dims,size);
+    Opm::GraphOfGrid gog(grid);
+    if (grid.size(0)==0)
+        return;
+
+    BOOST_REQUIRE_THROW(gog.setCellWeights(std::vector<float>(7, 1.)), std::invalid_argument);
+    gog.addWell(std::set<int>{0,4});
+    gog.setCellWeights({1., 2., 3., 4., 5., 6., 7., 8.});
+    BOOST_REQUIRE(gog.getVertex(0).weight==6.);
+    BOOST_REQUIRE(gog.getVertex(4).weight==6.);
+    BOOST_REQUIRE(gog.getVertex(3).weight==4.);
+    gog.contractVertices(2,3); // weights set before contraction are added up
+    BOOST_REQUIRE(gog.getVertex(2).weight==7.);
+    float totalWeight = 0;
+    gog.forEachVertex([&](int, float weight) { totalWeight += weight; });
+    BOOST_REQUIRE(totalWeight==36.);
+}
+
+// the array accessors agree with the vertex properties after contractions
+BOOST_AUTO_TEST_CASE(ArrayAccessAfterContraction)
+{
+    Dune::CpGrid grid;
+    std::array<int,3> dims{4,3,2};
+    std::array<double,3> size{1.,1.,1.};
+    grid.createCartesian(dims,size);
+    Opm::GraphOfGrid gog(grid);
+    if (grid.size(0)==0)
+        return;
+
+    gog.addWell(std::set<int>{1,5,9});
+    gog.addWell(std::set<int>{9,21}); // joins the first well
+    gog.contractVertices(14,15);
+    BOOST_REQUIRE(gog.size()==24-4);
+    BOOST_REQUIRE(gog.getWells().size()==1);
+
+    int numVertices = 0;
+    float totalWeight = 0;
+    std::vector<std::pair<int,float>> edges;
+    gog.forEachVertex([&](int gID, float weight)
+    {
+        ++numVertices;
+        totalWeight += weight;
+        const auto vertex = gog.getVertex(gID);
+        BOOST_CHECK(vertex.weight==weight);
+        BOOST_REQUIRE(gog.getEdges(gID, edges)==(int)vertex.edges.size());
+        BOOST_CHECK(std::map<int,float>(edges.begin(), edges.end())==vertex.edges);
+    });
+    BOOST_REQUIRE(numVertices==gog.size());
+    BOOST_REQUIRE(totalWeight==24);
+    BOOST_REQUIRE(gog.getVertex(1).weight==4);
+    BOOST_REQUIRE(gog.getVertex(21).weight==4); // well cells find their well
+    BOOST_REQUIRE(gog.getEdges(15, edges)==-1); // contracted outside of a well
+    BOOST_REQUIRE(gog.edgeList(14).size()==5);
+}
+
 BOOST_AUTO_TEST_CASE(SimpleGraphWithTransmissibilities)
 {
     Dune::CpGrid grid;
@@ -34,12 +34,16 @@
 
 #include <opm/grid/GraphOfGrid.hpp>
 #include <opm/grid/GraphOfGridWrappers.hpp>
+#include <opm/grid/common/CommunicationUtils.hpp>
 
 #if HAVE_OPM_COMMON
 #include <opm/input/eclipse/Schedule/Well/Well.hpp>
 #endif
 
 #include <algorithm>
+#include <map>
+#include <numeric>
+#include <unordered_map>
 
 #if HAVE_MPI
 BOOST_AUTO_TEST_CASE(ExtendRootExportList)
@@ -162,6 +166,81 @@ BOOST_AUTO_TEST_CASE(CommunicateExportedCells)
     }
 }
 
+// Vertices of the graph on root are spread in slabs of equal weight,
+// with edges pointing to the rank holding the neighbor.
+BOOST_AUTO_TEST_CASE(DistributeGraphOfGrid)
+{
+    Dune::CpGrid grid;
+    std::array<int, 3> dims { 6, 4, 3 };
+    std::array<double, 3> size { 1., 1., 1. };
+    grid.createCartesian(dims, size);
+    const auto& cc = grid.comm();
+
+    Opm::GraphOfGrid gog(grid);
+    if (cc.rank() == 0) {
+        gog.addWell(std::set<int> { 0, 1, 2 });
+        gog.addWell(std::set<int> { 30, 31 });
+        BOOST_REQUIRE(gog.size() == 69);
+    }
+    const auto piece = Opm::Impl::distributeGraphOfGrid(gog, cc, 0);
+    BOOST_REQUIRE(piece.weights.size() == piece.gIDs.size());
+    BOOST_REQUIRE(piece.edgeOffsets.size() == piece.gIDs.size() + 1);
+    BOOST_REQUIRE(piece.nborGIDs.size() == (std::size_t)piece.edgeOffsets.back());
+    BOOST_REQUIRE(piece.nborProcs.size() == piece.nborGIDs.size());
+    BOOST_REQUIRE(piece.edgeWeights.size() == piece.nborGIDs.size());
+
+    const float weight = std::accumulate(piece.weights.begin(), piece.weights.end(), 0.f);
+    BOOST_CHECK(cc.sum(weight) == 72);
+    BOOST_CHECK(weight <= 72.f / cc.size() + 3); // 3 is the largest vertex weight
+
+    // each vertex is held by one rank, which its neighbors know
+    const auto [allGIDs, displ] = Opm::allGatherv(piece.gIDs, cc);
+    BOOST_REQUIRE(allGIDs.size() == 69);
+    std::vector<int> gIDtoRank(72, -1);
+    for (int rank = 0; rank < cc.size(); ++rank) {
+        for (int i = displ[rank]; i < displ[rank + 1]; ++i) {
+            BOOST_REQUIRE(gIDtoRank[allGIDs[i]] == -1);
+            gIDtoRank[allGIDs[i]] = rank;
+        }
+    }
+    for (std::size_t e = 0; e < piece.nborGIDs.size(); ++e) {
+        BOOST_CHECK(gIDtoRank[piece.nborGIDs[e]] == piece.nborProcs[e]);
+    }
+    const auto numEdges = cc.sum(static_cast<int>(piece.nborGIDs.size()));
+    // 5*4*3 + 6*3*3 + 6*4*2 faces minus 2+1 within the wells, counted from both sides
+    BOOST_CHECK(numEdges == 2 * (60 + 54 + 48 - 3));
+}
+
+// The distributed graph is partitioned into a valid partition of all cells
+BOOST_AUTO_TEST_CASE(DistributedGraphPartitioning)
+{
+    Dune::CpGrid grid;
+    std::array<int, 3> dims { 8, 6, 4 };
+    std::array<double, 3> size { 1., 1., 1. };
+    grid.createCartesian(dims, size);
+    const auto& cc = grid.comm();
+
+    const std::unordered_map<std::string, std::set<int>> futureConnections;
+    const std::map<std::string, std::string> params { { "DistributeGraph", "true" } };
+    const auto [gIDtoRank, parallelWells, exportList, importList, wellConnections]
+        = Opm::zoltanPartitioningWithGraphOfGrid(grid, nullptr, futureConnections, nullptr, cc,
+                                                 Dune::EdgeWeightMethod::defaultTransEdgeWgt,
+                                                 0, 1.1, false, params, -1);
+
+    if (cc.rank() == 0) {
+        BOOST_REQUIRE(exportList.size() == 192);
+        for (int i = 0; i < 192; ++i) {
+            BOOST_CHECK(std::get<0>(exportList[i]) == i);
+            BOOST_CHECK(std::get<1>(exportList[i]) == gIDtoRank[i]);
+        }
+    }
+    BOOST_REQUIRE(cc.sum(static_cast<int>(importList.size())) == 192);
+    for (const auto& cell : importList) {
+        BOOST_CHECK(std::get<1>(cell) == cc.rank());
+    }
+    BOOST_CHECK(std::ranges::is_sorted(importList));
+}
+
 #if HAVE_OPM_COMMON
 namespace {
 auto createWell(const std::string& name)
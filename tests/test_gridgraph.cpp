@@ -0,0 +1,151 @@
+/*
+  Copyright 2025 Equinor ASA.
+
+  This file is part of the Open Porous Media project (OPM).
+
+  OPM is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  OPM is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with OPM.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include <config.h>
+
+#define BOOST_TEST_MODULE GridGraphTest
+#include <boost/test/unit_test.hpp>
+
+#include <opm/grid/CpGrid.hpp>
+#include <opm/grid/common/GridGraph.hpp>
+
+#if HAVE_OPM_COMMON
+#include <opm/input/eclipse/Schedule/Well/Well.hpp>
+#endif
+
+#include <set>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+struct Fixture
+{
+    Fixture()
+    {
+        int m_argc = boost::unit_test::framework::master_test_suite().argc;
+        char** m_argv = boost::unit_test::framework::master_test_suite().argv;
+        Dune::MPIHelper::instance(m_argc, m_argv);
+    }
+};
+
+BOOST_GLOBAL_FIXTURE(Fixture);
+
+namespace
+{
+template<class Graph>
+void checkFaceNeighbours(const Dune::CpGrid& grid, const Graph& graph)
+{
+    BOOST_REQUIRE_EQUAL(graph.numVertices(), grid.size(0));
+    BOOST_REQUIRE_EQUAL(graph.xadj().size(), grid.size(0) + 1);
+    int numInteriorFaces = 0;
+    for (const auto& element : elements(grid.leafGridView())) {
+        std::vector<int> neighbours;
+        for (const auto& intersection : intersections(grid.leafGridView(), element)) {
+            if (intersection.neighbor()) {
+                neighbours.push_back(intersection.outside().index());
+            }
+        }
+        numInteriorFaces += neighbours.size();
+        const auto cell = element.index();
+        BOOST_CHECK_EQUAL(graph.numEdges(cell), neighbours.size());
+        BOOST_CHECK_EQUAL_COLLECTIONS(graph.adjncy().begin() + graph.xadj()[cell],
+                                      graph.adjncy().begin() + graph.xadj()[cell + 1],
+                                      neighbours.begin(), neighbours.end());
+    }
+    BOOST_CHECK_EQUAL(graph.numEdges(), numInteriorFaces);
+}
+}
+
+BOOST_AUTO_TEST_CASE(faceGraph)
+{
+    Dune::CpGrid grid;
+    grid.createCartesian({4, 3, 2}, {1.0, 1.0, 1.0});
+
+    const Dune::cpgrid::GridGraph<int, float> graph(grid);
+    checkFaceNeighbours(grid, graph);
+    BOOST_CHECK(!graph.hasEdgeWeights());
+    if (grid.size(0) > 0) {
+        // 3*2*2 + 4*2*2 + 4*3*1 interior faces, each stored twice.
+        BOOST_CHECK_EQUAL(graph.numEdges(), 2 * (12 + 16 + 12));
+    }
+
+    // Same graph with 64 bit indices, as used for METIS.
+    const Dune::cpgrid::GridGraph<long, long> graph64(grid);
+    checkFaceNeighbours(grid, graph64);
+}
+
+BOOST_AUTO_TEST_CASE(vertexWeights)
+{
+    Dune::CpGrid grid;
+    grid.createCartesian({4, 3, 2}, {1.0, 1.0, 1.0});
+    const std::size_t numCells = grid.size(0);
+
+    // Two constraints per cell, the second one is zero for every other cell.
+    std::vector<double> weights(2 * numCells);
+    for (std::size_t cell = 0; cell < numCells; ++cell) {
+        weights[2 * cell] = 0.5 + cell;
+        weights[2 * cell + 1] = (cell % 2) * 1e-3;
+    }
+
+    Dune::cpgrid::GridGraph<int, float> graph(grid);
+    BOOST_CHECK_EQUAL(graph.numVertexWeights(), 0);
+    BOOST_CHECK(graph.vertexWeights().empty());
+    graph.setVertexWeights(weights, 2);
+    BOOST_CHECK_EQUAL(graph.numVertexWeights(), 2);
+    BOOST_REQUIRE_EQUAL(graph.vertexWeights().size(), weights.size());
+    for (std::size_t i = 0; i < weights.size(); ++i) {
+        BOOST_CHECK_EQUAL(graph.vertexWeights()[i], static_cast<float>(weights[i]));
+    }
+
+    // Integral weights are scaled per constraint, positive weights stay positive.
+    Dune::cpgrid::GridGraph<long, long> graph64(grid);
+    graph64.setVertexWeights(weights, 2);
+    BOOST_REQUIRE_EQUAL(graph64.vertexWeights().size(), weights.size());
+    for (std::size_t cell = 0; cell < numCells; ++cell) {
+        const auto first = graph64.vertexWeights()[2 * cell];
+        const auto second = graph64.vertexWeights()[2 * cell + 1];
+        BOOST_CHECK_GE(first, 1);
+        BOOST_CHECK_LE(first, 100);
+        BOOST_CHECK_EQUAL(second, (cell % 2) * 100);
+    }
+    if (numCells > 0) {
+        BOOST_CHECK_EQUAL(graph64.vertexWeights()[2 * (numCells - 1)], 100);
+    }
+}
+
+#if defined(HAVE_ZOLTAN) && defined(HAVE_MPI)
+BOOST_AUTO_TEST_CASE(faceGraphWithoutWellConnections)
+{
+    Dune::CpGrid grid;
+    grid.createCartesian({4, 3, 2}, {1.0, 1.0, 1.0});
+
+    // Without any wells the combined graph only has the faces of the grid,
+    // each with the uniform edge weight.
+    const std::vector<Dune::cpgrid::OpmWellType> wells;
+    const std::unordered_map<std::string, std::set<int>> futureConnections;
+    const Dune::cpgrid::CombinedGridWellGraph gridAndWells(grid, &wells, futureConnections, nullptr,
+                                                           grid.size(0) == 0, Dune::uniformEdgeWgt);
+    const Dune::cpgrid::ZoltanGridGraph graph(gridAndWells);
+    checkFaceNeighbours(grid, graph);
+    BOOST_CHECK_EQUAL(graph.edgeWeights().size(), graph.numEdges());
+    for (const auto weight : graph.edgeWeights()) {
+        BOOST_CHECK_EQUAL(weight, 1.0f);
+    }
+}
+#endif
@@ -27,6 +27,8 @@
 
 #include <opm/grid/MinpvProcessor.hpp>
 
+#include <random>
+
 
 BOOST_AUTO_TEST_CASE(GAP_MAXGAP)
 {
@@ -388,3 +390,67 @@ BOOST_AUTO_TEST_CASE(Processing)
     BOOST_CHECK_EQUAL(minpv_result7.nnc.size(), 1);
     BOOST_CHECK_EQUAL_COLLECTIONS(z7.begin(), z7.end(), zcorn7after.begin(), zcorn7after.end());
 }
+
+BOOST_AUTO_TEST_CASE(ThreadedMatchesSerial)
+{
+    // Columns of varying layer thickness with thin, small and inactive
+    // cells scattered around, so that both NNCs and removed cells occur.
+    const int nx = 13, ny = 11, nz = 9;
+    const int n = nx * ny * nz;
+    std::mt19937 gen(42);
+    std::uniform_real_distribution<double> dist(0.0, 1.0);
+
+    std::vector<double> thickness(n), pv(n), permz(n, 1.0);
+    std::vector<double> minpvv(n, 0.3);
+    std::vector<int> actnum(n, 1);
+    // The top layer is kept regular.
+    for (int c = nx * ny; c < n; ++c) {
+        thickness[c] = dist(gen) < 0.2 ? 0.01 : dist(gen);
+        pv[c] = dist(gen);
+        actnum[c] = dist(gen) < 0.9;
+    }
+    for (int c = 0; c < nx * ny; ++c) {
+        thickness[c] = 1.0;
+        pv[c] = 1.0;
+    }
+    std::vector<double> zcorn(8 * n);
+    for (int j = 0; j < ny; ++j) {
+        for (int i = 0; i < nx; ++i) {
+            double z = 0.0;
+            for (int k = 0; k < nz; ++k) {
+                const int c = i + nx * (j + ny * k);
+                const double top = z + (dist(gen) < 0.3 ? 0.1 * dist(gen) : 0.0);
+                z = top + thickness[c];
+                for (int dj = 0; dj < 2; ++dj) {
+                    for (int di = 0; di < 2; ++di) {
+                        const int ix = 2*i + di + 2*nx*(2*j + dj);
+                        zcorn[ix + 4*nx*ny*(2*k)] = top;
+                        zcorn[ix + 4*nx*ny*(2*k + 1)] = z;
+                    }
+                }
+            }
+        }
+    }
+    auto multz = [](int c) { return c % 17 == 0 ? 0.0 : 1.0; };
+
+    for (const bool merge : {false, true}) {
+        Opm::MinpvProcessor serial(nx, ny, nz);
+        serial.setNumThreads(1);
+        auto z_serial = zcorn;
+        const auto expected = serial.process(thickness, 0.05, 0.08, pv, minpvv, actnum, merge,
+                                             z_serial.data(), false, true, permz, multz);
+        BOOST_CHECK(!expected.removed_cells.empty());
+        BOOST_CHECK(merge || !expected.nnc.empty());
+
+        for (const int num_threads : {2, 3, 8}) {
+            Opm::MinpvProcessor threaded(nx, ny, nz);
+            threaded.setNumThreads(num_threads);
+            auto z_threaded = zcorn;
+            const auto result = threaded.process(thickness, 0.05, 0.08, pv, minpvv, actnum, merge,
+                                                 z_threaded.data(), false, true, permz, multz);
+            BOOST_CHECK(result.removed_cells == expected.removed_cells);
+            BOOST_CHECK(result.nnc == expected.nnc);
+            BOOST_CHECK(z_threaded == z_serial);
+        }
+    }
+}
@@ -0,0 +1,183 @@
+/*
+  Copyright 2025 Equinor ASA.
+
+  This file is part of the Open Porous Media project (OPM).
+
+  OPM is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  OPM is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with OPM.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include <config.h>
+
+#define BOOST_TEST_MODULE ParallelForEachTest
+#include <boost/test/unit_test.hpp>
+
+#include <opm/grid/CpGrid.hpp>
+#include <opm/grid/polyhedralgrid.hh>
+#include <opm/grid/utility/ParallelForEach.hpp>
+
+#include <algorithm>
+#include <atomic>
+#include <functional>
+#include <stdexcept>
+#include <vector>
+
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
+struct Fixture
+{
+    Fixture()
+    {
+        int m_argc = boost::unit_test::framework::master_test_suite().argc;
+        char** m_argv = boost::unit_test::framework::master_test_suite().argv;
+        Dune::MPIHelper::instance(m_argc, m_argv);
+    }
+};
+
+BOOST_GLOBAL_FIXTURE(Fixture);
+
+namespace
+{
+template <class GridView>
+void checkLoops(const GridView& gv)
+{
+    Opm::ParallelGridLoop loop(gv, true, 4);
+    const int nc = gv.size(0);
+    BOOST_REQUIRE_EQUAL(loop.numCells(), nc);
+
+    std::vector<std::atomic<int>> cell_visits(nc);
+    loop.forEachCell([&](const auto& elem) { ++cell_visits[gv.indexSet().index(elem)]; });
+    BOOST_CHECK(std::ranges::all_of(cell_visits, [](const auto& v) { return v == 1; }));
+
+    std::vector<int> num_intersections(nc, 0);
+    for (const auto& elem : elements(gv)) {
+        for (const auto& intersection : intersections(gv, elem)) {
+            static_cast<void>(intersection);
+            ++num_intersections[gv.indexSet().index(elem)];
+        }
+    }
+    std::vector<std::atomic<int>> intersection_visits(nc);
+    std::atomic<int> wrong_inside{0};
+    loop.forEachIntersection([&](const auto& elem, const auto& intersection) {
+        if (intersection.inside() != elem) {
+            ++wrong_inside;
+        }
+        ++intersection_visits[gv.indexSet().index(elem)];
+    });
+    BOOST_CHECK_EQUAL(wrong_inside.load(), 0);
+    for (int c = 0; c < nc; ++c) {
+        BOOST_CHECK_EQUAL(intersection_visits[c].load(), num_intersections[c]);
+    }
+
+    // Counting faces per cell concurrently needs atomics, unless the
+    // faces are handled by colour.
+    const int nf = loop.numFaces();
+    std::vector<std::atomic<int>> face_visits(nf);
+    std::vector<std::atomic<int>> atomic_count(nc);
+    loop.forEachFace([&](const int face, const int c0, const int c1) {
+        ++face_visits[face];
+        for (const int cell : {c0, c1}) {
+            if (cell >= 0) {
+                ++atomic_count[cell];
+            }
+        }
+    });
+    BOOST_CHECK(std::ranges::all_of(face_visits, [](const auto& v) { return v == 1; }));
+
+    std::vector<int> count(nc, 0);
+    std::ranges::fill(face_visits, 0);
+    loop.forEachFaceColoured([&](const int face, const int c0, const int c1) {
+        ++face_visits[face];
+        for (const int cell : {c0, c1}) {
+            if (cell >= 0) {
+                ++count[cell];
+            }
+        }
+    });
+    BOOST_CHECK(std::ranges::all_of(face_visits, [](const auto& v) { return v == 1; }));
+    for (int c = 0; c < nc; ++c) {
+        BOOST_CHECK_EQUAL(count[c], atomic_count[c].load());
+    }
+
+    // Cells sharing a face or a neighbour have different colours.
+    BOOST_CHECK(loop.numColours() > 1);
+    std::vector<std::vector<int>> neighbours(nc);
+    for (const auto& elem : elements(gv)) {
+        for (const auto& intersection : intersections(gv, elem)) {
+            if (intersection.neighbor()) {
+                neighbours[gv.indexSet().index(elem)].push_back(gv.indexSet().index(intersection.outside()));
+            }
+        }
+    }
+    for (int c = 0; c < nc; ++c) {
+        for (const int n : neighbours[c]) {
+            BOOST_CHECK_NE(loop.cellColour(c), loop.cellColour(n));
+            for (const int m : neighbours[n]) {
+                if (m != c) {
+                    BOOST_CHECK_NE(loop.cellColour(c), loop.cellColour(m));
+                }
+            }
+        }
+    }
+
+    const auto volume = [&](const auto& elem) { return elem.geometry().volume(); };
+    const double total = loop.transformReduceCells(0.0, volume, std::plus<>());
+    BOOST_CHECK_CLOSE(total, 24.0, 1e-10);
+}
+}
+
+BOOST_AUTO_TEST_CASE(cpGrid)
+{
+    Dune::CpGrid grid;
+    grid.createCartesian({4, 3, 2}, {1.0, 1.0, 1.0});
+    checkLoops(grid.leafGridView());
+}
+
+BOOST_AUTO_TEST_CASE(polyhedralGrid)
+{
+    Dune::PolyhedralGrid<3, 3> grid({4, 3, 2}, {1.0, 1.0, 1.0});
+    checkLoops(grid.leafGridView());
+}
+
+BOOST_AUTO_TEST_CASE(indexLoops)
+{
+    const int n = 10007;
+    std::vector<std::atomic<int>> visits(n);
+    Opm::parallelForEachIndex(n, [&](const int i) { ++visits[i]; }, 16);
+    BOOST_CHECK(std::ranges::all_of(visits, [](const auto& v) { return v == 1; }));
+
+    BOOST_CHECK_THROW(Opm::parallelForEachIndex(n, [](const int i) {
+        if (i == n / 2) {
+            throw std::runtime_error("failure");
+        }
+    }, 16), std::runtime_error);
+
+    // The result of an ordered reduction does not depend on the number of threads.
+    const auto term = [](const int i) { return 1.0 / (1.0 + i); };
+    const double sum = Opm::parallelTransformReduce(n, 0.0, term, std::plus<>(), 32);
+#ifdef _OPENMP
+    const int num_threads = omp_get_max_threads();
+    omp_set_num_threads(1);
+    BOOST_CHECK_EQUAL(Opm::parallelTransformReduce(n, 0.0, term, std::plus<>(), 32), sum);
+    omp_set_num_threads(3);
+    BOOST_CHECK_EQUAL(Opm::parallelTransformReduce(n, 0.0, term, std::plus<>(), 32), sum);
+    omp_set_num_threads(num_threads);
+#endif
+    double serial = 0.0;
+    for (int i = 0; i < n; ++i) {
+        serial += term(i);
+    }
+    BOOST_CHECK_CLOSE(sum, serial, 1e-10);
+}
@@ -9,6 +9,8 @@
 #include <opm/grid/cpgpreprocess/preprocess.h>
 #include <opm/grid/cpgpreprocess/make_edge_conformal.hpp>
 
+#include <tests/FaultedStaircase.hpp>
+
 #include <array>
 #include <cstddef>
 #include <initializer_list>
@@ -66,6 +68,12 @@ namespace {
             return *this;
         }
 
+        TestGrid& numThreads(const int num_threads)
+        {
+            this->num_threads_ = num_threads;
+            return *this;
+        }
+
         TestGrid& process()
         {
             auto input = grdecl{};
@@ -79,12 +87,13 @@ namespace {
             this->g_.emplace(processed_grid{});
 
             this->status_ =
-                process_grdecl(this->pinch_active_,
-                               this->edge_conformal_,
-                               this->ztol_,
-                               &input,
-                               /* is_aquifer_cell = */ nullptr,
-                               &*this->g_);
+                process_grdecl_threaded(this->pinch_active_,
+                                        this->edge_conformal_,
+                                        this->ztol_,
+                                        &input,
+                                        /* is_aquifer_cell = */ nullptr,
+                                        this->num_threads_,
+                                        &*this->g_);
 
             if ((this->status_ != 0) && (this->edge_conformal_ != 0)) {
                 add_cell_face_mapping(&*this->g_);
@@ -107,6 +116,7 @@ namespace {
         double ztol_{0.0};
         int pinch_active_{0};
         int edge_conformal_{0};
+        int num_threads_{1};
         int status_{};
 
         std::optional<processed_grid> g_{};
@@ -220,6 +230,45 @@ namespace {
 
             .actnum({ 1, 1, });
     }
+
+    TestGrid faultedStaircase(const int nx, const int ny, const int nz)
+    {
+        const auto input = Opm::faultedStaircase(nx, ny, nz);
+
+        return TestGrid {{ nx, ny, nz }}
+            .coord(input.coord)
+            .zcorn(input.zcorn)
+            .actnum(input.actnum);
+    }
+
+    void checkSameGrid(const processed_grid& g1, const processed_grid& g2)
+    {
+        BOOST_REQUIRE_EQUAL(g1.number_of_faces, g2.number_of_faces);
+        BOOST_REQUIRE_EQUAL(g1.number_of_nodes, g2.number_of_nodes);
+        BOOST_REQUIRE_EQUAL(g1.number_of_cells, g2.number_of_cells);
+
+        const auto nf = g1.number_of_faces;
+
+        BOOST_CHECK_EQUAL_COLLECTIONS(g1.face_node_ptr, g1.face_node_ptr + nf + 1,
+                                      g2.face_node_ptr, g2.face_node_ptr + nf + 1);
+
+        BOOST_CHECK_EQUAL_COLLECTIONS(g1.face_nodes, g1.face_nodes + g1.face_node_ptr[nf],
+                                      g2.face_nodes, g2.face_nodes + g2.face_node_ptr[nf]);
+
+        BOOST_CHECK_EQUAL_COLLECTIONS(g1.face_neighbors, g1.face_neighbors + 2*nf,
+                                      g2.face_neighbors, g2.face_neighbors + 2*nf);
+
+        for (auto f = 0*nf; f < nf; ++f) {
+            BOOST_CHECK_MESSAGE(g1.face_tag[f] == g2.face_tag[f],
+                                "Face tag mismatch for face " << f);
+        }
+
+        BOOST_CHECK_EQUAL_COLLECTIONS(g1.node_coordinates, g1.node_coordinates + 3*g1.number_of_nodes,
+                                      g2.node_coordinates, g2.node_coordinates + 3*g2.number_of_nodes);
+
+        BOOST_CHECK_EQUAL_COLLECTIONS(g1.local_cell_index, g1.local_cell_index + g1.number_of_cells,
+                                      g2.local_cell_index, g2.local_cell_index + g2.number_of_cells);
+    }
 } // Anonymous namespace
 
 BOOST_AUTO_TEST_SUITE(Regular_Processing)
@@ -841,3 +890,38 @@ BOOST_AUTO_TEST_CASE(Single_Fault_Connection)
 }
 
 BOOST_AUTO_TEST_SUITE_END()     // Edge_Conformal_Processing
+
+// ---------------------------------------------------------------------------
+
+BOOST_AUTO_TEST_SUITE(Threaded_Processing)
+
+BOOST_AUTO_TEST_CASE(Faulted_Staircase_Matches_Serial)
+{
+    for (const auto pinch : { false, true }) {
+        for (const auto conformal : { false, true }) {
+            auto serial = faultedStaircase(5, 7, 4)
+                .pinchActive(pinch)
+                .edgeConformal(conformal)
+                .numThreads(1);
+
+            serial.process();
+            BOOST_REQUIRE_EQUAL(serial.status(), 1);
+            BOOST_REQUIRE_GT(serial.grid().number_of_nodes,
+                             serial.grid().number_of_nodes_on_pillars);
+
+            for (const auto num_threads : { 2, 3, 16 }) {
+                auto threaded = faultedStaircase(5, 7, 4)
+                    .pinchActive(pinch)
+                    .edgeConformal(conformal)
+                    .numThreads(num_threads);
+
+                threaded.process();
+                BOOST_REQUIRE_EQUAL(threaded.status(), 1);
+
+                checkSameGrid(serial.grid(), threaded.grid());
+            }
+        }
+    }
+}
+
+BOOST_AUTO_TEST_SUITE_END()     // Threaded_Processing
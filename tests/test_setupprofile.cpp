@@ -0,0 +1,143 @@
+/*
+  Copyright 2025 Equinor ASA.
+
+  This file is part of the Open Porous Media project (OPM).
+
+  OPM is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  OPM is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with OPM.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include <config.h>
+
+#define BOOST_TEST_MODULE SetupProfileTest
+#include <boost/test/unit_test.hpp>
+
+#include <opm/grid/CpGrid.hpp>
+#include <opm/grid/utility/SetupProfile.hpp>
+
+#include <algorithm>
+#include <sstream>
+#include <string>
+
+struct Fixture
+{
+    Fixture()
+    {
+        int m_argc = boost::unit_test::framework::master_test_suite().argc;
+        char** m_argv = boost::unit_test::framework::master_test_suite().argv;
+        Dune::MPIHelper::instance(m_argc, m_argv);
+    }
+};
+
+BOOST_GLOBAL_FIXTURE(Fixture);
+
+BOOST_AUTO_TEST_CASE(disabled_profile_records_nothing)
+{
+    Opm::SetupProfile profile;
+    profile.setEnabled(false);
+    {
+        Opm::SetupProfile::Scope scope(&profile, "phase");
+        scope.count("cells", 10);
+    }
+    Opm::SetupProfile::Scope null_scope(nullptr, "phase");
+    null_scope.count("cells", 10);
+    BOOST_CHECK(profile.phases().empty());
+}
+
+BOOST_AUTO_TEST_CASE(nested_scopes)
+{
+    Opm::SetupProfile profile;
+    profile.setEnabled(true);
+    {
+        Opm::SetupProfile::Scope outer(&profile, "outer");
+        Opm::SetupProfile::Scope first(&profile, "first");
+        first.count("cells", 8);
+        first.close();
+        {
+            Opm::SetupProfile::Scope second(&profile, "second");
+            Opm::SetupProfile::Scope inner(&profile, "inner");
+        }
+        outer.count("faces", 36);
+    }
+
+    const auto& phases = profile.phases();
+    BOOST_REQUIRE_EQUAL(phases.size(), 4);
+    BOOST_CHECK_EQUAL(phases[0].name, "outer");
+    BOOST_CHECK_EQUAL(phases[0].parent, -1);
+    BOOST_CHECK_EQUAL(phases[1].name, "first");
+    BOOST_CHECK_EQUAL(phases[1].parent, 0);
+    BOOST_CHECK_EQUAL(phases[2].name, "second");
+    BOOST_CHECK_EQUAL(phases[2].parent, 0);
+    BOOST_CHECK_EQUAL(phases[3].name, "inner");
+    BOOST_CHECK_EQUAL(phases[3].parent, 2);
+    BOOST_CHECK_EQUAL(phases[3].depth, 2);
+
+    BOOST_REQUIRE_EQUAL(phases[1].counts.size(), 1);
+    BOOST_CHECK_EQUAL(phases[1].counts[0].first, "cells");
+    BOOST_CHECK_EQUAL(phases[1].counts[0].second, 8);
+    BOOST_REQUIRE_EQUAL(phases[0].counts.size(), 1);
+    BOOST_CHECK_EQUAL(phases[0].counts[0].second, 36);
+
+    for (const auto& phase : phases) {
+        BOOST_CHECK(phase.seconds >= 0.0);
+        BOOST_CHECK(phase.peak_rss_delta_kb >= 0);
+    }
+    // Children lie within their parents.
+    BOOST_CHECK(phases[1].start >= phases[0].start);
+    BOOST_CHECK(phases[2].start >= phases[1].start + phases[1].seconds);
+    BOOST_CHECK(phases[3].start + phases[3].seconds <= phases[0].start + phases[0].seconds);
+
+    std::ostringstream trace;
+    profile.writeChromeTrace(trace, 3);
+    const auto json = trace.str();
+    BOOST_CHECK(json.find("\"traceEvents\"") != std::string::npos);
+    BOOST_CHECK_EQUAL(std::count(json.begin(), json.end(), '\n'), 6);
+    BOOST_CHECK(json.find("\"name\":\"inner\"") != std::string::npos);
+    BOOST_CHECK(json.find("\"pid\":3") != std::string::npos);
+    BOOST_CHECK(json.find("\"cells\":8") != std::string::npos);
+
+    std::ostringstream report;
+    profile.writeReport(report);
+    BOOST_CHECK(report.str().find("    inner") != std::string::npos);
+
+    profile.clear();
+    BOOST_CHECK(profile.phases().empty());
+}
+
+BOOST_AUTO_TEST_CASE(cpgrid_records_setup_phases)
+{
+    Dune::CpGrid grid;
+    grid.enableSetupProfile(true);
+    grid.createCartesian({4, 3, 2}, {1.0, 1.0, 1.0});
+    grid.globalRefine(1);
+
+    const auto& phases = grid.setupProfile().phases();
+    auto find = [&phases](const std::string& name)
+    {
+        return std::find_if(phases.begin(), phases.end(),
+                            [&name](const auto& phase) { return phase.name == name; });
+    };
+
+    BOOST_REQUIRE(find("createCartesian") != phases.end());
+    BOOST_CHECK(find("refinement") != phases.end());
+    BOOST_CHECK_EQUAL(find("createCartesian")->parent, -1);
+    if (grid.comm().rank() == 0) {
+        const auto topology = find("topology");
+        BOOST_REQUIRE(topology != phases.end());
+        BOOST_CHECK_EQUAL(phases[topology->parent].name, "createCartesian");
+        BOOST_CHECK_EQUAL(topology->counts[0].first, "cells");
+        BOOST_CHECK_EQUAL(topology->counts[0].second, 24);
+        BOOST_CHECK(find("geometry") != phases.end());
+        BOOST_CHECK(find("cells") != phases.end());
+    }
+}
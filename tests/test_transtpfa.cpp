@@ -0,0 +1,127 @@
+/*
+  Copyright 2025 Equinor ASA.
+
+  This file is part of the Open Porous Media project (OPM).
+
+  OPM is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  OPM is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with OPM.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include <config.h>
+
+#define BOOST_TEST_MODULE TransTpfaTest
+#include <boost/test/unit_test.hpp>
+
+#include <opm/grid/CpGrid.hpp>
+#include <opm/grid/cart_grid.h>
+#include <opm/grid/UnstructuredGrid.h>
+#include <opm/grid/cpgrid/GridHelpers.hpp>
+#include <opm/grid/transmissibility/TransTpfa.hpp>
+
+#include <array>
+#include <cmath>
+#include <vector>
+
+struct Fixture
+{
+    Fixture()
+    {
+        int m_argc = boost::unit_test::framework::master_test_suite().argc;
+        char** m_argv = boost::unit_test::framework::master_test_suite().argv;
+        Dune::MPIHelper::instance(m_argc, m_argv);
+    }
+};
+
+BOOST_GLOBAL_FIXTURE(Fixture);
+
+namespace
+{
+const std::array<double, 3> cellSize {2.0, 1.0, 0.5};
+const std::array<double, 3> permeability {1.0, 2.0, 3.0};
+
+/* Diagonal permeability tensors in column major order. */
+std::vector<double> diagonalPermeability(int numCells)
+{
+    std::vector<double> perm(9 * numCells, 0.0);
+    for (int c = 0; c < numCells; ++c) {
+        for (int d = 0; d < 3; ++d) {
+            perm[9 * c + 4 * d] = permeability[d];
+        }
+    }
+    return perm;
+}
+
+/* In a Cartesian grid with diagonal permeability the one-sided
+ * transmissibility of a face with normal along axis d is
+ * k_d * area / (h_d / 2). */
+template<class Grid>
+void checkTransmissibilities(const Grid& grid)
+{
+    using namespace Opm::UgGridHelpers;
+    const int nc = numCells(grid);
+    const int nf = numFaces(grid);
+    const auto perm = diagonalPermeability(nc);
+
+    std::vector<double> htrans(numCellFaces(grid), -1.0);
+    tpfa_htrans_compute(&grid, perm.data(), htrans.data());
+
+    const auto c2f = cell2Faces(grid);
+    std::vector<double> expected_trans(nf, 0.0);
+    int i = 0;
+    for (int c = 0; c < nc; ++c) {
+        for (const int f : c2f[c]) {
+            const double* n = faceNormal(grid, f);
+            int d = 0;
+            for (int j = 1; j < 3; ++j) {
+                if (std::abs(n[j]) > std::abs(n[d])) {
+                    d = j;
+                }
+            }
+            const double expected = permeability[d] * faceArea(grid, f) / (0.5 * cellSize[d]);
+            BOOST_CHECK_CLOSE(htrans[i], expected, 1e-10);
+            expected_trans[f] += 1.0 / expected;
+            ++i;
+        }
+    }
+    BOOST_CHECK_EQUAL(i, static_cast<int>(htrans.size()));
+
+    std::vector<double> trans(nf, -1.0);
+    tpfa_trans_compute(&grid, htrans.data(), trans.data());
+    for (int f = 0; f < nf; ++f) {
+        BOOST_CHECK_CLOSE(trans[f], 1.0 / expected_trans[f], 1e-10);
+    }
+
+    // A uniform total mobility scales every transmissibility.
+    const std::vector<double> totmob(nc, 2.0);
+    std::vector<double> eff_trans(nf, -1.0);
+    tpfa_eff_trans_compute(&grid, totmob.data(), htrans.data(), eff_trans.data());
+    for (int f = 0; f < nf; ++f) {
+        BOOST_CHECK_CLOSE(eff_trans[f], 2.0 * trans[f], 1e-10);
+    }
+}
+}
+
+BOOST_AUTO_TEST_CASE(unstructuredGrid)
+{
+    const UnstructuredGrid* grid = create_grid_hexa3d(4, 3, 2, cellSize[0], cellSize[1], cellSize[2]);
+    BOOST_REQUIRE(grid != nullptr);
+    checkTransmissibilities(*grid);
+    destroy_grid(const_cast<UnstructuredGrid*>(grid));
+}
+
+BOOST_AUTO_TEST_CASE(cpGrid)
+{
+    Dune::CpGrid grid;
+    grid.createCartesian({4, 3, 2}, {cellSize[0], cellSize[1], cellSize[2]});
+    checkTransmissibilities(grid);
+}